@@ -56,6 +56,9 @@
 
 # include "proposed_analysis.h"
 # include "proposed_synthesis.h"
+# include "proposed_profile.h"
+# include "proposed_rtguard.h"
+# include "proposed_trace.h"
 
 
 #endif /* __SAF_PROPOSED_H_INCLUDED__ */
@@ -53,6 +53,8 @@
 #ifndef __PROPOSED_ANALYSIS_H_INCLUDED__
 #define __PROPOSED_ANALYSIS_H_INCLUDED__
 
+#include "proposed_profile.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -60,6 +62,79 @@ extern "C" {
 /** Maximum number of microphones */
 #define PROPOSED_MAX_NMICS ( 64 )
 
+/** Default ATF fitting error for proposed_analysis_create() (-30 dB) */
+#define PROPOSED_ATF_SH_DEFAULT_FIT_ERROR ( 1e-3f )
+
+/** Spatial parameter update schedules for proposed_analysis */
+typedef enum {
+    PROPOSED_ANALYSIS_UPDATE_ALL_BANDS,  /**< (Default) Every band is updated
+                                          *   every block */
+    PROPOSED_ANALYSIS_UPDATE_DECIMATED,  /**< Bands below the decimation
+                                          *   frequency are updated every Nth
+                                          *   block, the rest every block */
+    PROPOSED_ANALYSIS_UPDATE_ROUND_ROBIN,/**< Every Nth band is updated per
+                                          *   block, cycling through the bands
+                                          *   over N blocks */
+    PROPOSED_ANALYSIS_UPDATE_HOLD        /**< No bands are updated; the
+                                          *   previous estimates are held */
+}PROPOSED_ANALYSIS_UPDATE_SCHEDULES;
+
+/**
+ * Limits which may be placed on the analysis at run-time (e.g. by a CPU
+ * governor), on top of its settings, without changing the settings themselves
+ * (see proposed_analysis_getLimitsPtr())
+ */
+typedef struct _proposed_analysis_limits {
+    float maxAnalysisFreq;         /**< Upper limit on the maximum analysis
+                                    *   frequency, in Hz (0: no limit) */
+    int forceBandLimitedAnalysis;  /**< 1: band-limited analysis, regardless
+                                    *   of the setting; 0: as set */
+    int minUpdateInterval;         /**< >1: bands are updated round-robin, at
+                                    *   least this many blocks apart,
+                                    *   regardless of the update schedule;
+                                    *   0 or 1: as set */
+    int holdParameters;            /**< 1: no bands are updated (see
+                                    *   #PROPOSED_ANALYSIS_UPDATE_HOLD); 0: as
+                                    *   set */
+}proposed_analysis_limits;
+
+/** Error codes for loading and saving array model bundles */
+typedef enum {
+    PROPOSED_BUNDLE_OK,                  /**< No error */
+    PROPOSED_BUNDLE_ERROR_FILE,          /**< The file could not be opened,
+                                          *   mapped or written */
+    PROPOSED_BUNDLE_ERROR_FORMAT,        /**< Not a bundle, or truncated */
+    PROPOSED_BUNDLE_ERROR_VERSION,       /**< Bundle saved by an incompatible
+                                          *   version, or on a machine of
+                                          *   different byte order */
+    PROPOSED_BUNDLE_ERROR_MISMATCH,      /**< Bundle computed for a different
+                                          *   samplerate or hopsize */
+    PROPOSED_BUNDLE_ERROR_UNSUPPORTED    /**< The model cannot be stored (i.e.
+                                          *   the ATFs are compressed) */
+}PROPOSED_BUNDLE_ERROR_CODES;
+
+/**
+ * Options for the memory that holds the run-time state of each object (see
+ * proposed_setRunTimeMemoryOption())
+ */
+typedef enum {
+    PROPOSED_RUNTIME_MEMORY_HEAP,        /**< (Default) Each buffer is
+                                          *   allocated separately, as it
+                                          *   was before the arena (e.g. for
+                                          *   use with memory checkers) */
+    PROPOSED_RUNTIME_MEMORY_ARENA,       /**< All buffers of an
+                                          *   object are allocated in one
+                                          *   block, cache-line aligned and
+                                          *   laid out in the order that they
+                                          *   are accessed, which is faulted in
+                                          *   when the object is created */
+    PROPOSED_RUNTIME_MEMORY_ARENA_LOCKED /**< As
+                                          *   #PROPOSED_RUNTIME_MEMORY_ARENA,
+                                          *   and the block is also locked into
+                                          *   physical memory (if the OS
+                                          *   permits it) */
+}PROPOSED_RUNTIME_MEMORY_OPTIONS;
+
 /** Handle for the proposed analysis data */
 typedef struct _proposed_analysis_data* proposed_analysis_handle;
 
@@ -85,6 +160,25 @@ typedef struct _proposed_signal_container_data* proposed_signal_container_handle
  * @param[in] nDirs          Number of measurement directions
  * @param[in] nMics          Number of microphones
  * @param[in] h_len          Length of impulse responses, in samples
+ * @param[in] atfFitError    0: store the array ATFs for every grid direction,
+ *                           >0: store them as spherical harmonic coefficients
+ *                           per band instead, with the order of each band
+ *                           chosen as the lowest one for which the normalised
+ *                           squared fitting error (||H - H_SH||^2 / ||H||^2)
+ *                           is at most this value, e.g.
+ *                           #PROPOSED_ATF_SH_DEFAULT_FIT_ERROR. This is much
+ *                           smaller for dense measurement grids, but the
+ *                           steering vectors are then synthesised whenever
+ *                           they are needed. Bands that cannot be fitted this
+ *                           well are stored uncompressed (see
+ *                           proposed_analysis_getATFOrder() and
+ *                           proposed_analysis_getATFFitError())
+ *
+ * @note Everything that is precomputed from the array IRs is cached for the
+ *       lifetime of the analyser (and of the synthesisers created from it).
+ *       Further analysers created in the same process with identical IRs,
+ *       directions, samplerate, hopsize and atfFitError share this data,
+ *       rather than computing and storing it again. This is thread-safe.
  */
 void proposed_analysis_create(/* Input Arguments */
                               proposed_analysis_handle* const phAna,
@@ -95,7 +189,61 @@ void proposed_analysis_create(/* Input Arguments */
                               float* array_dirs_deg,
                               int nDirs,
                               int nMics,
-                              int h_len);
+                              int h_len,
+                              float atfFitError);
+
+/**
+ * Sets the maximum number of threads used to initialise the analysis and
+ * synthesis objects (which is otherwise one per processor, up to 16)
+ *
+ * The results are identical for any number of threads. This applies to all
+ * objects created afterwards in the process.
+ *
+ * @param[in] nThreads 0: one per processor (default), 1: only the calling
+ *                     thread, >1: at most this many threads
+ */
+void proposed_setMaxInitThreads(int nThreads);
+
+/** Returns the limit set with proposed_setMaxInitThreads() (0: one per processor) */
+int proposed_getMaxInitThreads(void);
+
+/**
+ * Sets how the run-time state (i.e. the buffers that are written to while
+ * processing) of the analysis, synthesis and container objects is allocated
+ *
+ * This applies to all objects created afterwards in the process, and is
+ * #PROPOSED_RUNTIME_MEMORY_HEAP unless set otherwise. Locking
+ * requires a sufficient RLIMIT_MEMLOCK on Linux/macOS, or working set size on
+ * Windows; if it is not permitted, then the memory is only pre-faulted.
+ *
+ * @param[in] option See #PROPOSED_RUNTIME_MEMORY_OPTIONS
+ */
+void proposed_setRunTimeMemoryOption(PROPOSED_RUNTIME_MEMORY_OPTIONS option);
+
+/**
+ * Creates a proposed analysis object from a bundle saved by
+ * proposed_bundle_save()
+ *
+ * The bundle is memory-mapped, and the analyser uses the precomputed data in
+ * place, so this is much faster than proposed_analysis_create() and the data
+ * is shared between processes. It is otherwise equivalent to creating the
+ * analyser from the array IRs that the bundle was saved from.
+ *
+ * @param[in] phAna     (&) address of proposed analysis handle (set to NULL
+ *                      if the bundle could not be loaded)
+ * @param[in] path      Path to the bundle
+ * @param[in] fs        Samplerate, Hz (must match the bundle)
+ * @param[in] hopsize   Filterbank hopsize (must match the bundle)
+ * @param[in] blocksize Number of time-domain samples to process at a time
+ * @returns #PROPOSED_BUNDLE_OK, or an error code (see
+ *          #PROPOSED_BUNDLE_ERROR_CODES)
+ */
+PROPOSED_BUNDLE_ERROR_CODES proposed_analysis_createFromBundle(/* Input Arguments */
+                                                               proposed_analysis_handle* const phAna,
+                                                               const char* path,
+                                                               float fs,
+                                                               int hopsize,
+                                                               int blocksize);
 
 /**
  * Destroys an instance of a proposed analysis object
@@ -105,6 +253,22 @@ void proposed_analysis_create(/* Input Arguments */
 void proposed_analysis_destroy(/* Input Arguments */
                                proposed_analysis_handle* const phAna);
 
+/**
+ * Returns the spherical harmonic order used to represent the ATFs of one band,
+ * or -1 if they are not compressed (see the atfFitError argument of
+ * proposed_analysis_create()), including if this band could not be fitted
+ * within atfFitError
+ */
+int proposed_analysis_getATFOrder(proposed_analysis_handle const hAna,
+                                  int band);
+
+/**
+ * Returns the normalised squared fitting error achieved for the ATFs of one
+ * band, or 0 if they are not compressed (see proposed_analysis_getATFOrder())
+ */
+float proposed_analysis_getATFFitError(proposed_analysis_handle const hAna,
+                                       int band);
+
 /**
  * Flushes run-time buffers with zeros
  *
@@ -187,6 +351,15 @@ int proposed_analysis_getNbands(proposed_analysis_handle const hAna);
 /** Returns number of grid directions (or 0 if hAna is not initialised) */
 int proposed_analysis_getNDirs(proposed_analysis_handle const hAna);
 
+/** Returns number of microphones (or 0 if hAna is not initialised) */
+int proposed_analysis_getNMics(proposed_analysis_handle const hAna);
+
+/**
+ * Returns 1 if the analyser was loaded from a bundle that also holds HRTFs
+ * (see proposed_synthesis_create()), or 0 otherwise
+ */
+int proposed_analysis_hasBundledHRTFs(proposed_analysis_handle const hAna);
+
 /**
  * Returns a pointer to the covariance matrix averaging scalar [0..1], which can
  * be changed at run-time
@@ -207,6 +380,132 @@ float* proposed_analysis_getCovarianceAvagingCoeffPtr(proposed_analysis_handle c
  */
 float* proposed_analysis_getMaxAnalysisFreqPtr(proposed_analysis_handle const hAna);
 
+/**
+ * Returns a pointer to the band-limited analysis flag, which can be changed at
+ * run-time
+ *
+ * When enabled (default), the covariance averaging, whitening, eigenvalue
+ * decomposition and DoA estimation are only carried out for the bands below
+ * the maximum analysis frequency. The per-block covariance matrices of the
+ * remaining bands are then only computed if and when the synthesiser requires
+ * them.
+ *
+ * @param[in] hAna proposed analysis handle
+ * @returns pointer to the flag, 1: enabled, 0: disabled (or NULL if hAna is not
+ *          initialised); 1 x 1
+ */
+int* proposed_analysis_getEnableBandLimitedAnalysisPtr(proposed_analysis_handle const hAna);
+
+/**
+ * Returns a pointer to the linear-only flag, which can be changed at run-time
+ *
+ * When enabled, proposed_analysis_apply() only applies the forward
+ * time-frequency transform; no covariance matrices or spatial parameters are
+ * computed, and the parameter container is left untouched. This should be
+ * paired with proposed_synthesis_getEnableLinearOnlyPtr().
+ *
+ * @param[in] hAna proposed analysis handle
+ * @returns pointer to the flag, 1: enabled, 0: disabled (default) (or NULL if
+ *          hAna is not initialised); 1 x 1
+ */
+int* proposed_analysis_getEnableLinearOnlyPtr(proposed_analysis_handle const hAna);
+
+/**
+ * Returns a pointer to the spatial parameter update schedule (see
+ * #PROPOSED_ANALYSIS_UPDATE_SCHEDULES), which can be changed at run-time
+ *
+ * Bands which are not due for an update in the current block hold their
+ * previous estimates in the parameter container, while their covariance
+ * matrices continue to be averaged every block. Therefore, the same parameter
+ * container should be passed to proposed_analysis_apply() for every block when
+ * using a schedule other than #PROPOSED_ANALYSIS_UPDATE_ALL_BANDS.
+ *
+ * @param[in] hAna proposed analysis handle
+ * @returns pointer to the update schedule (or NULL if hAna is not
+ *          initialised); 1 x 1
+ */
+PROPOSED_ANALYSIS_UPDATE_SCHEDULES* proposed_analysis_getUpdateSchedulePtr(proposed_analysis_handle const hAna);
+
+/**
+ * Returns a pointer to the update interval N (in blocks) used by the update
+ * schedule, which can be changed at run-time
+ *
+ * @param[in] hAna proposed analysis handle
+ * @returns pointer to the update interval, >=1 (or NULL if hAna is not
+ *          initialised); 1 x 1
+ */
+int* proposed_analysis_getUpdateIntervalPtr(proposed_analysis_handle const hAna);
+
+/**
+ * Returns a pointer to the frequency in Hz, below which bands are only updated
+ * every Nth block when using #PROPOSED_ANALYSIS_UPDATE_DECIMATED. This can be
+ * changed at run-time
+ *
+ * @param[in] hAna proposed analysis handle
+ * @returns pointer to the decimation frequency in Hz (or NULL if hAna is not
+ *          initialised); 1 x 1
+ */
+float* proposed_analysis_getDecimationFreqPtr(proposed_analysis_handle const hAna);
+
+/**
+ * Returns a pointer to the limits placed on the analysis settings, which can
+ * be changed at run-time (all zero by default, i.e. no limits)
+ *
+ * The limits are applied to the settings in effect for each block, so the
+ * settings returned by the other getters are never changed by them.
+ *
+ * @param[in] hAna proposed analysis handle
+ * @returns pointer to the limits (or NULL if hAna is not initialised); 1 x 1
+ */
+proposed_analysis_limits* proposed_analysis_getLimitsPtr(proposed_analysis_handle const hAna);
+
+/**
+ * Returns a pointer to the profiling flag, which can be changed at run-time
+ *
+ * When enabled, the time spent in each analysis stage is measured for every
+ * block (see proposed_profile.h and proposed_analysis_getProfile()).
+ *
+ * @param[in] hAna proposed analysis handle
+ * @returns pointer to the flag, 1: enabled, 0: disabled (default) (or NULL if
+ *          hAna is not initialised); 1 x 1
+ */
+int* proposed_analysis_getEnableProfilingPtr(proposed_analysis_handle const hAna);
+
+/**
+ * Returns the timing statistics of the analysis stages (the forward
+ * time-frequency transform up to the DoA estimation)
+ *
+ * The statistics of the other stages are returned with a count of 0. This may
+ * be called from another thread than the one processing, in which case the
+ * statistics of different stages may be from different blocks.
+ *
+ * @param[in]  hAna    proposed analysis handle
+ * @param[out] profile Statistics per stage
+ */
+void proposed_analysis_getProfile(proposed_analysis_handle const hAna,
+                                  proposed_profile* profile);
+
+/**
+ * Copies the raw timings of the analysis stages, from which the statistics are
+ * computed (see proposed_profile_getStats())
+ *
+ * Unlike proposed_analysis_getProfile(), this only copies memory, so it may be
+ * called on the processing thread between blocks. Stages that have not been
+ * run are left as they are in counters, so the timings of the analyser and
+ * synthesiser may be gathered into one struct.
+ *
+ * @param[in]     hAna     proposed analysis handle
+ * @param[in,out] counters Raw timings per stage
+ */
+void proposed_analysis_getProfileCounters(proposed_analysis_handle const hAna,
+                                          proposed_profile_counters* counters);
+
+/**
+ * Clears the timing statistics of the analysis stages (this should not be
+ * called while proposed_analysis_apply() is running on another thread)
+ */
+void proposed_analysis_resetProfile(proposed_analysis_handle const hAna);
+
 /**
  * Returns the analyser processing delay, in samples
  *
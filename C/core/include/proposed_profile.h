@@ -0,0 +1,115 @@
+/**
+ * @file proposed_profile.h
+ * @brief Per-stage timing of the processing functions of the proposed method
+ *
+ * When profiling is enabled for an analysis or synthesis object (see
+ * proposed_analysis_getEnableProfilingPtr() and
+ * proposed_synthesis_getEnableProfilingPtr()), the time spent in each of the
+ * stages below is measured for every block of audio, and running statistics
+ * are kept per stage. Stages which are computed per band (e.g. the covariance
+ * matrices) are summed over all bands of the block. When disabled (default),
+ * the cost is one branch per stage.
+ *
+ * Only raw counters are accumulated while processing. The statistics (e.g. the
+ * percentiles) are computed from them by proposed_profile_getStats(), so a
+ * processing thread may copy the counters (see
+ * proposed_analysis_getProfileCounters()) and leave the statistics to another
+ * thread.
+ *
+ * The analyser times the stages up to and including the DoA estimation, and
+ * the synthesiser the rest; including when they are processed together by
+ * proposed_synthesis_applyFused().
+ *
+ * @author agent
+ * @date 19th October 2026
+ */
+
+#ifndef __PROPOSED_PROFILE_H_INCLUDED__
+#define __PROPOSED_PROFILE_H_INCLUDED__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** Number of histogram bins per decade, for the percentiles of the stage timings */
+#define PROPOSED_PROFILE_BINS_PER_DECADE ( 20 )
+
+/** Number of histogram bins for the stage timings, which cover 1us to 1s */
+#define PROPOSED_PROFILE_NUM_BINS ( 6*PROPOSED_PROFILE_BINS_PER_DECADE )
+
+/** Processing stages that are timed */
+typedef enum {
+    PROPOSED_PROFILE_FORWARD_FB = 0,      /**< Forward time-frequency transform */
+    PROPOSED_PROFILE_COVARIANCE,          /**< Covariance matrices and their
+                                           *   temporal averaging */
+    PROPOSED_PROFILE_WHITENING,           /**< Diffuse-field whitening of the
+                                           *   covariance matrices */
+    PROPOSED_PROFILE_EIG,                 /**< Eigenvalue decompositions */
+    PROPOSED_PROFILE_MUSIC,               /**< Source number detection and
+                                           *   MUSIC DoA estimation */
+    PROPOSED_PROFILE_POSE_UPDATE,         /**< Rotation/translation of the
+                                           *   linear decoder directions and
+                                           *   HRTF look-ups */
+    PROPOSED_PROFILE_BSM,                 /**< Binaural signal matching (BSM)
+                                           *   decoders for the current pose */
+    PROPOSED_PROFILE_MIXING_CONSTRUCTION, /**< Per-band mixing matrices */
+    PROPOSED_PROFILE_MIXING_APPLY,        /**< Application of the mixing
+                                           *   matrices */
+    PROPOSED_PROFILE_INVERSE_FB,          /**< Inverse time-frequency
+                                           *   transform */
+
+    PROPOSED_PROFILE_NUM_STAGES           /**< Number of stages */
+
+} PROPOSED_PROFILE_STAGES;
+
+/** Running statistics of the time spent in one stage per block of audio */
+typedef struct _proposed_profile_stats {
+    float last_ms;                   /**< Time spent for the last block, in milliseconds */
+    float mean_ms;                   /**< Mean time per block, in milliseconds */
+    float p99_ms;                    /**< 99th percentile, in milliseconds (to within 12%) */
+    float max_ms;                    /**< Maximum time per block, in milliseconds */
+    unsigned int count;              /**< Number of blocks for which this stage was run */
+
+} proposed_profile_stats;
+
+/** Statistics of all stages */
+typedef struct _proposed_profile {
+    proposed_profile_stats stage[PROPOSED_PROFILE_NUM_STAGES]; /**< Statistics per stage, see #PROPOSED_PROFILE_STAGES */
+
+} proposed_profile;
+
+/** Raw timings of one stage, accumulated over the blocks of audio */
+typedef struct _proposed_profile_stage_counters {
+    unsigned long long last_ns;      /**< Time spent during the last block, in nanoseconds */
+    unsigned long long max_ns;       /**< Maximum time spent per block */
+    double sum_ns;                   /**< Total time spent over all blocks */
+    unsigned int count;              /**< Number of blocks for which this stage was run */
+    unsigned int hist[PROPOSED_PROFILE_NUM_BINS]; /**< Number of blocks per time bin; logarithmically spaced from 1us to 1s */
+
+} proposed_profile_stage_counters;
+
+/** Raw timings of all stages */
+typedef struct _proposed_profile_counters {
+    proposed_profile_stage_counters stage[PROPOSED_PROFILE_NUM_STAGES]; /**< Per stage, see #PROPOSED_PROFILE_STAGES */
+
+} proposed_profile_counters;
+
+/**
+ * Computes the statistics of all stages from their raw timings
+ *
+ * @param[in]  counters Raw timings, e.g. from
+ *                      proposed_analysis_getProfileCounters()
+ * @param[out] profile  Statistics per stage
+ */
+void proposed_profile_getStats(const proposed_profile_counters* counters,
+                               proposed_profile* profile);
+
+/** Returns the name of a stage (e.g. "Forward FB"), for display purposes */
+const char* proposed_profile_getStageName(PROPOSED_PROFILE_STAGES stage);
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* __PROPOSED_PROFILE_H_INCLUDED__ */
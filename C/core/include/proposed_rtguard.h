@@ -0,0 +1,69 @@
+/**
+ * @file proposed_rtguard.h
+ * @brief Real-time safety guard for the processing functions of the proposed
+ *        method (debugging only)
+ *
+ * When the core is built with PROPOSED_ENABLE_RT_GUARD (CMake option of the
+ * same name), the heap (malloc/calloc/realloc/free etc.) and blocking thread
+ * functions (pthread_mutex_lock, pthread_cond_wait, pthread_create etc.) are
+ * interposed. Any call made while a thread is inside proposed_analysis_apply(),
+ * proposed_synthesis_apply(), proposed_synthesis_applyFused() or
+ * interface_process() is recorded as a violation, along with its call stack,
+ * and the LAPACK-backed SAF utility function (e.g. utility_cseig(),
+ * utility_cinv(), utility_cpinv()) that it was made from, if any.
+ *
+ * Interposition is currently only implemented for Linux (glibc); elsewhere,
+ * and when the guard is not built in, these functions do nothing.
+ *
+ * @author agent
+ * @date 19th October 2026
+ */
+
+#ifndef __PROPOSED_RTGUARD_H_INCLUDED__
+#define __PROPOSED_RTGUARD_H_INCLUDED__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#ifdef PROPOSED_ENABLE_RT_GUARD
+/** Marks the start of a real-time region (which may be nested) */
+# define PROPOSED_RTGUARD_ENTER(region) proposed_rtguard_enter(region)
+/** Marks the end of a real-time region */
+# define PROPOSED_RTGUARD_LEAVE() proposed_rtguard_leave()
+#else
+# define PROPOSED_RTGUARD_ENTER(region)
+# define PROPOSED_RTGUARD_LEAVE()
+#endif
+
+/**
+ * Returns 1 if the guard is built in and supported on this platform, or 0 if
+ * no violations can be detected
+ */
+int proposed_rtguard_isSupported(void);
+
+/**
+ * Marks the start of a real-time region on the calling thread
+ *
+ * @param[in] region Name of the region, for the report (static string)
+ */
+void proposed_rtguard_enter(const char* region);
+
+/** Marks the end of the real-time region entered last on the calling thread */
+void proposed_rtguard_leave(void);
+
+/** Returns the number of violations recorded since the last reset */
+int proposed_rtguard_getNumViolations(void);
+
+/** Prints the recorded violations and their call stacks to stdout */
+void proposed_rtguard_printReport(void);
+
+/** Discards the recorded violations */
+void proposed_rtguard_reset(void);
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* __PROPOSED_RTGUARD_H_INCLUDED__ */
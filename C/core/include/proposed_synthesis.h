@@ -90,8 +90,14 @@ typedef enum {
 
 /** HRTF interpolation options for proposed_synthesis */
 typedef enum {
-    PROPOSED_HRTF_INTERP_NEAREST,    /**< Quantise to nearest measurement */
-    PROPOSED_HRTF_INTERP_TRIANGULAR  /**< Triangular interpolation */
+    PROPOSED_HRTF_INTERP_NEAREST,        /**< Quantise to nearest measurement */
+    PROPOSED_HRTF_INTERP_TRIANGULAR,     /**< Triangular interpolation */
+    PROPOSED_HRTF_INTERP_NEAREST_LAZY,   /**< As #PROPOSED_HRTF_INTERP_NEAREST, but
+                                          *   each direction is only computed (and
+                                          *   then cached) upon first use */
+    PROPOSED_HRTF_INTERP_TRIANGULAR_LAZY /**< As #PROPOSED_HRTF_INTERP_TRIANGULAR,
+                                          *   but each direction is only computed
+                                          *   (and then cached) upon first use */
 }PROPOSED_HRTF_INTERP_OPTIONS;
 
 
@@ -104,7 +110,10 @@ typedef enum {
  *
  * @param[in] phSyn        (&) address of proposed synthesis handle
  * @param[in] hAna         proposed analysis handle
- * @param[in] binConfig    Binaural configuration
+ * @param[in] binConfig    Binaural configuration, or NULL to use the HRTFs
+ *                         stored in the bundle that hAna was loaded from (see
+ *                         proposed_analysis_hasBundledHRTFs()); interpOption
+ *                         and enableDiffEQ_HRTFs are then ignored
  * @param[in] interpOption see #PROPOSED_HRTF_INTERP_OPTIONS
  */
 void proposed_synthesis_create(/* Input Arguments */
@@ -125,6 +134,27 @@ void proposed_synthesis_create(/* Input Arguments */
 void proposed_synthesis_destroy(/* Input Arguments */
                                 proposed_synthesis_handle* const phSyn);
 
+/**
+ * Saves everything that an analyser (and optionally a synthesiser) precomputes
+ * from the array IRs (and HRIRs) to a bundle, which may then be loaded with
+ * proposed_analysis_createFromBundle()
+ *
+ * The bundle is only valid for the samplerate and hopsize of hAna, and is
+ * stored in the byte order of this machine. Analysers created with compressed
+ * ATFs (atfFitError>0) cannot be saved.
+ *
+ * @param[in] hAna proposed analysis handle
+ * @param[in] hSyn proposed synthesis handle created from hAna, whose HRTFs are
+ *                 also stored, or NULL to only store the array model
+ * @param[in] path Path of the bundle to write
+ * @returns #PROPOSED_BUNDLE_OK, or an error code (see
+ *          #PROPOSED_BUNDLE_ERROR_CODES)
+ */
+PROPOSED_BUNDLE_ERROR_CODES proposed_bundle_save(/* Input Arguments */
+                                                 proposed_analysis_handle const hAna,
+                                                 proposed_synthesis_handle const hSyn,
+                                                 const char* path);
+
 /**
  * Flushes run-time buffers with zeros
  *
@@ -166,6 +196,132 @@ void proposed_synthesis_apply(/* Input Arguments */
                               /* Output Arguments */
                               float** output);
 
+/**
+ * Performs the analysis and synthesis in a single pass over the bands
+ *
+ * Equivalent to calling proposed_analysis_apply() followed by
+ * proposed_synthesis_apply(), and gives the same results. However, rather than
+ * sweeping over all bands for each processing stage, each band is taken from
+ * the covariance update through to the mixed output in one go, while its data
+ * is still in cache. This is faster when the per-band data for all bands does
+ * not fit in cache (i.e. for larger arrays).
+ *
+ * @param[in]  hSyn       proposed synthesis handle
+ * @param[in]  hAna       proposed analysis handle (the one that was passed to
+ *                        proposed_synthesis_create())
+ * @param[in]  input      Input buffer; nInputs x blocksize
+ * @param[in]  nInputs    Number of channels in input buffer
+ * @param[in]  hPCon      Parameter container handle
+ * @param[in]  hSCon      Signal container handle
+ * @param[in]  ypr_rad    Listener yaw-pitch-roll, in radians; 3 x 1
+ * @param[in]  xyz_m      Listener position, in metres; 3 x 1
+ * @param[in]  dist_map   Distance map option, see #PROPOSED_DISTANCE_MAPS
+ * @param[in]  src_dist_m Source distance, in metres
+ * @param[in]  enableSrcD Flag, 1: enable source directivity, 0: disable
+ * @param[in]  nChannels  Number of channels in output buffer
+ * @param[in]  blocksize  Number of samples in input/output buffers
+ * @param[out] output     Output buffer; nChannels x blocksize
+ */
+void proposed_synthesis_applyFused(/* Input Arguments */
+                                   proposed_synthesis_handle const hSyn,
+                                   proposed_analysis_handle const hAna,
+                                   float** input,
+                                   int nInputs,
+                                   proposed_param_container_handle  const hPCon,
+                                   proposed_signal_container_handle const hSCon,
+                                   float* ypr_rad,
+                                   float* xyz_m,
+                                   PROPOSED_DISTANCE_MAPS dist_map,
+                                   float src_dist_m,
+                                   int enableSrcD,
+                                   int nChannels,
+                                   int blocksize,
+                                   /* Output Arguments */
+                                   float** output);
+
+/**
+ * Outputs the remaining tail of the synthesis filterbank, assuming that the
+ * input is silent, without updating the mixing matrices
+ *
+ * This may be called instead of proposed_synthesis_apply() (and the analysis)
+ * while the input is silent, in order to flush out the remaining output. The
+ * mixing matrices are left untouched, such that the temporal averaging resumes
+ * from the same state once proposed_synthesis_apply() is called again.
+ *
+ * @param[in]  hSyn       proposed synthesis handle
+ * @param[in]  nChannels  Number of channels in output buffer
+ * @param[in]  blocksize  Number of samples in output buffer
+ * @param[out] output     Output buffer; nChannels x blocksize
+ */
+void proposed_synthesis_applyTail(/* Input Arguments */
+                                  proposed_synthesis_handle const hSyn,
+                                  int nChannels,
+                                  int blocksize,
+                                  /* Output Arguments */
+                                  float** output);
+
+/**
+ * Converts the current per-band mixing matrices into time-domain FIR filters,
+ * for use with proposed_synthesis_applyStaticFIRs()
+ *
+ * The mixing weights are interpolated from the band centre frequencies onto a
+ * uniform frequency grid, and the filterbank delay is imposed, such that the
+ * output of the FIRs is time-aligned with that of proposed_synthesis_apply().
+ * This is only meaningful for linear-only rendering (see
+ * proposed_synthesis_getEnableLinearOnlyPtr()), for which the mixing matrices
+ * depend only on the listener pose, and should be called after at least one
+ * call to proposed_synthesis_apply() using the pose in question.
+ *
+ * There is one FIR per ear and microphone (see
+ * proposed_synthesis_getNumStaticFIRs()), and they may be computed over several
+ * calls, e.g. a few per block, to spread the cost when called from the audio
+ * thread. The mixing matrices are captured when firstFIR is 0, and all of the
+ * FIRs are then designed from those, even if proposed_synthesis_apply() is
+ * called in between. The FIRs must all have been computed before they are
+ * applied.
+ *
+ * @param[in] hSyn     proposed synthesis handle
+ * @param[in] firstFIR Index of the first FIR to compute
+ * @param[in] nFIRs    Number of FIRs to compute (clamped to those remaining)
+ */
+void proposed_synthesis_computeStaticFIRs(proposed_synthesis_handle const hSyn,
+                                          int firstFIR,
+                                          int nFIRs);
+
+/**
+ * Renders the input using the FIRs obtained with
+ * proposed_synthesis_computeStaticFIRs(), via uniformly partitioned
+ * (overlap-save) fast convolution
+ *
+ * This bypasses the filterbank entirely, and is intended for when the listener
+ * pose is static. Note that the convolution only produces the full FIR output
+ * once it has been called for proposed_synthesis_getStaticFIRLength()/blocksize
+ * blocks; likewise, the filterbank path requires its processing delay worth of
+ * blocks to be primed again after it has been bypassed. Therefore, the caller
+ * should run both paths in parallel when switching between them.
+ *
+ * @param[in]  hSyn      proposed synthesis handle
+ * @param[in]  input     Input buffer; nInputs x blocksize
+ * @param[in]  nInputs   Number of channels in the input buffer
+ * @param[in]  nChannels Number of channels in output buffer
+ * @param[in]  blocksize Number of samples in input/output buffers
+ * @param[out] output    Output buffer; nChannels x blocksize
+ */
+void proposed_synthesis_applyStaticFIRs(/* Input Arguments */
+                                        proposed_synthesis_handle const hSyn,
+                                        float** input,
+                                        int nInputs,
+                                        int nChannels,
+                                        int blocksize,
+                                        /* Output Arguments */
+                                        float** output);
+
+/** Returns the length of the static FIRs, in samples */
+int proposed_synthesis_getStaticFIRLength(proposed_synthesis_handle const hSyn);
+
+/** Returns the number of static FIRs, i.e. #NUM_EARS x nMics */
+int proposed_synthesis_getNumStaticFIRs(proposed_synthesis_handle const hSyn);
+
 /**
  * Returns a pointer to the eq vector, which can be changed at run-time
  *
@@ -227,6 +383,63 @@ float* proposed_synthesis_getMaxMagLSFreqPtr(proposed_synthesis_handle const hSy
  *          initialised); 1 x 1
  */
 float* proposed_synthesis_getLinear2ParametricBalancePtr(proposed_synthesis_handle const hSyn);
+
+/**
+ * Returns a pointer to the linear-only flag, which can be changed at run-time
+ *
+ * When enabled, only the linear (BSM/PWD) decoder is used for rendering, and
+ * the spatial parameters and covariance matrices are not used. This should be
+ * paired with proposed_analysis_getEnableLinearOnlyPtr(). Switching to and from
+ * linear-only rendering is smoothed by the same temporal averaging as the
+ * mixing matrices (see proposed_synthesis_getSynthesisAveragingCoeffPtr()).
+ *
+ * @param[in] hSyn proposed synthesis handle
+ * @returns pointer to the flag, 1: enabled, 0: disabled (default) (or NULL if
+ *          hSyn is not initialised); 1 x 1
+ */
+int* proposed_synthesis_getEnableLinearOnlyPtr(proposed_synthesis_handle const hSyn);
+
+/**
+ * Returns a pointer to the profiling flag, which can be changed at run-time
+ *
+ * When enabled, the time spent in each synthesis stage is measured for every
+ * block (see proposed_profile.h and proposed_synthesis_getProfile()).
+ *
+ * @param[in] hSyn proposed synthesis handle
+ * @returns pointer to the flag, 1: enabled, 0: disabled (default) (or NULL if
+ *          hSyn is not initialised); 1 x 1
+ */
+int* proposed_synthesis_getEnableProfilingPtr(proposed_synthesis_handle const hSyn);
+
+/**
+ * Returns the timing statistics of the synthesis stages (the pose update up
+ * to the inverse time-frequency transform)
+ *
+ * The statistics of the other stages are returned with a count of 0. This may
+ * be called from another thread than the one processing, in which case the
+ * statistics of different stages may be from different blocks.
+ *
+ * @param[in]  hSyn    proposed synthesis handle
+ * @param[out] profile Statistics per stage
+ */
+void proposed_synthesis_getProfile(proposed_synthesis_handle const hSyn,
+                                   proposed_profile* profile);
+
+/**
+ * Copies the raw timings of the synthesis stages (see
+ * proposed_analysis_getProfileCounters())
+ *
+ * @param[in]     hSyn     proposed synthesis handle
+ * @param[in,out] counters Raw timings per stage
+ */
+void proposed_synthesis_getProfileCounters(proposed_synthesis_handle const hSyn,
+                                           proposed_profile_counters* counters);
+
+/**
+ * Clears the timing statistics of the synthesis stages (this should not be
+ * called while the synthesiser is processing on another thread)
+ */
+void proposed_synthesis_resetProfile(proposed_synthesis_handle const hSyn);
  
 /**
  * Returns the synthesiser processing delay, in samples
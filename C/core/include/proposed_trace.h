@@ -0,0 +1,97 @@
+/**
+ * @file proposed_trace.h
+ * @brief Optional tracing of processing spans, as Chrome trace-event JSON
+ *
+ * While tracing is enabled (see proposed_trace_setEnabled()), every processing
+ * stage of the analysis and synthesis (see #PROPOSED_PROFILE_STAGES), and any
+ * other span marked with proposed_trace_begin() and proposed_trace_end(), is
+ * recorded along with the thread that it ran on. proposed_trace_dump() then
+ * writes the recorded spans to a file, which may be opened in chrome://tracing
+ * or https://ui.perfetto.dev, to see how the spans of the different threads
+ * (e.g. audio, initialisation, OSC and GUI) interleave over time.
+ *
+ * Each thread records into its own ring buffer, without locking or
+ * allocating, so spans may also be recorded from the audio thread. Once a ring
+ * buffer is full, its oldest spans are overwritten. When disabled (default),
+ * the cost is one branch per span.
+ *
+ * @author agent
+ * @date 19th October 2026
+ */
+
+#ifndef __PROPOSED_TRACE_H_INCLUDED__
+#define __PROPOSED_TRACE_H_INCLUDED__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** Maximum number of threads that may record spans at the same time */
+#define PROPOSED_TRACE_MAX_THREADS ( 8 )
+
+/** Number of spans held per thread (older spans are overwritten) */
+#define PROPOSED_TRACE_RING_SIZE ( 16384 )
+
+/**
+ * Enables (1) or disables (0) tracing, for all threads
+ *
+ * Timestamps are relative to when tracing was first enabled.
+ */
+void proposed_trace_setEnabled(int enable);
+
+/** Returns 1 if tracing is enabled, 0 if it is not */
+int proposed_trace_isEnabled(void);
+
+/**
+ * Names the calling thread in the trace
+ *
+ * @param[in] name Name of the thread (static string, which must not contain
+ *                 quotes or backslashes)
+ */
+void proposed_trace_setThreadName(const char* name);
+
+/**
+ * Releases the ring buffer of the calling thread (if it has one), so that it
+ * may be used by another thread; e.g. before a short-lived thread returns.
+ * The spans that were already recorded are kept.
+ */
+void proposed_trace_releaseThread(void);
+
+/**
+ * Returns the start time of a span, to pass to proposed_trace_end(), or 0 if
+ * tracing is disabled
+ */
+unsigned long long proposed_trace_begin(void);
+
+/**
+ * Records a span on the calling thread, from t0 until now
+ *
+ * @param[in] name Name of the span (static string, which must not contain
+ *                 quotes or backslashes)
+ * @param[in] t0   Start time, as returned by proposed_trace_begin(); nothing
+ *                 is recorded if this is 0
+ */
+void proposed_trace_end(const char* name,
+                        unsigned long long t0);
+
+/**
+ * Writes the recorded spans of all threads to a file, as Chrome trace-event
+ * JSON
+ *
+ * This may be called while spans are still being recorded; any span that is
+ * overwritten while it is being read is left out.
+ *
+ * @param[in] path Path of the file to write
+ * @returns Number of spans written, or -1 if the file could not be written
+ */
+int proposed_trace_dump(const char* path);
+
+/** Discards the spans recorded so far (but not the enable flag) */
+void proposed_trace_reset(void);
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* __PROPOSED_TRACE_H_INCLUDED__ */
@@ -56,27 +56,172 @@
 /*                            PROPOSED Analysis                               */
 /* ========================================================================== */
 
-void proposed_analysis_create
+/** Arguments and per-worker scratch of proposed_analysis_buildModelBand() */
+typedef struct _proposed_analysis_modelJob {
+    proposed_array_model* m;                               /**< Model being built */
+    void* hEig[PROPOSED_MAX_INIT_THREADS];                 /**< Eigen solver per worker */
+    float_complex* U[PROPOSED_MAX_INIT_THREADS];           /**< Eigen vectors per worker; nMics x nMics */
+    float_complex* E[PROPOSED_MAX_INIT_THREADS];           /**< Eigen values per worker; nMics x nMics */
+    float_complex* H_W[PROPOSED_MAX_INIT_THREADS];         /**< Whitened ATFs per worker; nMics x nDirs */
+    float_complex* H_band[PROPOSED_MAX_INIT_THREADS];      /**< ATFs of one band per worker; nMics x nDirs */
+
+} proposed_analysis_modelJob;
+
+/* Computes the diffuse coherence matrix, whitening matrix and whitened scanning ATFs of one band */
+static void proposed_analysis_buildModelBand
+(
+    void* ctx,
+    int band,
+    int worker
+)
+{
+    proposed_analysis_modelJob* job = (proposed_analysis_modelJob*)ctx;
+    proposed_array_model* m = job->m;
+    int i, j, dir, nDirs, nMics, nBands;
+    float_complex *U, *E, *H_W, *H_band;
+    const float_complex calpha = cmplxf(1.0f, 0.0f); const float_complex cbeta = cmplxf(0.0f, 0.0f); /* blas */
+
+    nBands = m->nBands;
+    nDirs = m->nDirs;
+    nMics = m->nMics;
+    U = job->U[worker];
+    E = job->E[worker];
+    H_W = job->H_W[worker];
+    H_band = job->H_band[worker];
+
+    /* ATFs of this band; nMics x nDirs */
+    for(dir=0; dir<nDirs; dir++)
+        for(i=0; i<nMics; i++)
+            H_band[i*nDirs + dir] = m->H_array[(dir*nBands + band)*nMics + i];
+
+    /* Diffuse covariance matrix */
+    diffCohMtxMeas(H_band, 1, nMics, nDirs, NULL, &(m->DCM_array[band*nMics*nMics]));
+    cblas_sscal(/*re+im*/2*nMics*nMics, 1.0f/(float)nDirs, (float*)&(m->DCM_array[band*nMics*nMics]), 1);
+
+    /* Decomposition of the diffuse covariance matrix */
+    utility_cseig(job->hEig[worker], &(m->DCM_array[band*nMics*nMics]), nMics, 1, U, E, NULL);
+
+    /* Compute spatial whitening matrix */
+    for(i=0; i<nMics; i++)
+        E[i*nMics+i] = cmplxf(sqrtf(1.0f/(crealf(E[i*nMics+i])+2.23e-10f)), 0.0f);
+    cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, nMics, nMics, nMics, &calpha,
+                E, nMics,
+                U, nMics, &cbeta,
+                m->T[band], nMics);
+
+    /* Whiten the array steering vectors / anechoic acoustic transfer functions (ATFs) */
+    cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nMics, nDirs, nMics, &calpha,
+                m->T[band], nMics,
+                H_band, nDirs, &cbeta,
+                H_W, nDirs);
+
+    /* Take subset */
+    for(i=0; i<nMics; i++)
+        for(j=0; j<m->nScan; j++)
+            m->H_scan_w[band*nMics*(m->nScan) + i*(m->nScan) + j] = H_W[i*nDirs + m->scan_idx[j]];
+}
+
+/* Computes everything in the array model, which only depends on the array IRs and the filterbank configuration */
+static void proposed_analysis_buildModel
+(
+    proposed_analysis_data* a,
+    proposed_array_model* m,
+    float* h_array,
+    float* array_dirs_deg,
+    float atfFitError
+)
+{
+    int i, w, idx_max, nDirs, nMics, nBands, nWorkers;
+    float scale;
+    proposed_analysis_modelJob job;
+
+    m->nBands = nBands = a->nBands;
+    m->nDirs = nDirs = a->nDirs;
+    m->nMics = nMics = a->nMics;
+    m->freqVector = malloc1d(nBands*sizeof(float));
+    afSTFT_getCentreFreqs(a->hFB_enc, a->fs, nBands, m->freqVector);
+    m->array_dirs_deg = malloc1d(nDirs*2*sizeof(float));
+    memcpy(m->array_dirs_deg, array_dirs_deg, nDirs*2*sizeof(float));
+    m->array_dirs_xyz = malloc1d(nDirs*3*sizeof(float));
+    unitSph2cart(m->array_dirs_deg, nDirs, 1, m->array_dirs_xyz);
+
+    /* Scale steering vectors so that the peak of loudest measurement is 1 */
+    utility_simaxv(h_array, nDirs*nMics*(a->h_len), &idx_max);
+    scale = 1.0f/h_array[idx_max];
+
+    /* The IRs are converted to the filterbank domain a chunk of directions at a time, so that the time-domain data and the
+     * band-major ATFs are never copied in full (the synthesiser gathers the ATFs one direction at a time, so they are stored
+     * direction-major) */
+    m->H_array = malloc1d(nDirs*nBands*nMics*sizeof(float_complex));
+    proposed_FIRtoFilterbankCoeffs(h_array, nDirs, nMics, a->h_len, a->hopsize, nBands, scale, 1, m->H_array);
+
+    /* Scanning grid */
+    m->nScan = 0;
+    m->scan_dirs_deg = malloc1d(nDirs*2*sizeof(float));
+    m->scan_dirs_xyz = malloc1d(nDirs*3*sizeof(float));
+    for(i=0; i<nDirs; i++){
+        if(m->array_dirs_deg[i*2+1]>-PROPOSED_ELEV_SCANNING_WINDOW_DEG && m->array_dirs_deg[i*2+1]<PROPOSED_ELEV_SCANNING_WINDOW_DEG){
+            m->scan_dirs_deg[m->nScan*2] = m->array_dirs_deg[i*2];
+            m->scan_dirs_deg[m->nScan*2+1] = m->array_dirs_deg[i*2+1];
+            m->nScan++;
+        }
+    }
+    unitSph2cart(m->scan_dirs_deg, m->nScan, 1, m->scan_dirs_xyz);
+    m->scan_idx = malloc1d(m->nScan*sizeof(int));
+    proposed_findNearestGridIndices(m->array_dirs_xyz, m->scan_dirs_xyz, nDirs, m->nScan, m->scan_idx);
+
+    /* Integration weights */
+    m->W = malloc1d(nDirs*sizeof(float));
+    if (cblas_sasum(nDirs, m->array_dirs_deg+1, 2)/(float)nDirs<0.001){
+        for(i=0; i<nDirs; i++)
+            m->W[i] = 1.0f;
+    }
+    else
+        proposed_getQuadratureWeights(m->array_dirs_deg, nDirs, m->W);
+
+    /* Diffuse coherence matrices, and for spatial whitening of the spatial covariance matrix, such that it has an identity structure under diffuse-field conditions (see [2]) */
+    m->H_scan_w = malloc1d(nBands*nMics*(m->nScan)*sizeof(float_complex));
+    m->T = (float_complex**)malloc2d(nBands, nMics*nMics, sizeof(float_complex));
+    m->DCM_array = malloc1d(nBands*nMics*nMics*sizeof(float_complex));
+    job.m = m;
+    nWorkers = proposed_parallel_getNumWorkers(nBands);
+    for(w=0; w<nWorkers; w++){
+        utility_cseig_create(&(job.hEig[w]), nMics);
+        job.U[w] = malloc1d(nMics*nMics*sizeof(float_complex));
+        job.E[w] = malloc1d(nMics*nMics*sizeof(float_complex));
+        job.H_W[w] = malloc1d(nMics*nDirs*sizeof(float_complex));
+        job.H_band[w] = malloc1d(nMics*nDirs*sizeof(float_complex));
+    }
+    proposed_parallel_for(nBands, nWorkers, &proposed_analysis_buildModelBand, (void*)&job);
+    for(w=0; w<nWorkers; w++){
+        utility_cseig_destroy(&(job.hEig[w]));
+        free(job.U[w]);
+        free(job.E[w]);
+        free(job.H_W[w]);
+        free(job.H_band[w]);
+    }
+
+    /* Optionally, replace them with their spherical harmonic representation */
+    if(atfFitError>0.0f){
+        proposed_atfSH_create(&(m->hATF_SH), m->H_array, m->array_dirs_deg, nBands, nMics, nDirs, atfFitError);
+        free(m->H_array);
+        m->H_array = NULL;
+    }
+}
+
+/* Allocates an analyser and everything that it does not share with other instances, except for the run-time buffers */
+static proposed_analysis_data* proposed_analysis_alloc
 (
-    proposed_analysis_handle* const phAna,
     float fs,
     int hopsize,
     int blocksize,
-    float* h_array,
-    float* array_dirs_deg,
     int nDirs,
     int nMics,
     int h_len
 )
 {
     proposed_analysis_data* a = (proposed_analysis_data*)malloc1d(sizeof(proposed_analysis_data));
-    *phAna = (void*)a;
-    int band, i, j, idx_max;
-    float* w_tmp;
-    float_complex *U, *E, *H_W;
-    const float_complex calpha = cmplxf(1.0f, 0.0f); const float_complex cbeta = cmplxf(0.0f, 0.0f); /* blas */
 
-    nMics = SAF_MIN(nMics, PROPOSED_MAX_NMICS);
     assert(blocksize % hopsize == 0); /* Must be a multiple of hopsize */
     assert(blocksize<=PROPOSED_MAX_BLOCKSIZE);
 
@@ -84,122 +229,154 @@ void proposed_analysis_create
     a->fs = fs;
     a->hopsize = hopsize;
     a->blocksize = blocksize;
-    a->h_array = malloc1d(nDirs*nMics*h_len*sizeof(float));
-    memcpy(a->h_array, h_array, nDirs*nMics*h_len*sizeof(float));
-    a->array_dirs_deg = malloc1d(nDirs*2*sizeof(float));
-    memcpy(a->array_dirs_deg, array_dirs_deg, nDirs*2*sizeof(float));
-    a->array_dirs_xyz = malloc1d(nDirs*3*sizeof(float));
-    unitSph2cart(a->array_dirs_deg, nDirs, 1, a->array_dirs_xyz);
     a->nDirs = nDirs;
     a->nMics = nMics;
     a->h_len = h_len;
     a->covAvgCoeff = 0.3f;
     a->covAvgCoeff = SAF_CLAMP(a->covAvgCoeff, 0.0f, 0.99999f);
     a->maximumAnalysisFreq = 9e3f;
-     
-    /* Scale steering vectors so that the peak of loudest measurement is 1 */
-    utility_simaxv(a->h_array, nDirs*nMics*h_len, &idx_max);
-    cblas_sscal(nDirs*nMics*h_len, 1.0f/a->h_array[idx_max], a->h_array, 1);
+    a->enableBandLimitedAnalysis = 1;
+    a->enableLinearOnly = 0;
+    a->updateSchedule = PROPOSED_ANALYSIS_UPDATE_ALL_BANDS;
+    a->updateInterval = 2;
+    a->decimationFreq = 1.5e3f;
+    memset(&(a->limits), 0, sizeof(proposed_analysis_limits));
+    a->profiler.enable = 0;
+    proposed_profiler_reset(&(a->profiler));
     
-    /* For optional plotting purposes  */
-    a->grid_histogram = calloc1d(a->nDirs, sizeof(float));
-
     /* Initialise time-frequency transform  */
     a->timeSlots = a->blocksize/a->hopsize;
     afSTFT_create(&(a->hFB_enc), a->nMics, 0, a->hopsize, 1, 0, AFSTFT_BANDS_CH_TIME);
     a->nBands = afSTFT_getNBands(a->hFB_enc);
-    a->freqVector = malloc1d(a->nBands*sizeof(float));
     a->filterbankDelay = afSTFT_getProcDelay(a->hFB_enc);
-    afSTFT_getCentreFreqs(a->hFB_enc, a->fs, a->nBands, a->freqVector);
-    a->H_array = malloc1d(a->nBands*(a->nMics)*(a->nDirs)*sizeof(float_complex));
-    a->H_array_w = malloc1d(a->nBands*(a->nMics)*(a->nDirs)*sizeof(float_complex));
-    afSTFT_FIRtoFilterbankCoeffs(a->h_array, a->nDirs, a->nMics, a->h_len, a->hopsize, 1, 0, a->H_array);
-   
-    /* Initialise DoA estimator */
     utility_cseig_create(&(a->hEig), a->nMics);
-    a->nScan = 0;
-    a->scan_dirs_deg = malloc1d(nDirs*2*sizeof(float));
-    a->scan_dirs_xyz = malloc1d(nDirs*3*sizeof(float));
-    for(i=0; i<nDirs; i++){
-        if(a->array_dirs_deg[i*2+1]>-PROPOSED_ELEV_SCANNING_WINDOW_DEG && a->array_dirs_deg[i*2+1]<PROPOSED_ELEV_SCANNING_WINDOW_DEG){
-            a->scan_dirs_deg[a->nScan*2] = a->array_dirs_deg[i*2];
-            a->scan_dirs_deg[a->nScan*2+1] = a->array_dirs_deg[i*2+1];
-            a->nScan++;
-        }
-    }
-    unitSph2cart(a->scan_dirs_deg, a->nScan, 1, a->scan_dirs_xyz);
-    a->scan_idx = malloc1d(a->nScan*sizeof(int));
+    a->smk = proposed_kernels_getSmallMat(a->nMics);
+    a->model = NULL;
+    a->hDoA = NULL;
+    a->arena = NULL;
+    a->grid_histogram = NULL;
+    a->inputBlock = NULL;
+    a->Cx = NULL;
+    a->V = a->Vn = NULL;
+    a->lambda = NULL;
+    return a;
+}
+
+/* Takes over a reference to the array model, and allocates the run-time buffers */
+static void proposed_analysis_attachModel
+(
+    proposed_analysis_data* a,
+    proposed_array_model* m
+)
+{
+    a->model = m;
+    a->freqVector = m->freqVector;
+    a->array_dirs_deg = m->array_dirs_deg;
+    a->array_dirs_xyz = m->array_dirs_xyz;
+    a->T = m->T;
+    a->nScan = m->nScan;
+    a->scan_dirs_deg = m->scan_dirs_deg;
+    a->scan_dirs_xyz = m->scan_dirs_xyz;
+    a->H_scan_w = m->H_scan_w;
+    a->scan_idx = m->scan_idx;
+
+    /* Initialise DoA estimator */
 #if PROPOSED_USE_MUSIC
     proposed_sdMUSIC_create(&(a->hDoA), a->nMics, a->scan_dirs_deg, a->nScan);
 #else
 //TODO: implement
   //  sphPWD_create
 #endif
-    proposed_findNearestGridIndices(a->array_dirs_xyz, a->scan_dirs_xyz, a->nDirs, a->nScan, a->scan_idx);
- 
-    /* Integration weights */
-    a->W = calloc1d(a->nDirs*a->nDirs,sizeof(float_complex));
-    if (cblas_sasum(a->nDirs, a->array_dirs_deg+1, 2)/(float)a->nDirs<0.001){
-        for(i=0; i<a->nDirs; i++)
-            a->W[i*(a->nDirs)+i] = cmplxf(1.0f, 0.0f);
-    }
-    else{
-        w_tmp = malloc1d(a->nDirs*sizeof(float));
-        if(a->nDirs<1200)
-            getVoronoiWeights(a->array_dirs_deg, a->nDirs, 0, w_tmp);
-        for(i=0; i<a->nDirs; i++)
-            a->W[i*(a->nDirs)+i] = cmplxf(a->nDirs<1200 ? w_tmp[i] : 1.0f, 0.0f);
-    }
 
-    /* Compute diffuse coherence matrices */
-    a->T = (float_complex**)malloc2d(a->nBands, a->nMics*(a->nMics), sizeof(float_complex));
-    a->DCM_array = malloc1d(a->nBands*(a->nMics)*(a->nMics)*sizeof(float_complex));
-    diffCohMtxMeas(a->H_array, a->nBands, a->nMics, a->nDirs, NULL, a->DCM_array);
-    
-    /* For spatial whitening of the spatial covariance matrix, such that it has an identity structure under diffuse-field conditions (see [2]) */
-    a->H_scan_w = malloc1d(a->nBands*(a->nMics)*(a->nScan)*sizeof(float_complex));
-    U = malloc1d(a->nMics*(a->nMics)*sizeof(float_complex));
-    E = malloc1d(a->nMics*(a->nMics)*sizeof(float_complex));
-    H_W = malloc1d(a->nMics*(a->nDirs)*sizeof(float_complex));
-    for(band=0; band<a->nBands; band++){
-        /* Diffuse covariance matrix */
-        cblas_sscal(/*re+im*/2*(a->nMics)*(a->nMics), 1.0f/(float)a->nDirs, (float*)&(a->DCM_array[band*(a->nMics)*(a->nMics)]), 1);
-         
-        /* Decomposition of the diffuse covariance matrix */
-        utility_cseig(a->hEig, &(a->DCM_array[band*(a->nMics)*(a->nMics)]), a->nMics, 1, U, E, NULL);
-
-        /* Compute spatial whitening matrix */
-        for(i=0; i<a->nMics; i++)
-            E[i*a->nMics+i] = cmplxf(sqrtf(1.0f/(crealf(E[i*a->nMics+i])+2.23e-10f)), 0.0f);
-        cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, a->nMics, a->nMics, a->nMics, &calpha,
-                    E, a->nMics,
-                    U, a->nMics, &cbeta,
-                    a->T[band], a->nMics);
-
-        /* Whiten the array steering vectors / anechoic acoustic transfer functions (ATFs) */
-        cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, a->nMics, a->nDirs, a->nMics, &calpha,
-                    a->T[band], a->nMics,
-                    &(a->H_array[band*(a->nMics)*(a->nDirs)]), a->nDirs, &cbeta,
-                    &(a->H_array_w[band*(a->nMics)*(a->nDirs)]), a->nDirs);
-        
-        /* Take subset */
-        for(i=0; i<a->nMics; i++)
-            for(j=0; j<a->nScan; j++)
-                a->H_scan_w[band*(a->nMics)*(a->nScan) + i*(a->nScan) + j] = a->H_array_w[band*(a->nMics)*(a->nDirs) + i*(a->nDirs) + a->scan_idx[j]];
+    /* Run-time variables, in the order that they are accessed per block */
+    proposed_arena_create(&(a->arena));
+    proposed_arena_reserve2d(a->arena, &(a->inputBlock), a->nMics, a->blocksize, sizeof(float));
+    proposed_arena_reserve1d(a->arena, &(a->Cx), a->nBands, sizeof(CxMic));
+    proposed_arena_reserve1d(a->arena, &(a->V), (a->nMics)*(a->nMics), sizeof(float_complex));
+    proposed_arena_reserve1d(a->arena, &(a->lambda), a->nMics, sizeof(float));
+    proposed_arena_reserve1d(a->arena, &(a->Vn), (a->nMics)*(a->nMics), sizeof(float_complex));
+    proposed_arena_reserve1d(a->arena, &(a->grid_histogram), a->nDirs, sizeof(float)); /* For optional plotting purposes */
+    proposed_arena_commit(a->arena);
+
+    /* Flush run-time buffers with zeros */
+    proposed_analysis_reset((proposed_analysis_handle)a);
+}
+
+void proposed_analysis_create
+(
+    proposed_analysis_handle* const phAna,
+    float fs,
+    int hopsize,
+    int blocksize,
+    float* h_array,
+    float* array_dirs_deg,
+    int nDirs,
+    int nMics,
+    int h_len,
+    float atfFitError
+)
+{
+    proposed_analysis_data* a;
+    proposed_array_model* m;
+    unsigned long long key;
+
+    nMics = SAF_MIN(nMics, PROPOSED_MAX_NMICS);
+    atfFitError = SAF_MAX(atfFitError, 0.0f);
+    a = proposed_analysis_alloc(fs, hopsize, blocksize, nDirs, nMics, h_len);
+    *phAna = (void*)a;
+
+    /* Array model; computed once per process for a given set of array IRs and configuration, and then shared */
+    key = proposed_cache_hash(PROPOSED_CACHE_HASH_SEED, "array", 5);
+    key = proposed_cache_hash(key, &fs, sizeof(float));
+    key = proposed_cache_hash(key, &hopsize, sizeof(int));
+    key = proposed_cache_hash(key, &nDirs, sizeof(int));
+    key = proposed_cache_hash(key, &nMics, sizeof(int));
+    key = proposed_cache_hash(key, &h_len, sizeof(int));
+    key = proposed_cache_hash(key, &atfFitError, sizeof(float));
+    key = proposed_cache_hash(key, array_dirs_deg, nDirs*2*sizeof(float));
+    key = proposed_cache_hash(key, h_array, nDirs*nMics*h_len*sizeof(float));
+    m = (proposed_array_model*)proposed_cache_find(key);
+    if(m==NULL){
+        m = proposed_arrayModel_create();
+        m->entry.key = key;
+        proposed_analysis_buildModel(a, m, h_array, array_dirs_deg, atfFitError);
+        m = (proposed_array_model*)proposed_cache_insert(&(m->entry));
     }
-    free(U);
-    free(E);
-    free(H_W);
+    proposed_analysis_attachModel(a, m);
+}
 
-    /* Run-time variables */
-    a->inputBlock = (float**)malloc2d(a->nMics, a->blocksize, sizeof(float));
-    a->Cx = malloc1d(a->nBands*sizeof(CxMic));
-    a->V  = malloc1d((a->nMics)*(a->nMics)*sizeof(float_complex));
-    a->Vn = malloc1d((a->nMics)*(a->nMics)*sizeof(float_complex));
-    a->lambda = malloc1d((a->nMics)*sizeof(float));
+PROPOSED_BUNDLE_ERROR_CODES proposed_analysis_createFromBundle
+(
+    proposed_analysis_handle* const phAna,
+    const char* path,
+    float fs,
+    int hopsize,
+    int blocksize
+)
+{
+    proposed_analysis_data* a;
+    proposed_array_model* m;
+    PROPOSED_BUNDLE_ERROR_CODES error;
+    float bundle_fs;
+    int bundle_hopsize;
 
-    /* Flush run-time buffers with zeros */
-    proposed_analysis_reset((*phAna));
+    *phAna = NULL;
+    m = proposed_bundle_load(path, &bundle_fs, &bundle_hopsize, &error);
+    if(m==NULL)
+        return error;
+    if(bundle_fs!=fs || bundle_hopsize!=hopsize){
+        proposed_arrayModel_release(&m);
+        return PROPOSED_BUNDLE_ERROR_MISMATCH;
+    }
+    a = proposed_analysis_alloc(fs, hopsize, blocksize, m->nDirs, m->nMics, 0);
+    if(a->nBands!=m->nBands){
+        proposed_arrayModel_release(&m);
+        proposed_analysis_destroy((proposed_analysis_handle*)&a);
+        return PROPOSED_BUNDLE_ERROR_FORMAT;
+    }
+    proposed_analysis_attachModel(a, m);
+    *phAna = (void*)a;
+    return PROPOSED_BUNDLE_OK;
 }
 
 void proposed_analysis_destroy
@@ -210,35 +387,17 @@ void proposed_analysis_destroy
     proposed_analysis_data *a = (proposed_analysis_data*)(*phAna);
 
     if (a != NULL) {
-        free(a->h_array);
-        free(a->H_array);
-        free(a->H_array_w);
-        free(a->DCM_array);
-        free(a->W);
-        free(a->T);
-        free(a->array_dirs_xyz);
-        free(a->array_dirs_deg);
-        
-        /* For optional plotting purposes  */
-        free(a->grid_histogram);
+        proposed_arrayModel_release(&(a->model));
 
         /* Destroy time-frequency transform  */
         afSTFT_destroy(&(a->hFB_enc));
-        free(a->freqVector);
 
         /* Destroy DoA estimator */
         utility_cseig_destroy(&(a->hEig));
         proposed_sdMUSIC_destroy(&(a->hDoA));
-        free(a->scan_dirs_deg);
-        free(a->scan_dirs_xyz);
-        free(a->H_scan_w);
 
-        /* Free run-time variables */
-        free(a->inputBlock);
-        free(a->Cx);
-        free(a->V);
-        free(a->Vn);
-        free(a->lambda);
+        /* Free run-time variables (and the histogram) */
+        proposed_arena_destroy(&(a->arena));
 
         free(a);
         a = NULL;
@@ -246,6 +405,36 @@ void proposed_analysis_destroy
     }
 }
 
+int proposed_analysis_getATFOrder
+(
+    proposed_analysis_handle const hAna,
+    int band
+)
+{
+    proposed_analysis_data *a;
+    if(hAna==NULL)
+        return -1;
+    a = (proposed_analysis_data*)(hAna);
+    if(a->model->hATF_SH==NULL || band<0 || band>=a->nBands)
+        return -1;
+    return proposed_atfSH_getOrder(a->model->hATF_SH, band);
+}
+
+float proposed_analysis_getATFFitError
+(
+    proposed_analysis_handle const hAna,
+    int band
+)
+{
+    proposed_analysis_data *a;
+    if(hAna==NULL)
+        return 0.0f;
+    a = (proposed_analysis_data*)(hAna);
+    if(a->model->hATF_SH==NULL || band<0 || band>=a->nBands)
+        return 0.0f;
+    return proposed_atfSH_getFitError(a->model->hATF_SH, band);
+}
+
 void proposed_analysis_reset
 (
     proposed_analysis_handle const hAna
@@ -259,6 +448,8 @@ void proposed_analysis_reset
 
     for(band=0; band<a->nBands; band++)
         memset(a->Cx[band].Cx, 0, PROPOSED_MAX_NMICS*PROPOSED_MAX_NMICS*sizeof(float_complex));
+    a->blockCounter = 0;
+    a->forceFullUpdate = 1;
     
     /* For optional plotting */
     memset(a->grid_histogram, 0, a->nDirs*sizeof(float));
@@ -277,13 +468,49 @@ void proposed_analysis_apply
     proposed_analysis_data *a = (proposed_analysis_data*)(hAna);
     proposed_param_container_data *pcon = (proposed_param_container_data*)(hPCon);
     proposed_signal_container_data *scon = (proposed_signal_container_data*)(hSCon);
-    int i, j, k, ch, band, K;
-    int est_idx[PROPOSED_MAX_NMICS];
-    float diffuseness;
-    CxMic Cx_new, T_Cx, T_Cx_TH;
-    const float_complex calpha = cmplxf(1.0f, 0.0f); const float_complex cbeta = cmplxf(0.0f, 0.0f); /* blas */
+    int band, updateInterval;
 
     assert(blocksize==a->blocksize);
+    PROPOSED_RTGUARD_ENTER("proposed_analysis_apply");
+
+    /* Forward time-frequency transform */
+    proposed_analysis_forwardTransform(a, input, nChannels, blocksize, scon);
+
+    /* Linear-only rendering does not require any spatial analysis (the parameter container is left as is) */
+    if(a->enableLinearOnly){
+        proposed_profiler_commit(&(a->profiler));
+        PROPOSED_RTGUARD_LEAVE();
+        return;
+    }
+
+    /* Update covariance matrix per band */
+    updateInterval = proposed_analysis_beginSchedule(a);
+    for(band=0; band<a->nBands; band++)
+        proposed_analysis_updateCovariance(a, scon, band);
+
+    /* Spatial parameter estimation per band */
+    for(band=0; band<a->nBands; band++)
+        proposed_analysis_estimateParameters(a, pcon, band, updateInterval);
+
+    /* Advance the update schedule */
+    proposed_analysis_endSchedule(a);
+    proposed_profiler_commit(&(a->profiler));
+    PROPOSED_RTGUARD_LEAVE();
+}
+
+void proposed_analysis_forwardTransform
+(
+    proposed_analysis_data* a,
+    float** input,
+    int nChannels,
+    int blocksize,
+    proposed_signal_container_data* scon
+)
+{
+    int ch;
+    unsigned long long t0;
+
+    t0 = proposed_profiler_begin(&(a->profiler));
 
     /* Load time-domain data */
     for(ch=0; ch<SAF_MIN(nChannels, a->nMics); ch++)
@@ -294,25 +521,119 @@ void proposed_analysis_apply
     /* Forward time-frequency transform */
     afSTFT_forward_knownDimensions(a->hFB_enc, a->inputBlock, blocksize, a->nMics, a->timeSlots, scon->inTF); 
 
-    /* Update covariance matrix per band */
-    for(band=0; band<a->nBands; band++){
-        cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, a->nMics, a->nMics, a->timeSlots, &calpha,
-                    FLATTEN2D(scon->inTF[band]), a->timeSlots,
-                    FLATTEN2D(scon->inTF[band]), a->timeSlots, &cbeta,
-                    Cx_new.Cx, a->nMics);
-
-        /* Make a copy for the signal container */
-        cblas_ccopy(a->nMics*a->nMics, (float_complex*)Cx_new.Cx, 1, (float_complex*)scon->Cx[band].Cx, 1);
-
-        /* Apply temporal averaging */
-        cblas_sscal(/*re+im*/2*(a->nMics) * (a->nMics),      SAF_CLAMP(a->covAvgCoeff, 0.0f, 0.999f), (float*)a->Cx[band].Cx, 1);
-        cblas_saxpy(/*re+im*/2*(a->nMics) * (a->nMics), 1.0f-SAF_CLAMP(a->covAvgCoeff, 0.0f, 0.999f), (float*)Cx_new.Cx, 1, (float*)a->Cx[band].Cx, 1);
+    /* Covariance matrices are not computed for linear-only rendering */
+    if(a->enableLinearOnly){
+        memset(scon->Cx_isValid, 0, a->nBands*sizeof(int));
+        a->forceFullUpdate = 1; /* held estimates are stale by the time the analysis resumes */
     }
+    proposed_profiler_end(&(a->profiler), PROPOSED_PROFILE_FORWARD_FB, t0);
+}
 
-    /* Spatial parameter estimation per band */
-    for (band = 0; band < a->nBands; band++) {
-        if (a->freqVector[band]<a->maximumAnalysisFreq && a->freqVector[band]<PROPOSED_MAX_RENDERING_FREQ){
-            /* Apply diffuse whitening process */
+void proposed_analysis_updateCovariance
+(
+    proposed_analysis_data* a,
+    proposed_signal_container_data* scon,
+    int band
+)
+{
+    CxMic Cx_new;
+    unsigned long long t0;
+    const float_complex calpha = cmplxf(1.0f, 0.0f); const float_complex cbeta = cmplxf(0.0f, 0.0f); /* blas */
+
+    /* Bands above the analysis limit are not used by the estimator, so their covariance matrices are only computed if the synthesiser asks for them */
+    if(a->blockBandLimitedAnalysis && !(a->freqVector[band]<a->blockMaxAnalysisFreq && a->freqVector[band]<PROPOSED_MAX_RENDERING_FREQ)){
+        scon->Cx_isValid[band] = 0;
+        return;
+    }
+    t0 = proposed_profiler_begin(&(a->profiler));
+    cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, a->nMics, a->nMics, a->timeSlots, &calpha,
+                FLATTEN2D(scon->inTF[band]), a->timeSlots,
+                FLATTEN2D(scon->inTF[band]), a->timeSlots, &cbeta,
+                Cx_new.Cx, a->nMics);
+
+    /* Make a copy for the signal container */
+    cblas_ccopy(a->nMics*a->nMics, (float_complex*)Cx_new.Cx, 1, (float_complex*)scon->Cx[band].Cx, 1);
+    scon->Cx_isValid[band] = 1;
+
+    /* Apply temporal averaging */
+    cblas_sscal(/*re+im*/2*(a->nMics) * (a->nMics),      SAF_CLAMP(a->covAvgCoeff, 0.0f, 0.999f), (float*)a->Cx[band].Cx, 1);
+    cblas_saxpy(/*re+im*/2*(a->nMics) * (a->nMics), 1.0f-SAF_CLAMP(a->covAvgCoeff, 0.0f, 0.999f), (float*)Cx_new.Cx, 1, (float*)a->Cx[band].Cx, 1);
+    proposed_profiler_end(&(a->profiler), PROPOSED_PROFILE_COVARIANCE, t0);
+}
+
+int proposed_analysis_beginSchedule
+(
+    proposed_analysis_data* a
+)
+{
+    const proposed_analysis_limits* limits = &(a->limits);
+    int band, updateInterval, prevBandLimitedAnalysis;
+    float prevMaxAnalysisFreq;
+
+    /* The limits are applied to copies of the settings, which may then be changed at any time without being overridden */
+    prevMaxAnalysisFreq = a->blockMaxAnalysisFreq;
+    prevBandLimitedAnalysis = a->blockBandLimitedAnalysis;
+    a->blockMaxAnalysisFreq = limits->maxAnalysisFreq > 0.0f ? SAF_MIN(a->maximumAnalysisFreq, limits->maxAnalysisFreq) : a->maximumAnalysisFreq;
+    a->blockBandLimitedAnalysis = a->enableBandLimitedAnalysis || limits->forceBandLimitedAnalysis;
+
+    /* Bands re-entering the analysis range hold the estimates (and, if band-limited, the covariance matrices) from when they
+     * left it, so these are discarded and every band is re-estimated rather than resuming from stale values */
+    if(a->blockMaxAnalysisFreq > prevMaxAnalysisFreq){
+        if(prevBandLimitedAnalysis){
+            for(band=0; band<a->nBands; band++)
+                if(a->freqVector[band]>=prevMaxAnalysisFreq && a->freqVector[band]<a->blockMaxAnalysisFreq)
+                    memset(a->Cx[band].Cx, 0, PROPOSED_MAX_NMICS*PROPOSED_MAX_NMICS*sizeof(float_complex));
+        }
+        a->forceFullUpdate = 1;
+    }
+    a->blockUpdateSchedule = a->updateSchedule;
+    updateInterval = SAF_MAX(a->updateInterval, 1);
+    if(limits->holdParameters)
+        a->blockUpdateSchedule = PROPOSED_ANALYSIS_UPDATE_HOLD;
+    else if(limits->minUpdateInterval > 1){
+        a->blockUpdateSchedule = PROPOSED_ANALYSIS_UPDATE_ROUND_ROBIN;
+        updateInterval = SAF_MAX(updateInterval, limits->minUpdateInterval);
+    }
+    a->blockCounter = a->blockCounter % updateInterval;
+    return updateInterval;
+}
+
+void proposed_analysis_estimateParameters
+(
+    proposed_analysis_data* a,
+    proposed_param_container_data* pcon,
+    int band,
+    int updateInterval
+)
+{
+    int i, j, k, K, isDue;
+    int est_idx[PROPOSED_MAX_NMICS];
+    float diffuseness;
+    CxMic T_Cx, T_Cx_TH;
+    unsigned long long t0;
+    const float_complex calpha = cmplxf(1.0f, 0.0f); const float_complex cbeta = cmplxf(0.0f, 0.0f); /* blas */
+
+    if (a->freqVector[band]<a->blockMaxAnalysisFreq && a->freqVector[band]<PROPOSED_MAX_RENDERING_FREQ){
+        /* Hold the previous estimates if this band is not due for an update */
+        switch(a->blockUpdateSchedule){
+            default: /* fall through */
+            case PROPOSED_ANALYSIS_UPDATE_ALL_BANDS:   isDue = 1; break;
+            case PROPOSED_ANALYSIS_UPDATE_DECIMATED:   isDue = a->freqVector[band]>=a->decimationFreq || a->blockCounter==0; break;
+            case PROPOSED_ANALYSIS_UPDATE_ROUND_ROBIN: isDue = band % updateInterval == a->blockCounter; break;
+            case PROPOSED_ANALYSIS_UPDATE_HOLD:        isDue = 0; break;
+        }
+        if(!isDue && !a->forceFullUpdate)
+            return;
+
+        /* Apply diffuse whitening process */
+        t0 = proposed_profiler_begin(&(a->profiler));
+        if(a->smk!=NULL){
+            a->smk->whiten(a->T[band], a->Cx[band].Cx, T_Cx_TH.Cx);
+            proposed_profiler_end(&(a->profiler), PROPOSED_PROFILE_WHITENING, t0);
+            t0 = proposed_profiler_begin(&(a->profiler));
+            a->smk->eigh(T_Cx_TH.Cx, a->V, a->lambda);
+        }
+        else{
             cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, a->nMics, a->nMics, a->nMics, &calpha,
                         a->T[band], a->nMics,
                         a->Cx[band].Cx, a->nMics, &cbeta,
@@ -321,54 +642,68 @@ void proposed_analysis_apply
                         T_Cx.Cx, a->nMics,
                         a->T[band], a->nMics, &cbeta,
                         T_Cx_TH.Cx, a->nMics);
+            proposed_profiler_end(&(a->profiler), PROPOSED_PROFILE_WHITENING, t0);
+            t0 = proposed_profiler_begin(&(a->profiler));
             utility_cseig(a->hEig, T_Cx_TH.Cx, a->nMics, 1, a->V, NULL, a->lambda);
+        }
+        proposed_profiler_end(&(a->profiler), PROPOSED_PROFILE_EIG, t0);
 
-            /* Detect number of sources */
-            diffuseness = proposed_comedie(a->lambda, a->nMics);
-            K = SAF_MIN(SAF_MIN((a->nMics-1)*diffuseness+1, (1.0f-diffuseness)*(a->nMics)), (int)((float)a->nMics/2.0f));
-            //K = SAF_MIN((a->nMics-1)*diffuseness+1, (int)((float)a->nMics/2.0f));
-            K = SAF_MAX(K, 1); /* forcing at least one */
-            
-            /* Store diffuseness and source number estimates */
-            pcon->nSrcs[band] = SAF_MIN(K, PROPOSED_MAX_K);
-            pcon->diffuseness[band] = diffuseness;
-            
-            if (K>0){
-                /* Apply DoA estimator */
-                for(i=0; i<a->nMics; i++)
-                    for(j=0, k=K; j<a->nMics-K; j++, k++)
-                        a->Vn[i*(a->nMics-K)+j] = a->V[i*(a->nMics)+k];
-                proposed_sdMUSIC_compute(a->hDoA, &(a->H_scan_w[band*(a->nMics)*(a->nScan)]), a->Vn, K, NULL, (int*)est_idx);
-
-                /* Store */
-                for(j=0; j<pcon->nSrcs[band]; j++){
-                    pcon->doa_idx[band][j] = pcon->gains_idx[band][j] = a->scan_idx[est_idx[j]];
-                    pcon->src_gains[band][j] = 1.0f; /* Default gains per band */
-                    
-                    /* For optional plotting */
-                    a->grid_histogram[a->scan_idx[est_idx[j]]] += 1.0f;
-                }
+        /* Detect number of sources */
+        t0 = proposed_profiler_begin(&(a->profiler));
+        diffuseness = proposed_comedie(a->lambda, a->nMics);
+        K = SAF_MIN(SAF_MIN((a->nMics-1)*diffuseness+1, (1.0f-diffuseness)*(a->nMics)), (int)((float)a->nMics/2.0f));
+        //K = SAF_MIN((a->nMics-1)*diffuseness+1, (int)((float)a->nMics/2.0f));
+        K = SAF_MAX(K, 1); /* forcing at least one */
+        
+        /* Store diffuseness and source number estimates */
+        pcon->nSrcs[band] = SAF_MIN(K, PROPOSED_MAX_K);
+        pcon->diffuseness[band] = diffuseness;
+        
+        if (K>0){
+            /* Apply DoA estimator */
+            for(i=0; i<a->nMics; i++)
+                for(j=0, k=K; j<a->nMics-K; j++, k++)
+                    a->Vn[i*(a->nMics-K)+j] = a->V[i*(a->nMics)+k];
+            proposed_sdMUSIC_compute(a->hDoA, &(a->H_scan_w[band*(a->nMics)*(a->nScan)]), a->Vn, K, NULL, (int*)est_idx);
+
+            /* Store */
+            for(j=0; j<pcon->nSrcs[band]; j++){
+                pcon->doa_idx[band][j] = pcon->gains_idx[band][j] = a->scan_idx[est_idx[j]];
+                pcon->src_gains[band][j] = 1.0f; /* Default gains per band */
+                
+                /* For optional plotting */
+                a->grid_histogram[a->scan_idx[est_idx[j]]] += 1.0f;
             }
         }
-        else {
-            /* "residual" only rendering (but of course, not subtracting anything) */
-            pcon->nSrcs[band] = 0;
-            pcon->diffuseness[band] = 1.0f;
-             
-            /* Or we extrapolate the parameters somehow? */
-            if (band-1>0){
-                K = pcon->nSrcs[band-1];
-                pcon->nSrcs[band] = K;
-                for(j=0; j<K; j++){
-                    pcon->doa_idx[band][j]   = pcon->doa_idx[band-1][j];
-                    pcon->gains_idx[band][j] = pcon->gains_idx[band-1][j];
-                    pcon->src_gains[band][j] = pcon->src_gains[band-1][j];
-                }
+        proposed_profiler_end(&(a->profiler), PROPOSED_PROFILE_MUSIC, t0);
+    }
+    else {
+        /* "residual" only rendering (but of course, not subtracting anything) */
+        pcon->nSrcs[band] = 0;
+        pcon->diffuseness[band] = 1.0f;
+         
+        /* Or we extrapolate the parameters somehow? */
+        if (band-1>0){
+            K = pcon->nSrcs[band-1];
+            pcon->nSrcs[band] = K;
+            for(j=0; j<K; j++){
+                pcon->doa_idx[band][j]   = pcon->doa_idx[band-1][j];
+                pcon->gains_idx[band][j] = pcon->gains_idx[band-1][j];
+                pcon->src_gains[band][j] = pcon->src_gains[band-1][j];
             }
         }
     }
 }
 
+void proposed_analysis_endSchedule
+(
+    proposed_analysis_data* a
+)
+{
+    a->blockCounter++;
+    a->forceFullUpdate = 0;
+}
+
 const float* proposed_analysis_getFrequencyVectorPtr
 (
     proposed_analysis_handle const hAna,
@@ -443,6 +778,22 @@ int proposed_analysis_getNDirs
     return hAna == NULL ? 0 : ((proposed_analysis_data*)(hAna))->nDirs;
 }
 
+int proposed_analysis_getNMics
+(
+    proposed_analysis_handle const hAna
+)
+{
+    return hAna == NULL ? 0 : ((proposed_analysis_data*)(hAna))->nMics;
+}
+
+int proposed_analysis_hasBundledHRTFs
+(
+    proposed_analysis_handle const hAna
+)
+{
+    return hAna == NULL ? 0 : ((proposed_analysis_data*)(hAna))->model->H_bin != NULL;
+}
+
 float* proposed_analysis_getCovarianceAvagingCoeffPtr
 (
     proposed_analysis_handle const hAna
@@ -467,6 +818,123 @@ float* proposed_analysis_getMaxAnalysisFreqPtr
     return &(a->maximumAnalysisFreq);
 }
 
+int* proposed_analysis_getEnableBandLimitedAnalysisPtr
+(
+    proposed_analysis_handle const hAna
+)
+{
+    proposed_analysis_data *a;
+    if(hAna==NULL)
+        return NULL;
+    a = (proposed_analysis_data*)(hAna);
+    return &(a->enableBandLimitedAnalysis);
+}
+
+int* proposed_analysis_getEnableLinearOnlyPtr
+(
+    proposed_analysis_handle const hAna
+)
+{
+    proposed_analysis_data *a;
+    if(hAna==NULL)
+        return NULL;
+    a = (proposed_analysis_data*)(hAna);
+    return &(a->enableLinearOnly);
+}
+
+PROPOSED_ANALYSIS_UPDATE_SCHEDULES* proposed_analysis_getUpdateSchedulePtr
+(
+    proposed_analysis_handle const hAna
+)
+{
+    proposed_analysis_data *a;
+    if(hAna==NULL)
+        return NULL;
+    a = (proposed_analysis_data*)(hAna);
+    return &(a->updateSchedule);
+}
+
+int* proposed_analysis_getUpdateIntervalPtr
+(
+    proposed_analysis_handle const hAna
+)
+{
+    proposed_analysis_data *a;
+    if(hAna==NULL)
+        return NULL;
+    a = (proposed_analysis_data*)(hAna);
+    return &(a->updateInterval);
+}
+
+float* proposed_analysis_getDecimationFreqPtr
+(
+    proposed_analysis_handle const hAna
+)
+{
+    proposed_analysis_data *a;
+    if(hAna==NULL)
+        return NULL;
+    a = (proposed_analysis_data*)(hAna);
+    return &(a->decimationFreq);
+}
+
+proposed_analysis_limits* proposed_analysis_getLimitsPtr
+(
+    proposed_analysis_handle const hAna
+)
+{
+    proposed_analysis_data *a;
+    if(hAna==NULL)
+        return NULL;
+    a = (proposed_analysis_data*)(hAna);
+    return &(a->limits);
+}
+
+int* proposed_analysis_getEnableProfilingPtr
+(
+    proposed_analysis_handle const hAna
+)
+{
+    proposed_analysis_data *a;
+    if(hAna==NULL)
+        return NULL;
+    a = (proposed_analysis_data*)(hAna);
+    return &(a->profiler.enable);
+}
+
+void proposed_analysis_getProfile
+(
+    proposed_analysis_handle const hAna,
+    proposed_profile* profile
+)
+{
+    proposed_profile_counters counters;
+
+    memset(&counters, 0, sizeof(proposed_profile_counters));
+    if(hAna!=NULL)
+        proposed_profiler_getCounters(&(((proposed_analysis_data*)(hAna))->profiler), &counters);
+    proposed_profile_getStats(&counters, profile);
+}
+
+void proposed_analysis_getProfileCounters
+(
+    proposed_analysis_handle const hAna,
+    proposed_profile_counters* counters
+)
+{
+    if(hAna!=NULL)
+        proposed_profiler_getCounters(&(((proposed_analysis_data*)(hAna))->profiler), counters);
+}
+
+void proposed_analysis_resetProfile
+(
+    proposed_analysis_handle const hAna
+)
+{
+    if(hAna!=NULL)
+        proposed_profiler_reset(&(((proposed_analysis_data*)(hAna))->profiler));
+}
+
 int proposed_analysis_getProcDelay
 (
     proposed_analysis_handle const hAna
@@ -489,18 +957,21 @@ void proposed_param_container_create
     proposed_param_container_data* pcon = (proposed_param_container_data*)malloc1d(sizeof(proposed_param_container_data));
     *phPCon = (void*)pcon;
     proposed_analysis_data *a = (proposed_analysis_data*)(hAna);
+    int i;
 
     /* Copy data that is relevant to the container */
     pcon->nBands = a->nBands;
 
-    /* Allocate parameter storage */
-    pcon->nSrcs = malloc1d(pcon->nBands*sizeof(int));
-    pcon->diffuseness = malloc1d(pcon->nBands*sizeof(float));
-    pcon->doa_idx = (int**)malloc2d(pcon->nBands, PROPOSED_MAX_K, sizeof(int));
-    pcon->gains_idx = (int**)malloc2d(pcon->nBands, PROPOSED_MAX_K, sizeof(int));
-
-    /* Allocate the optional parameter storage */
-    pcon->src_gains = (float**)calloc2d(pcon->nBands, PROPOSED_MAX_K, sizeof(float));
+    /* Allocate parameter storage (and the optional parameter storage), in the order that it is accessed per block */
+    proposed_arena_create(&(pcon->arena));
+    proposed_arena_reserve1d(pcon->arena, &(pcon->nSrcs), pcon->nBands, sizeof(int)); /* i.e. no sources until the first estimates are made */
+    proposed_arena_reserve1d(pcon->arena, &(pcon->diffuseness), pcon->nBands, sizeof(float));
+    proposed_arena_reserve2d(pcon->arena, &(pcon->doa_idx), pcon->nBands, PROPOSED_MAX_K, sizeof(int));
+    proposed_arena_reserve2d(pcon->arena, &(pcon->gains_idx), pcon->nBands, PROPOSED_MAX_K, sizeof(int));
+    proposed_arena_reserve2d(pcon->arena, &(pcon->src_gains), pcon->nBands, PROPOSED_MAX_K, sizeof(float));
+    proposed_arena_commit(pcon->arena);
+    for(i=0; i<pcon->nBands; i++)
+        pcon->diffuseness[i] = 1.0f;
 }
 
 void proposed_param_container_destroy
@@ -512,11 +983,7 @@ void proposed_param_container_destroy
 
     if (pcon != NULL) {
         /* Free parameter storage */
-        free(pcon->nSrcs);
-        free(pcon->diffuseness);
-        free(pcon->doa_idx);
-        free(pcon->gains_idx);
-        free(pcon->src_gains);
+        proposed_arena_destroy(&(pcon->arena));
 
         free(pcon);
         pcon = NULL;
@@ -539,11 +1006,12 @@ void proposed_signal_container_create
     scon->nBands = a->nBands;
     scon->timeSlots = a->timeSlots;
 
-    /* Copy of the NON-time-averaged covariance matrix per band */
-    scon->Cx = malloc1d(a->nBands*sizeof(CxMic));
-
-    /* Time-frequency frame */
-    scon->inTF = (float_complex***)malloc3d(scon->nBands, scon->nMics, scon->timeSlots, sizeof(float_complex));
+    /* Time-frequency frame, and a copy of the NON-time-averaged covariance matrix per band (which is computed from it) */
+    proposed_arena_create(&(scon->arena));
+    proposed_arena_reserve3d(scon->arena, &(scon->inTF), scon->nBands, scon->nMics, scon->timeSlots, sizeof(float_complex));
+    proposed_arena_reserve1d(scon->arena, &(scon->Cx_isValid), scon->nBands, sizeof(int));
+    proposed_arena_reserve1d(scon->arena, &(scon->Cx), scon->nBands, sizeof(CxMic));
+    proposed_arena_commit(scon->arena);
 }
 
 void proposed_signal_container_destroy
@@ -555,8 +1023,7 @@ void proposed_signal_container_destroy
 
     if (scon != NULL) {
         /* Free time-frequency frame */
-        free(scon->Cx);
-        free(scon->inTF);
+        proposed_arena_destroy(&(scon->arena));
 
         free(scon);
         scon = NULL;
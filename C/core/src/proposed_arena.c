@@ -0,0 +1,282 @@
+/**
+ * @file proposed_arena.c
+ * @ingroup PROPOSED
+ * @brief Per-object memory arena for the run-time state of the proposed method
+ *
+ * The buffers that an object writes to while processing (covariance and mixing
+ * matrices, time-frequency frames, FIR partitions etc.) are first reserved one
+ * by one when it is created, and then allocated together as one block, in the
+ * order in which they were reserved. Objects reserve them in the order that
+ * they are accessed for each block of audio, so that consecutive accesses
+ * tend to fall on the same or adjacent pages. Each buffer (and the row
+ * pointer tables of 2-D and 3-D buffers) starts on a cache line.
+ *
+ * The block is zeroed when it is allocated, which also faults in all of its
+ * pages, so that this does not happen during the first blocks of audio. It may
+ * optionally also be locked into physical memory, so that it is never paged
+ * out. The arena is opt-in; by default, each buffer is allocated separately,
+ * as before (see proposed_setRunTimeMemoryOption()).
+ *
+ * @author agent
+ * @date 19th October 2026
+ */
+
+#include "proposed_internal.h"
+
+#if defined(_WIN32)
+# include <windows.h>
+#else
+# include <sys/mman.h>
+#endif
+
+/** Alignment of each buffer, in bytes */
+#define PROPOSED_ARENA_ALIGNMENT ( 64 )
+
+/** Rounds up to a multiple of #PROPOSED_ARENA_ALIGNMENT */
+#define PROPOSED_ARENA_ALIGN(x) ( (((x) + PROPOSED_ARENA_ALIGNMENT - 1) / PROPOSED_ARENA_ALIGNMENT) * PROPOSED_ARENA_ALIGNMENT )
+
+/** Number of buffers that an arena initially has room for (more room is made as needed) */
+#define PROPOSED_ARENA_INIT_BUFFERS ( 48 )
+
+/** Option used by objects created from now on (see proposed_setRunTimeMemoryOption()) */
+static PROPOSED_RUNTIME_MEMORY_OPTIONS proposed_runTimeMemoryOption = PROPOSED_RUNTIME_MEMORY_HEAP; /* opt-in, as before the arena */
+
+/** One reserved buffer */
+typedef struct _proposed_arena_buffer {
+    void** pBuffer;                  /**< Where to store the address of the buffer */
+    int nDims;                       /**< 1, 2 or 3 */
+    size_t dim1;                     /**< Number of elements (1-D), or of rows */
+    size_t dim2;                     /**< Number of columns (2-D and 3-D) */
+    size_t dim3;                     /**< Number of elements per column (3-D) */
+    size_t elemSize;                 /**< Size of each element, in bytes */
+
+} proposed_arena_buffer;
+
+/** Main structure for an arena */
+struct _proposed_arena {
+    proposed_arena_buffer* buffers;  /**< Reserved buffers, in the order that they are laid out; maxBuffers x 1 */
+    int nBuffers;                    /**< Number of reserved buffers */
+    int maxBuffers;                  /**< Number of buffers that there is currently room for */
+    PROPOSED_RUNTIME_MEMORY_OPTIONS option; /**< Option at the time that the arena was created */
+    void* mem;                       /**< Allocated memory (NULL for #PROPOSED_RUNTIME_MEMORY_HEAP) */
+    unsigned char* block;            /**< Aligned start of the block within mem */
+    size_t blockSize;                /**< Size of the block, in bytes */
+    int isLocked;                    /**< 1: the block has been locked into physical memory, 0: it has not */
+};
+
+/* Size of a buffer and its row pointer tables within the block */
+static size_t proposed_arena_bufferSize
+(
+    const proposed_arena_buffer* buf
+)
+{
+    switch(buf->nDims){
+        case 1:  return PROPOSED_ARENA_ALIGN(buf->dim1*buf->elemSize);
+        case 2:  return PROPOSED_ARENA_ALIGN(buf->dim1*sizeof(void*)) +
+                        PROPOSED_ARENA_ALIGN(buf->dim1*buf->dim2*buf->elemSize);
+        default: return PROPOSED_ARENA_ALIGN(buf->dim1*sizeof(void*)) +
+                        PROPOSED_ARENA_ALIGN(buf->dim1*buf->dim2*sizeof(void*)) +
+                        PROPOSED_ARENA_ALIGN(buf->dim1*buf->dim2*buf->dim3*buf->elemSize);
+    }
+}
+
+/* Places a buffer at *pos, and advances *pos past it. The rows are laid out as by malloc2d()/malloc3d(), so FLATTEN2D()/FLATTEN3D() may be used */
+static void proposed_arena_place
+(
+    const proposed_arena_buffer* buf,
+    unsigned char** pos
+)
+{
+    unsigned char* data;
+    void** rows, ***planes;
+    size_t i, j;
+
+    switch(buf->nDims){
+        case 1:
+            *(buf->pBuffer) = (void*)(*pos);
+            break;
+        case 2:
+            rows = (void**)(*pos);
+            data = (*pos) + PROPOSED_ARENA_ALIGN(buf->dim1*sizeof(void*));
+            for(i=0; i<buf->dim1; i++)
+                rows[i] = (void*)(data + i*(buf->dim2)*(buf->elemSize));
+            *(buf->pBuffer) = (void*)rows;
+            break;
+        default:
+            planes = (void***)(*pos);
+            rows = (void**)((*pos) + PROPOSED_ARENA_ALIGN(buf->dim1*sizeof(void*)));
+            data = (unsigned char*)rows + PROPOSED_ARENA_ALIGN(buf->dim1*buf->dim2*sizeof(void*));
+            for(i=0; i<buf->dim1; i++){
+                planes[i] = &rows[i*(buf->dim2)];
+                for(j=0; j<buf->dim2; j++)
+                    rows[i*(buf->dim2)+j] = (void*)(data + (i*(buf->dim2)+j)*(buf->dim3)*(buf->elemSize));
+            }
+            *(buf->pBuffer) = (void*)planes;
+            break;
+    }
+    (*pos) += proposed_arena_bufferSize(buf);
+}
+
+static void proposed_arena_add
+(
+    proposed_arena* arena,
+    void* pBuffer,
+    int nDims,
+    size_t dim1,
+    size_t dim2,
+    size_t dim3,
+    size_t elemSize
+)
+{
+    proposed_arena_buffer* buf;
+
+    assert(arena->mem==NULL); /* Must be reserved before the arena is committed */
+    if(arena->nBuffers==arena->maxBuffers){
+        arena->maxBuffers *= 2;
+        arena->buffers = (proposed_arena_buffer*)realloc1d(arena->buffers, arena->maxBuffers*sizeof(proposed_arena_buffer));
+    }
+    buf = &(arena->buffers[arena->nBuffers++]);
+    buf->pBuffer = (void**)pBuffer;
+    buf->nDims = nDims;
+    buf->dim1 = dim1;
+    buf->dim2 = dim2;
+    buf->dim3 = dim3;
+    buf->elemSize = elemSize;
+    *(buf->pBuffer) = NULL;
+}
+
+void proposed_setRunTimeMemoryOption
+(
+    PROPOSED_RUNTIME_MEMORY_OPTIONS option
+)
+{
+    proposed_runTimeMemoryOption = option;
+}
+
+void proposed_arena_create
+(
+    proposed_arena** const pArena
+)
+{
+    proposed_arena* arena = (proposed_arena*)malloc1d(sizeof(proposed_arena));
+    *pArena = arena;
+
+    arena->maxBuffers = PROPOSED_ARENA_INIT_BUFFERS;
+    arena->buffers = (proposed_arena_buffer*)malloc1d(arena->maxBuffers*sizeof(proposed_arena_buffer));
+    arena->nBuffers = 0;
+    arena->option = proposed_runTimeMemoryOption;
+    arena->mem = NULL;
+    arena->block = NULL;
+    arena->blockSize = 0;
+    arena->isLocked = 0;
+}
+
+void proposed_arena_reserve1d
+(
+    proposed_arena* arena,
+    void* pBuffer,
+    size_t nElements,
+    size_t elemSize
+)
+{
+    proposed_arena_add(arena, pBuffer, 1, nElements, 1, 1, elemSize);
+}
+
+void proposed_arena_reserve2d
+(
+    proposed_arena* arena,
+    void* pBuffer,
+    size_t dim1,
+    size_t dim2,
+    size_t elemSize
+)
+{
+    proposed_arena_add(arena, pBuffer, 2, dim1, dim2, 1, elemSize);
+}
+
+void proposed_arena_reserve3d
+(
+    proposed_arena* arena,
+    void* pBuffer,
+    size_t dim1,
+    size_t dim2,
+    size_t dim3,
+    size_t elemSize
+)
+{
+    proposed_arena_add(arena, pBuffer, 3, dim1, dim2, dim3, elemSize);
+}
+
+void proposed_arena_commit
+(
+    proposed_arena* arena
+)
+{
+    proposed_arena_buffer* buf;
+    unsigned char* pos;
+    int i;
+
+    /* Separate (zeroed) allocations, as the objects used before */
+    if(arena->option==PROPOSED_RUNTIME_MEMORY_HEAP){
+        for(i=0; i<arena->nBuffers; i++){
+            buf = &(arena->buffers[i]);
+            switch(buf->nDims){
+                case 1:  *(buf->pBuffer) = calloc1d(buf->dim1, buf->elemSize); break;
+                case 2:  *(buf->pBuffer) = (void*)calloc2d(buf->dim1, buf->dim2, buf->elemSize); break;
+                default: *(buf->pBuffer) = (void*)calloc3d(buf->dim1, buf->dim2, buf->dim3, buf->elemSize); break;
+            }
+        }
+        return;
+    }
+
+    /* One block; writing the zeros faults in every page now, rather than upon first access while processing */
+    arena->blockSize = 0;
+    for(i=0; i<arena->nBuffers; i++)
+        arena->blockSize += proposed_arena_bufferSize(&(arena->buffers[i]));
+    arena->mem = malloc1d(arena->blockSize + PROPOSED_ARENA_ALIGNMENT);
+    arena->block = (unsigned char*)PROPOSED_ARENA_ALIGN((size_t)arena->mem);
+    memset(arena->block, 0, arena->blockSize);
+    pos = arena->block;
+    for(i=0; i<arena->nBuffers; i++)
+        proposed_arena_place(&(arena->buffers[i]), &pos);
+
+    /* Locking may not be permitted (e.g. RLIMIT_MEMLOCK), in which case the block is only pre-faulted */
+    if(arena->option==PROPOSED_RUNTIME_MEMORY_ARENA_LOCKED && arena->blockSize>0){
+#if defined(_WIN32)
+        arena->isLocked = VirtualLock((LPVOID)arena->block, arena->blockSize) ? 1 : 0;
+#else
+        arena->isLocked = mlock((const void*)arena->block, arena->blockSize)==0;
+#endif
+    }
+}
+
+void proposed_arena_destroy
+(
+    proposed_arena** const pArena
+)
+{
+    proposed_arena* arena = *pArena;
+    int i;
+
+    if(arena!=NULL){
+        if(arena->mem==NULL){
+            for(i=0; i<arena->nBuffers; i++)
+                free(*(arena->buffers[i].pBuffer));
+        }
+        else{
+            if(arena->isLocked){
+#if defined(_WIN32)
+                VirtualUnlock((LPVOID)arena->block, arena->blockSize);
+#else
+                munlock((const void*)arena->block, arena->blockSize);
+#endif
+            }
+            free(arena->mem);
+        }
+        for(i=0; i<arena->nBuffers; i++)
+            *(arena->buffers[i].pBuffer) = NULL;
+        free(arena->buffers);
+        free(arena);
+        *pArena = NULL;
+    }
+}
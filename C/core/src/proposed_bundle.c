@@ -0,0 +1,409 @@
+/**
+ * @file proposed_bundle.c
+ * @ingroup PROPOSED
+ * @brief Pre-computed array model bundles, which are memory-mapped when loaded
+ *
+ * A bundle holds everything in the array model (see proposed_array_model) for
+ * one samplerate and hopsize, i.e. the filterbank-domain ATFs, scanning grid,
+ * whitening matrices and diffuse coherence matrices, and optionally the
+ * interpolated HRTFs for the array grid. The file consists of a fixed header,
+ * followed by one section per array. Each section starts at a multiple of
+ * #PROPOSED_BUNDLE_ALIGNMENT bytes and is stored in exactly the layout that is
+ * used at run-time, so a loaded model points directly into the mapped file,
+ * and nothing is computed or copied.
+ *
+ * The mapping is read-only and shared by the OS between all processes that
+ * load the same bundle; pages are only read from disk upon first access.
+ *
+ * A loaded model is cached under a key of its own, which is derived from that
+ * of the saved model, and from the HRTFs stored along with it. It is therefore
+ * never mistaken for a model computed from the array IRs (which has no HRTFs),
+ * nor for a bundle of the same array that holds different HRTFs.
+ *
+ * @author agent
+ * @date 19th October 2026
+ */
+
+#include "proposed_internal.h"
+
+#if defined(_WIN32)
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+/** Identifies a bundle file (including the terminating null) */
+#define PROPOSED_BUNDLE_MAGIC "PRPBNDL"
+
+/** Increment whenever the layout of the header or of any section changes (or the meaning of the key) */
+#define PROPOSED_BUNDLE_VERSION ( 2 )
+
+/** Written in the byte order of the machine that saved the bundle */
+#define PROPOSED_BUNDLE_BYTE_ORDER_MARK ( 0x01020304u )
+
+/** Alignment of each section, in bytes */
+#define PROPOSED_BUNDLE_ALIGNMENT ( 64 )
+
+/** Rounds up to a multiple of #PROPOSED_BUNDLE_ALIGNMENT */
+#define PROPOSED_BUNDLE_ALIGN(x) ( (((x) + PROPOSED_BUNDLE_ALIGNMENT - 1) / PROPOSED_BUNDLE_ALIGNMENT) * PROPOSED_BUNDLE_ALIGNMENT )
+
+/** Sections of a bundle, in the order that they are stored */
+typedef enum {
+    PROPOSED_BUNDLE_FREQ_VECTOR,    /**< nBands x 1 float */
+    PROPOSED_BUNDLE_DIRS_DEG,       /**< nDirs x 2 float */
+    PROPOSED_BUNDLE_DIRS_XYZ,       /**< nDirs x 3 float */
+    PROPOSED_BUNDLE_W,              /**< nDirs x 1 float */
+    PROPOSED_BUNDLE_DCM,            /**< nBands x nMics x nMics float_complex */
+    PROPOSED_BUNDLE_T,              /**< nBands x nMics x nMics float_complex */
+    PROPOSED_BUNDLE_SCAN_DIRS_DEG,  /**< nScan x 2 float */
+    PROPOSED_BUNDLE_SCAN_DIRS_XYZ,  /**< nScan x 3 float */
+    PROPOSED_BUNDLE_SCAN_IDX,       /**< nScan x 1 int */
+    PROPOSED_BUNDLE_H_SCAN_W,       /**< nBands x nMics x nScan float_complex */
+    PROPOSED_BUNDLE_H_ARRAY,        /**< nDirs x nBands x nMics float_complex */
+    PROPOSED_BUNDLE_H_BIN,          /**< nDirs x nBands x #NUM_EARS float_complex (empty if there are no HRTFs) */
+
+    PROPOSED_BUNDLE_NUM_SECTIONS
+
+} PROPOSED_BUNDLE_SECTIONS;
+
+/** Header at the start of a bundle */
+typedef struct _proposed_bundle_header {
+    char magic[8];                 /**< #PROPOSED_BUNDLE_MAGIC */
+    unsigned int version;          /**< #PROPOSED_BUNDLE_VERSION */
+    unsigned int byteOrder;        /**< #PROPOSED_BUNDLE_BYTE_ORDER_MARK */
+    unsigned long long key;        /**< Cache key of the loaded model; derived from that of the saved model and the stored HRTFs (0: not cached) */
+    unsigned long long fileSize;   /**< Size of the whole bundle, in bytes */
+    float fs;                      /**< Samplerate that the model was computed for, Hz */
+    int hopsize;                   /**< Filterbank hopsize that the model was computed for */
+    int nBands;                    /**< Number of frequency bands */
+    int nMics;                     /**< Number of microphones */
+    int nDirs;                     /**< Number of measurement directions */
+    int nScan;                     /**< Number of scanning directions */
+    int hrtfInterpOption;          /**< #PROPOSED_HRTF_INTERP_OPTIONS used for the HRTFs (-1: no HRTFs) */
+    int reserved;                  /**< Zero */
+    unsigned long long offset[PROPOSED_BUNDLE_NUM_SECTIONS]; /**< Start of each section, in bytes */
+
+} proposed_bundle_header;
+
+/** Read-only mapping of a bundle file */
+typedef struct _proposed_bundle_mapping {
+    void* base;                    /**< Start of the mapped file */
+    size_t size;                   /**< Size of the mapped file, in bytes */
+#if defined(_WIN32)
+    HANDLE hFile;                  /**< File handle */
+    HANDLE hMap;                   /**< File mapping handle */
+#endif
+
+} proposed_bundle_mapping;
+
+/* Size of each section, in bytes */
+static size_t proposed_bundle_sectionSize
+(
+    const proposed_bundle_header* hdr,
+    int section
+)
+{
+    size_t nBands, nMics, nDirs, nScan;
+
+    nBands = (size_t)hdr->nBands;
+    nMics = (size_t)hdr->nMics;
+    nDirs = (size_t)hdr->nDirs;
+    nScan = (size_t)hdr->nScan;
+    switch(section){
+        case PROPOSED_BUNDLE_FREQ_VECTOR:   return nBands*sizeof(float);
+        case PROPOSED_BUNDLE_DIRS_DEG:      return nDirs*2*sizeof(float);
+        case PROPOSED_BUNDLE_DIRS_XYZ:      return nDirs*3*sizeof(float);
+        case PROPOSED_BUNDLE_W:             return nDirs*sizeof(float);
+        case PROPOSED_BUNDLE_DCM:           /* fall through */
+        case PROPOSED_BUNDLE_T:             return nBands*nMics*nMics*sizeof(float_complex);
+        case PROPOSED_BUNDLE_SCAN_DIRS_DEG: return nScan*2*sizeof(float);
+        case PROPOSED_BUNDLE_SCAN_DIRS_XYZ: return nScan*3*sizeof(float);
+        case PROPOSED_BUNDLE_SCAN_IDX:      return nScan*sizeof(int);
+        case PROPOSED_BUNDLE_H_SCAN_W:      return nBands*nMics*nScan*sizeof(float_complex);
+        case PROPOSED_BUNDLE_H_ARRAY:       return nDirs*nBands*nMics*sizeof(float_complex);
+        case PROPOSED_BUNDLE_H_BIN:         return hdr->hrtfInterpOption<0 ? 0 : nDirs*nBands*NUM_EARS*sizeof(float_complex);
+        default:                            return 0;
+    }
+}
+
+/* Maps a whole file read-only; returns 0 on success */
+static int proposed_bundle_map
+(
+    const char* path,
+    proposed_bundle_mapping* map
+)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER fileSize;
+
+    map->hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(map->hFile==INVALID_HANDLE_VALUE)
+        return 1;
+    if(!GetFileSizeEx(map->hFile, &fileSize) || fileSize.QuadPart<(LONGLONG)sizeof(proposed_bundle_header)){
+        CloseHandle(map->hFile);
+        return 1;
+    }
+    map->size = (size_t)fileSize.QuadPart;
+    map->hMap = CreateFileMappingA(map->hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(map->hMap==NULL){
+        CloseHandle(map->hFile);
+        return 1;
+    }
+    map->base = MapViewOfFile(map->hMap, FILE_MAP_READ, 0, 0, 0);
+    if(map->base==NULL){
+        CloseHandle(map->hMap);
+        CloseHandle(map->hFile);
+        return 1;
+    }
+    return 0;
+#else
+    struct stat st;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if(fd<0)
+        return 1;
+    if(fstat(fd, &st)!=0 || st.st_size<(off_t)sizeof(proposed_bundle_header)){
+        close(fd);
+        return 1;
+    }
+    map->size = (size_t)st.st_size;
+    map->base = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); /* the mapping keeps its own reference to the file */
+    if(map->base==MAP_FAILED)
+        return 1;
+    return 0;
+#endif
+}
+
+static void proposed_bundle_unmap
+(
+    proposed_bundle_mapping* map
+)
+{
+#if defined(_WIN32)
+    UnmapViewOfFile(map->base);
+    CloseHandle(map->hMap);
+    CloseHandle(map->hFile);
+#else
+    munmap(map->base, map->size);
+#endif
+}
+
+/* Checks that the header describes a complete bundle of this version and byte order, and that its indices are in range */
+static PROPOSED_BUNDLE_ERROR_CODES proposed_bundle_validate
+(
+    const proposed_bundle_header* hdr,
+    const char* base,
+    size_t fileSize
+)
+{
+    int section, i;
+    size_t size;
+    const int* scan_idx;
+
+    if(memcmp(hdr->magic, PROPOSED_BUNDLE_MAGIC, sizeof(PROPOSED_BUNDLE_MAGIC))!=0)
+        return PROPOSED_BUNDLE_ERROR_FORMAT;
+    if(hdr->byteOrder!=PROPOSED_BUNDLE_BYTE_ORDER_MARK || hdr->version!=PROPOSED_BUNDLE_VERSION)
+        return PROPOSED_BUNDLE_ERROR_VERSION;
+    if(hdr->fileSize!=(unsigned long long)fileSize || hdr->nBands<1 || hdr->nDirs<1 || hdr->nScan<0 ||
+       hdr->nMics<1 || hdr->nMics>PROPOSED_MAX_NMICS || hdr->hopsize<1)
+        return PROPOSED_BUNDLE_ERROR_FORMAT;
+    if(hdr->hrtfInterpOption<-1 || hdr->hrtfInterpOption>(int)PROPOSED_HRTF_INTERP_TRIANGULAR) /* the lazy modes are never stored */
+        return PROPOSED_BUNDLE_ERROR_FORMAT;
+    for(section=0; section<PROPOSED_BUNDLE_NUM_SECTIONS; section++){
+        size = proposed_bundle_sectionSize(hdr, section);
+        if(hdr->offset[section] % PROPOSED_BUNDLE_ALIGNMENT != 0 || hdr->offset[section]<sizeof(proposed_bundle_header) ||
+           hdr->offset[section] + size > hdr->fileSize)
+            return PROPOSED_BUNDLE_ERROR_FORMAT;
+    }
+
+    /* The scanning grid indexes the array grid */
+    scan_idx = (const int*)(base + hdr->offset[PROPOSED_BUNDLE_SCAN_IDX]);
+    for(i=0; i<hdr->nScan; i++)
+        if(scan_idx[i]<0 || scan_idx[i]>=hdr->nDirs)
+            return PROPOSED_BUNDLE_ERROR_FORMAT;
+    return PROPOSED_BUNDLE_OK;
+}
+
+/* Destructor of array models that point into a mapped bundle */
+static void proposed_bundle_destroyModel
+(
+    void* model
+)
+{
+    proposed_array_model* m = (proposed_array_model*)model;
+    proposed_bundle_mapping* map = (proposed_bundle_mapping*)m->hBundle;
+
+    free(m->T); /* only the row pointers are allocated */
+    proposed_bundle_unmap(map);
+    free(map);
+    free(m);
+}
+
+proposed_array_model* proposed_bundle_load
+(
+    const char* path,
+    float* fs,
+    int* hopsize,
+    PROPOSED_BUNDLE_ERROR_CODES* error
+)
+{
+    proposed_bundle_mapping* map;
+    proposed_bundle_header hdr;
+    proposed_array_model* m;
+    char* base;
+    int band;
+
+    map = (proposed_bundle_mapping*)malloc1d(sizeof(proposed_bundle_mapping));
+    if(path==NULL || proposed_bundle_map(path, map)!=0){
+        free(map);
+        *error = PROPOSED_BUNDLE_ERROR_FILE;
+        return NULL;
+    }
+    base = (char*)map->base;
+    memcpy(&hdr, base, sizeof(proposed_bundle_header));
+    *error = proposed_bundle_validate(&hdr, base, map->size);
+    if(*error!=PROPOSED_BUNDLE_OK){
+        proposed_bundle_unmap(map);
+        free(map);
+        return NULL;
+    }
+    *fs = hdr.fs;
+    *hopsize = hdr.hopsize;
+
+    /* Another handle may already hold this model (loaded from this bundle, or from a copy of it) */
+    m = hdr.key!=0 ? (proposed_array_model*)proposed_cache_find(hdr.key) : NULL;
+    if(m!=NULL){
+        proposed_bundle_unmap(map);
+        free(map);
+        return m;
+    }
+
+    /* Otherwise, the model is made to point into the mapping */
+    m = proposed_arrayModel_create();
+    m->entry.key = hdr.key;
+    m->entry.destroy = &proposed_bundle_destroyModel;
+    m->hBundle = (void*)map;
+    m->nBands = hdr.nBands;
+    m->nMics = hdr.nMics;
+    m->nDirs = hdr.nDirs;
+    m->nScan = hdr.nScan;
+    m->freqVector = (float*)(base + hdr.offset[PROPOSED_BUNDLE_FREQ_VECTOR]);
+    m->array_dirs_deg = (float*)(base + hdr.offset[PROPOSED_BUNDLE_DIRS_DEG]);
+    m->array_dirs_xyz = (float*)(base + hdr.offset[PROPOSED_BUNDLE_DIRS_XYZ]);
+    m->W = (float*)(base + hdr.offset[PROPOSED_BUNDLE_W]);
+    m->DCM_array = (float_complex*)(base + hdr.offset[PROPOSED_BUNDLE_DCM]);
+    m->T = (float_complex**)malloc1d(hdr.nBands*sizeof(float_complex*));
+    for(band=0; band<hdr.nBands; band++)
+        m->T[band] = (float_complex*)(base + hdr.offset[PROPOSED_BUNDLE_T]) + band*hdr.nMics*hdr.nMics;
+    m->scan_dirs_deg = (float*)(base + hdr.offset[PROPOSED_BUNDLE_SCAN_DIRS_DEG]);
+    m->scan_dirs_xyz = (float*)(base + hdr.offset[PROPOSED_BUNDLE_SCAN_DIRS_XYZ]);
+    m->scan_idx = (int*)(base + hdr.offset[PROPOSED_BUNDLE_SCAN_IDX]);
+    m->H_scan_w = (float_complex*)(base + hdr.offset[PROPOSED_BUNDLE_H_SCAN_W]);
+    m->H_array = (float_complex*)(base + hdr.offset[PROPOSED_BUNDLE_H_ARRAY]);
+    m->hATF_SH = NULL;
+    m->H_bin = hdr.hrtfInterpOption<0 ? NULL : (float_complex*)(base + hdr.offset[PROPOSED_BUNDLE_H_BIN]);
+    m->hrtfInterpOption = hdr.hrtfInterpOption;
+    if(m->entry.key!=0)
+        m = (proposed_array_model*)proposed_cache_insert(&(m->entry));
+    return m;
+}
+
+PROPOSED_BUNDLE_ERROR_CODES proposed_bundle_save
+(
+    proposed_analysis_handle const hAna,
+    proposed_synthesis_handle const hSyn,
+    const char* path
+)
+{
+    proposed_analysis_data *a = (proposed_analysis_data*)(hAna);
+    proposed_synthesis_data *s = (proposed_synthesis_data*)(hSyn);
+    proposed_array_model* m;
+    proposed_bundle_header hdr;
+    const void* data[PROPOSED_BUNDLE_NUM_SECTIONS];
+    const char zeros[PROPOSED_BUNDLE_ALIGNMENT] = {0};
+    unsigned long long pos;
+    size_t size;
+    int section, dir, ok;
+    FILE* file;
+
+    if(a==NULL || path==NULL)
+        return PROPOSED_BUNDLE_ERROR_FILE;
+    m = a->model;
+    if(m->H_array==NULL) /* The SH representation of the ATFs cannot be stored */
+        return PROPOSED_BUNDLE_ERROR_UNSUPPORTED;
+    assert(s==NULL || s->model==m);
+
+    memset(&hdr, 0, sizeof(proposed_bundle_header));
+    memcpy(hdr.magic, PROPOSED_BUNDLE_MAGIC, sizeof(PROPOSED_BUNDLE_MAGIC));
+    hdr.version = PROPOSED_BUNDLE_VERSION;
+    hdr.byteOrder = PROPOSED_BUNDLE_BYTE_ORDER_MARK;
+    hdr.fs = a->fs;
+    hdr.hopsize = a->hopsize;
+    hdr.nBands = m->nBands;
+    hdr.nMics = m->nMics;
+    hdr.nDirs = m->nDirs;
+    hdr.nScan = m->nScan;
+    hdr.hrtfInterpOption = -1;
+    if(s!=NULL){
+        /* The tables are stored in full, so the lazy modes become their precomputed equivalents */
+        switch(s->interpOption){
+            case PROPOSED_HRTF_INTERP_NEAREST_LAZY:    hdr.hrtfInterpOption = (int)PROPOSED_HRTF_INTERP_NEAREST; break;
+            case PROPOSED_HRTF_INTERP_TRIANGULAR_LAZY: hdr.hrtfInterpOption = (int)PROPOSED_HRTF_INTERP_TRIANGULAR; break;
+            default:                                   hdr.hrtfInterpOption = (int)s->interpOption; break;
+        }
+    }
+
+    /* Key of the loaded model, which identifies both the array model and the HRTFs that are stored with it */
+    hdr.key = 0;
+    if(m->entry.key!=0){
+        hdr.key = proposed_cache_hash(m->entry.key, "bundle", 6);
+        hdr.key = proposed_cache_hash(hdr.key, &(hdr.hrtfInterpOption), sizeof(int));
+        for(dir=0; dir<hdr.nDirs && hdr.hrtfInterpOption>=0; dir++)
+            hdr.key = proposed_cache_hash(hdr.key, proposed_synthesis_getHRTF(s, dir), hdr.nBands*NUM_EARS*sizeof(float_complex));
+    }
+    pos = PROPOSED_BUNDLE_ALIGN(sizeof(proposed_bundle_header));
+    for(section=0; section<PROPOSED_BUNDLE_NUM_SECTIONS; section++){
+        hdr.offset[section] = pos;
+        pos = PROPOSED_BUNDLE_ALIGN(pos + proposed_bundle_sectionSize(&hdr, section));
+    }
+    hdr.fileSize = pos;
+
+    data[PROPOSED_BUNDLE_FREQ_VECTOR] = m->freqVector;
+    data[PROPOSED_BUNDLE_DIRS_DEG] = m->array_dirs_deg;
+    data[PROPOSED_BUNDLE_DIRS_XYZ] = m->array_dirs_xyz;
+    data[PROPOSED_BUNDLE_W] = m->W;
+    data[PROPOSED_BUNDLE_DCM] = m->DCM_array;
+    data[PROPOSED_BUNDLE_T] = m->T[0]; /* the rows are contiguous */
+    data[PROPOSED_BUNDLE_SCAN_DIRS_DEG] = m->scan_dirs_deg;
+    data[PROPOSED_BUNDLE_SCAN_DIRS_XYZ] = m->scan_dirs_xyz;
+    data[PROPOSED_BUNDLE_SCAN_IDX] = m->scan_idx;
+    data[PROPOSED_BUNDLE_H_SCAN_W] = m->H_scan_w;
+    data[PROPOSED_BUNDLE_H_ARRAY] = m->H_array;
+    data[PROPOSED_BUNDLE_H_BIN] = NULL; /* gathered per direction below */
+
+    file = fopen(path, "wb");
+    if(file==NULL)
+        return PROPOSED_BUNDLE_ERROR_FILE;
+    ok = fwrite(&hdr, sizeof(proposed_bundle_header), 1, file)==1;
+    pos = sizeof(proposed_bundle_header);
+    for(section=0; section<PROPOSED_BUNDLE_NUM_SECTIONS && ok; section++){
+        ok = fwrite(zeros, 1, (size_t)(hdr.offset[section]-pos), file)==(size_t)(hdr.offset[section]-pos);
+        size = proposed_bundle_sectionSize(&hdr, section);
+        if(section==PROPOSED_BUNDLE_H_BIN){
+            /* Also completes the tables of the lazy interpolation modes */
+            for(dir=0; dir<hdr.nDirs && size>0 && ok; dir++)
+                ok = fwrite(proposed_synthesis_getHRTF(s, dir), sizeof(float_complex), hdr.nBands*NUM_EARS, file)==(size_t)(hdr.nBands*NUM_EARS);
+        }
+        else if(size>0)
+            ok = ok && fwrite(data[section], 1, size, file)==size;
+        pos = hdr.offset[section] + size;
+    }
+    ok = ok && fwrite(zeros, 1, (size_t)(hdr.fileSize-pos), file)==(size_t)(hdr.fileSize-pos);
+    ok = (fclose(file)==0) && ok;
+    return ok ? PROPOSED_BUNDLE_OK : PROPOSED_BUNDLE_ERROR_FILE;
+}
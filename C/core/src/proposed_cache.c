@@ -0,0 +1,152 @@
+/**
+ * @file proposed_cache.c
+ * @ingroup PROPOSED
+ * @brief Process-wide cache of the read-only models of the proposed method
+ *
+ * Everything that proposed_analysis_create() and proposed_synthesis_create()
+ * precompute from the array IRs and HRIRs (ATFs, diffuse coherence and
+ * whitening matrices, interpolated HRTFs etc.) is read-only afterwards. When
+ * several renderers are created in one process for the same measurements and
+ * configuration, these models are therefore computed once and then shared,
+ * with each instance only allocating its own run-time state.
+ *
+ * Models are found by a hash of the data and parameters that they are computed
+ * from. A model is removed from the cache when its last reference is dropped,
+ * so the cache never holds on to memory which is no longer in use.
+ *
+ * @author agent
+ * @date 19th October 2026
+ */
+
+#include "proposed_internal.h"
+
+#if defined(_WIN32)
+# include <windows.h>
+static SRWLOCK proposed_cache_lock = SRWLOCK_INIT;
+# define PROPOSED_CACHE_LOCK()   AcquireSRWLockExclusive(&proposed_cache_lock)
+# define PROPOSED_CACHE_UNLOCK() ReleaseSRWLockExclusive(&proposed_cache_lock)
+#else
+# include <pthread.h>
+static pthread_mutex_t proposed_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+# define PROPOSED_CACHE_LOCK()   pthread_mutex_lock(&proposed_cache_lock)
+# define PROPOSED_CACHE_UNLOCK() pthread_mutex_unlock(&proposed_cache_lock)
+#endif
+
+/** FNV-1a 64-bit prime */
+#define PROPOSED_CACHE_HASH_PRIME ( 0x100000001b3ULL )
+
+/** Cached models (guarded by proposed_cache_lock) */
+static proposed_cache_entry* proposed_cache_head = NULL;
+
+unsigned long long proposed_cache_hash
+(
+    unsigned long long h,
+    const void* data,
+    size_t nBytes
+)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    unsigned int word;
+    size_t i;
+
+    /* The IRs are hashed in full, so 4 bytes are consumed per step */
+    for(i=0; i+4<=nBytes; i+=4){
+        memcpy(&word, &bytes[i], 4);
+        h = (h ^ (unsigned long long)word) * PROPOSED_CACHE_HASH_PRIME;
+    }
+    for(; i<nBytes; i++)
+        h = (h ^ (unsigned long long)bytes[i]) * PROPOSED_CACHE_HASH_PRIME;
+    return h;
+}
+
+void* proposed_cache_find
+(
+    unsigned long long key
+)
+{
+#ifdef PROPOSED_DISABLE_MODEL_CACHE
+    (void)key;
+    return NULL;
+#else
+    proposed_cache_entry* entry;
+
+    PROPOSED_CACHE_LOCK();
+    for(entry = proposed_cache_head; entry!=NULL; entry = entry->next){
+        if(entry->key==key){
+            entry->refCount++;
+            break;
+        }
+    }
+    PROPOSED_CACHE_UNLOCK();
+    return (void*)entry;
+#endif
+}
+
+void* proposed_cache_insert
+(
+    proposed_cache_entry* entry
+)
+{
+#ifdef PROPOSED_DISABLE_MODEL_CACHE
+    entry->key = 0;
+    return (void*)entry;
+#else
+    proposed_cache_entry* existing;
+
+    PROPOSED_CACHE_LOCK();
+    for(existing = proposed_cache_head; existing!=NULL; existing = existing->next)
+        if(existing->key==entry->key)
+            break;
+    if(existing!=NULL)
+        existing->refCount++;
+    else{
+        entry->next = proposed_cache_head;
+        proposed_cache_head = entry;
+    }
+    PROPOSED_CACHE_UNLOCK();
+
+    /* Another instance computed the same model in the meantime */
+    if(existing!=NULL){
+        entry->destroy((void*)entry);
+        return (void*)existing;
+    }
+    return (void*)entry;
+#endif
+}
+
+void proposed_cache_retain
+(
+    proposed_cache_entry* entry
+)
+{
+    PROPOSED_CACHE_LOCK();
+    entry->refCount++;
+    PROPOSED_CACHE_UNLOCK();
+}
+
+void proposed_cache_release
+(
+    proposed_cache_entry** const pEntry
+)
+{
+    proposed_cache_entry *entry, **link;
+    int isLast;
+
+    entry = *pEntry;
+    if(entry==NULL)
+        return;
+    PROPOSED_CACHE_LOCK();
+    isLast = --(entry->refCount)==0;
+    if(isLast){
+        for(link = &proposed_cache_head; (*link)!=NULL; link = &((*link)->next)){
+            if((*link)==entry){
+                (*link) = entry->next;
+                break;
+            }
+        }
+    }
+    PROPOSED_CACHE_UNLOCK();
+    if(isLast)
+        entry->destroy((void*)entry);
+    *pEntry = NULL;
+}
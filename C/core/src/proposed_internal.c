@@ -80,6 +80,558 @@ void proposed_findNearestGridIndices
     }
 }
 
+void proposed_toDirectionMajor
+(
+    const float_complex* in,
+    int nBands,
+    int nCH,
+    int nDirs,
+    float_complex* out
+)
+{
+    int band, ch, dir;
+
+    for(band=0; band<nBands; band++)
+        for(ch=0; ch<nCH; ch++)
+            for(dir=0; dir<nDirs; dir++)
+                out[(dir*nBands + band)*nCH + ch] = in[(band*nCH + ch)*nDirs + dir];
+}
+
+/** Grid of cells used to find the neighbours of each direction in proposed_getQuadratureWeights() */
+typedef struct _proposed_quadrature_job {
+    const float* xyz;                /**< Grid directions; FLAT: nDirs x 3 */
+    int nDirs;                       /**< Number of directions */
+    float cellSize;                  /**< Width of each cell */
+    int nCells;                      /**< Number of cells per dimension, spanning [-1 1] */
+    const int* cellStart;            /**< Index into cellDirs of the first direction of each cell; nCells^3+1 x 1 */
+    const int* cellDirs;             /**< Direction indices, sorted by cell; nDirs x 1 */
+    float* area;                     /**< Estimated (unnormalised) area of each direction; nDirs x 1 */
+
+} proposed_quadrature_job;
+
+/* Cell index of one coordinate */
+static int proposed_quadrature_cell
+(
+    const proposed_quadrature_job* job,
+    float x
+)
+{
+    int q = (int)((x + 1.0f)/job->cellSize);
+    return SAF_CLAMP(q, 0, job->nCells-1);
+}
+
+/* Estimates the area represented by one direction */
+static void proposed_quadrature_area
+(
+    void* ctx,
+    int dir,
+    int worker
+)
+{
+    proposed_quadrature_job* job = (proposed_quadrature_job*)ctx;
+    const float* p = &(job->xyz[dir*3]);
+    float knn[PROPOSED_QUADRATURE_KNN];
+    float d2, dx, dy, dz, sigma2, sum;
+    int c[3], q[3], r, R, i, k, n, nFound, cell;
+
+    (void)worker;
+    for(i=0; i<3; i++)
+        c[i] = proposed_quadrature_cell(job, p[i]);
+
+    /* Squared (chordal) distances to the nearest neighbours, searching shells of cells of increasing size. Directions
+     * outside of the shells searched so far are at least r*cellSize away, which ends the search */
+    nFound = 0;
+    for(r=0; r<=job->nCells; r++){
+        for(q[0]=c[0]-r; q[0]<=c[0]+r; q[0]++){
+            for(q[1]=c[1]-r; q[1]<=c[1]+r; q[1]++){
+                for(q[2]=c[2]-r; q[2]<=c[2]+r; q[2]++){
+                    if(SAF_MAX(SAF_MAX(abs(q[0]-c[0]), abs(q[1]-c[1])), abs(q[2]-c[2]))!=r ||
+                       q[0]<0 || q[1]<0 || q[2]<0 || q[0]>=job->nCells || q[1]>=job->nCells || q[2]>=job->nCells)
+                        continue;
+                    cell = (q[0]*(job->nCells) + q[1])*(job->nCells) + q[2];
+                    for(n=job->cellStart[cell]; n<job->cellStart[cell+1]; n++){
+                        if(job->cellDirs[n]==dir)
+                            continue;
+                        dx = job->xyz[job->cellDirs[n]*3]   - p[0];
+                        dy = job->xyz[job->cellDirs[n]*3+1] - p[1];
+                        dz = job->xyz[job->cellDirs[n]*3+2] - p[2];
+                        d2 = dx*dx + dy*dy + dz*dz;
+                        if(nFound==PROPOSED_QUADRATURE_KNN && d2>=knn[PROPOSED_QUADRATURE_KNN-1])
+                            continue;
+                        /* insertion into the sorted list */
+                        k = nFound<PROPOSED_QUADRATURE_KNN ? nFound++ : PROPOSED_QUADRATURE_KNN-1;
+                        for(; k>0 && knn[k-1]>d2; k--)
+                            knn[k] = knn[k-1];
+                        knn[k] = d2;
+                    }
+                }
+            }
+        }
+        if(nFound==PROPOSED_QUADRATURE_KNN && knn[PROPOSED_QUADRATURE_KNN-1] <= (float)(r*r)*(job->cellSize)*(job->cellSize))
+            break;
+    }
+    sigma2 = nFound>0 ? SAF_MAX(knn[nFound-1], 1e-12f) : 4.0f;
+
+    /* Gaussian kernel density, over the directions within 3 standard deviations. Since the kernel integrates to
+     * 2*pi*sigma^2 over the sphere (for small sigma), the area is that over the sum */
+    R = (int)(3.0f*sqrtf(sigma2)/(job->cellSize)) + 1;
+    sum = 0.0f;
+    for(q[0]=SAF_MAX(c[0]-R, 0); q[0]<=SAF_MIN(c[0]+R, job->nCells-1); q[0]++){
+        for(q[1]=SAF_MAX(c[1]-R, 0); q[1]<=SAF_MIN(c[1]+R, job->nCells-1); q[1]++){
+            for(q[2]=SAF_MAX(c[2]-R, 0); q[2]<=SAF_MIN(c[2]+R, job->nCells-1); q[2]++){
+                cell = (q[0]*(job->nCells) + q[1])*(job->nCells) + q[2];
+                for(n=job->cellStart[cell]; n<job->cellStart[cell+1]; n++){
+                    dx = job->xyz[job->cellDirs[n]*3]   - p[0];
+                    dy = job->xyz[job->cellDirs[n]*3+1] - p[1];
+                    dz = job->xyz[job->cellDirs[n]*3+2] - p[2];
+                    d2 = dx*dx + dy*dy + dz*dz;
+                    if(d2 < 9.0f*sigma2)
+                        sum += expf(-d2/(2.0f*sigma2));
+                }
+            }
+        }
+    }
+    job->area[dir] = 2.0f*SAF_PI*sigma2/sum; /* sum>=1, since it includes this direction */
+}
+
+void proposed_getQuadratureWeights
+(
+    float* dirs_deg,
+    int nDirs,
+    float* weights
+)
+{
+    proposed_quadrature_job job;
+    float* xyz;
+    int *cellStart, *cellDirs, *cellOf, *fill;
+    int i, nCells3;
+    float total, scale;
+
+    if(nDirs<PROPOSED_VORONOI_MAX_DIRS){
+        getVoronoiWeights(dirs_deg, nDirs, 0, weights);
+        return;
+    }
+
+    /* Cells about as wide as the expected nearest neighbour distance (cap area of K directions = K*4pi/nDirs) */
+    xyz = malloc1d(nDirs*3*sizeof(float));
+    unitSph2cart(dirs_deg, nDirs, 1, xyz);
+    job.xyz = xyz;
+    job.nDirs = nDirs;
+    job.cellSize = sqrtf(4.0f*(float)PROPOSED_QUADRATURE_KNN/(float)nDirs);
+    job.nCells = SAF_CLAMP((int)(2.0f/job.cellSize) + 1, 1, 128);
+    job.cellSize = 2.0f/(float)job.nCells;
+    nCells3 = job.nCells*job.nCells*job.nCells;
+
+    /* Sort the directions by cell (counting sort) */
+    cellStart = calloc1d(nCells3+1, sizeof(int));
+    cellDirs = malloc1d(nDirs*sizeof(int));
+    cellOf = malloc1d(nDirs*sizeof(int));
+    fill = malloc1d(nCells3*sizeof(int));
+    for(i=0; i<nDirs; i++){
+        cellOf[i] = (proposed_quadrature_cell(&job, xyz[i*3])*job.nCells + proposed_quadrature_cell(&job, xyz[i*3+1]))*job.nCells +
+                    proposed_quadrature_cell(&job, xyz[i*3+2]);
+        cellStart[cellOf[i]+1]++;
+    }
+    for(i=0; i<nCells3; i++){
+        cellStart[i+1] += cellStart[i];
+        fill[i] = cellStart[i];
+    }
+    for(i=0; i<nDirs; i++)
+        cellDirs[fill[cellOf[i]]++] = i;
+    job.cellStart = cellStart;
+    job.cellDirs = cellDirs;
+    job.area = weights;
+    proposed_parallel_for(nDirs, proposed_parallel_getNumWorkers(nDirs), &proposed_quadrature_area, (void*)&job);
+
+    /* Normalise to the area of the unit sphere */
+    total = 0.0f;
+    for(i=0; i<nDirs; i++)
+        total += weights[i];
+    scale = 4.0f*SAF_PI/total;
+    cblas_sscal(nDirs, scale, weights, 1);
+    free(xyz);
+    free(cellStart);
+    free(cellDirs);
+    free(cellOf);
+    free(fill);
+}
+
+/** Arguments and per-worker scratch of proposed_FIRtoFilterbankCoeffs() */
+typedef struct _proposed_FIRtoFB_job {
+    float* h;                        /**< Filters; FLAT: nDirs x nCH x irLen */
+    int nDirs, nCH, irLen, hopsize, nBands, directionMajor;
+    float scale;                     /**< Gain applied to the filters */
+    float_complex* out;              /**< Filterbank coefficients */
+    float* h_chunk[PROPOSED_MAX_INIT_THREADS];         /**< Scaled filters of one chunk, led by the first direction */
+    float_complex* H_chunk[PROPOSED_MAX_INIT_THREADS]; /**< Filterbank coefficients of one chunk */
+
+} proposed_FIRtoFB_job;
+
+static void proposed_FIRtoFilterbankCoeffs_chunk
+(
+    void* ctx,
+    int chunk,
+    int worker
+)
+{
+    proposed_FIRtoFB_job* job = (proposed_FIRtoFB_job*)ctx;
+    int band, i, j, dir, nChunk, len;
+    float* h_chunk = job->h_chunk[worker];
+    float_complex* H_chunk = job->H_chunk[worker];
+
+    dir = chunk*PROPOSED_INIT_CHUNK_DIRS;
+    nChunk = SAF_MIN(PROPOSED_INIT_CHUNK_DIRS, job->nDirs-dir);
+    len = job->nCH*(job->irLen);
+    utility_svsmul(job->h, &(job->scale), len, h_chunk);
+    utility_svsmul(&(job->h[dir*len]), &(job->scale), nChunk*len, &h_chunk[len]);
+    afSTFT_FIRtoFilterbankCoeffs(h_chunk, nChunk+1, job->nCH, job->irLen, job->hopsize, 1, 0, H_chunk);
+    for(band=0; band<job->nBands; band++){
+        for(i=0; i<job->nCH; i++){
+            for(j=0; j<nChunk; j++){
+                if(job->directionMajor)
+                    job->out[((dir+j)*(job->nBands) + band)*(job->nCH) + i] = H_chunk[(band*(job->nCH) + i)*(nChunk+1) + j+1];
+                else
+                    job->out[(band*(job->nCH) + i)*(job->nDirs) + dir+j] = H_chunk[(band*(job->nCH) + i)*(nChunk+1) + j+1];
+            }
+        }
+    }
+}
+
+void proposed_FIRtoFilterbankCoeffs
+(
+    float* h,
+    int nDirs,
+    int nCH,
+    int irLen,
+    int hopsize,
+    int nBands,
+    float scale,
+    int directionMajor,
+    float_complex* out
+)
+{
+    proposed_FIRtoFB_job job;
+    int w, nChunks, nWorkers;
+
+    job.h = h;
+    job.nDirs = nDirs;
+    job.nCH = nCH;
+    job.irLen = irLen;
+    job.hopsize = hopsize;
+    job.nBands = nBands;
+    job.directionMajor = directionMajor;
+    job.scale = scale;
+    job.out = out;
+    nChunks = (nDirs + PROPOSED_INIT_CHUNK_DIRS - 1)/PROPOSED_INIT_CHUNK_DIRS;
+    nWorkers = proposed_parallel_getNumWorkers(nChunks);
+    for(w=0; w<nWorkers; w++){
+        job.h_chunk[w] = malloc1d((PROPOSED_INIT_CHUNK_DIRS+1)*nCH*irLen*sizeof(float));
+        job.H_chunk[w] = malloc1d(nBands*nCH*(PROPOSED_INIT_CHUNK_DIRS+1)*sizeof(float_complex));
+    }
+    proposed_parallel_for(nChunks, nWorkers, &proposed_FIRtoFilterbankCoeffs_chunk, (void*)&job);
+    for(w=0; w<nWorkers; w++){
+        free(job.h_chunk[w]);
+        free(job.H_chunk[w]);
+    }
+}
+
+float_complex* proposed_signal_container_getCx
+(
+    proposed_signal_container_data* scon,
+    int band
+)
+{
+    const float_complex calpha = cmplxf(1.0f, 0.0f); const float_complex cbeta = cmplxf(0.0f, 0.0f); /* blas */
+
+    if(!scon->Cx_isValid[band]){
+        cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, scon->nMics, scon->nMics, scon->timeSlots, &calpha,
+                    FLATTEN2D(scon->inTF[band]), scon->timeSlots,
+                    FLATTEN2D(scon->inTF[band]), scon->timeSlots, &cbeta,
+                    scon->Cx[band].Cx, scon->nMics);
+        scon->Cx_isValid[band] = 1;
+    }
+    return scon->Cx[band].Cx;
+}
+
+static void proposed_arrayModel_destroy
+(
+    void* model
+)
+{
+    proposed_array_model* m = (proposed_array_model*)model;
+
+    free(m->freqVector);
+    free(m->array_dirs_deg);
+    free(m->array_dirs_xyz);
+    free(m->H_array);
+    proposed_atfSH_destroy(&(m->hATF_SH));
+    free(m->DCM_array);
+    free(m->W);
+    free(m->T);
+    free(m->scan_dirs_deg);
+    free(m->scan_dirs_xyz);
+    free(m->scan_idx);
+    free(m->H_scan_w);
+    free(m);
+}
+
+proposed_array_model* proposed_arrayModel_create(void)
+{
+    proposed_array_model* model = (proposed_array_model*)calloc1d(1, sizeof(proposed_array_model));
+    model->entry.refCount = 1;
+    model->entry.destroy = &proposed_arrayModel_destroy;
+    return model;
+}
+
+proposed_array_model* proposed_arrayModel_retain
+(
+    proposed_array_model* model
+)
+{
+    if(model!=NULL)
+        proposed_cache_retain(&(model->entry));
+    return model;
+}
+
+void proposed_arrayModel_release
+(
+    proposed_array_model** const pModel
+)
+{
+    proposed_cache_entry* entry;
+
+    if((*pModel) != NULL){
+        entry = &((*pModel)->entry);
+        proposed_cache_release(&entry);
+        *pModel = NULL;
+    }
+}
+
+static void proposed_hrtfModel_destroy
+(
+    void* model
+)
+{
+    proposed_hrtf_model* m = (proposed_hrtf_model*)model;
+
+    free(m->H_bin);
+    free(m);
+}
+
+proposed_hrtf_model* proposed_hrtfModel_create(void)
+{
+    proposed_hrtf_model* model = (proposed_hrtf_model*)calloc1d(1, sizeof(proposed_hrtf_model));
+    model->entry.refCount = 1;
+    model->entry.destroy = &proposed_hrtfModel_destroy;
+    return model;
+}
+
+void proposed_hrtfModel_release
+(
+    proposed_hrtf_model** const pModel
+)
+{
+    proposed_cache_entry* entry;
+
+    if((*pModel) != NULL){
+        entry = &((*pModel)->entry);
+        proposed_cache_release(&entry);
+        *pModel = NULL;
+    }
+}
+
+typedef struct _atfSH_data {
+    int nBands;                      /**< Number of bands */
+    int nMics;                       /**< Number of microphones */
+    int nDirs;                       /**< Number of grid directions */
+    int maxOrder;                    /**< Highest order used by any band */
+    int* order;                      /**< SH order per band, or -1 if the band is stored uncompressed; nBands x 1 */
+    float* fitError;                 /**< Normalised squared fitting error per band (0 if uncompressed); nBands x 1 */
+    int* offset;                     /**< Offset of each band into C; nBands x 1 */
+    float* C;                        /**< Real and imaginary SH coefficients per band (or ATFs, if uncompressed); FLAT: sum_band (2 x nMics x (order[band]+1)^2, or 2 x nMics x nDirs) */
+    float* Y;                        /**< Real SH evaluated at the grid directions; FLAT: nDirs x (maxOrder+1)^2 */
+
+}atfSH_data;
+
+void proposed_atfSH_create
+(
+    void** const phSH,
+    const float_complex* H_array,
+    float* dirs_deg,
+    int nBands,
+    int nMics,
+    int nDirs,
+    float maxFitError
+)
+{
+    *phSH = malloc1d(sizeof(atfSH_data));
+    atfSH_data *h = (atfSH_data*)(*phSH);
+    int band, i, j, order, order_lim, nSH, nSH_lim, nSH_max, nCoeffs, nStored;
+    float err, nrm;
+    float *Y, *H_ri, *H_fit, *C_ri;
+    float** pinvY;
+
+    h->nBands = nBands;
+    h->nMics = nMics;
+    h->nDirs = nDirs;
+    h->order = malloc1d(nBands*sizeof(int));
+    h->fitError = malloc1d(nBands*sizeof(float));
+    h->offset = malloc1d(nBands*sizeof(int));
+    h->C = NULL;
+
+    /* The number of SH may not exceed the number of grid directions */
+    order_lim = SAF_MAX(SAF_MIN(PROPOSED_ATF_SH_MAX_ORDER, (int)sqrtf((float)nDirs)-1), 0);
+    nSH_lim = ORDER2NSH(order_lim);
+    Y = malloc1d(nSH_lim*nDirs*sizeof(float));
+    getRSH(order_lim, dirs_deg, nDirs, Y); /* nSH_lim x nDirs; the first (N+1)^2 rows being the order N SH */
+
+    /* Real and imaginary parts are fitted together, as a 2nMics x nDirs real matrix */
+    H_ri = malloc1d(2*nMics*nDirs*sizeof(float));
+    H_fit = malloc1d(2*nMics*nDirs*sizeof(float));
+    C_ri = malloc1d(2*nMics*nSH_lim*sizeof(float));
+    pinvY = (float**)calloc1d(order_lim+1, sizeof(float*)); /* computed upon first use, per order */
+    nCoeffs = 0;
+    for(band=0; band<nBands; band++){
+        for(i=0; i<nMics; i++){
+            for(j=0; j<nDirs; j++){
+                H_ri[i*nDirs+j]         = crealf(H_array[(j*nBands + band)*nMics + i]);
+                H_ri[(nMics+i)*nDirs+j] = cimagf(H_array[(j*nBands + band)*nMics + i]);
+            }
+        }
+        nrm = cblas_snrm2(2*nMics*nDirs, H_ri, 1);
+        nrm = nrm*nrm + 2.23e-20f;
+
+        /* Least-squares fit, increasing the order until the fitting error is small enough (or the order limit is reached) */
+        for(order=0;; order++){
+            nSH = ORDER2NSH(order);
+            if(pinvY[order]==NULL){
+                pinvY[order] = malloc1d(nDirs*nSH*sizeof(float));
+                utility_spinv(NULL, Y, nSH, nDirs, pinvY[order]);
+            }
+            cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, 2*nMics, nSH, nDirs, 1.0f,
+                        H_ri, nDirs,
+                        pinvY[order], nSH, 0.0f,
+                        C_ri, nSH);
+            cblas_scopy(2*nMics*nDirs, H_ri, 1, H_fit, 1);
+            cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, 2*nMics, nDirs, nSH, -1.0f,
+                        C_ri, nSH,
+                        Y, nDirs, 1.0f,
+                        H_fit, nDirs);
+            err = cblas_snrm2(2*nMics*nDirs, H_fit, 1);
+            if(err*err/nrm <= maxFitError || order==order_lim)
+                break;
+        }
+
+        /* Store the coefficients, or the ATFs themselves if even the highest order does not fit them well enough */
+        h->offset[band] = nCoeffs;
+        if(err*err/nrm <= maxFitError){
+            h->order[band] = order;
+            h->fitError[band] = err*err/nrm;
+            nStored = 2*nMics*nSH;
+        }
+        else{
+            h->order[band] = -1;
+            h->fitError[band] = 0.0f;
+            nStored = 2*nMics*nDirs;
+        }
+        nCoeffs += nStored;
+        h->C = realloc1d(h->C, nCoeffs*sizeof(float));
+        cblas_scopy(nStored, h->order[band]<0 ? H_ri : C_ri, 1, &(h->C[h->offset[band]]), 1);
+    }
+
+    /* Only the SH up to the highest order used are kept, direction-major */
+    h->maxOrder = 0;
+    for(band=0; band<nBands; band++)
+        h->maxOrder = SAF_MAX(h->maxOrder, h->order[band]);
+    nSH_max = ORDER2NSH(h->maxOrder);
+    h->Y = malloc1d(nDirs*nSH_max*sizeof(float));
+    for(i=0; i<nSH_max; i++)
+        for(j=0; j<nDirs; j++)
+            h->Y[j*nSH_max+i] = Y[i*nDirs+j];
+
+    /* clean-up */
+    for(i=0; i<=order_lim; i++)
+        free(pinvY[i]);
+    free(pinvY);
+    free(Y);
+    free(H_ri);
+    free(H_fit);
+    free(C_ri);
+}
+
+void proposed_atfSH_destroy
+(
+    void** const phSH
+)
+{
+    atfSH_data *h = (atfSH_data*)(*phSH);
+
+    if (h != NULL) {
+        free(h->order);
+        free(h->fitError);
+        free(h->offset);
+        free(h->C);
+        free(h->Y);
+        free(h);
+        h = NULL;
+        *phSH = NULL;
+    }
+}
+
+void proposed_atfSH_getATFs
+(
+    void* const hSH,
+    int band,
+    const int* dir_idx,
+    int nIdx,
+    float_complex* H
+)
+{
+    atfSH_data *h = (atfSH_data*)(hSH);
+    int i, j, nSH, nSH_max;
+    const float *C_re, *C_im, *y;
+
+    /* Uncompressed band */
+    if(h->order[band]<0){
+        C_re = &(h->C[h->offset[band]]);
+        C_im = &(C_re[(h->nMics)*(h->nDirs)]);
+        for(j=0; j<nIdx; j++)
+            for(i=0; i<h->nMics; i++)
+                H[i*nIdx+j] = cmplxf(C_re[i*(h->nDirs)+dir_idx[j]], C_im[i*(h->nDirs)+dir_idx[j]]);
+        return;
+    }
+
+    nSH = ORDER2NSH(h->order[band]);
+    nSH_max = ORDER2NSH(h->maxOrder);
+    C_re = &(h->C[h->offset[band]]);
+    C_im = &(C_re[(h->nMics)*nSH]);
+    for(j=0; j<nIdx; j++){
+        y = &(h->Y[dir_idx[j]*nSH_max]);
+        for(i=0; i<h->nMics; i++)
+            H[i*nIdx+j] = cmplxf(cblas_sdot(nSH, &C_re[i*nSH], 1, y, 1), cblas_sdot(nSH, &C_im[i*nSH], 1, y, 1));
+    }
+}
+
+int proposed_atfSH_getOrder
+(
+    void* const hSH,
+    int band
+)
+{
+    atfSH_data *h = (atfSH_data*)(hSH);
+    return h->order[band];
+}
+
+float proposed_atfSH_getFitError
+(
+    void* const hSH,
+    int band
+)
+{
+    atfSH_data *h = (atfSH_data*)(hSH);
+    return h->fitError[band];
+}
+
 typedef struct _array2binauralMagLS_data {
     float_complex** invAA_H;
     float_complex *M, *H_mod, *H_mod_gains;
@@ -87,6 +639,39 @@ typedef struct _array2binauralMagLS_data {
     
 }array2binauralMagLS_data;
 
+/** Arguments of proposed_array2binauralMagLS_invBand() */
+typedef struct _array2binauralMagLS_job {
+    array2binauralMagLS_data* h;
+    float_complex* ATFs;
+    int nMics, nDirs;
+
+} array2binauralMagLS_job;
+
+/* Computes inv(A*A^H) for one band */
+static void proposed_array2binauralMagLS_invBand
+(
+    void* ctx,
+    int band,
+    int worker
+)
+{
+    array2binauralMagLS_job* job = (array2binauralMagLS_job*)ctx;
+    int i, nMics, nDirs;
+    float_complex AAH[PROPOSED_MAX_NMICS*PROPOSED_MAX_NMICS];
+    const float_complex calpha = cmplxf(1.0f, 0.0f); const float_complex cbeta = cmplxf(0.0f, 0.0f);
+
+    (void)worker;
+    nMics = job->nMics;
+    nDirs = job->nDirs;
+    cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, nMics, nMics, nDirs, &calpha,
+                &(job->ATFs[band*nMics*nDirs]), nDirs,
+                &(job->ATFs[band*nMics*nDirs]), nDirs, &cbeta,
+                AAH, nMics);
+    for(i=0; i<nMics; i++)
+        AAH[i*nMics+i] = craddf(AAH[i*nMics+i], 0.0001f);
+    utility_cinv(NULL, AAH, job->h->invAA_H[band], nMics);
+}
+
 void proposed_array2binauralMagLS_create
 (
     void** phA2B,
@@ -98,9 +683,7 @@ void proposed_array2binauralMagLS_create
 {
     *phA2B = malloc1d(sizeof(array2binauralMagLS_data));
     array2binauralMagLS_data *h = (array2binauralMagLS_data*)(*phA2B);
-    int i, band;
-    float_complex AAH[PROPOSED_MAX_NMICS*PROPOSED_MAX_NMICS];
-    const float_complex calpha = cmplxf(1.0f, 0.0f); const float_complex cbeta = cmplxf(0.0f, 0.0f);
+    array2binauralMagLS_job job;
     
     h->AWHH = malloc1d(nMics*nMics*sizeof(float_complex));
     h->AW = malloc1d(nMics*nDirs*sizeof(float_complex));
@@ -110,15 +693,11 @@ void proposed_array2binauralMagLS_create
     
     /* Precompute the inverse A*A^H matrices */
     h->invAA_H = (float_complex**)malloc2d(nBands, nMics*nMics, sizeof(float_complex));
-    for (band=0; band<nBands; band++){
-        cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, nMics, nMics, nDirs, &calpha,
-                    &ATFs[band*nMics*nDirs], nDirs,
-                    &ATFs[band*nMics*nDirs], nDirs, &cbeta,
-                    AAH, nMics);
-        for(i=0; i<nMics; i++)
-            AAH[i*nMics+i] = craddf(AAH[i*nMics+i], 0.0001f);
-        utility_cinv(NULL, AAH, h->invAA_H[band], nMics);
-    }
+    job.h = h;
+    job.ATFs = ATFs;
+    job.nMics = nMics;
+    job.nDirs = nDirs;
+    proposed_parallel_for(nBands, proposed_parallel_getNumWorkers(nBands), &proposed_array2binauralMagLS_invBand, (void*)&job);
 }
 
 void proposed_array2binauralMagLS_destroy
@@ -239,23 +818,22 @@ void proposed_getInterpolatedHRTFs
     proposed_analysis_data *a = (proposed_analysis_data*)(hAna);
     int band, i, j, ntable, ntri;
     int* idx;
-    float* itds_s, *interpTable, *w;
+    float* itds_s, *interpTable, *w, *w_tmp;
     float_complex*** hrtf_fb;    /* nBands x NUM_EARS x N_dirs */
 
     /* Pass HRIRs through the filterbank */
     hrtf_fb = (float_complex***)malloc3d(a->nBands, NUM_EARS, binConfig->nHRIR, sizeof(float_complex));
-    HRIRs2HRTFs_afSTFT(binConfig->hrirs, binConfig->nHRIR, binConfig->lHRIR, a->hopsize, 1, 0, FLATTEN3D(hrtf_fb));
+    proposed_FIRtoFilterbankCoeffs(binConfig->hrirs, binConfig->nHRIR, NUM_EARS, binConfig->lHRIR, a->hopsize, a->nBands, 1.0f, 0, FLATTEN3D(hrtf_fb));
 
-    /* Integration weights */
-    if (cblas_sasum(nTargetDirs, target_dirs_deg+1, 2)/(float)nTargetDirs<0.0001)
-        w = NULL;
-    else{
-        if(nTargetDirs<1200){
-            w = malloc1d(nTargetDirs*sizeof(float));
-            getVoronoiWeights(target_dirs_deg, nTargetDirs, 0, w);
+    /* Integration weights (those of the array grid are already in the model) */
+    w = w_tmp = NULL;
+    if (cblas_sasum(nTargetDirs, target_dirs_deg+1, 2)/(float)nTargetDirs>=0.0001){
+        if(target_dirs_deg==a->array_dirs_deg)
+            w = a->model->W;
+        else{
+            w = w_tmp = malloc1d(nTargetDirs*sizeof(float));
+            proposed_getQuadratureWeights(target_dirs_deg, nTargetDirs, w);
         }
-        else
-            w=NULL;
     }
 
     /* estimate the ITDs for each HRIR */
@@ -265,6 +843,7 @@ void proposed_getInterpolatedHRTFs
     /* Apply HRTF interpolation */
     switch(interpOption){
         case PROPOSED_HRTF_INTERP_NEAREST:
+        case PROPOSED_HRTF_INTERP_NEAREST_LAZY:
             /* Quantise to nearest hrir direction */
             idx = malloc1d(nTargetDirs*sizeof(int));
             findClosestGridPoints(binConfig->hrir_dirs_deg, binConfig->nHRIR, target_dirs_deg, nTargetDirs, 1, idx, NULL, NULL);
@@ -279,6 +858,7 @@ void proposed_getInterpolatedHRTFs
             break;
 
         case PROPOSED_HRTF_INTERP_TRIANGULAR:
+        case PROPOSED_HRTF_INTERP_TRIANGULAR_LAZY:
             /* Interpolation table */
             interpTable = NULL;
             generateVBAPgainTable3D_srcs(target_dirs_deg, nTargetDirs, binConfig->hrir_dirs_deg, binConfig->nHRIR, 0, 0, 0.0f, &interpTable, &ntable, &ntri);
@@ -298,7 +878,92 @@ void proposed_getInterpolatedHRTFs
     /* Clean-up */
     free(itds_s);
     free(hrtf_fb);
-    free(w);
+    free(w_tmp);
+}
+
+void proposed_getLazyHRTFData
+(
+    proposed_analysis_handle const hAna,
+    PROPOSED_HRTF_INTERP_OPTIONS interpOption,
+    proposed_binaural_config* binConfig,
+    float* target_dirs_deg,
+    int nTargetDirs,
+    int ENABLE_DIFF_EQ,
+    float_complex* hrtf_meas,
+    float* itds_s,
+    int* interp_idx,
+    float* interp_w,
+    float* dfEQ
+)
+{
+    proposed_analysis_data *a = (proposed_analysis_data*)(hAna);
+    int band, i, j, k, c0, nChunk, ntable, ntri;
+    int* idx;
+    float before, after;
+    float* interpTable;
+    float_complex* hrtf_eq;
+
+    /* Pass HRIRs through the filterbank */
+    proposed_FIRtoFilterbankCoeffs(binConfig->hrirs, binConfig->nHRIR, NUM_EARS, binConfig->lHRIR, a->hopsize, a->nBands, 1.0f, 0, hrtf_meas);
+
+    /* estimate the ITDs for each HRIR */
+    estimateITDs(binConfig->hrirs, binConfig->nHRIR, binConfig->lHRIR, binConfig->hrir_fs, itds_s);
+
+    /* Diffuse-field EQ gains, taken as the gain that diffuseFieldEqualiseHRTFs() applies to the measured set */
+    for(band=0; band<a->nBands*NUM_EARS; band++)
+        dfEQ[band] = 1.0f;
+    if(ENABLE_DIFF_EQ){
+        hrtf_eq = malloc1d(a->nBands*NUM_EARS*(binConfig->nHRIR)*sizeof(float_complex));
+        memcpy(hrtf_eq, hrtf_meas, a->nBands*NUM_EARS*(binConfig->nHRIR)*sizeof(float_complex));
+        diffuseFieldEqualiseHRTFs(binConfig->nHRIR, itds_s, a->freqVector, a->nBands, NULL, 1, 0, hrtf_eq);
+        for(band=0; band<a->nBands; band++){
+            for(i=0; i<NUM_EARS; i++){
+                before = cblas_scasum(binConfig->nHRIR, &hrtf_meas[(band*NUM_EARS + i)*(binConfig->nHRIR)], 1);
+                after  = cblas_scasum(binConfig->nHRIR, &hrtf_eq[(band*NUM_EARS + i)*(binConfig->nHRIR)], 1);
+                dfEQ[band*NUM_EARS + i] = before > 0.0f ? after/before : 1.0f;
+            }
+        }
+        free(hrtf_eq);
+    }
+
+    /* Up to 3 HRTFs (and their weights) per target direction */
+    memset(interp_idx, 0, nTargetDirs*3*sizeof(int));
+    memset(interp_w, 0, nTargetDirs*3*sizeof(float));
+    switch(interpOption){
+        default:
+        case PROPOSED_HRTF_INTERP_NEAREST:
+        case PROPOSED_HRTF_INTERP_NEAREST_LAZY:
+            /* Quantise to nearest hrir direction */
+            idx = malloc1d(nTargetDirs*sizeof(int));
+            findClosestGridPoints(binConfig->hrir_dirs_deg, binConfig->nHRIR, target_dirs_deg, nTargetDirs, 1, idx, NULL, NULL);
+            for(j=0; j<nTargetDirs; j++){
+                interp_idx[j*3] = idx[j];
+                interp_w[j*3] = 1.0f;
+            }
+            free(idx);
+            break;
+
+        case PROPOSED_HRTF_INTERP_TRIANGULAR:
+        case PROPOSED_HRTF_INTERP_TRIANGULAR_LAZY:
+            /* Interpolation tables are computed in chunks, to keep the (dense) tables small */
+            for(c0=0; c0<nTargetDirs; c0+=PROPOSED_LAZY_HRTF_CHUNK){
+                nChunk = SAF_MIN(PROPOSED_LAZY_HRTF_CHUNK, nTargetDirs-c0);
+                interpTable = NULL;
+                generateVBAPgainTable3D_srcs(&target_dirs_deg[c0*2], nChunk, binConfig->hrir_dirs_deg, binConfig->nHRIR, 0, 0, 0.0f, &interpTable, &ntable, &ntri);
+                VBAPgainTable2InterpTable(interpTable, nChunk, binConfig->nHRIR);
+                for(j=0; j<nChunk; j++){
+                    for(i=0, k=0; i<binConfig->nHRIR && k<3; i++){
+                        if(interpTable[j*(binConfig->nHRIR)+i] > 0.0f){
+                            interp_idx[(c0+j)*3+k] = i;
+                            interp_w[(c0+j)*3+k] = interpTable[j*(binConfig->nHRIR)+i];
+                            k++;
+                        }
+                    }
+                }
+                free(interpTable);
+            }
+            break;
+    }
 }
 
 /** Internal data structure for sdMUSIC */
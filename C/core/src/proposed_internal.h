@@ -54,6 +54,8 @@
 
 #include "proposed_analysis.h"
 #include "proposed_synthesis.h"
+#include "proposed_rtguard.h"
+#include "proposed_trace.h"
 #include "saf.h"
 #include "saf_externals.h"
 
@@ -61,6 +63,16 @@
 extern "C" {
 #endif /* __cplusplus */
 
+#ifdef PROPOSED_ENABLE_RT_GUARD
+/* Violations made from within these LAPACK-backed SAF utility functions are reported as such (see proposed_rtguard.h) */
+# define utility_cseig(...)  ( proposed_rtguard_setWrapper("utility_cseig"),  utility_cseig(__VA_ARGS__),  proposed_rtguard_setWrapper(NULL) )
+# define utility_cinv(...)   ( proposed_rtguard_setWrapper("utility_cinv"),   utility_cinv(__VA_ARGS__),   proposed_rtguard_setWrapper(NULL) )
+# define utility_cpinv(...)  ( proposed_rtguard_setWrapper("utility_cpinv"),  utility_cpinv(__VA_ARGS__),  proposed_rtguard_setWrapper(NULL) )
+# define utility_spinv(...)  ( proposed_rtguard_setWrapper("utility_spinv"),  utility_spinv(__VA_ARGS__),  proposed_rtguard_setWrapper(NULL) )
+# define utility_csvd(...)   ( proposed_rtguard_setWrapper("utility_csvd"),   utility_csvd(__VA_ARGS__),   proposed_rtguard_setWrapper(NULL) )
+# define utility_cglslv(...) ( proposed_rtguard_setWrapper("utility_cglslv"), utility_cglslv(__VA_ARGS__), proposed_rtguard_setWrapper(NULL) )
+#endif
+
 /** Maximum supported blocksize */
 #define PROPOSED_MAX_BLOCKSIZE ( 4096 )
 
@@ -76,6 +88,153 @@ extern "C" {
 /** +/- elevation window when scanning for DoA, [10..90] */
 #define PROPOSED_ELEV_SCANNING_WINDOW_DEG ( 20.0f )
 
+/** Number of directions per interpolation table, when preparing the lazy HRTF interpolation */
+#define PROPOSED_LAZY_HRTF_CHUNK ( 256 )
+
+/** Number of array IR directions converted to the filterbank domain at a time, during initialisation */
+#define PROPOSED_INIT_CHUNK_DIRS ( 64 )
+
+/** Highest spherical harmonic order used to represent the array ATFs (see proposed_atfSH_create()) */
+#define PROPOSED_ATF_SH_MAX_ORDER ( 20 )
+
+/** Grids with fewer directions than this get exact Voronoi integration weights (see proposed_getQuadratureWeights()) */
+#define PROPOSED_VORONOI_MAX_DIRS ( 1200 )
+
+/** Number of nearest neighbours that set the kernel width of the fast integration weights */
+#define PROPOSED_QUADRATURE_KNN ( 24 )
+
+/** Maximum number of threads used during initialisation (see proposed_setMaxInitThreads()) */
+#define PROPOSED_MAX_INIT_THREADS ( 16 )
+
+/** Memory arena holding the run-time state of one object (see proposed_arena_create()) */
+typedef struct _proposed_arena proposed_arena;
+
+/**
+ * Work function for proposed_parallel_for(); processes one index, using the
+ * scratch memory of the given worker [0..nWorkers-1]
+ */
+typedef void (*proposed_parallelFn)(void* ctx, int index, int worker);
+
+/**
+ * Mixing kernel: for each band, blends M = gain_par*M_par + gain_lin*M_lin and
+ * then computes outTF = M * inTF
+ *
+ * All matrices are band-major and contiguous. M_par, M_lin and M are
+ * nBands x #NUM_EARS x nMics, inTF is nBands x nMics x timeSlots and outTF is
+ * nBands x #NUM_EARS x timeSlots.
+ */
+typedef void (*proposed_mixKernel)(int nBands,
+                                   int nMics,
+                                   int timeSlots,
+                                   const float* gain_par,
+                                   const float* gain_lin,
+                                   const float_complex* M_par,
+                                   const float_complex* M_lin,
+                                   const float_complex* inTF,
+                                   float_complex* M,
+                                   float_complex* outTF);
+
+/** Instruction sets supported by the mixing kernels */
+typedef enum {
+    PROPOSED_KERNEL_ISA_SCALAR = 0, /**< Portable C implementation */
+    PROPOSED_KERNEL_ISA_AVX2,       /**< AVX2 + FMA */
+    PROPOSED_KERNEL_ISA_AVX512      /**< AVX-512F */
+} PROPOSED_KERNEL_ISA;
+
+/**
+ * Fixed-size small-matrix kernels for one number of microphones, N
+ *
+ * Generated for the commonly deployed array sizes (see
+ * proposed_kernels_getSmallMat()); all matrices are row-major.
+ */
+typedef struct _proposed_smallmat_kernels {
+    int nMics;                       /**< Number of microphones, N */
+    /** T_Cx_TH = T * Cx * T^H; N x N */
+    void (*whiten)(const float_complex* T, const float_complex* Cx, float_complex* T_Cx_TH);
+    /** Hermitian eigenvalue decomposition (Jacobi), eigenvalues in decending order; N x N */
+    void (*eigh)(const float_complex* A, float_complex* V, float* lambda);
+    /** Hermitian positive-definite inverse (Cholesky); returns 0 on success; N x N */
+    int  (*invHPD)(const float_complex* A, float_complex* invA);
+    /** Ds = inv(As^H*invCx*As)*As^H*invCx; K x N, and Dd = I - As*Ds; N x N, indexed by K-1 */
+    void (*sourceFilters[PROPOSED_MAX_K])(const float_complex* As, const float_complex* invCx, float_complex* Ds, float_complex* Dd);
+    /** out = h_dir * Ds; #NUM_EARS x N, indexed by K-1 */
+    void (*sourceStream[PROPOSED_MAX_K])(const float_complex* h_dir, const float_complex* Ds, float_complex* out);
+    /** out = M_lin * Dd; #NUM_EARS x N */
+    void (*ambientStream)(const float_complex* M_lin, const float_complex* Dd, float_complex* out);
+} proposed_smallmat_kernels;
+
+/** Seed for proposed_cache_hash() */
+#define PROPOSED_CACHE_HASH_SEED ( 0xcbf29ce484222325ULL )
+
+/**
+ * Header of a reference-counted, read-only model, which may be shared by any
+ * number of handles in the process (see proposed_cache_find())
+ *
+ * This must be the first member of the model struct.
+ */
+typedef struct _proposed_cache_entry {
+    int refCount;                          /**< Number of handles holding this model */
+    unsigned long long key;                /**< Hash of everything the model is computed from (0: not cached) */
+    void (*destroy)(void* model);          /**< Frees the model once the last reference is dropped */
+    struct _proposed_cache_entry* next;    /**< Next model in the cache */
+
+}proposed_cache_entry;
+
+/**
+ * Read-only description of the microphone array, which is shared between the
+ * analysers created for the same array IRs and configuration, and the
+ * synthesisers created from them
+ *
+ * It is built by proposed_analysis_create(), or mapped from a bundle by
+ * proposed_analysis_createFromBundle(), and must not be modified once it has
+ * been inserted into the cache.
+ */
+typedef struct _proposed_array_model {
+    proposed_cache_entry entry;      /**< Reference count and cache key */
+    int nBands;                      /**< Number of frequency bands */
+    int nMics;                       /**< Number of microphones */
+    int nDirs;                       /**< Number of measurement directions */
+    float* freqVector;               /**< Centre frequencies; nBands x 1 */
+    float* array_dirs_deg;           /**< Array grid dirs in degrees; FLAT: nDirs x 2 */
+    float* array_dirs_xyz;           /**< Array grid dirs as Cartesian coordinates of unit length; FLAT: nDirs x 3 */
+    float_complex* H_array;          /**< Array IRs in the frequency domain, direction-major; FLAT: nDirs x nBands x nMics (NULL if hATF_SH is used instead) */
+    void* hATF_SH;                   /**< Spherical harmonic representation of the array IRs (NULL if H_array is used instead) */
+    float_complex* DCM_array;        /**< Diffuse covariance matrix (computed over all grid directions); FLAT: nBands x nMics x nMics */
+    float* W;                        /**< Diffuse integration weights, i.e. the diagonal of the weighting matrix; nDirs x 1 */
+    float_complex** T;               /**< Spatial whitening matrix per band; nBands x (nMics x nMics) */
+    int nScan;                       /**< Number of scanning directions */
+    float* scan_dirs_deg;            /**< Scanning grid dirs in degrees; FLAT: nScan x 2 */
+    float* scan_dirs_xyz;            /**< Scanning grid dirs in Cartesian coordinates; FLAT: nScan x 3 */
+    int* scan_idx;                   /**< Scanning grid indices into the array grid; nScan x 1 */
+    float_complex* H_scan_w;         /**< Whitened array IRs of the scanning grid; FLAT: nBands x nMics x nScan */
+    void* hBundle;                   /**< Memory-mapped bundle that the arrays above point into (NULL if they are allocated), see proposed_bundle_load() */
+    float_complex* H_bin;            /**< HRTFs stored in the bundle, direction-major; FLAT: nDirs x nBands x #NUM_EARS (NULL if there are none) */
+    int hrtfInterpOption;            /**< #PROPOSED_HRTF_INTERP_OPTIONS that H_bin was computed with */
+
+}proposed_array_model;
+
+/**
+ * Interpolated HRTFs for the array grid, which are shared between the
+ * synthesisers created for the same array model, HRIRs and HRTF options
+ *
+ * Only used when the HRTFs are fully precomputed (the lazy interpolation
+ * modes write to their tables at run-time, so each synthesiser keeps its own).
+ */
+typedef struct _proposed_hrtf_model {
+    proposed_cache_entry entry;      /**< Reference count and cache key */
+    float_complex* H_bin;            /**< HRTFs, direction-major; FLAT: nDirs x nBands x #NUM_EARS */
+
+}proposed_hrtf_model;
+
+/** Stage timings of one analysis or synthesis object (see proposed_profile.h) */
+typedef struct _proposed_profiler {
+    int enable;                      /**< Flag, 1: time the stages, 0: do not (default) */
+    unsigned long long block_ns[PROPOSED_PROFILE_NUM_STAGES]; /**< Time spent in each stage so far during the current block, in nanoseconds */
+    int isActive[PROPOSED_PROFILE_NUM_STAGES]; /**< 1: the stage has been run during the current block, 0: it has not */
+    proposed_profile_counters counters; /**< Timings of the previous blocks */
+
+} proposed_profiler;
+
 /** Helper struct for averaging covariance matrices (block-wise) */
 typedef struct _CxMic{
     float_complex Cx[PROPOSED_MAX_NMICS*PROPOSED_MAX_NMICS];
@@ -92,9 +251,9 @@ typedef struct _proposed_analysis_data
     float fs;                             /**< Host samplerate, Hz */
     int hopsize;                          /**< Filterbank hop size (blocksize must be divisable by this */
     int blocksize;                        /**< Number of samples to process at a time (note that 1 doa and diffuseness estimate is made per block) */
-    float* h_array;                       /**< Array impulse responses; FLAT: nDirs x nMics x h_len */
-    float* array_dirs_deg;                /**< Array grid dirs in degrees; FLAT: nDirs x 2 */
-    float* array_dirs_xyz;                /**< Array grid coordinates (unit vectors and only used by grid-based estimators); FLAT: nDirs x 3 */
+    proposed_array_model* model;          /**< Shared array description (H_array, DCM_array, W etc.) */
+    float* array_dirs_deg;                /**< Array grid dirs in degrees, owned by the model; FLAT: nDirs x 2 */
+    float* array_dirs_xyz;                /**< Array grid coordinates (unit vectors and only used by grid-based estimators), owned by the model; FLAT: nDirs x 3 */
     int nDirs;                            /**< Number of ATFs/scanning directions */
     int nMics;                            /**< Number of microphones */
     int h_len;                            /**< Length of impulse responses, in samples */
@@ -102,6 +261,11 @@ typedef struct _proposed_analysis_data
     /* Optional user parameters (that can also be manipulated at run-time) */
     float covAvgCoeff;                    /**< Temporal averaging coefficient [0 1] */
     float maximumAnalysisFreq;            /**< Maximum analysis frequency in Hz */
+    int enableBandLimitedAnalysis;        /**< Flag, 1: only process the bands used by the estimator (covariance matrices for the remaining bands are computed on demand by the synthesiser), 0: process all bands */
+    PROPOSED_ANALYSIS_UPDATE_SCHEDULES updateSchedule; /**< Spatial parameter update schedule, see #PROPOSED_ANALYSIS_UPDATE_SCHEDULES */
+    int updateInterval;                   /**< Update interval used by the schedule, in blocks */
+    float decimationFreq;                 /**< Bands below this frequency (Hz) are updated every updateInterval blocks with #PROPOSED_ANALYSIS_UPDATE_DECIMATED */
+    proposed_analysis_limits limits;      /**< Limits placed on the settings above (e.g. by a CPU governor), see proposed_analysis_getLimitsPtr() */
     
     /* For optional plotting purposes  */
     float* grid_histogram;                /**< Histogram for the scanning directions; nDirs x 1 */
@@ -111,28 +275,33 @@ typedef struct _proposed_analysis_data
     int nBands;                           /**< Number of frequency bands */
     int timeSlots;                        /**< Number of time slots */
     int filterbankDelay;                  /**< Filterbank delay, in time-domain samples */
-    float* freqVector;                    /**< Centre frequencies; nBands x 1 */
-    float_complex* DCM_array;             /**< Diffuse covariance matrix (computed over all grid directions and weighted); FLAT: nBands x nMics x nMics */
-    float_complex* H_array;               /**< Array IRs in the frequency domain; FLAT: nBands x nMics x nDirs */
-    float_complex* H_array_w;             /**< Array IRs in the frequency domain spatially weightend; FLAT: nBands x nMics x nDirs */
+    float* freqVector;                    /**< Centre frequencies, owned by the model; nBands x 1 */
 
     /* DoA and diffuseness estimator data */
     void* hEig;                           /**< handle for the eigen solver */
-    float_complex** T;                    /**< for covariance whitening; nBands x (nMics x nMics) */
+    const proposed_smallmat_kernels* smk; /**< Fixed-size kernels for this number of microphones (NULL if there are none) */
+    float_complex** T;                    /**< for covariance whitening, owned by the model; nBands x (nMics x nMics) */
     void* hDoA;                           /**< DoA estimator handle */
     int nScan;                            /**< Number of scanning directions */
-    float* scan_dirs_deg;                 /**< Scanning grid dirs in degrees; FLAT: nScan x 2 */
-    float* scan_dirs_xyz;                 /**< Scanning grid dirs in Cartesian coordinates; FLAT: nScan x 3 */
-    float_complex* H_scan_w;              /**< Array IRs used for scanning, in the frequency domain; FLAT: nBands x nMics x nScan */
-    int* scan_idx;                        /**< Scanning grid indices; nScan x 1 */
-    float_complex* W;                     /**< Diffuse integration weighting matrix; FLAT: nDirs x nDirs */
+    float* scan_dirs_deg;                 /**< Scanning grid dirs in degrees, owned by the model; FLAT: nScan x 2 */
+    float* scan_dirs_xyz;                 /**< Scanning grid dirs in Cartesian coordinates, owned by the model; FLAT: nScan x 3 */
+    float_complex* H_scan_w;              /**< Array IRs used for scanning, in the frequency domain, owned by the model; FLAT: nBands x nMics x nScan */
+    int* scan_idx;                        /**< Scanning grid indices, owned by the model; nScan x 1 */
 
     /* Run-time variables */
+    proposed_arena* arena;                /**< Holds grid_histogram and the buffers below */
     float** inputBlock;                   /**< Input frame; nMics x blocksize */
     CxMic* Cx;                            /**< Current (time-averaged) covariance matrix per band; nBands x 1 */
     float_complex* V;                     /**< Eigen vectors; FLAT: nMics x nMics */
     float_complex* Vn;                    /**< Noise subspace; FLAT: nMics x (nMics-K) */
     float* lambda;                        /**< Eigenvalues; nMics x 1 */
+    int blockCounter;                     /**< Number of blocks processed since the last reset (wraps at updateInterval) */
+    float blockMaxAnalysisFreq;           /**< Maximum analysis frequency in effect for the current block, in Hz (see proposed_analysis_beginSchedule()) */
+    int blockBandLimitedAnalysis;         /**< Band-limited analysis flag in effect for the current block */
+    PROPOSED_ANALYSIS_UPDATE_SCHEDULES blockUpdateSchedule; /**< Update schedule in effect for the current block */
+    int forceFullUpdate;                  /**< Flag, 1: update all bands in the next block regardless of the schedule */
+    int enableLinearOnly;                 /**< Flag, 1: only apply the time-frequency transform (no covariance or parameter estimation), 0: full analysis */
+    proposed_profiler profiler;           /**< Timings of the analysis stages */
 
 }proposed_analysis_data;
 
@@ -140,7 +309,7 @@ typedef struct _proposed_analysis_data
 typedef struct _proposed_synthesis_data
 {
     /* User parameters */
-    proposed_binaural_config* binConfig; /**< Internal copy of user configuration */
+    proposed_binaural_config* binConfig; /**< Internal copy of user configuration (without the HRIRs, which are only needed during initialisation; all zero if the HRTFs were loaded from a bundle) */
     PROPOSED_HRTF_INTERP_OPTIONS interpOption; /**< HRIR interpolation option, see #PROPOSED_HRTF_INTERP_OPTIONS */
 
     /* Optional user parameters (that can also be manipulated at run-time) */
@@ -150,6 +319,7 @@ typedef struct _proposed_synthesis_data
     float maxBSMFreq;                /**< Frequency up to which to use BSM before switching to Ambisonics [0..fs/2] */
     float maxMagLSFreq;              /**< Frequency up to which to use MagLS optimisation */
     float linear2parBalance;         /**< Linear to parametric balance [0..1] */
+    int enableLinearOnly;            /**< Flag, 1: only render using the linear decoder, 0: linear + parametric rendering */
 
     /* Things relevant to the synthesiser, which are copied from the proposed_analysis_create() to keep everything aligned */
     float fs;                        /**< Host samplerate, Hz */
@@ -158,19 +328,20 @@ typedef struct _proposed_synthesis_data
     int blocksize;                   /**< blocksize in samples */
     int nDirs;                       /**< Number of measurement/scanning directions */
     int nMics;                       /**< Number of microphones */
-    float_complex* H_array;          /**< Array IRs in the frequency domain; FLAT: nBands x nMics x nDirs */
-    float* array_dirs_deg;           /**< Array measurement dirs in degrees; FLAT: nDirs x 2 */
-    float** array_dirs_xyz;          /**< Array measurement dirs as Cartesian coordinates of unit length; nDirs x 3 */
+    proposed_array_model* model;     /**< Array description shared with the analyser; use proposed_synthesis_getATFs() for the array IRs */
+    float* array_dirs_deg;           /**< Array measurement dirs in degrees, owned by the model; FLAT: nDirs x 2 */
+    float* array_dirs_xyz;           /**< Array measurement dirs as Cartesian coordinates of unit length, owned by the model; FLAT: nDirs x 3 */
     int timeSlots;                   /**< Number of time frames in the time-frequency transform domain */
-    float* freqVector;               /**< Frequency vector (band centre frequencies); nBands x 1 */
-    float_complex* DCM_array;        /**< Diffuse coherence matrix for the array; FLAT: nBands x nMics x nMics */
-    float_complex* W;                /**< Diffuse integration weighting matrix; FLAT: nDirs x nDirs */
+    float* freqVector;               /**< Frequency vector (band centre frequencies), owned by the model; nBands x 1 */
 
     /* Time-frequency transform */
     void* hFB_dec;                   /**< Filterbank handle */
     
     /* Direct-stream rendering data */
-    float_complex* H_bin;            /**< To spatialise the source beamformers; FLAT: nBands x #NUM_EARS x nDirs */
+    float_complex* H_bin;            /**< To spatialise the source beamformers, direction-major; FLAT: nDirs x nBands x #NUM_EARS. Use proposed_synthesis_getHRTF() to access it */
+    proposed_hrtf_model* hrtfModel;  /**< Shared model owning H_bin (NULL in the lazy modes, where H_bin is owned by this synthesiser) */
+    float* srcDirTables;             /**< Source directivity gain, tabulated over the cosine of the angle between the original and translated source directions, per directivity pattern; FLAT: (NUM_DIRECTIVITIES+1) x SRC_DIRECTIVITY_TABLE_SIZE */
+    int* srcDirTableIdx;             /**< Directivity pattern (table) to use for each band; nBands x 1 */
     
     /* Ambient-rendering data */
     int nDiff;                       /**< Number of directions used for rendering */
@@ -179,6 +350,15 @@ typedef struct _proposed_synthesis_data
     float_complex* H_array_diff;     /**< Rendering Array IRs in the frequency domain; FLAT: nBands x nMics x nDiff */
     float_complex* H_bin_diff;       /**< Rendering HRTFs (can include rotations in the case of BSM); FLAT: nBands x #NUM_EARS x nDiff */
     float* diffEQ;                   /**< diffuse-field EQ, as described in [2]; nBands x 1 */
+
+    /* Lazy HRTF interpolation (#PROPOSED_HRTF_INTERP_NEAREST_LAZY, #PROPOSED_HRTF_INTERP_TRIANGULAR_LAZY) */
+    int* H_bin_isValid;              /**< Flag per direction, 1: H_bin has been computed, 0: it is computed upon first use; nDirs x 1 (NULL if H_bin was fully precomputed) */
+    int nHRIR;                       /**< Number of measured HRIRs */
+    float_complex* H_meas;           /**< Measured HRTFs in the filterbank domain; FLAT: nBands x #NUM_EARS x nHRIR */
+    float* itds_meas;                /**< ITDs of the measured HRIRs, in seconds; nHRIR x 1 */
+    int* interpIdx;                  /**< Indices of the (up to 3) measured HRTFs used for each direction; FLAT: nDirs x 3 */
+    float* interpW;                  /**< The corresponding interpolation weights; FLAT: nDirs x 3 */
+    float* dfEQ;                     /**< Diffuse-field EQ gains for the HRTFs; FLAT: nBands x #NUM_EARS */
     
     /* Ambient-rendering data - BSM */
     float_complex* M_BSM;            /**< FLAT: nBands x #NUM_EARS x nMics */
@@ -199,26 +379,50 @@ typedef struct _proposed_synthesis_data
     float_complex* M_HRTFs;          /**< HRTFs taking into account head orientation and position, and incl. 1/R gains; FLAT: nBands x #NUM_EARS x nPWD */
     
     /* Run-time variables */
+    proposed_arena* arena;           /**< Holds the buffers that are written to while processing (see proposed_synthesis_create()) */
     void* hPinv;                     /**< Handle for computing the Moore-Penrose pseudo inverse */
     void* hLinSolve;                 /**< Handle for solving linear equations (Ax=b) */
     void* hInv;                      /**< Handle for matrix inversion */
+    const proposed_smallmat_kernels* smk; /**< Fixed-size kernels for this number of microphones (NULL if there are none) */
     float_complex* As;               /**< Array steering vector for DoA; FLAT: nMics x #PROPOSED_MAX_K */
     float_complex* Ds;               /**< Source beamforming matrix; FLAT: #PROPOSED_MAX_K x nMics */
     float_complex* Dd;               /**< Source beamforming matrix; FLAT: nMics x nMics */
     float_complex* new_M_par;        /**< New mixing matrix, for parametric rendering; FLAT: #NUM_EARS x nMics */
-    float_complex* new_M_lin;        /**< New mixing matrix, for linear rendering only; FLAT: #NUM_EARS x nMics */
+    float_complex** M_lin;           /**< Mixing matrix per band for the linear rendering; nBands x FLAT: (#NUM_EARS x nMics) */
     float_complex** M_par;           /**< Mixing matrix per band for the parametric rendering; nBands x FLAT: (#NUM_EARS x nMics) */
-    float_complex** M;               /**< Mixing matrix per band; nBands x FLAT: (#NUM_EARS x nMics) */
+    float_complex** M;               /**< Blended mixing matrix per band, M = gain_par*M_par + gain_lin*M_lin; nBands x FLAT: (#NUM_EARS x nMics) */
+    float* gain_par;                 /**< Gain applied to M_par when blending; nBands x 1 */
+    float* gain_lin;                 /**< Gain applied to M_lin when blending; nBands x 1 */
+    proposed_mixKernel mixKernel;    /**< Mixing kernel, selected at creation time for the host CPU */
 
     /* Run-time audio buffers */
     float_complex*** outTF;          /**< nBands x #NUM_EARS x timeSlots */
     float** outTD;                   /**< output time-domain buffer; #NUM_EARS x blocksize */
+
+    /* Static-pose FIR rendering (uniformly partitioned convolution) */
+    int filterbankDelay;             /**< Filterbank delay in samples, which is imposed on the FIRs to keep them aligned with the filterbank path */
+    int firLength;                   /**< Length of the FIRs, in samples (a power of 2, and a multiple of blocksize) */
+    int nFirPartitions;              /**< Number of partitions, firLength/blocksize */
+    int fdlIdx;                      /**< Current position in the frequency-domain delay line */
+    void* hFFT_fir;                  /**< FFT handle for designing the FIRs; firLength */
+    void* hFFT_part;                 /**< FFT handle for the partitioned convolution; 2 x blocksize */
+    float* firWindow;                /**< Window applied to the FIRs; firLength x 1 */
+    float* firTD;                    /**< FIR design buffer; firLength x 1 */
+    float_complex* firTF;            /**< FIR design buffer; (firLength/2+1) x 1 */
+    float_complex** M_fir;           /**< Mixing matrices that the FIRs are designed from; nBands x (#NUM_EARS x nMics) */
+    float_complex* H_fir;            /**< FIR partitions; FLAT: #NUM_EARS x nMics x nFirPartitions x (blocksize+1) */
+    float_complex* X_fdl;            /**< Frequency-domain delay line of the input; FLAT: nFirPartitions x nMics x (blocksize+1) */
+    float_complex* Y_fir;            /**< Output accumulation buffer; (blocksize+1) x 1 */
+    float* firInTD;                  /**< Previous and current input blocks; FLAT: nMics x 2*blocksize */
+    float* firOutTD;                 /**< Time-domain convolution output; 2*blocksize x 1 */
+    proposed_profiler profiler;      /**< Timings of the synthesis stages */
  
 } proposed_synthesis_data;
 
 /** Parameter container to store the data from an analyser for one blocksize of audio */
 typedef struct _proposed_param_container_data {
     int nBands;                      /**< Number of bands */
+    proposed_arena* arena;           /**< Holds the parameters below */
 
     /* Estimated Parameters */
     int* nSrcs;                      /**< Number of sources per band; nBands x 1 */
@@ -245,9 +449,11 @@ typedef struct _proposed_signal_container_data {
     int nMics;                       /**< Number of spherical harmonic components */
     int nBands;                      /**< Number of bands in the time-frequency transform */
     int timeSlots;                   /**< Number of time frames in time-frequency transform */
+    proposed_arena* arena;           /**< Holds the buffers below */
 
     /* Covariance matrices and signal statistics computed during the analysis */
     CxMic* Cx;                       /**< NON-time-averaged covariance matrix per band; nBands x .Cx(nMics x nMics) */
+    int* Cx_isValid;                 /**< Flag per band, 1: Cx has been computed for the current block, 0: it must be computed from inTF before use; nBands x 1 */
 
     /* TF frame to carry over to a decoder */
     float_complex*** inTF;           /**< Input frame in TF-domain; nBands x nMics x timeSlots */
@@ -268,6 +474,460 @@ void proposed_findNearestGridIndices(float* grid_dirs_xyz,
                                      int nTarget,
                                      int* indices);
 
+/**
+ * Computes integration weights for a spherical grid, i.e. the area of the
+ * sphere represented by each direction (summing to 4pi)
+ *
+ * Grids with fewer than #PROPOSED_VORONOI_MAX_DIRS directions use the areas of
+ * their spherical Voronoi cells (getVoronoiWeights()), which is exact but
+ * scales poorly. Denser grids instead use an adaptive kernel density estimate:
+ * the directions are binned into a uniform grid of cells, so that the
+ * #PROPOSED_QUADRATURE_KNN nearest neighbours of each direction are found
+ * locally; their distance sets the width of a Gaussian kernel, whose sum over
+ * the surrounding directions gives the local density, and the area is its
+ * reciprocal. This costs O(nDirs) for typical measurement grids (computed in
+ * parallel), and agrees with the Voronoi areas to within a few percent for
+ * smoothly varying grid densities.
+ *
+ * @param[in]  dirs_deg Grid directions [azi elev] in degrees; FLAT: nDirs x 2
+ * @param[in]  nDirs    Number of directions
+ * @param[out] weights  Integration weights; nDirs x 1
+ */
+void proposed_getQuadratureWeights(float* dirs_deg,
+                                   int nDirs,
+                                   float* weights);
+
+/**
+ * Converts a band-major (nBands x nCH x nDirs) table of transfer functions into
+ * a direction-major (nDirs x nBands x nCH) one, such that gathering one
+ * direction for all bands and channels reads contiguous memory
+ */
+void proposed_toDirectionMajor(const float_complex* in,
+                               int nBands,
+                               int nCH,
+                               int nDirs,
+                               float_complex* out);
+
+/**
+ * Returns the number of workers to use for nItems independent items (at least
+ * 1, and at most nItems), given the number of processors and the limit set
+ * with proposed_setMaxInitThreads()
+ */
+int proposed_parallel_getNumWorkers(int nItems);
+
+/**
+ * Calls fn for every index [0..nItems-1], split between nWorkers threads (the
+ * calling thread being one of them), and returns once all have been processed
+ *
+ * The calls for different indices must not write to the same memory, other
+ * than to per-worker scratch memory; the results are then identical for any
+ * number of workers.
+ */
+void proposed_parallel_for(int nItems,
+                           int nWorkers,
+                           proposed_parallelFn fn,
+                           void* ctx);
+
+/**
+ * Sets the SAF utility function that the calling thread is about to call (or
+ * NULL once it has returned), for the real-time safety guard report
+ */
+void proposed_rtguard_setWrapper(const char* name);
+
+/** Clears the statistics of all stages (but not the enable flag) */
+void proposed_profiler_reset(proposed_profiler* p);
+
+/** Returns the current value of a monotonic clock, in nanoseconds */
+unsigned long long proposed_profiler_now(void);
+
+/**
+ * Returns the start time of a stage, to pass to proposed_profiler_end(), or 0
+ * if neither profiling nor tracing (see proposed_trace.h) is enabled
+ */
+unsigned long long proposed_profiler_begin(const proposed_profiler* p);
+
+/**
+ * Adds the time since t0 (see proposed_profiler_begin()) to the given stage
+ * for the current block, and records it as a span if tracing is enabled; a
+ * stage may be timed any number of times per block
+ */
+void proposed_profiler_end(proposed_profiler* p,
+                           PROPOSED_PROFILE_STAGES stage,
+                           unsigned long long t0);
+
+/**
+ * Records a span on the calling thread, from t0 until t1 (in nanoseconds, see
+ * proposed_profiler_now()), if tracing is enabled and t0 is not 0
+ */
+void proposed_trace_record(const char* name,
+                           unsigned long long t0,
+                           unsigned long long t1);
+
+/**
+ * Adds the time spent in each stage during the current block to its
+ * counters, and starts the next block; stages that were not run are left
+ * as they are
+ */
+void proposed_profiler_commit(proposed_profiler* p);
+
+/**
+ * Copies the counters of the stages that have been run at least once; the
+ * other stages are left as they are
+ */
+void proposed_profiler_getCounters(const proposed_profiler* p,
+                                   proposed_profile_counters* counters);
+
+/**
+ * Creates an empty arena for the run-time state of one object, using the
+ * option set with proposed_setRunTimeMemoryOption()
+ *
+ * Buffers are reserved with proposed_arena_reserve1d/2d/3d(), in the order
+ * that they are accessed while processing, and are then all allocated (and
+ * zeroed) by proposed_arena_commit(). They are freed together by
+ * proposed_arena_destroy(), and must not be freed individually.
+ */
+void proposed_arena_create(proposed_arena** const pArena);
+
+/** Reserves a 1-D buffer; *pBuffer is set by proposed_arena_commit() */
+void proposed_arena_reserve1d(proposed_arena* arena,
+                              void* pBuffer,
+                              size_t nElements,
+                              size_t elemSize);
+
+/** Reserves a 2-D buffer, laid out as by malloc2d(); *pBuffer is set by proposed_arena_commit() */
+void proposed_arena_reserve2d(proposed_arena* arena,
+                              void* pBuffer,
+                              size_t dim1,
+                              size_t dim2,
+                              size_t elemSize);
+
+/** Reserves a 3-D buffer, laid out as by malloc3d(); *pBuffer is set by proposed_arena_commit() */
+void proposed_arena_reserve3d(proposed_arena* arena,
+                              void* pBuffer,
+                              size_t dim1,
+                              size_t dim2,
+                              size_t dim3,
+                              size_t elemSize);
+
+/** Allocates all reserved buffers, zeroed, and sets their addresses */
+void proposed_arena_commit(proposed_arena* arena);
+
+/** Frees all buffers of an arena (setting their addresses to NULL) and the arena itself, and sets *pArena to NULL */
+void proposed_arena_destroy(proposed_arena** const pArena);
+
+/**
+ * Converts FIR filters to filterbank coefficients, equivalent to (but faster
+ * than) afSTFT_FIRtoFilterbankCoeffs() with LDmode=1 and hybridmode=0
+ *
+ * The directions are converted in chunks of #PROPOSED_INIT_CHUNK_DIRS, in
+ * parallel. afSTFT_FIRtoFilterbankCoeffs() aligns all filters to the delay of
+ * the first direction, so that direction leads every chunk, which keeps the
+ * result identical to converting all of them at once.
+ *
+ * @param[in]  h              Filters; FLAT: nDirs x nCH x irLen
+ * @param[in]  nDirs          Number of directions
+ * @param[in]  nCH            Number of channels
+ * @param[in]  irLen          Length of the filters, in samples
+ * @param[in]  hopsize        Filterbank hopsize
+ * @param[in]  nBands         Number of bands (for this hopsize)
+ * @param[in]  scale          Gain applied to the filters
+ * @param[in]  directionMajor 0: output is FLAT: nBands x nCH x nDirs,
+ *                            1: output is FLAT: nDirs x nBands x nCH
+ * @param[out] out            Filterbank coefficients
+ */
+void proposed_FIRtoFilterbankCoeffs(float* h,
+                                    int nDirs,
+                                    int nCH,
+                                    int irLen,
+                                    int hopsize,
+                                    int nBands,
+                                    float scale,
+                                    int directionMajor,
+                                    float_complex* out);
+
+/**
+ * Continues a 64-bit FNV-1a style hash h over nBytes of data; start with
+ * #PROPOSED_CACHE_HASH_SEED
+ */
+unsigned long long proposed_cache_hash(unsigned long long h,
+                                       const void* data,
+                                       size_t nBytes);
+
+/**
+ * Returns the cached model with this key, adding a reference to it, or NULL
+ * if there is none
+ *
+ * All cache operations are thread-safe. Defining PROPOSED_DISABLE_MODEL_CACHE
+ * at compile time disables the sharing (this then always returns NULL).
+ */
+void* proposed_cache_find(unsigned long long key);
+
+/**
+ * Inserts a newly computed model (holding one reference) into the cache, and
+ * returns it
+ *
+ * If another thread has inserted a model with the same key in the meantime,
+ * then the new one is destroyed, and the existing one is returned instead
+ * (with a reference added).
+ */
+void* proposed_cache_insert(proposed_cache_entry* entry);
+
+/** Adds a reference to a model */
+void proposed_cache_retain(proposed_cache_entry* entry);
+
+/**
+ * Drops a reference to a model, removing it from the cache and destroying it
+ * if it was the last one, and sets *pEntry to NULL
+ */
+void proposed_cache_release(proposed_cache_entry** const pEntry);
+
+/** Returns a new, empty array model holding one reference (not yet cached) */
+proposed_array_model* proposed_arrayModel_create(void);
+
+/** Adds a reference to an array model, and returns it */
+proposed_array_model* proposed_arrayModel_retain(proposed_array_model* model);
+
+/** Drops a reference to an array model (destroying it if it was the last one), and sets *pModel to NULL */
+void proposed_arrayModel_release(proposed_array_model** const pModel);
+
+/** Returns a new, empty HRTF model holding one reference (not yet cached) */
+proposed_hrtf_model* proposed_hrtfModel_create(void);
+
+/** Drops a reference to an HRTF model (destroying it if it was the last one), and sets *pModel to NULL */
+void proposed_hrtfModel_release(proposed_hrtf_model** const pModel);
+
+/**
+ * Fits a spherical harmonic (SH) representation to the array ATFs, per band
+ *
+ * For each band, H(band) ~= C(band) * Y, where Y are the real SH evaluated at
+ * the grid directions. The order of each band is the lowest for which the
+ * normalised squared fitting error is at most maxFitError (capped at
+ * #PROPOSED_ATF_SH_MAX_ORDER, and by the number of grid directions). The
+ * search starts at order 0 for every band (the pseudo-inverses of the SH are
+ * shared by all bands), since the required order does not always grow with
+ * frequency. Bands that cannot be fitted within maxFitError at the highest
+ * order are stored uncompressed instead.
+ *
+ * Only the coefficients and the SH at the grid directions are stored, so the
+ * memory footprint no longer scales with nBands x nDirs.
+ *
+ * @param[in] phSH        (&) address of the ATF SH handle
+ * @param[in] H_array     Array ATFs, direction-major; FLAT: nDirs x nBands x nMics
+ * @param[in] dirs_deg    Grid directions [azi elev] in degrees; FLAT: nDirs x 2
+ * @param[in] nBands      Number of bands
+ * @param[in] nMics       Number of microphones
+ * @param[in] nDirs       Number of grid directions
+ * @param[in] maxFitError Maximum normalised squared fitting error per band
+ */
+void proposed_atfSH_create(void** const phSH,
+                           const float_complex* H_array,
+                           float* dirs_deg,
+                           int nBands,
+                           int nMics,
+                           int nDirs,
+                           float maxFitError);
+
+/** Destroys an ATF SH representation */
+void proposed_atfSH_destroy(void** const phSH);
+
+/**
+ * Synthesises the ATFs of one band for a set of grid directions
+ *
+ * Costs 2 x nMics x (order+1)^2 multiply-adds per direction, and does not
+ * allocate, so it may be called at run-time.
+ *
+ * @param[in]  hSH     ATF SH handle
+ * @param[in]  band    Band index
+ * @param[in]  dir_idx Grid direction indices; nIdx x 1
+ * @param[in]  nIdx    Number of directions
+ * @param[out] H       ATFs; FLAT: nMics x nIdx
+ */
+void proposed_atfSH_getATFs(void* const hSH,
+                            int band,
+                            const int* dir_idx,
+                            int nIdx,
+                            float_complex* H);
+
+/** Returns the SH order used for one band, or -1 if it is stored uncompressed */
+int proposed_atfSH_getOrder(void* const hSH,
+                            int band);
+
+/** Returns the normalised squared fitting error of one band (0 if it is stored uncompressed) */
+float proposed_atfSH_getFitError(void* const hSH,
+                                 int band);
+
+/**
+ * Memory-maps a bundle saved by proposed_bundle_save(), and returns an array
+ * model (holding one reference) that points directly into it
+ *
+ * If a model with the same cache key (i.e. loaded from the same bundle, or a
+ * copy of it) is already held by another handle, then that one is returned
+ * instead, and the file is not kept mapped. Models computed from the array IRs
+ * have different keys, so they are never returned here.
+ *
+ * @param[in]  path    Path to the bundle
+ * @param[out] fs      Samplerate that the model was computed for, Hz
+ * @param[out] hopsize Filterbank hopsize that the model was computed for
+ * @param[out] error   See #PROPOSED_BUNDLE_ERROR_CODES
+ * @returns the array model, or NULL if the bundle could not be loaded
+ */
+proposed_array_model* proposed_bundle_load(const char* path,
+                                           float* fs,
+                                           int* hopsize,
+                                           PROPOSED_BUNDLE_ERROR_CODES* error);
+
+/**
+ * Returns the NON-time-averaged covariance matrix of the current block for one
+ * band, computing it from the TF-domain input frame if the analyser skipped it
+ * (see proposed_analysis_getEnableBandLimitedAnalysisPtr())
+ *
+ * @param[in] scon proposed signal container
+ * @param[in] band Band index
+ * @returns pointer to the covariance matrix; FLAT: nMics x nMics
+ */
+float_complex* proposed_signal_container_getCx(proposed_signal_container_data* scon,
+                                               int band);
+
+/**
+ * Loads the input block and applies the forward time-frequency transform,
+ * storing the result in the signal container (first stage of
+ * proposed_analysis_apply())
+ */
+void proposed_analysis_forwardTransform(proposed_analysis_data* a,
+                                        float** input,
+                                        int nChannels,
+                                        int blocksize,
+                                        proposed_signal_container_data* scon);
+
+/**
+ * Updates the covariance matrix of one band (second stage of
+ * proposed_analysis_apply())
+ */
+void proposed_analysis_updateCovariance(proposed_analysis_data* a,
+                                        proposed_signal_container_data* scon,
+                                        int band);
+
+/**
+ * Resolves the settings in effect for the current block (i.e. the user
+ * settings with the limits applied), and prepares the parameter update
+ * schedule; returns the update interval to pass to
+ * proposed_analysis_estimateParameters()
+ *
+ * @note Must be called before the covariance matrices of the block are updated
+ */
+int proposed_analysis_beginSchedule(proposed_analysis_data* a);
+
+/**
+ * Estimates the spatial parameters of one band (third stage of
+ * proposed_analysis_apply())
+ *
+ * @note Bands above the maximum analysis frequency are extrapolated from the
+ *       band below, so the bands must be processed in ascending order
+ */
+void proposed_analysis_estimateParameters(proposed_analysis_data* a,
+                                          proposed_param_container_data* pcon,
+                                          int band,
+                                          int updateInterval);
+
+/** Advances the parameter update schedule, once all bands have been processed */
+void proposed_analysis_endSchedule(proposed_analysis_data* a);
+
+/**
+ * Updates the ambient and linear rendering matrices for the current listener
+ * pose (first stage of proposed_synthesis_apply())
+ *
+ * @param[in]  s          proposed synthesis data
+ * @param[in]  ypr_rad    Listener yaw-pitch-roll, in radians; 3 x 1
+ * @param[in]  xyz_m      Listener position, in metres; 3 x 1
+ * @param[in]  src_dist_m Source distance, in metres
+ * @param[out] Rzyx       Rotation matrix for the listener orientation
+ */
+void proposed_synthesis_updatePose(proposed_synthesis_data* s,
+                                   float* ypr_rad,
+                                   float* xyz_m,
+                                   float src_dist_m,
+                                   float Rzyx[3][3]);
+
+/**
+ * Computes the mixing matrix of one band (second stage of
+ * proposed_synthesis_apply())
+ */
+void proposed_synthesis_computeMixingMatrix(proposed_synthesis_data* s,
+                                            proposed_param_container_data* pcon,
+                                            proposed_signal_container_data* scon,
+                                            int band,
+                                            float Rzyx[3][3],
+                                            float* xyz_m,
+                                            PROPOSED_DISTANCE_MAPS dist_map,
+                                            float src_dist_m,
+                                            int enableSrcD);
+
+/**
+ * Blends and applies the mixing matrices of bands [band, band+nBands) to the
+ * input (third stage of proposed_synthesis_apply())
+ */
+void proposed_synthesis_mixBands(proposed_synthesis_data* s,
+                                 proposed_signal_container_data* scon,
+                                 int band,
+                                 int nBands);
+
+/**
+ * Applies the inverse time-frequency transform and copies the result to the
+ * output (final stage of proposed_synthesis_apply())
+ */
+void proposed_synthesis_inverseTransform(proposed_synthesis_data* s,
+                                         int nChannels,
+                                         int blocksize,
+                                         float** output);
+
+/**
+ * Returns the fastest mixing kernel supported by the host CPU
+ *
+ * The CPU is queried once, upon the first call. Defining
+ * PROPOSED_DISABLE_SIMD at compile time forces the scalar kernel.
+ */
+proposed_mixKernel proposed_kernels_getMixKernel(void);
+
+/** Returns the instruction set used by proposed_kernels_getMixKernel() */
+PROPOSED_KERNEL_ISA proposed_kernels_getISA(void);
+
+/**
+ * Returns the mixing kernel for a specific instruction set, or NULL if it is
+ * not supported by the host CPU (e.g. to compare the kernels with each other)
+ */
+proposed_mixKernel proposed_kernels_getMixKernelForISA(PROPOSED_KERNEL_ISA isa);
+
+/**
+ * Returns the fixed-size small-matrix kernels for nMics microphones, or NULL
+ * if there are none for this array size (in which case, the generic BLAS and
+ * LAPACK routines should be used instead)
+ */
+const proposed_smallmat_kernels* proposed_kernels_getSmallMat(int nMics);
+
+/**
+ * Inverse of a general complex K x K matrix (K = 1..3, interleaved real and
+ * imaginary parts), in closed form
+ *
+ * Matrices that are singular, or nearly so relative to the magnitude of their
+ * diagonal, are diagonally loaded before they are inverted, such that invA is
+ * always finite (and zero if A is zero).
+ */
+void proposed_smallmat_cinv(const float* A,
+                            int K,
+                            float* invA);
+
+/** Portable mixing kernel, valid for any dimensions */
+void proposed_kernels_mix_scalar(int nBands,
+                                 int nMics,
+                                 int timeSlots,
+                                 const float* gain_par,
+                                 const float* gain_lin,
+                                 const float_complex* M_par,
+                                 const float_complex* M_lin,
+                                 const float_complex* inTF,
+                                 float_complex* M,
+                                 float_complex* outTF);
+
 /**
  * Creates an instance of the BSM implementation
  *
@@ -353,6 +1013,67 @@ void proposed_getInterpolatedHRTFs(/* Input Arguments */
                                    /* Output Arguments */
                                    float_complex* hrtf_interp);
 
+/**
+ * Prepares everything required to interpolate the HRTFs one direction at a
+ * time (see proposed_synthesis_getHRTF()), rather than for all directions at
+ * once (see proposed_getInterpolatedHRTFs())
+ *
+ * Since the whole set of interpolated HRTFs is no longer available, the
+ * diffuse-field EQ is derived from the measured set instead.
+ *
+ * @param[in]  hAna            proposed analysis handle
+ * @param[in]  interpOption    #PROPOSED_HRTF_INTERP_NEAREST_LAZY or
+ *                             #PROPOSED_HRTF_INTERP_TRIANGULAR_LAZY
+ * @param[in]  binConfig       Binaural configuration
+ * @param[in]  target_dirs_deg Target/interpolation dirs, in degrees;
+ *                             FLAT: nTargetDirs x 2
+ * @param[in]  nTargetDirs     Number of target/interpolation directions
+ * @param[in]  ENABLE_DIFF_EQ  Flag, 1: enabled diffuse-field EQ, 0: disabled
+ * @param[out] hrtf_meas       Measured HRTFs in the filterbank domain;
+ *                             FLAT: nBands x #NUM_EARS x nHRIR
+ * @param[out] itds_s          ITDs of the measured HRIRs; nHRIR x 1
+ * @param[out] interp_idx      HRTF indices per target dir; FLAT: nTargetDirs x 3
+ * @param[out] interp_w        HRTF weights per target dir; FLAT: nTargetDirs x 3
+ * @param[out] dfEQ            Diffuse-field EQ gains; FLAT: nBands x #NUM_EARS
+ */
+void proposed_getLazyHRTFData(/* Input Arguments */
+                              proposed_analysis_handle const hAna,
+                              PROPOSED_HRTF_INTERP_OPTIONS interpOption,
+                              proposed_binaural_config* binConfig,
+                              float* target_dirs_deg,
+                              int nTargetDirs,
+                              int ENABLE_DIFF_EQ,
+                              /* Output Arguments */
+                              float_complex* hrtf_meas,
+                              float* itds_s,
+                              int* interp_idx,
+                              float* interp_w,
+                              float* dfEQ);
+
+/**
+ * Returns the HRTFs of one grid direction; nBands x #NUM_EARS
+ *
+ * In the lazy modes, the direction is interpolated and cached upon first use.
+ * In nearest mode, this is a copy and a gain per band; in triangular mode, the
+ * magnitudes and ITD of (up to) 3 measurements are interpolated, as in
+ * interpHRTFs(). Neither allocates, so this may be called on the audio thread.
+ */
+const float_complex* proposed_synthesis_getHRTF(proposed_synthesis_data* s,
+                                                int dir);
+
+/**
+ * Gathers the array ATFs of one band for a set of grid directions; FLAT:
+ * nMics x nIdx
+ *
+ * These are copied from the array model, or synthesised from its SH
+ * representation if the ATFs were compressed (see proposed_analysis_create()).
+ */
+void proposed_synthesis_getATFs(proposed_synthesis_data* s,
+                                int band,
+                                const int* dir_idx,
+                                int nIdx,
+                                float_complex* H);
+
 /**
  * Creates an instance of the space-domain MUSIC implementation
  *
@@ -0,0 +1,469 @@
+/**
+ * @file proposed_kernels.c
+ * @ingroup PROPOSED
+ * @brief Specialised kernels for the proposed method
+ *
+ * The mixing stage applies a #NUM_EARS x nMics matrix per band to the
+ * nMics x timeSlots input of that band. These matrices are too small for the
+ * BLAS libraries to be efficient (the call overhead dominates), so instead,
+ * the blending of the parametric and linear mixing matrices and the mixing
+ * itself are carried out here for all bands in one pass.
+ *
+ * A portable scalar kernel is always available. On x86-64, AVX2 and AVX-512
+ * variants are also compiled (using per-function target attributes, so no
+ * global compiler flags are needed) and the fastest one supported by the host
+ * CPU is selected at run-time. The SIMD variants are specialised for
+ * timeSlots == 2 (i.e. the plug-in's 256 sample frames with a 128 sample hop),
+ * and defer to the scalar kernel otherwise.
+ *
+ * The analysis and the source/ambient stream separation also operate on tiny
+ * matrices (K x K with K<=#PROPOSED_MAX_K, #NUM_EARS x nMics and nMics x nMics).
+ * For the array sizes that are most commonly deployed, fixed-size versions of
+ * these operations are generated from proposed_smallmat.h, which avoid the run-
+ * time dispatch and workspace handling of the generic BLAS/LAPACK wrappers.
+ *
+ * @author agent
+ * @date 19th October 2026
+ */
+
+#include "proposed_internal.h"
+#include <float.h>
+
+#if !defined(PROPOSED_DISABLE_SIMD) && (NUM_EARS == 2) && (defined(__x86_64__) || defined(_M_X64))
+# define PROPOSED_KERNELS_X86 ( 1 )
+# include <immintrin.h>
+# if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+#  define PROPOSED_TARGET_AVX2
+#  define PROPOSED_TARGET_AVX512
+# else
+#  define PROPOSED_TARGET_AVX2   __attribute__((target("avx2,fma")))
+#  define PROPOSED_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+# endif
+#else
+# define PROPOSED_KERNELS_X86 ( 0 )
+#endif
+
+/* ========================================================================== */
+/*                                Scalar Kernel                               */
+/* ========================================================================== */
+
+void proposed_kernels_mix_scalar
+(
+    int nBands,
+    int nMics,
+    int timeSlots,
+    const float* gain_par,
+    const float* gain_lin,
+    const float_complex* M_par,
+    const float_complex* M_lin,
+    const float_complex* inTF,
+    float_complex* M,
+    float_complex* outTF
+)
+{
+    int band, i, ear, mic, t, nM;
+    float re, im, mr, mi, xr, xi;
+    const float *pPar, *pLin, *pIn, *pMrow;
+    float *pM, *pOut;
+
+    nM = 2*NUM_EARS*nMics; /* re+im */
+    for(band=0; band<nBands; band++){
+        pPar = (const float*)M_par + band*nM;
+        pLin = (const float*)M_lin + band*nM;
+        pIn  = (const float*)inTF  + band*2*nMics*timeSlots;
+        pM   = (float*)M           + band*nM;
+        pOut = (float*)outTF       + band*2*NUM_EARS*timeSlots;
+
+        /* Blend */
+        for(i=0; i<nM; i++)
+            pM[i] = gain_par[band]*pPar[i] + gain_lin[band]*pLin[i];
+
+        /* Mix */
+        for(ear=0; ear<NUM_EARS; ear++){
+            pMrow = pM + 2*ear*nMics;
+            for(t=0; t<timeSlots; t++){
+                re = im = 0.0f;
+                for(mic=0; mic<nMics; mic++){
+                    mr = pMrow[2*mic];
+                    mi = pMrow[2*mic+1];
+                    xr = pIn[2*(mic*timeSlots+t)];
+                    xi = pIn[2*(mic*timeSlots+t)+1];
+                    re += mr*xr - mi*xi;
+                    im += mr*xi + mi*xr;
+                }
+                pOut[2*(ear*timeSlots+t)]   = re;
+                pOut[2*(ear*timeSlots+t)+1] = im;
+            }
+        }
+    }
+}
+
+#if PROPOSED_KERNELS_X86
+
+/* ========================================================================== */
+/*                                 AVX2 Kernel                                */
+/* ========================================================================== */
+
+/*
+ * With timeSlots == 2, the output of one band, [ear0 t0, ear0 t1, ear1 t0,
+ * ear1 t1], fits in a single 256-bit register. Each microphone contributes the
+ * complex product of [M0m, M0m, M1m, M1m] with [x0, x1, x0, x1]; the real and
+ * imaginary parts of M are accumulated separately and combined with a single
+ * addsub at the end.
+ */
+PROPOSED_TARGET_AVX2
+static void proposed_kernels_mix_avx2
+(
+    int nBands,
+    int nMics,
+    int timeSlots,
+    const float* gain_par,
+    const float* gain_lin,
+    const float_complex* M_par,
+    const float_complex* M_lin,
+    const float_complex* inTF,
+    float_complex* M,
+    float_complex* outTF
+)
+{
+    int band, i, mic, nM;
+    const float *pPar, *pLin, *pIn, *pM0, *pM1;
+    float *pM, *pOut;
+    __m256 gp, gl, x, xs, aR, aI, accR, accI;
+
+    if(timeSlots!=2){
+        proposed_kernels_mix_scalar(nBands, nMics, timeSlots, gain_par, gain_lin, M_par, M_lin, inTF, M, outTF);
+        return;
+    }
+
+    nM = 2*NUM_EARS*nMics; /* re+im */
+    for(band=0; band<nBands; band++){
+        pPar = (const float*)M_par + band*nM;
+        pLin = (const float*)M_lin + band*nM;
+        pIn  = (const float*)inTF  + band*4*nMics;
+        pM   = (float*)M           + band*nM;
+        pOut = (float*)outTF       + band*2*NUM_EARS*2;
+
+        /* Blend */
+        gp = _mm256_set1_ps(gain_par[band]);
+        gl = _mm256_set1_ps(gain_lin[band]);
+        for(i=0; i+8<=nM; i+=8)
+            _mm256_storeu_ps(pM+i, _mm256_fmadd_ps(gl, _mm256_loadu_ps(pLin+i), _mm256_mul_ps(gp, _mm256_loadu_ps(pPar+i))));
+        for(; i<nM; i++)
+            pM[i] = gain_par[band]*pPar[i] + gain_lin[band]*pLin[i];
+
+        /* Mix */
+        pM0 = pM;
+        pM1 = pM + 2*nMics;
+        accR = _mm256_setzero_ps();
+        accI = _mm256_setzero_ps();
+        for(mic=0; mic<nMics; mic++){
+            x  = _mm256_broadcast_ps((const __m128*)(pIn + 4*mic));
+            xs = _mm256_permute_ps(x, 0xB1); /* swap re/im */
+            aR = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(pM0[2*mic])),   _mm_set1_ps(pM1[2*mic]),   1);
+            aI = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(pM0[2*mic+1])), _mm_set1_ps(pM1[2*mic+1]), 1);
+            accR = _mm256_fmadd_ps(aR, x,  accR);
+            accI = _mm256_fmadd_ps(aI, xs, accI);
+        }
+        _mm256_storeu_ps(pOut, _mm256_addsub_ps(accR, accI));
+    }
+}
+
+/* ========================================================================== */
+/*                               AVX-512 Kernel                               */
+/* ========================================================================== */
+
+/*
+ * Same as the AVX2 kernel, except that two microphones are processed per
+ * iteration (one per 256-bit half), and the halves are summed at the end.
+ */
+PROPOSED_TARGET_AVX512
+static void proposed_kernels_mix_avx512
+(
+    int nBands,
+    int nMics,
+    int timeSlots,
+    const float* gain_par,
+    const float* gain_lin,
+    const float_complex* M_par,
+    const float_complex* M_lin,
+    const float_complex* inTF,
+    float_complex* M,
+    float_complex* outTF
+)
+{
+    int band, i, mic, nM;
+    const float *pPar, *pLin, *pIn, *pM0, *pM1;
+    float *pM, *pOut;
+    __m512 gp, gl, x2, xs2, aR2, aI2, accR2, accI2, m2;
+    __m256 x, xs, aR, aI, accR, accI;
+    const __m512i idxX  = _mm512_setr_epi32(0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 6, 7, 4, 5, 6, 7);
+    const __m512i idxRe = _mm512_setr_epi32(0, 0, 0, 0, 4, 4, 4, 4, 2, 2, 2, 2, 6, 6, 6, 6);
+    const __m512i idxIm = _mm512_setr_epi32(1, 1, 1, 1, 5, 5, 5, 5, 3, 3, 3, 3, 7, 7, 7, 7);
+
+    if(timeSlots!=2){
+        proposed_kernels_mix_scalar(nBands, nMics, timeSlots, gain_par, gain_lin, M_par, M_lin, inTF, M, outTF);
+        return;
+    }
+
+    nM = 2*NUM_EARS*nMics; /* re+im */
+    for(band=0; band<nBands; band++){
+        pPar = (const float*)M_par + band*nM;
+        pLin = (const float*)M_lin + band*nM;
+        pIn  = (const float*)inTF  + band*4*nMics;
+        pM   = (float*)M           + band*nM;
+        pOut = (float*)outTF       + band*2*NUM_EARS*2;
+
+        /* Blend */
+        gp = _mm512_set1_ps(gain_par[band]);
+        gl = _mm512_set1_ps(gain_lin[band]);
+        for(i=0; i+16<=nM; i+=16)
+            _mm512_storeu_ps(pM+i, _mm512_fmadd_ps(gl, _mm512_loadu_ps(pLin+i), _mm512_mul_ps(gp, _mm512_loadu_ps(pPar+i))));
+        for(; i<nM; i++)
+            pM[i] = gain_par[band]*pPar[i] + gain_lin[band]*pLin[i];
+
+        /* Mix, two microphones at a time */
+        pM0 = pM;
+        pM1 = pM + 2*nMics;
+        accR2 = _mm512_setzero_ps();
+        accI2 = _mm512_setzero_ps();
+        for(mic=0; mic+2<=nMics; mic+=2){
+            /* [x0 x1 x0 x1] of mic and mic+1 */
+            x2  = _mm512_permutexvar_ps(idxX, _mm512_castps256_ps512(_mm256_loadu_ps(pIn + 4*mic)));
+            xs2 = _mm512_permute_ps(x2, 0xB1); /* swap re/im */
+
+            /* [M0m M1m] of mic and mic+1, as [r0 i0 r0' i0' r1 i1 r1' i1'] */
+            m2  = _mm512_castps256_ps512(_mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pM0 + 2*mic)), _mm_loadu_ps(pM1 + 2*mic), 1));
+            aR2 = _mm512_permutexvar_ps(idxRe, m2);
+            aI2 = _mm512_permutexvar_ps(idxIm, m2);
+            accR2 = _mm512_fmadd_ps(aR2, x2,  accR2);
+            accI2 = _mm512_fmadd_ps(aI2, xs2, accI2);
+        }
+        accR = _mm256_add_ps(_mm512_castps512_ps256(accR2), _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(accR2), 1)));
+        accI = _mm256_add_ps(_mm512_castps512_ps256(accI2), _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(accI2), 1)));
+
+        /* Odd number of microphones */
+        for(; mic<nMics; mic++){
+            x  = _mm256_broadcast_ps((const __m128*)(pIn + 4*mic));
+            xs = _mm256_permute_ps(x, 0xB1);
+            aR = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(pM0[2*mic])),   _mm_set1_ps(pM1[2*mic]),   1);
+            aI = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(pM0[2*mic+1])), _mm_set1_ps(pM1[2*mic+1]), 1);
+            accR = _mm256_fmadd_ps(aR, x,  accR);
+            accI = _mm256_fmadd_ps(aI, xs, accI);
+        }
+        _mm256_storeu_ps(pOut, _mm256_addsub_ps(accR, accI));
+    }
+}
+
+/* ========================================================================== */
+/*                                CPU Dispatch                                */
+/* ========================================================================== */
+
+static PROPOSED_KERNEL_ISA proposed_kernels_detectISA(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    unsigned long long xcr0;
+
+    /* AVX and FMA, and the OS saves the YMM registers */
+    __cpuid(info, 1);
+    if(!((info[2]>>27)&1) || !((info[2]>>28)&1) || !((info[2]>>12)&1))
+        return PROPOSED_KERNEL_ISA_SCALAR;
+    xcr0 = _xgetbv(0);
+    if((xcr0&0x6)!=0x6)
+        return PROPOSED_KERNEL_ISA_SCALAR;
+    __cpuidex(info, 7, 0);
+    if(!((info[1]>>5)&1))
+        return PROPOSED_KERNEL_ISA_SCALAR;
+
+    /* AVX-512F, and the OS saves the ZMM registers */
+    if(((info[1]>>16)&1) && (xcr0&0xE6)==0xE6)
+        return PROPOSED_KERNEL_ISA_AVX512;
+    return PROPOSED_KERNEL_ISA_AVX2;
+#else
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f"))
+        return PROPOSED_KERNEL_ISA_AVX512;
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return PROPOSED_KERNEL_ISA_AVX2;
+    return PROPOSED_KERNEL_ISA_SCALAR;
+#endif
+}
+
+#endif /* PROPOSED_KERNELS_X86 */
+
+/* The detection is idempotent, so concurrent first calls are harmless */
+static int kernelISA = -1;
+
+PROPOSED_KERNEL_ISA proposed_kernels_getISA(void)
+{
+    if(kernelISA<0){
+#if PROPOSED_KERNELS_X86
+        kernelISA = (int)proposed_kernels_detectISA();
+#else
+        kernelISA = (int)PROPOSED_KERNEL_ISA_SCALAR;
+#endif
+    }
+    return (PROPOSED_KERNEL_ISA)kernelISA;
+}
+
+proposed_mixKernel proposed_kernels_getMixKernel(void)
+{
+    return proposed_kernels_getMixKernelForISA(proposed_kernels_getISA());
+}
+
+proposed_mixKernel proposed_kernels_getMixKernelForISA
+(
+    PROPOSED_KERNEL_ISA isa
+)
+{
+    if(isa>proposed_kernels_getISA())
+        return NULL; /* not supported by the host CPU (or not compiled) */
+    switch(isa){
+#if PROPOSED_KERNELS_X86
+        case PROPOSED_KERNEL_ISA_AVX512: return proposed_kernels_mix_avx512;
+        case PROPOSED_KERNEL_ISA_AVX2:   return proposed_kernels_mix_avx2;
+#endif
+        default:                         return proposed_kernels_mix_scalar;
+    }
+}
+
+/* ========================================================================== */
+/*                           Small-Matrix Kernels                             */
+/* ========================================================================== */
+
+/** Maximum number of Jacobi sweeps (convergence usually takes 4-6) */
+#define PROPOSED_SMALLMAT_MAX_SWEEPS ( 12 )
+
+/** Jacobi convergence threshold, relative off-diagonal to diagonal energy */
+#define PROPOSED_SMALLMAT_JACOBI_TOL ( 1e-12f )
+
+/** Matrices with |det(A)| below this, relative to mean(|diag(A)|)^K, are treated as singular by proposed_smallmat_cinv() */
+#define PROPOSED_SMALLMAT_CINV_TOL ( 1e-6 )
+
+/** Diagonal loading applied to singular matrices by proposed_smallmat_cinv(), relative to mean(|diag(A)|) */
+#define PROPOSED_SMALLMAT_CINV_LOADING ( 1e-3f )
+
+#if PROPOSED_MAX_K != 3
+# error "The small-matrix kernels are specialised for PROPOSED_MAX_K == 3"
+#endif
+
+/* Closed-form inverse of a general complex K x K matrix, K = 1..3; returns |det(A)|^2, and leaves invA untouched if it is 0 */
+static inline float proposed_smallmat_cinvClosedForm
+(
+    const float* A,
+    const int K,
+    float* invA
+)
+{
+    int i, j;
+    float detr, deti, idetr, ideti, den, cr, ci;
+    float C[2*9]; /* cofactors */
+
+#define PSM_MULR(a, b) ((A)[2*(a)]*(A)[2*(b)] - (A)[2*(a)+1]*(A)[2*(b)+1])
+#define PSM_MULI(a, b) ((A)[2*(a)]*(A)[2*(b)+1] + (A)[2*(a)+1]*(A)[2*(b)])
+    switch(K){
+        case 1:
+            den = A[0]*A[0] + A[1]*A[1];
+            if(den>0.0f){
+                invA[0] =  A[0]/den;
+                invA[1] = -A[1]/den;
+            }
+            return den;
+        case 2:
+            detr = PSM_MULR(0, 3) - PSM_MULR(1, 2);
+            deti = PSM_MULI(0, 3) - PSM_MULI(1, 2);
+            C[0] =  A[6]; C[1] =  A[7]; /* d */
+            C[2] = -A[2]; C[3] = -A[3]; /* -b */
+            C[4] = -A[4]; C[5] = -A[5]; /* -c */
+            C[6] =  A[0]; C[7] =  A[1]; /* a */
+            break;
+        default: /* 3 */
+            /* Adjugate, adj(A)[i][j] = cofactor(A)[j][i] */
+            for(i=0; i<3; i++){
+                for(j=0; j<3; j++){
+                    C[2*(j*3+i)]   = PSM_MULR(((i+1)%3)*3+(j+1)%3, ((i+2)%3)*3+(j+2)%3) - PSM_MULR(((i+1)%3)*3+(j+2)%3, ((i+2)%3)*3+(j+1)%3);
+                    C[2*(j*3+i)+1] = PSM_MULI(((i+1)%3)*3+(j+1)%3, ((i+2)%3)*3+(j+2)%3) - PSM_MULI(((i+1)%3)*3+(j+2)%3, ((i+2)%3)*3+(j+1)%3);
+                }
+            }
+            /* Expansion along the first row */
+            detr = deti = 0.0f;
+            for(j=0; j<3; j++){
+                detr += A[2*j]*C[2*(j*3)]   - A[2*j+1]*C[2*(j*3)+1];
+                deti += A[2*j]*C[2*(j*3)+1] + A[2*j+1]*C[2*(j*3)];
+            }
+            break;
+    }
+#undef PSM_MULR
+#undef PSM_MULI
+
+    den = detr*detr + deti*deti;
+    if(den<=0.0f)
+        return den;
+    idetr =  detr/den;
+    ideti = -deti/den;
+    for(i=0; i<K*K; i++){
+        cr = C[2*i];
+        ci = C[2*i+1];
+        invA[2*i]   = cr*idetr - ci*ideti;
+        invA[2*i+1] = cr*ideti + ci*idetr;
+    }
+    return den;
+}
+
+void proposed_smallmat_cinv
+(
+    const float* A,
+    int K,
+    float* invA
+)
+{
+    int i;
+    float scale, den;
+    double thresh;
+    float Areg[2*9];
+
+    /* Scale of the matrix, to which the singularity threshold is relative */
+    scale = 0.0f;
+    for(i=0; i<K; i++)
+        scale += sqrtf(A[2*(i*K+i)]*A[2*(i*K+i)] + A[2*(i*K+i)+1]*A[2*(i*K+i)+1]);
+    scale /= (float)K;
+    thresh = PROPOSED_SMALLMAT_CINV_TOL;
+    for(i=0; i<K; i++)
+        thresh *= (double)scale;
+    den = proposed_smallmat_cinvClosedForm(A, K, invA);
+    if((double)den > thresh*thresh)
+        return;
+
+    /* (Nearly) singular, so invert a diagonally loaded version instead (or output zeros if A is zero) */
+    memcpy(Areg, A, 2*K*K*sizeof(float));
+    for(i=0; i<K; i++)
+        Areg[2*(i*K+i)] += PROPOSED_SMALLMAT_CINV_LOADING*scale;
+    if(scale<=0.0f || proposed_smallmat_cinvClosedForm(Areg, K, invA)<=0.0f)
+        memset(invA, 0, 2*K*K*sizeof(float));
+}
+
+#define PSM_N 4
+#include "proposed_smallmat.h"
+#undef PSM_N
+#define PSM_N 6
+#include "proposed_smallmat.h"
+#undef PSM_N
+#define PSM_N 8
+#include "proposed_smallmat.h"
+#undef PSM_N
+
+const proposed_smallmat_kernels* proposed_kernels_getSmallMat(int nMics)
+{
+#ifdef PROPOSED_DISABLE_SMALLMAT
+    return NULL;
+#else
+    switch(nMics){
+        case 4:  return &proposed_smallmat_kernels_4;
+        case 6:  return &proposed_smallmat_kernels_6;
+        case 8:  return &proposed_smallmat_kernels_8;
+        default: return NULL;
+    }
+#endif
+}
@@ -0,0 +1,154 @@
+/**
+ * @file proposed_parallel.c
+ * @ingroup PROPOSED
+ * @brief Worker threads for the initialisation of the proposed method
+ *
+ * Most of the precomputation done by proposed_analysis_create() and
+ * proposed_synthesis_create() is independent per band or per direction, so it
+ * is split between a number of worker threads. Each index is always processed
+ * in full by a single call, which only writes to its own outputs, so the
+ * results do not depend on the number of threads or on their scheduling.
+ *
+ * This is only intended for initialisation; the threads are started and
+ * joined for each call. The thread limit may be changed from any thread (e.g.
+ * the GUI, while another thread is initialising), so it is read and written
+ * atomically.
+ *
+ * @author agent
+ * @date 19th October 2026
+ */
+
+#include "proposed_internal.h"
+
+#if defined(_WIN32)
+# include <windows.h>
+# define PROPOSED_PARALLEL_LOAD(x) ( InterlockedCompareExchange((x), 0, 0) )
+# define PROPOSED_PARALLEL_STORE(x, value) ( InterlockedExchange((x), (value)) )
+#else
+# include <pthread.h>
+# include <unistd.h>
+# define PROPOSED_PARALLEL_LOAD(x) ( __sync_fetch_and_add((x), 0) )
+# define PROPOSED_PARALLEL_STORE(x, value) ( __sync_lock_test_and_set((x), (value)) )
+#endif
+
+/** Maximum number of threads set with proposed_setMaxInitThreads() (0: one per processor) */
+static volatile long proposed_maxInitThreads = 0;
+
+/** Work shared by the workers of one proposed_parallel_for() call */
+typedef struct _proposed_parallel_job {
+    proposed_parallelFn fn;          /**< Work function */
+    void* ctx;                       /**< User data passed to fn */
+    int nItems;                      /**< Number of indices */
+    int nWorkers;                    /**< Number of workers */
+    int worker;                      /**< This worker */
+
+} proposed_parallel_job;
+
+/* Each worker takes every nWorkers'th index, so that bands (whose cost tends to grow with frequency) are spread evenly */
+static void proposed_parallel_run
+(
+    proposed_parallel_job* job
+)
+{
+    int i;
+
+    for(i=job->worker; i<job->nItems; i+=job->nWorkers)
+        job->fn(job->ctx, i, job->worker);
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI proposed_parallel_thread(LPVOID job)
+{
+    proposed_parallel_run((proposed_parallel_job*)job);
+    return 0;
+}
+#else
+static void* proposed_parallel_thread(void* job)
+{
+    proposed_parallel_run((proposed_parallel_job*)job);
+    return NULL;
+}
+#endif
+
+void proposed_setMaxInitThreads
+(
+    int nThreads
+)
+{
+    PROPOSED_PARALLEL_STORE(&proposed_maxInitThreads, (long)SAF_MAX(nThreads, 0));
+}
+
+int proposed_getMaxInitThreads(void)
+{
+    return (int)PROPOSED_PARALLEL_LOAD(&proposed_maxInitThreads);
+}
+
+int proposed_parallel_getNumWorkers
+(
+    int nItems
+)
+{
+    int nThreads, maxThreads;
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    nThreads = (int)info.dwNumberOfProcessors;
+#else
+    nThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    maxThreads = proposed_getMaxInitThreads();
+    if(maxThreads>0)
+        nThreads = SAF_MIN(nThreads, maxThreads);
+    nThreads = SAF_MIN(nThreads, PROPOSED_MAX_INIT_THREADS);
+    return SAF_CLAMP(SAF_MIN(nThreads, nItems), 1, PROPOSED_MAX_INIT_THREADS);
+}
+
+void proposed_parallel_for
+(
+    int nItems,
+    int nWorkers,
+    proposed_parallelFn fn,
+    void* ctx
+)
+{
+    proposed_parallel_job jobs[PROPOSED_MAX_INIT_THREADS];
+    int w, started[PROPOSED_MAX_INIT_THREADS];
+#if defined(_WIN32)
+    HANDLE threads[PROPOSED_MAX_INIT_THREADS];
+#else
+    pthread_t threads[PROPOSED_MAX_INIT_THREADS];
+#endif
+
+    nWorkers = SAF_CLAMP(nWorkers, 1, PROPOSED_MAX_INIT_THREADS);
+    for(w=0; w<nWorkers; w++){
+        jobs[w].fn = fn;
+        jobs[w].ctx = ctx;
+        jobs[w].nItems = nItems;
+        jobs[w].nWorkers = nWorkers;
+        jobs[w].worker = w;
+    }
+
+    /* The calling thread is worker 0. If a thread cannot be started, then its share is done here instead */
+    for(w=1; w<nWorkers; w++){
+#if defined(_WIN32)
+        threads[w] = CreateThread(NULL, 0, proposed_parallel_thread, (LPVOID)&jobs[w], 0, NULL);
+        started[w] = threads[w]!=NULL;
+#else
+        started[w] = pthread_create(&threads[w], NULL, proposed_parallel_thread, (void*)&jobs[w])==0;
+#endif
+    }
+    proposed_parallel_run(&jobs[0]);
+    for(w=1; w<nWorkers; w++){
+        if(!started[w]){
+            proposed_parallel_run(&jobs[w]);
+            continue;
+        }
+#if defined(_WIN32)
+        WaitForSingleObject(threads[w], INFINITE);
+        CloseHandle(threads[w]);
+#else
+        pthread_join(threads[w], NULL);
+#endif
+    }
+}
@@ -0,0 +1,172 @@
+/**
+ * @file proposed_profile.c
+ * @ingroup PROPOSED
+ * @brief Per-stage timing of the processing functions of the proposed method
+ *        (see proposed_profile.h)
+ *
+ * The time spent in each stage is summed over the block, and then added to the
+ * raw counters of that stage by proposed_profiler_commit(). The percentiles
+ * are taken from a histogram with logarithmically spaced bins (1us to 1s), so
+ * that nothing needs to be stored per block; they are only computed when the
+ * statistics are requested (proposed_profile_getStats()), which need not be on
+ * the processing thread.
+ *
+ * @author agent
+ * @date 19th October 2026
+ */
+
+#include "proposed_internal.h"
+
+#if defined(_WIN32)
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
+/** Stage names, see #PROPOSED_PROFILE_STAGES */
+static const char* proposed_profile_stageNames[PROPOSED_PROFILE_NUM_STAGES] = {
+    "Forward FB", "Covariance", "Whitening", "EIG", "MUSIC", "Pose update", "BSM", "Mixing construction", "Mixing apply", "Inverse FB"
+};
+
+unsigned long long proposed_profiler_now(void)
+{
+#if defined(_WIN32)
+    static double nsPerCount = 0.0;
+    LARGE_INTEGER freq, count;
+
+    if(nsPerCount==0.0){
+        QueryPerformanceFrequency(&freq);
+        nsPerCount = 1e9/(double)freq.QuadPart;
+    }
+    QueryPerformanceCounter(&count);
+    return (unsigned long long)((double)count.QuadPart*nsPerCount);
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec*1000000000ull + (unsigned long long)ts.tv_nsec;
+#endif
+}
+
+const char* proposed_profile_getStageName
+(
+    PROPOSED_PROFILE_STAGES stage
+)
+{
+    if((int)stage<0 || stage>=PROPOSED_PROFILE_NUM_STAGES)
+        return "";
+    return proposed_profile_stageNames[stage];
+}
+
+void proposed_profiler_reset
+(
+    proposed_profiler* p
+)
+{
+    int enable;
+
+    enable = p->enable;
+    memset(p, 0, sizeof(proposed_profiler));
+    p->enable = enable;
+}
+
+unsigned long long proposed_profiler_begin
+(
+    const proposed_profiler* p
+)
+{
+    return p->enable || proposed_trace_isEnabled() ? proposed_profiler_now() : 0;
+}
+
+void proposed_profiler_end
+(
+    proposed_profiler* p,
+    PROPOSED_PROFILE_STAGES stage,
+    unsigned long long t0
+)
+{
+    unsigned long long t1;
+
+    /* t0 is 0 if neither profiling nor tracing was enabled when the stage started */
+    if(t0==0)
+        return;
+    t1 = proposed_profiler_now();
+    if(p->enable){
+        p->block_ns[stage] += t1 - t0;
+        p->isActive[stage] = 1;
+    }
+    proposed_trace_record(proposed_profile_stageNames[stage], t0, t1);
+}
+
+void proposed_profiler_commit
+(
+    proposed_profiler* p
+)
+{
+    proposed_profile_stage_counters* ps;
+    unsigned long long block_ns;
+    int i, bin;
+
+    for(i=0; i<PROPOSED_PROFILE_NUM_STAGES; i++){
+        if(!p->isActive[i])
+            continue;
+        ps = &(p->counters.stage[i]);
+        block_ns = p->block_ns[i];
+        ps->last_ns = block_ns;
+        ps->max_ns = SAF_MAX(ps->max_ns, block_ns);
+        ps->sum_ns += (double)block_ns;
+        ps->count++;
+        bin = block_ns>1000 ? (int)((float)PROPOSED_PROFILE_BINS_PER_DECADE*log10f((float)block_ns/1000.0f)) : 0;
+        ps->hist[SAF_CLAMP(bin, 0, PROPOSED_PROFILE_NUM_BINS-1)]++;
+        p->block_ns[i] = 0;
+        p->isActive[i] = 0;
+    }
+}
+
+void proposed_profiler_getCounters
+(
+    const proposed_profiler* p,
+    proposed_profile_counters* counters
+)
+{
+    int i;
+
+    for(i=0; i<PROPOSED_PROFILE_NUM_STAGES; i++)
+        if(p->counters.stage[i].count>0)
+            counters->stage[i] = p->counters.stage[i];
+}
+
+void proposed_profile_getStats
+(
+    const proposed_profile_counters* counters,
+    proposed_profile* profile
+)
+{
+    const proposed_profile_stage_counters* ps;
+    proposed_profile_stats* stats;
+    unsigned int count, target, cumulative;
+    int i, bin;
+
+    for(i=0; i<PROPOSED_PROFILE_NUM_STAGES; i++){
+        ps = &(counters->stage[i]);
+        stats = &(profile->stage[i]);
+        count = ps->count;
+        stats->count = count;
+        stats->last_ms = (float)ps->last_ns*1e-6f;
+        stats->max_ms = (float)ps->max_ns*1e-6f;
+        stats->mean_ms = count>0 ? (float)(ps->sum_ns*1e-6/(double)count) : 0.0f;
+
+        /* Upper edge of the bin containing the 99th percentile, but no more than the maximum */
+        stats->p99_ms = 0.0f;
+        if(count>0){
+            target = count - count/100;
+            cumulative = 0;
+            for(bin=0; bin<PROPOSED_PROFILE_NUM_BINS-1; bin++){
+                cumulative += ps->hist[bin];
+                if(cumulative>=target)
+                    break;
+            }
+            stats->p99_ms = SAF_MIN(1e-3f*powf(10.0f, (float)(bin+1)/(float)PROPOSED_PROFILE_BINS_PER_DECADE), stats->max_ms);
+        }
+    }
+}
@@ -0,0 +1,262 @@
+/**
+ * @file proposed_rtguard.c
+ * @ingroup PROPOSED
+ * @brief Real-time safety guard (see proposed_rtguard.h)
+ *
+ * The heap and blocking pthread functions are defined here, and forward to
+ * the C library (the __libc_* allocator entry points of glibc, and the next
+ * definitions of the pthread functions found with dlsym()). Since the core is
+ * linked statically, these definitions take precedence for the whole process.
+ * While the calling thread is inside a real-time region, each call is also
+ * recorded with its call stack. Recording does not itself allocate, and the
+ * call stacks are only symbolised when the report is printed.
+ *
+ * @author agent
+ * @date 19th October 2026
+ */
+
+#if defined(PROPOSED_ENABLE_RT_GUARD) && !defined(_WIN32) && !defined(_GNU_SOURCE)
+# define _GNU_SOURCE /* for RTLD_NEXT */
+#endif
+#include "proposed_internal.h"
+
+#if defined(PROPOSED_ENABLE_RT_GUARD) && defined(__GLIBC__)
+# define PROPOSED_RTGUARD_ACTIVE ( 1 )
+# include <dlfcn.h>
+# include <execinfo.h>
+# include <pthread.h>
+# include <unistd.h>
+#else
+# define PROPOSED_RTGUARD_ACTIVE ( 0 )
+#endif
+
+#if PROPOSED_RTGUARD_ACTIVE
+
+/** Maximum number of violations that are kept (all of them are counted) */
+#define PROPOSED_RTGUARD_MAX_VIOLATIONS ( 32 )
+
+/** Maximum number of frames kept per call stack */
+#define PROPOSED_RTGUARD_MAX_FRAMES ( 24 )
+
+/** One recorded violation */
+typedef struct _proposed_rtguard_violation {
+    const char* function;            /**< Interposed function that was called */
+    const char* region;              /**< Real-time region that it was called from */
+    const char* wrapper;             /**< SAF utility function that it was called from (NULL if none) */
+    int nFrames;                     /**< Number of frames */
+    void* frames[PROPOSED_RTGUARD_MAX_FRAMES]; /**< Call stack */
+
+} proposed_rtguard_violation;
+
+static proposed_rtguard_violation proposed_rtguard_violations[PROPOSED_RTGUARD_MAX_VIOLATIONS];
+static volatile int proposed_rtguard_nViolations = 0;
+static volatile int proposed_rtguard_backtraceReady = 0;
+static __thread int proposed_rtguard_depth = 0;                /**< Nesting depth of the real-time regions on this thread */
+static __thread int proposed_rtguard_recording = 0;            /**< 1 while this thread is recording (i.e. not a violation) */
+static __thread const char* proposed_rtguard_region = NULL;    /**< Outermost real-time region on this thread */
+static __thread const char* proposed_rtguard_wrapper = NULL;   /**< SAF utility function currently being called on this thread */
+
+/* glibc allocator entry points, which are not affected by the definitions below */
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t n, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void* __libc_memalign(size_t alignment, size_t size);
+extern void  __libc_free(void* ptr);
+
+static void proposed_rtguard_check
+(
+    const char* function
+)
+{
+    proposed_rtguard_violation* v;
+    int i;
+
+    if(proposed_rtguard_depth==0 || proposed_rtguard_recording)
+        return;
+    proposed_rtguard_recording = 1;
+    i = __sync_fetch_and_add(&proposed_rtguard_nViolations, 1);
+    if(i<PROPOSED_RTGUARD_MAX_VIOLATIONS){
+        v = &proposed_rtguard_violations[i];
+        v->function = function;
+        v->region = proposed_rtguard_region;
+        v->wrapper = proposed_rtguard_wrapper;
+        v->nFrames = backtrace(v->frames, PROPOSED_RTGUARD_MAX_FRAMES);
+    }
+    proposed_rtguard_recording = 0;
+}
+
+/* Finds the next definition of an interposed function (which is done outside of any real-time region, upon first use) */
+static void* proposed_rtguard_next
+(
+    void** next,
+    const char* name
+)
+{
+    if(*next==NULL)
+        *next = dlsym(RTLD_NEXT, name);
+    return *next;
+}
+
+void* malloc(size_t size)
+{
+    proposed_rtguard_check("malloc");
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size)
+{
+    proposed_rtguard_check("calloc");
+    return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    proposed_rtguard_check("realloc");
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr)
+{
+    if(ptr!=NULL)
+        proposed_rtguard_check("free");
+    __libc_free(ptr);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size)
+{
+    proposed_rtguard_check("posix_memalign");
+    *ptr = __libc_memalign(alignment, size);
+    return *ptr==NULL && size>0 ? 12 /* ENOMEM */ : 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    proposed_rtguard_check("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    static void* next = NULL;
+    proposed_rtguard_check("pthread_mutex_lock");
+    return ((int(*)(pthread_mutex_t*))proposed_rtguard_next(&next, "pthread_mutex_lock"))(mutex);
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t* rwlock)
+{
+    static void* next = NULL;
+    proposed_rtguard_check("pthread_rwlock_rdlock");
+    return ((int(*)(pthread_rwlock_t*))proposed_rtguard_next(&next, "pthread_rwlock_rdlock"))(rwlock);
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t* rwlock)
+{
+    static void* next = NULL;
+    proposed_rtguard_check("pthread_rwlock_wrlock");
+    return ((int(*)(pthread_rwlock_t*))proposed_rtguard_next(&next, "pthread_rwlock_wrlock"))(rwlock);
+}
+
+int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex)
+{
+    static void* next = NULL;
+    proposed_rtguard_check("pthread_cond_wait");
+    return ((int(*)(pthread_cond_t*, pthread_mutex_t*))proposed_rtguard_next(&next, "pthread_cond_wait"))(cond, mutex);
+}
+
+int pthread_create(pthread_t* thread, const pthread_attr_t* attr, void* (*fn)(void*), void* arg)
+{
+    static void* next = NULL;
+    proposed_rtguard_check("pthread_create");
+    return ((int(*)(pthread_t*, const pthread_attr_t*, void* (*)(void*), void*))proposed_rtguard_next(&next, "pthread_create"))(thread, attr, fn, arg);
+}
+
+int pthread_join(pthread_t thread, void** retval)
+{
+    static void* next = NULL;
+    proposed_rtguard_check("pthread_join");
+    return ((int(*)(pthread_t, void**))proposed_rtguard_next(&next, "pthread_join"))(thread, retval);
+}
+
+#endif /* PROPOSED_RTGUARD_ACTIVE */
+
+int proposed_rtguard_isSupported(void)
+{
+    return PROPOSED_RTGUARD_ACTIVE;
+}
+
+void proposed_rtguard_enter
+(
+    const char* region
+)
+{
+#if PROPOSED_RTGUARD_ACTIVE
+    void* frame;
+
+    /* The first call to backtrace() loads the unwinder, which allocates */
+    if(!proposed_rtguard_backtraceReady){
+        backtrace(&frame, 1);
+        proposed_rtguard_backtraceReady = 1;
+    }
+    if(proposed_rtguard_depth++==0)
+        proposed_rtguard_region = region;
+#else
+    (void)region;
+#endif
+}
+
+void proposed_rtguard_leave(void)
+{
+#if PROPOSED_RTGUARD_ACTIVE
+    if(proposed_rtguard_depth>0 && --proposed_rtguard_depth==0)
+        proposed_rtguard_region = NULL;
+#endif
+}
+
+void proposed_rtguard_setWrapper
+(
+    const char* name
+)
+{
+#if PROPOSED_RTGUARD_ACTIVE
+    proposed_rtguard_wrapper = name;
+#else
+    (void)name;
+#endif
+}
+
+int proposed_rtguard_getNumViolations(void)
+{
+#if PROPOSED_RTGUARD_ACTIVE
+    return proposed_rtguard_nViolations;
+#else
+    return 0;
+#endif
+}
+
+void proposed_rtguard_printReport(void)
+{
+#if PROPOSED_RTGUARD_ACTIVE
+    proposed_rtguard_violation* v;
+    int i, nViolations;
+
+    nViolations = proposed_rtguard_nViolations;
+    printf("Real-time safety guard: %d violation(s)\n", nViolations);
+    for(i=0; i<SAF_MIN(nViolations, PROPOSED_RTGUARD_MAX_VIOLATIONS); i++){
+        v = &proposed_rtguard_violations[i];
+        printf("  [%d] %s() inside %s%s%s:\n", i, v->function, v->region!=NULL ? v->region : "?",
+               v->wrapper!=NULL ? ", from " : "", v->wrapper!=NULL ? v->wrapper : "");
+        fflush(stdout);
+        backtrace_symbols_fd(v->frames, v->nFrames, STDOUT_FILENO);
+    }
+    if(nViolations>PROPOSED_RTGUARD_MAX_VIOLATIONS)
+        printf("  (%d more not shown)\n", nViolations-PROPOSED_RTGUARD_MAX_VIOLATIONS);
+    fflush(stdout);
+#endif
+}
+
+void proposed_rtguard_reset(void)
+{
+#if PROPOSED_RTGUARD_ACTIVE
+    proposed_rtguard_nViolations = 0;
+#endif
+}
@@ -0,0 +1,404 @@
+/**
+ * @file proposed_smallmat.h
+ * @ingroup PROPOSED
+ * @brief Template for the fixed-size small-matrix kernels
+ *
+ * This file is included once per supported number of microphones by
+ * proposed_kernels.c, with PSM_N defined to that number. Since all loop bounds
+ * are then compile-time constants, the compiler is able to fully unroll and
+ * keep everything in registers. Matrices are row-major, with interleaved
+ * real/imaginary parts.
+ *
+ * @author agent
+ * @date 19th October 2026
+ */
+
+#ifndef PSM_N
+# error "PSM_N must be defined before including proposed_smallmat.h"
+#endif
+
+#define PSM_CAT_(a, b) a##_##b
+#define PSM_CAT(a, b)  PSM_CAT_(a, b)
+#define PSM_FN(name)   PSM_CAT(proposed_smallmat_##name, PSM_N)
+#define PSM_FNK(name, K) PSM_CAT(PSM_CAT(proposed_smallmat_##name, PSM_N), K)
+
+/** T_Cx_TH = T * Cx * T^H, where Cx is Hermitian; N x N */
+static void PSM_FN(whiten)
+(
+    const float_complex* T,
+    const float_complex* Cx,
+    float_complex* T_Cx_TH
+)
+{
+    int i, j, k;
+    float re, im;
+    float tmp[2*PSM_N*PSM_N];
+    const float* pT  = (const float*)T;
+    const float* pCx = (const float*)Cx;
+    float* pOut = (float*)T_Cx_TH;
+
+    /* tmp = T * Cx */
+    for(i=0; i<PSM_N; i++){
+        for(j=0; j<PSM_N; j++){
+            re = im = 0.0f;
+            for(k=0; k<PSM_N; k++){
+                re += pT[2*(i*PSM_N+k)]*pCx[2*(k*PSM_N+j)]   - pT[2*(i*PSM_N+k)+1]*pCx[2*(k*PSM_N+j)+1];
+                im += pT[2*(i*PSM_N+k)]*pCx[2*(k*PSM_N+j)+1] + pT[2*(i*PSM_N+k)+1]*pCx[2*(k*PSM_N+j)];
+            }
+            tmp[2*(i*PSM_N+j)]   = re;
+            tmp[2*(i*PSM_N+j)+1] = im;
+        }
+    }
+
+    /* out = tmp * T^H; only the upper triangle is computed, since the result is Hermitian */
+    for(i=0; i<PSM_N; i++){
+        for(j=i; j<PSM_N; j++){
+            re = im = 0.0f;
+            for(k=0; k<PSM_N; k++){
+                re += tmp[2*(i*PSM_N+k)]*pT[2*(j*PSM_N+k)]   + tmp[2*(i*PSM_N+k)+1]*pT[2*(j*PSM_N+k)+1];
+                im += tmp[2*(i*PSM_N+k)+1]*pT[2*(j*PSM_N+k)] - tmp[2*(i*PSM_N+k)]*pT[2*(j*PSM_N+k)+1];
+            }
+            pOut[2*(i*PSM_N+j)]   = re;
+            pOut[2*(i*PSM_N+j)+1] = i==j ? 0.0f : im;
+            pOut[2*(j*PSM_N+i)]   = re;
+            pOut[2*(j*PSM_N+i)+1] = i==j ? 0.0f : -im;
+        }
+    }
+}
+
+/**
+ * Eigenvalue decomposition of a Hermitian matrix, using cyclic Jacobi
+ * rotations. Eigenvalues are returned in decending order, with the
+ * corresponding eigenvectors in the columns of V; N x N
+ */
+static void PSM_FN(eigh)
+(
+    const float_complex* A,
+    float_complex* V,
+    float* lambda
+)
+{
+    int i, j, k, p, q, sweep, maxIdx;
+    float off, diag, absApq, ur, ui, theta, t, c, s, tmpf;
+    float gr, gi, hr, hi, xr, xi, yr, yi;
+    float a[2*PSM_N*PSM_N];
+    float* v = (float*)V;
+
+    memcpy(a, A, 2*PSM_N*PSM_N*sizeof(float));
+    memset(v, 0, 2*PSM_N*PSM_N*sizeof(float));
+    for(i=0; i<PSM_N; i++)
+        v[2*(i*PSM_N+i)] = 1.0f;
+
+    for(sweep=0; sweep<PROPOSED_SMALLMAT_MAX_SWEEPS; sweep++){
+        /* Converged once the off-diagonal energy is negligible compared to the diagonal */
+        off = diag = 0.0f;
+        for(i=0; i<PSM_N; i++){
+            diag += a[2*(i*PSM_N+i)]*a[2*(i*PSM_N+i)];
+            for(j=i+1; j<PSM_N; j++)
+                off += a[2*(i*PSM_N+j)]*a[2*(i*PSM_N+j)] + a[2*(i*PSM_N+j)+1]*a[2*(i*PSM_N+j)+1];
+        }
+        if(off <= PROPOSED_SMALLMAT_JACOBI_TOL*diag || off < FLT_MIN)
+            break;
+
+        for(p=0; p<PSM_N-1; p++){
+            for(q=p+1; q<PSM_N; q++){
+                absApq = sqrtf(a[2*(p*PSM_N+q)]*a[2*(p*PSM_N+q)] + a[2*(p*PSM_N+q)+1]*a[2*(p*PSM_N+q)+1]);
+                if(absApq < FLT_MIN)
+                    continue;
+
+                /* Phase of Apq, u = Apq/|Apq|, which makes the rotation real */
+                ur = a[2*(p*PSM_N+q)]/absApq;
+                ui = a[2*(p*PSM_N+q)+1]/absApq;
+
+                /* Real Jacobi rotation for [App |Apq|; |Apq| Aqq] */
+                theta = (a[2*(q*PSM_N+q)] - a[2*(p*PSM_N+p)])/(2.0f*absApq);
+                t = 1.0f/(fabsf(theta) + sqrtf(theta*theta + 1.0f));
+                t = theta < 0.0f ? -t : t;
+                c = 1.0f/sqrtf(t*t + 1.0f);
+                s = t*c;
+
+                /* G = [c, s; -s*conj(u), c*conj(u)], A <- A*G, V <- V*G */
+                gr = -s*ur;  gi = s*ui;   /* -s*conj(u) */
+                hr =  c*ur;  hi = -c*ui;  /*  c*conj(u) */
+                for(k=0; k<PSM_N; k++){
+                    xr = a[2*(k*PSM_N+p)]; xi = a[2*(k*PSM_N+p)+1];
+                    yr = a[2*(k*PSM_N+q)]; yi = a[2*(k*PSM_N+q)+1];
+                    a[2*(k*PSM_N+p)]   = c*xr + yr*gr - yi*gi;
+                    a[2*(k*PSM_N+p)+1] = c*xi + yr*gi + yi*gr;
+                    a[2*(k*PSM_N+q)]   = s*xr + yr*hr - yi*hi;
+                    a[2*(k*PSM_N+q)+1] = s*xi + yr*hi + yi*hr;
+                    xr = v[2*(k*PSM_N+p)]; xi = v[2*(k*PSM_N+p)+1];
+                    yr = v[2*(k*PSM_N+q)]; yi = v[2*(k*PSM_N+q)+1];
+                    v[2*(k*PSM_N+p)]   = c*xr + yr*gr - yi*gi;
+                    v[2*(k*PSM_N+p)+1] = c*xi + yr*gi + yi*gr;
+                    v[2*(k*PSM_N+q)]   = s*xr + yr*hr - yi*hi;
+                    v[2*(k*PSM_N+q)+1] = s*xi + yr*hi + yi*hr;
+                }
+
+                /* A <- G^H*A, where G^H = [c, -s*u; s, c*u] */
+                for(k=0; k<PSM_N; k++){
+                    xr = a[2*(p*PSM_N+k)]; xi = a[2*(p*PSM_N+k)+1];
+                    yr = a[2*(q*PSM_N+k)]; yi = a[2*(q*PSM_N+k)+1];
+                    a[2*(p*PSM_N+k)]   = c*xr - s*(ur*yr - ui*yi);
+                    a[2*(p*PSM_N+k)+1] = c*xi - s*(ur*yi + ui*yr);
+                    a[2*(q*PSM_N+k)]   = s*xr + c*(ur*yr - ui*yi);
+                    a[2*(q*PSM_N+k)+1] = s*xi + c*(ur*yi + ui*yr);
+                }
+
+                /* Remove round-off */
+                a[2*(p*PSM_N+q)] = a[2*(p*PSM_N+q)+1] = 0.0f;
+                a[2*(q*PSM_N+p)] = a[2*(q*PSM_N+p)+1] = 0.0f;
+                a[2*(p*PSM_N+p)+1] = a[2*(q*PSM_N+q)+1] = 0.0f;
+            }
+        }
+    }
+
+    /* Sort in decending order */
+    for(i=0; i<PSM_N; i++)
+        lambda[i] = a[2*(i*PSM_N+i)];
+    for(i=0; i<PSM_N-1; i++){
+        maxIdx = i;
+        for(j=i+1; j<PSM_N; j++)
+            if(lambda[j] > lambda[maxIdx])
+                maxIdx = j;
+        if(maxIdx!=i){
+            tmpf = lambda[i]; lambda[i] = lambda[maxIdx]; lambda[maxIdx] = tmpf;
+            for(k=0; k<PSM_N; k++){
+                xr = v[2*(k*PSM_N+i)]; xi = v[2*(k*PSM_N+i)+1];
+                v[2*(k*PSM_N+i)]   = v[2*(k*PSM_N+maxIdx)];
+                v[2*(k*PSM_N+i)+1] = v[2*(k*PSM_N+maxIdx)+1];
+                v[2*(k*PSM_N+maxIdx)]   = xr;
+                v[2*(k*PSM_N+maxIdx)+1] = xi;
+            }
+        }
+    }
+}
+
+/**
+ * Inverse of a Hermitian positive-definite matrix, via its Cholesky
+ * factorisation A = L*L^H, such that inv(A) = inv(L)^H * inv(L); N x N
+ *
+ * @returns 0 on success, or -1 if A is not (numerically) positive-definite
+ */
+static int PSM_FN(invHPD)
+(
+    const float_complex* A,
+    float_complex* invA
+)
+{
+    int i, j, k;
+    float re, im, d;
+    float L[2*PSM_N*PSM_N], iL[2*PSM_N*PSM_N], invDiag[PSM_N];
+    const float* pA = (const float*)A;
+    float* pOut = (float*)invA;
+
+    /* Cholesky factorisation */
+    memset(L, 0, 2*PSM_N*PSM_N*sizeof(float));
+    for(j=0; j<PSM_N; j++){
+        d = pA[2*(j*PSM_N+j)];
+        for(k=0; k<j; k++)
+            d -= L[2*(j*PSM_N+k)]*L[2*(j*PSM_N+k)] + L[2*(j*PSM_N+k)+1]*L[2*(j*PSM_N+k)+1];
+        if(!(d > 0.0f))
+            return -1;
+        L[2*(j*PSM_N+j)] = sqrtf(d);
+        invDiag[j] = 1.0f/L[2*(j*PSM_N+j)];
+        for(i=j+1; i<PSM_N; i++){
+            re = pA[2*(i*PSM_N+j)];
+            im = pA[2*(i*PSM_N+j)+1];
+            for(k=0; k<j; k++){ /* L[i][k]*conj(L[j][k]) */
+                re -= L[2*(i*PSM_N+k)]*L[2*(j*PSM_N+k)]   + L[2*(i*PSM_N+k)+1]*L[2*(j*PSM_N+k)+1];
+                im -= L[2*(i*PSM_N+k)+1]*L[2*(j*PSM_N+k)] - L[2*(i*PSM_N+k)]*L[2*(j*PSM_N+k)+1];
+            }
+            L[2*(i*PSM_N+j)]   = re*invDiag[j];
+            L[2*(i*PSM_N+j)+1] = im*invDiag[j];
+        }
+    }
+
+    /* inv(L), by forward substitution (also lower triangular) */
+    memset(iL, 0, 2*PSM_N*PSM_N*sizeof(float));
+    for(j=0; j<PSM_N; j++){
+        iL[2*(j*PSM_N+j)] = invDiag[j];
+        for(i=j+1; i<PSM_N; i++){
+            re = im = 0.0f;
+            for(k=j; k<i; k++){
+                re += L[2*(i*PSM_N+k)]*iL[2*(k*PSM_N+j)]   - L[2*(i*PSM_N+k)+1]*iL[2*(k*PSM_N+j)+1];
+                im += L[2*(i*PSM_N+k)]*iL[2*(k*PSM_N+j)+1] + L[2*(i*PSM_N+k)+1]*iL[2*(k*PSM_N+j)];
+            }
+            iL[2*(i*PSM_N+j)]   = -re*invDiag[i];
+            iL[2*(i*PSM_N+j)+1] = -im*invDiag[i];
+        }
+    }
+
+    /* inv(A) = inv(L)^H * inv(L); only the upper triangle is computed, since the result is Hermitian */
+    for(i=0; i<PSM_N; i++){
+        for(j=i; j<PSM_N; j++){
+            re = im = 0.0f;
+            for(k=j; k<PSM_N; k++){ /* conj(iL[k][i])*iL[k][j] */
+                re += iL[2*(k*PSM_N+i)]*iL[2*(k*PSM_N+j)]   + iL[2*(k*PSM_N+i)+1]*iL[2*(k*PSM_N+j)+1];
+                im += iL[2*(k*PSM_N+i)]*iL[2*(k*PSM_N+j)+1] - iL[2*(k*PSM_N+i)+1]*iL[2*(k*PSM_N+j)];
+            }
+            pOut[2*(i*PSM_N+j)]   = re;
+            pOut[2*(i*PSM_N+j)+1] = i==j ? 0.0f : im;
+            pOut[2*(j*PSM_N+i)]   = re;
+            pOut[2*(j*PSM_N+i)+1] = i==j ? 0.0f : -im;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Source beamformers, Ds = inv(As^H*invCx*As) * As^H*invCx; K x N, and the
+ * residual, Dd = I - As*Ds; N x N
+ */
+static inline void PSM_FN(sourceFilters)
+(
+    const float_complex* As,
+    const float_complex* invCx,
+    const int K,
+    float_complex* Ds,
+    float_complex* Dd
+)
+{
+    int i, j, k;
+    float re, im;
+    float AH_Cx[2*PROPOSED_MAX_K*PSM_N], AH_Cx_A[2*PROPOSED_MAX_K*PROPOSED_MAX_K], inv_AH_Cx_A[2*PROPOSED_MAX_K*PROPOSED_MAX_K];
+    const float* pAs = (const float*)As;
+    const float* pCx = (const float*)invCx;
+    float* pDs = (float*)Ds;
+    float* pDd = (float*)Dd;
+
+    /* AH_Cx = As^H * invCx; K x N */
+    for(i=0; i<K; i++){
+        for(j=0; j<PSM_N; j++){
+            re = im = 0.0f;
+            for(k=0; k<PSM_N; k++){ /* conj(As[k][i])*invCx[k][j] */
+                re += pAs[2*(k*K+i)]*pCx[2*(k*PSM_N+j)]   + pAs[2*(k*K+i)+1]*pCx[2*(k*PSM_N+j)+1];
+                im += pAs[2*(k*K+i)]*pCx[2*(k*PSM_N+j)+1] - pAs[2*(k*K+i)+1]*pCx[2*(k*PSM_N+j)];
+            }
+            AH_Cx[2*(i*PSM_N+j)]   = re;
+            AH_Cx[2*(i*PSM_N+j)+1] = im;
+        }
+    }
+
+    /* AH_Cx_A = AH_Cx * As; K x K */
+    for(i=0; i<K; i++){
+        for(j=0; j<K; j++){
+            re = im = 0.0f;
+            for(k=0; k<PSM_N; k++){
+                re += AH_Cx[2*(i*PSM_N+k)]*pAs[2*(k*K+j)]   - AH_Cx[2*(i*PSM_N+k)+1]*pAs[2*(k*K+j)+1];
+                im += AH_Cx[2*(i*PSM_N+k)]*pAs[2*(k*K+j)+1] + AH_Cx[2*(i*PSM_N+k)+1]*pAs[2*(k*K+j)];
+            }
+            AH_Cx_A[2*(i*K+j)]   = re;
+            AH_Cx_A[2*(i*K+j)+1] = im;
+        }
+    }
+    proposed_smallmat_cinv(AH_Cx_A, K, inv_AH_Cx_A);
+
+    /* Ds = inv_AH_Cx_A * AH_Cx; K x N */
+    for(i=0; i<K; i++){
+        for(j=0; j<PSM_N; j++){
+            re = im = 0.0f;
+            for(k=0; k<K; k++){
+                re += inv_AH_Cx_A[2*(i*K+k)]*AH_Cx[2*(k*PSM_N+j)]   - inv_AH_Cx_A[2*(i*K+k)+1]*AH_Cx[2*(k*PSM_N+j)+1];
+                im += inv_AH_Cx_A[2*(i*K+k)]*AH_Cx[2*(k*PSM_N+j)+1] + inv_AH_Cx_A[2*(i*K+k)+1]*AH_Cx[2*(k*PSM_N+j)];
+            }
+            pDs[2*(i*PSM_N+j)]   = re;
+            pDs[2*(i*PSM_N+j)+1] = im;
+        }
+    }
+
+    /* Dd = I - As * Ds; N x N */
+    for(i=0; i<PSM_N; i++){
+        for(j=0; j<PSM_N; j++){
+            re = im = 0.0f;
+            for(k=0; k<K; k++){
+                re += pAs[2*(i*K+k)]*pDs[2*(k*PSM_N+j)]   - pAs[2*(i*K+k)+1]*pDs[2*(k*PSM_N+j)+1];
+                im += pAs[2*(i*K+k)]*pDs[2*(k*PSM_N+j)+1] + pAs[2*(i*K+k)+1]*pDs[2*(k*PSM_N+j)];
+            }
+            pDd[2*(i*PSM_N+j)]   = (i==j ? 1.0f : 0.0f) - re;
+            pDd[2*(i*PSM_N+j)+1] = -im;
+        }
+    }
+}
+
+/** out = h_dir * Ds, where h_dir is #NUM_EARS x K and Ds is K x N */
+static inline void PSM_FN(sourceStream)
+(
+    const float_complex* h_dir,
+    const float_complex* Ds,
+    const int K,
+    float_complex* out
+)
+{
+    int i, j, k;
+    float re, im;
+    const float* pH = (const float*)h_dir;
+    const float* pDs = (const float*)Ds;
+    float* pOut = (float*)out;
+
+    for(i=0; i<NUM_EARS; i++){
+        for(j=0; j<PSM_N; j++){
+            re = im = 0.0f;
+            for(k=0; k<K; k++){
+                re += pH[2*(i*K+k)]*pDs[2*(k*PSM_N+j)]   - pH[2*(i*K+k)+1]*pDs[2*(k*PSM_N+j)+1];
+                im += pH[2*(i*K+k)]*pDs[2*(k*PSM_N+j)+1] + pH[2*(i*K+k)+1]*pDs[2*(k*PSM_N+j)];
+            }
+            pOut[2*(i*PSM_N+j)]   = re;
+            pOut[2*(i*PSM_N+j)+1] = im;
+        }
+    }
+}
+
+/** out = M_lin * Dd, where M_lin is #NUM_EARS x N and Dd is N x N */
+static void PSM_FN(ambientStream)
+(
+    const float_complex* M_lin,
+    const float_complex* Dd,
+    float_complex* out
+)
+{
+    int i, j, k;
+    float re, im;
+    const float* pM = (const float*)M_lin;
+    const float* pDd = (const float*)Dd;
+    float* pOut = (float*)out;
+
+    for(i=0; i<NUM_EARS; i++){
+        for(j=0; j<PSM_N; j++){
+            re = im = 0.0f;
+            for(k=0; k<PSM_N; k++){
+                re += pM[2*(i*PSM_N+k)]*pDd[2*(k*PSM_N+j)]   - pM[2*(i*PSM_N+k)+1]*pDd[2*(k*PSM_N+j)+1];
+                im += pM[2*(i*PSM_N+k)]*pDd[2*(k*PSM_N+j)+1] + pM[2*(i*PSM_N+k)+1]*pDd[2*(k*PSM_N+j)];
+            }
+            pOut[2*(i*PSM_N+j)]   = re;
+            pOut[2*(i*PSM_N+j)+1] = im;
+        }
+    }
+}
+
+/* Specialisations for each number of sources, K = 1..#PROPOSED_MAX_K */
+#define PSM_DEFINE_K(K) \
+static void PSM_FNK(sourceFilters, K)(const float_complex* As, const float_complex* invCx, float_complex* Ds, float_complex* Dd) \
+{ PSM_FN(sourceFilters)(As, invCx, K, Ds, Dd); } \
+static void PSM_FNK(sourceStream, K)(const float_complex* h_dir, const float_complex* Ds, float_complex* out) \
+{ PSM_FN(sourceStream)(h_dir, Ds, K, out); }
+PSM_DEFINE_K(1)
+PSM_DEFINE_K(2)
+PSM_DEFINE_K(3)
+#undef PSM_DEFINE_K
+
+/** Kernel table for this number of microphones */
+static const proposed_smallmat_kernels PSM_FN(kernels) = {
+    PSM_N,
+    PSM_FN(whiten),
+    PSM_FN(eigh),
+    PSM_FN(invHPD),
+    { PSM_FNK(sourceFilters, 1), PSM_FNK(sourceFilters, 2), PSM_FNK(sourceFilters, 3) },
+    { PSM_FNK(sourceStream, 1),  PSM_FNK(sourceStream, 2),  PSM_FNK(sourceStream, 3) },
+    PSM_FN(ambientStream)
+};
+
+#undef PSM_CAT_
+#undef PSM_CAT
+#undef PSM_FN
+#undef PSM_FNK
@@ -56,6 +56,108 @@
 #define DIRECTIVITY_ORDER_MAX ( 4 )
 const float directivity_freqs_hz[NUM_DIRECTIVITIES] = {176.776695296637f,  353.553390593274f, 707.106781186548f, 1414.21356237310f, 2828.42712474619f, 5656.85424949238f, 11313.7084989848f, 22627.4169979695f, 1e10f};
 const float directivity_orders[NUM_DIRECTIVITIES] = {0.4f, 0.5f, 0.65f, 0.8f, 0.95f, 1.2f, 1.8f, 3.2f, 3.9f};
+#define SRC_DIRECTIVITY_TABLE_SIZE ( 257 )
+
+/* Tabulates the source directivity gain for a given (fractional) order, over the cosine of the angle between the original and
+ * translated source directions, from -1 to 1. Since the directivity pattern is axisymmetric, the gain only depends on this angle */
+static void proposed_synthesis_tabulateDirectivity
+(
+    float order_directivity,
+    float* table
+)
+{
+    int i, order_directivity_cl, order_directivity_fl;
+    float c_n[DIRECTIVITY_ORDER_MAX+1];
+    float c_n_fl[DIRECTIVITY_ORDER_MAX+1];
+    float c_nm[ORDER2NSH(DIRECTIVITY_ORDER_MAX)];
+    float y_nm[ORDER2NSH(DIRECTIVITY_ORDER_MAX)];
+    float dir_rad_incl[2], onAxis;
+
+    order_directivity_cl = (int)(order_directivity+1.0f);
+    order_directivity_fl = (int)order_directivity;
+    beamWeightsCardioid2Spherical(order_directivity_cl, (float*)c_n);
+    beamWeightsCardioid2Spherical(order_directivity_fl, (float*)c_n_fl);
+    cblas_sscal(order_directivity_cl+1, (order_directivity-(float)order_directivity_fl), c_n, 1);
+    cblas_saxpy(order_directivity_fl+1, (1.0f - (order_directivity-(float)order_directivity_fl)), c_n_fl, 1, c_n, 1);
+
+    /* Pattern steered towards the north pole, evaluated at inclinations from pi to 0 */
+    rotateAxisCoeffsReal(order_directivity_cl, c_n, 0.0f, 0.0f, c_nm);
+    dir_rad_incl[0] = 0.0f;
+    dir_rad_incl[1] = 0.0f;
+    getSHreal_recur(order_directivity_cl, dir_rad_incl, 1, y_nm);
+    onAxis = cblas_sdot(ORDER2NSH(order_directivity_cl), c_nm, 1, y_nm, 1);
+    for(i=0; i<SRC_DIRECTIVITY_TABLE_SIZE; i++){
+        dir_rad_incl[1] = acosf(SAF_CLAMP(-1.0f + 2.0f*(float)i/(float)(SRC_DIRECTIVITY_TABLE_SIZE-1), -1.0f, 1.0f));
+        getSHreal_recur(order_directivity_cl, dir_rad_incl, 1, y_nm);
+        table[i] = fabsf( cblas_sdot(ORDER2NSH(order_directivity_cl), c_nm, 1, y_nm, 1) / (onAxis + 0.0001f) );
+    }
+}
+
+/* Linearly interpolated look-up of a table made by proposed_synthesis_tabulateDirectivity() */
+static float proposed_synthesis_lookupDirectivity
+(
+    const float* table,
+    float cosAngle
+)
+{
+    int idx;
+    float pos, frac;
+
+    pos = (SAF_CLAMP(cosAngle, -1.0f, 1.0f) + 1.0f) * 0.5f * (float)(SRC_DIRECTIVITY_TABLE_SIZE-1);
+    idx = SAF_MIN((int)pos, SRC_DIRECTIVITY_TABLE_SIZE-2);
+    frac = pos - (float)idx;
+    return (1.0f-frac)*table[idx] + frac*table[idx+1];
+}
+
+/** Arguments and per-worker scratch of proposed_synthesis_pwdBand() */
+typedef struct _proposed_synthesis_pwdJob {
+    proposed_synthesis_data* s;                   /**< Synthesiser being created */
+    int enableEPbeamformers;                      /**< See proposed_synthesis_create() */
+    float_complex* Ad[PROPOSED_MAX_INIT_THREADS]; /**< ATFs of the PWD directions per worker; nMics x nPWD */
+    float_complex* U[PROPOSED_MAX_INIT_THREADS];  /**< Left singular vectors per worker */
+    float_complex* V[PROPOSED_MAX_INIT_THREADS];  /**< Right singular vectors per worker */
+
+} proposed_synthesis_pwdJob;
+
+/* Computes the plane-wave decomposition beamformers of one band */
+static void proposed_synthesis_pwdBand
+(
+    void* ctx,
+    int band,
+    int worker
+)
+{
+    proposed_synthesis_pwdJob* job = (proposed_synthesis_pwdJob*)ctx;
+    proposed_synthesis_data* s = job->s;
+    float_complex *Ad, *U, *V;
+    const float_complex calpha = cmplxf(1.0f, 0.0f); const float_complex cbeta = cmplxf(0.0f, 0.0f); /* blas */
+
+    Ad = job->Ad[worker];
+    U = job->U[worker];
+    V = job->V[worker];
+    proposed_synthesis_getATFs(s, band, s->pwd_indices, s->nPWD, Ad);
+    if(job->enableEPbeamformers){
+        /* As it is done in [2]: */
+        utility_csvd(NULL, Ad, s->nMics, s->nPWD, U, NULL, V, NULL);
+        if (s->nPWD>s->nMics){
+            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, s->nPWD, s->nMics, s->nMics, &calpha,
+                        V, s->nPWD,
+                        U, s->nMics, &cbeta,
+                        &s->M_PWD[band*s->nPWD*s->nMics], s->nMics);
+        }
+        else{
+            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, s->nPWD, s->nMics, s->nPWD, &calpha,
+                        V, s->nPWD,
+                        U, s->nMics, &cbeta,
+                        &s->M_PWD[band*s->nPWD*s->nMics], s->nMics);
+        }
+        cblas_sscal(2*s->nPWD*s->nMics, sqrtf(1.0f/(float)s->nMics), (float*)&s->M_PWD[band*s->nPWD*s->nMics], 1);
+    }
+    else{
+        utility_cpinv(NULL, Ad, s->nMics, s->nPWD, &s->M_PWD[band*s->nPWD*s->nMics]);
+        cblas_sscal(2*s->nPWD*s->nMics, sqrtf((float)s->nMics)/(float)s->nMics, (float*)&s->M_PWD[band*s->nPWD*s->nMics], 1);
+    }
+}
 
 /* ========================================================================== */
 /*                            PROPOSED Synthesis                              */
@@ -76,9 +178,14 @@ void proposed_synthesis_create
     proposed_synthesis_data* s = (proposed_synthesis_data*)malloc1d(sizeof(proposed_synthesis_data));
     *phSyn = (proposed_synthesis_handle)s;
     proposed_analysis_data *a = (proposed_analysis_data*)(hAna);
-    int band, i, j;
+    int band, i, j, dir, lazyHRTFs;
+    float_complex* H_bin_bm;
+    const float_complex* H_dir;
+    proposed_hrtf_model* hrtfModel;
+    unsigned long long key;
     proposed_binaural_config* bConfig;
-    const float_complex calpha = cmplxf(1.0f, 0.0f); const float_complex cbeta = cmplxf(0.0f, 0.0f); /* blas */
+    proposed_synthesis_pwdJob pwdJob;
+    int w, nWorkers;
 
     /* User configuration parameters */
     s->interpOption = interpOption;
@@ -94,6 +201,9 @@ void proposed_synthesis_create
     s->maxBSMFreq = 9e3f;
     s->maxMagLSFreq = 1.5e3f;
     s->linear2parBalance = 1.0f;
+    s->enableLinearOnly = 0;
+    s->profiler.enable = 0;
+    proposed_profiler_reset(&(s->profiler));
 
     /* Things relevant to the synthesiser, which are copied from the analyser to keep things aligned */
     s->fs = a->fs;
@@ -102,53 +212,146 @@ void proposed_synthesis_create
     s->blocksize = a->blocksize;
     s->nDirs = a->nDirs;
     s->nMics = a->nMics;
-    s->H_array = malloc1d(s->nBands*(s->nMics)*(s->nDirs)*sizeof(float_complex));
-    memcpy(s->H_array, a->H_array, s->nBands*(s->nMics)*(s->nDirs)*sizeof(float_complex));
-    s->DCM_array = malloc1d(s->nBands*(s->nMics)*(s->nMics)*sizeof(float_complex));
-    memcpy(s->DCM_array, a->DCM_array, s->nBands*(s->nMics)*(s->nMics)*sizeof(float_complex));
-    s->W = malloc1d(s->nDirs*(s->nDirs)*sizeof(float_complex));
-    memcpy(s->W, a->W, s->nDirs*(s->nDirs)*sizeof(float_complex));
-    s->array_dirs_deg = malloc1d((s->nDirs)*2*sizeof(float));
-    memcpy(s->array_dirs_deg, a->array_dirs_deg, (s->nDirs)*2*sizeof(float));
-    s->array_dirs_xyz = (float**)malloc2d((s->nDirs), 3, sizeof(float));
-    memcpy(FLATTEN2D(s->array_dirs_xyz), a->array_dirs_xyz, (s->nDirs)*3*sizeof(float));
+    s->model = proposed_arrayModel_retain(a->model);
+    s->array_dirs_deg = s->model->array_dirs_deg;
+    s->array_dirs_xyz = s->model->array_dirs_xyz;
     s->timeSlots = a->timeSlots;
-    s->freqVector = malloc1d(s->nBands*sizeof(float));
-    memcpy(s->freqVector, a->freqVector, s->nBands*sizeof(float));
+    s->freqVector = s->model->freqVector;
 
     /* Time-frequency transform */
     afSTFT_create(&(s->hFB_dec), 0, NUM_EARS, s->hopsize, 1, 0, AFSTFT_BANDS_CH_TIME);
+
+    /* Run-time state, i.e. everything that is written to while processing, in the order that it is accessed per block. It is allocated
+     * here in one go, and the parts that depend on the HRTFs and array model are then initialised below */
+    s->nDiff = __Tdesign_degree_21_nPoints;
+    s->nPWD = favour2Daccuracy ? 24 : __Tdesign_degree_6_nPoints;
+    s->filterbankDelay = a->filterbankDelay; /* FIRs are long enough to accommodate the filterbank delay on either side of their peak */
+    assert(s->filterbankDelay>0); /* Otherwise, the FIR window below would be all zeros */
+    for(s->firLength = 2*(s->blocksize); s->firLength < 2*(s->filterbankDelay); s->firLength *= 2);
+    s->nFirPartitions = s->firLength/(s->blocksize);
+    proposed_arena_create(&(s->arena));
+    proposed_arena_reserve1d(s->arena, &(s->diff_pos_xyz), s->nDiff*3, sizeof(float));       /* proposed_synthesis_updatePose() */
+    proposed_arena_reserve1d(s->arena, &(s->diff_dirs_xyz_new), s->nDiff*3, sizeof(float));
+    proposed_arena_reserve1d(s->arena, &(s->diff_gains), s->nDiff, sizeof(float));
+    proposed_arena_reserve1d(s->arena, &(s->diff_dirs_xyz_rot), s->nDiff*3, sizeof(float));
+    proposed_arena_reserve1d(s->arena, &(s->diff_indices), s->nDiff, sizeof(int));
+    proposed_arena_reserve1d(s->arena, &(s->H_bin_diff), s->nBands*NUM_EARS*(s->nDiff), sizeof(float_complex));
+    proposed_arena_reserve1d(s->arena, &(s->M_BSM), s->nBands*NUM_EARS*(s->nMics), sizeof(float_complex));
+    proposed_arena_reserve1d(s->arena, &(s->pwd_pos_xyz), s->nPWD*3, sizeof(float));
+    proposed_arena_reserve1d(s->arena, &(s->pwd_gains), s->nPWD, sizeof(float));
+    proposed_arena_reserve1d(s->arena, &(s->pwd_dirs_xyz_rot), s->nPWD*3, sizeof(float));
+    proposed_arena_reserve1d(s->arena, &(s->pwd_indices), s->nPWD, sizeof(int));
+    proposed_arena_reserve1d(s->arena, &(s->M_HRTFs), s->nBands*NUM_EARS*(s->nPWD), sizeof(float_complex));
+    lazyHRTFs = binConfig!=NULL && (interpOption==PROPOSED_HRTF_INTERP_NEAREST_LAZY || interpOption==PROPOSED_HRTF_INTERP_TRIANGULAR_LAZY);
+    if(lazyHRTFs){ /* filled in upon first use, which may be on the audio thread (see proposed_synthesis_getHRTF()) */
+        proposed_arena_reserve1d(s->arena, &(s->H_bin), s->nBands*NUM_EARS*(s->nDirs), sizeof(float_complex));
+        proposed_arena_reserve1d(s->arena, &(s->H_bin_isValid), s->nDirs, sizeof(int));
+    }
+    proposed_arena_reserve1d(s->arena, &(s->As), (s->nMics)*PROPOSED_MAX_K, sizeof(float_complex)); /* proposed_synthesis_computeMixingMatrix() */
+    proposed_arena_reserve1d(s->arena, &(s->Ds), PROPOSED_MAX_K*(s->nMics), sizeof(float_complex));
+    proposed_arena_reserve1d(s->arena, &(s->Dd), (s->nMics)*(s->nMics), sizeof(float_complex));
+    proposed_arena_reserve1d(s->arena, &(s->new_M_par), NUM_EARS*(s->nMics), sizeof(float_complex));
+    proposed_arena_reserve2d(s->arena, &(s->M_par), s->nBands, NUM_EARS*(s->nMics), sizeof(float_complex));
+    proposed_arena_reserve2d(s->arena, &(s->M_lin), s->nBands, NUM_EARS*(s->nMics), sizeof(float_complex));
+    proposed_arena_reserve1d(s->arena, &(s->gain_par), s->nBands, sizeof(float));
+    proposed_arena_reserve1d(s->arena, &(s->gain_lin), s->nBands, sizeof(float));
+    proposed_arena_reserve2d(s->arena, &(s->M), s->nBands, NUM_EARS*(s->nMics), sizeof(float_complex)); /* proposed_synthesis_mixBands() etc. */
+    proposed_arena_reserve3d(s->arena, &(s->outTF), s->nBands, NUM_EARS, s->timeSlots, sizeof(float_complex));
+    proposed_arena_reserve2d(s->arena, &(s->outTD), NUM_EARS, s->blocksize, sizeof(float));
+    proposed_arena_reserve1d(s->arena, &(s->firTD), s->firLength, sizeof(float));     /* proposed_synthesis_computeStaticFIRs() */
+    proposed_arena_reserve1d(s->arena, &(s->firTF), s->firLength/2+1, sizeof(float_complex));
+    proposed_arena_reserve2d(s->arena, &(s->M_fir), s->nBands, NUM_EARS*(s->nMics), sizeof(float_complex));
+    proposed_arena_reserve1d(s->arena, &(s->H_fir), NUM_EARS*(s->nMics)*(s->nFirPartitions)*(s->blocksize+1), sizeof(float_complex));
+    proposed_arena_reserve1d(s->arena, &(s->firInTD), (s->nMics)*2*(s->blocksize), sizeof(float)); /* proposed_synthesis_applyStaticFIRs() */
+    proposed_arena_reserve1d(s->arena, &(s->X_fdl), (s->nFirPartitions)*(s->nMics)*(s->blocksize+1), sizeof(float_complex));
+    proposed_arena_reserve1d(s->arena, &(s->Y_fir), s->blocksize+1, sizeof(float_complex));
+    proposed_arena_reserve1d(s->arena, &(s->firOutTD), 2*(s->blocksize), sizeof(float));
+    proposed_arena_commit(s->arena);
  
-    /* Copy binaural configuration */
-    s->binConfig = malloc1d(sizeof(proposed_binaural_config));
-    bConfig = s->binConfig;
-    bConfig->lHRIR = binConfig->lHRIR;
-    bConfig->nHRIR = binConfig->nHRIR;
-    bConfig->hrir_fs = binConfig->hrir_fs;
-    bConfig->hrirs = malloc1d(bConfig->nHRIR * NUM_EARS * (bConfig->lHRIR) * sizeof(float));
-    memcpy(bConfig->hrirs, binConfig->hrirs, bConfig->nHRIR * NUM_EARS * (bConfig->lHRIR) * sizeof(float));
-    bConfig->hrir_dirs_deg = malloc1d(bConfig->nHRIR*2*sizeof(float));
-    memcpy(bConfig->hrir_dirs_deg, binConfig->hrir_dirs_deg, bConfig->nHRIR*2*sizeof(float));
+    /* Copy binaural configuration. The HRIRs are only read during initialisation, so they are used in place rather than copied */
+    s->binConfig = calloc1d(1, sizeof(proposed_binaural_config));
+    if(binConfig!=NULL){
+        s->binConfig->lHRIR = binConfig->lHRIR;
+        s->binConfig->nHRIR = binConfig->nHRIR;
+        s->binConfig->hrir_fs = binConfig->hrir_fs;
+    }
+    bConfig = binConfig;
     
     /* DIRECT-STREAM Pre-process HRTFs, interpolate them for the scanning grid */
-    s->H_bin = calloc1d(s->nBands*NUM_EARS*(s->nDirs),sizeof(float_complex));
-    proposed_getInterpolatedHRTFs(hAna, interpOption, bConfig, a->array_dirs_deg, s->nDirs, enableDiffEQ_HRTFs, s->H_bin);
+    s->nHRIR = s->binConfig->nHRIR;
+    if(bConfig==NULL){
+        /* HRTFs stored in the bundle that the analyser was loaded from, which are owned by the array model */
+        assert(s->model->H_bin!=NULL);
+        s->interpOption = (PROPOSED_HRTF_INTERP_OPTIONS)s->model->hrtfInterpOption;
+        s->H_bin = s->model->H_bin;
+        s->hrtfModel = NULL;
+        s->H_bin_isValid = NULL;
+        s->H_meas = NULL;
+        s->itds_meas = NULL;
+        s->interpIdx = NULL;
+        s->interpW = NULL;
+        s->dfEQ = NULL;
+    }
+    else if(lazyHRTFs){
+        /* Only the directions that are actually used are interpolated, upon first use. The T-design and PWD directions are
+         * pre-warmed below. H_bin is in the arena, but is also written here in full (in case the arena is disabled, see
+         * proposed_setRunTimeMemoryOption()), so that its pages are not faulted in on the audio thread when a new direction
+         * is first used */
+        memset(s->H_bin, 0, s->nBands*NUM_EARS*(s->nDirs)*sizeof(float_complex));
+        s->hrtfModel = NULL;
+        s->H_meas = malloc1d(s->nBands*NUM_EARS*(s->nHRIR)*sizeof(float_complex));
+        s->itds_meas = malloc1d(s->nHRIR*sizeof(float));
+        s->interpIdx = malloc1d(s->nDirs*3*sizeof(int));
+        s->interpW = malloc1d(s->nDirs*3*sizeof(float));
+        s->dfEQ = malloc1d(s->nBands*NUM_EARS*sizeof(float));
+        proposed_getLazyHRTFData(hAna, interpOption, bConfig, a->array_dirs_deg, s->nDirs, enableDiffEQ_HRTFs,
+                                 s->H_meas, s->itds_meas, s->interpIdx, s->interpW, s->dfEQ);
+    }
+    else{
+        /* The interpolated HRTFs are shared by all synthesisers created for the same array model and HRIRs */
+        key = proposed_cache_hash(PROPOSED_CACHE_HASH_SEED, "hrtf", 4);
+        key = proposed_cache_hash(key, &(s->model->entry.key), sizeof(unsigned long long));
+        key = proposed_cache_hash(key, &interpOption, sizeof(PROPOSED_HRTF_INTERP_OPTIONS));
+        key = proposed_cache_hash(key, &enableDiffEQ_HRTFs, sizeof(int));
+        key = proposed_cache_hash(key, &(bConfig->nHRIR), sizeof(int));
+        key = proposed_cache_hash(key, &(bConfig->lHRIR), sizeof(int));
+        key = proposed_cache_hash(key, &(bConfig->hrir_fs), sizeof(int));
+        key = proposed_cache_hash(key, bConfig->hrir_dirs_deg, bConfig->nHRIR*2*sizeof(float));
+        key = proposed_cache_hash(key, bConfig->hrirs, bConfig->nHRIR*NUM_EARS*(bConfig->lHRIR)*sizeof(float));
+        hrtfModel = s->model->entry.key!=0 ? (proposed_hrtf_model*)proposed_cache_find(key) : NULL;
+        if(hrtfModel==NULL){
+            hrtfModel = proposed_hrtfModel_create();
+            hrtfModel->entry.key = s->model->entry.key!=0 ? key : 0;
+            H_bin_bm = calloc1d(s->nBands*NUM_EARS*(s->nDirs),sizeof(float_complex));
+            proposed_getInterpolatedHRTFs(hAna, interpOption, bConfig, a->array_dirs_deg, s->nDirs, enableDiffEQ_HRTFs, H_bin_bm);
+            hrtfModel->H_bin = malloc1d(s->nBands*NUM_EARS*(s->nDirs)*sizeof(float_complex));
+            proposed_toDirectionMajor(H_bin_bm, s->nBands, NUM_EARS, s->nDirs, hrtfModel->H_bin);
+            free(H_bin_bm);
+            if(hrtfModel->entry.key!=0)
+                hrtfModel = (proposed_hrtf_model*)proposed_cache_insert(&(hrtfModel->entry));
+        }
+        s->hrtfModel = hrtfModel;
+        s->H_bin = hrtfModel->H_bin;
+        s->H_bin_isValid = NULL;
+        s->H_meas = NULL;
+        s->itds_meas = NULL;
+        s->interpIdx = NULL;
+        s->interpW = NULL;
+        s->dfEQ = NULL;
+    }
     
     /* AMBIENT-STREAM */
-    s->nDiff = __Tdesign_degree_21_nPoints;
     s->diff_dirs_xyz = malloc1d(s->nDiff*3*sizeof(float));
     unitSph2cart((float*)__Tdesign_degree_21_dirs_deg, s->nDiff, 1, s->diff_dirs_xyz);
     s->H_array_diff = calloc1d(s->nBands*s->nMics*(s->nDiff),sizeof(float_complex));
-    s->H_bin_diff = calloc1d(s->nBands*NUM_EARS*(s->nDiff),sizeof(float_complex));
-    s->diff_indices = malloc1d(s->nDiff*sizeof(int));
-    proposed_findNearestGridIndices(FLATTEN2D(s->array_dirs_xyz), s->diff_dirs_xyz, s->nDirs, s->nDiff, s->diff_indices);
-    for(band=0; band<s->nBands; band++){
-        for(i=0; i<s->nMics; i++)
-            for(j=0; j<s->nDiff; j++)
-                s->H_array_diff[band*s->nMics*s->nDiff + i*s->nDiff + j] = s->H_array[band*s->nMics*s->nDirs + i*s->nDirs + s->diff_indices[j]];
-        for(i=0; i<NUM_EARS; i++)
-            for(j=0; j<s->nDiff; j++)
-                s->H_bin_diff[band*NUM_EARS*s->nDiff + i*s->nDiff + j] = s->H_bin[band*NUM_EARS*s->nDirs + i*s->nDirs + s->diff_indices[j]];
+    proposed_findNearestGridIndices(s->array_dirs_xyz, s->diff_dirs_xyz, s->nDirs, s->nDiff, s->diff_indices);
+    for(band=0; band<s->nBands; band++)
+        proposed_synthesis_getATFs(s, band, s->diff_indices, s->nDiff, &(s->H_array_diff[band*s->nMics*s->nDiff]));
+    for(j=0; j<s->nDiff; j++){
+        H_dir = proposed_synthesis_getHRTF(s, s->diff_indices[j]);
+        for(band=0; band<s->nBands; band++)
+            for(i=0; i<NUM_EARS; i++)
+                s->H_bin_diff[band*NUM_EARS*s->nDiff + i*s->nDiff + j] = H_dir[band*NUM_EARS + i];
     }
     
     /* Diffuse-field equalisation term, as in [2] */
@@ -163,20 +366,24 @@ void proposed_synthesis_create
         s->diffEQ[band] = enableDiffEQ_ATFs ? SAF_MIN(sqrtf(1.0f / cblas_scasum(s->nMics, &D_array[band * s->nMics * s->nMics], s->nMics + 1)), 2.0f) : 1.0f;  //cblas_scasum(NUM_EARS, &s->H_bin_diff[band * NUM_EARS * NUM_EARS], NUM_EARS + 1)
     free(D_array);
     free(D_bin);
+
+    /* Source directivity gain tables; the last table is for bands above all directivity frequencies (order 0) */
+    s->srcDirTables = malloc1d((NUM_DIRECTIVITIES+1)*SRC_DIRECTIVITY_TABLE_SIZE*sizeof(float));
+    for(dir=0; dir<=NUM_DIRECTIVITIES; dir++)
+        proposed_synthesis_tabulateDirectivity(dir<NUM_DIRECTIVITIES ? directivity_orders[dir] : 0.0f, &(s->srcDirTables[dir*SRC_DIRECTIVITY_TABLE_SIZE]));
+    s->srcDirTableIdx = malloc1d(s->nBands*sizeof(int));
+    for(band=0; band<s->nBands; band++){
+        s->srcDirTableIdx[band] = NUM_DIRECTIVITIES;
+        for(dir=NUM_DIRECTIVITIES-1; dir>=0; dir--)
+            if(s->freqVector[band]<directivity_freqs_hz[dir])
+                s->srcDirTableIdx[band] = dir;
+    }
      
     /* BSM 6DoF baseline */
-    s->M_BSM = malloc1d(s->nBands*NUM_EARS*s->nMics*sizeof(float_complex));
-    s->diff_pos_xyz = malloc1d(s->nDiff*3*sizeof(float));
-    s->diff_dirs_xyz_new = malloc1d(s->nDiff*3*sizeof(float));
-    s->diff_dirs_xyz_rot = malloc1d(s->nDiff*3*sizeof(float));
-    s->diff_gains = calloc1d(s->nDiff, sizeof(float));
     proposed_array2binauralMagLS_create(&s->hBSM, s->H_array_diff, s->nBands, s->nMics, s->nDiff);
        
     /* Linear 6DoF baseline */
-    s->nPWD = favour2Daccuracy ? 24 : __Tdesign_degree_6_nPoints;
     s->pwd_dirs_xyz = malloc1d(s->nPWD*3*sizeof(float));
-    s->pwd_pos_xyz = malloc1d(s->nPWD*3*sizeof(float));
-    s->pwd_dirs_xyz_rot = malloc1d(s->nPWD*3*sizeof(float));
     float pwd_dirs_deg[24][2] = { {0.0f} };
     if(favour2Daccuracy){
         for (i = 0; i < s->nPWD; i++)
@@ -186,69 +393,48 @@ void proposed_synthesis_create
     else{ 
         unitSph2cart((float*)__Tdesign_degree_6_dirs_deg, s->nPWD, 1, s->pwd_dirs_xyz);
     }
-    s->pwd_indices = malloc1d(s->nPWD*sizeof(int));
-    s->pwd_gains = malloc1d(s->nPWD*sizeof(float));
-    proposed_findNearestGridIndices(FLATTEN2D(s->array_dirs_xyz), s->pwd_dirs_xyz, s->nDirs, s->nPWD, s->pwd_indices);
+    proposed_findNearestGridIndices(s->array_dirs_xyz, s->pwd_dirs_xyz, s->nDirs, s->nPWD, s->pwd_indices);
     s->M_PWD = malloc1d(s->nBands*s->nPWD*s->nMics*sizeof(float_complex));
-    float_complex* Ad;
-    Ad = malloc1d(s->nMics*s->nPWD*sizeof(float_complex));
-    s->M_HRTFs = malloc1d(s->nBands*NUM_EARS*s->nPWD*sizeof(float_complex));
-    float_complex* U, *V;
-    U = V = NULL;
-    if(enableEPbeamformers){
-        U = malloc1d(SAF_MAX(s->nMics, s->nPWD)*SAF_MAX(s->nMics, s->nPWD)*sizeof(float_complex));
-        V = malloc1d(SAF_MAX(s->nMics, s->nPWD)*SAF_MAX(s->nMics, s->nPWD)*sizeof(float_complex));
-    }
-    for(band=0; band<s->nBands; band++){
-        for(i=0; i<s->nMics; i++)
-            for(j=0; j<s->nPWD; j++)
-                Ad[i*s->nPWD + j] = s->H_array[band*s->nMics*s->nDirs + i*s->nDirs + s->pwd_indices[j]];
+    pwdJob.s = s;
+    pwdJob.enableEPbeamformers = enableEPbeamformers;
+    nWorkers = proposed_parallel_getNumWorkers(s->nBands);
+    for(w=0; w<nWorkers; w++){
+        pwdJob.Ad[w] = malloc1d(s->nMics*s->nPWD*sizeof(float_complex));
+        pwdJob.U[w] = pwdJob.V[w] = NULL;
         if(enableEPbeamformers){
-            /* As it is done in [2]: */
-            utility_csvd(NULL, Ad, s->nMics, s->nPWD, U, NULL, V, NULL);
-            if (s->nPWD>s->nMics){
-                cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, s->nPWD, s->nMics, s->nMics, &calpha,
-                            V, s->nPWD,
-                            U, s->nMics, &cbeta,
-                            &s->M_PWD[band*s->nPWD*s->nMics], s->nMics);
-            }
-            else{
-                cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, s->nPWD, s->nMics, s->nPWD, &calpha,
-                            V, s->nPWD,
-                            U, s->nMics, &cbeta,
-                            &s->M_PWD[band*s->nPWD*s->nMics], s->nMics);
-            }
-            cblas_sscal(2*s->nPWD*s->nMics, sqrtf(1.0f/(float)s->nMics), (float*)&s->M_PWD[band*s->nPWD*s->nMics], 1);
-        }
-        else{
-            utility_cpinv(NULL, Ad, s->nMics, s->nPWD, &s->M_PWD[band*s->nPWD*s->nMics]);
-            cblas_sscal(2*s->nPWD*s->nMics, sqrtf((float)s->nMics)/(float)s->nMics, (float*)&s->M_PWD[band*s->nPWD*s->nMics], 1);
+            pwdJob.U[w] = malloc1d(SAF_MAX(s->nMics, s->nPWD)*SAF_MAX(s->nMics, s->nPWD)*sizeof(float_complex));
+            pwdJob.V[w] = malloc1d(SAF_MAX(s->nMics, s->nPWD)*SAF_MAX(s->nMics, s->nPWD)*sizeof(float_complex));
         }
-        for(i=0; i<NUM_EARS; i++)
-            for(j=0; j<s->nPWD; j++)
-                s->M_HRTFs[band*NUM_EARS*s->nPWD + i*s->nPWD + j] = s->H_bin[band*NUM_EARS*s->nDirs + i*s->nDirs + s->pwd_indices[j]];
     }
-    free(Ad);
-    if(enableEPbeamformers){
-        free(U);
-        free(V);
+    proposed_parallel_for(s->nBands, nWorkers, &proposed_synthesis_pwdBand, (void*)&pwdJob);
+    for(w=0; w<nWorkers; w++){
+        free(pwdJob.Ad[w]);
+        free(pwdJob.U[w]);
+        free(pwdJob.V[w]);
+    }
+
+    /* HRTFs of the PWD directions (gathered on this thread, since the lazy modes fill H_bin upon first use) */
+    for(j=0; j<s->nPWD; j++){
+        H_dir = proposed_synthesis_getHRTF(s, s->pwd_indices[j]);
+        for(band=0; band<s->nBands; band++)
+            for(i=0; i<NUM_EARS; i++)
+                s->M_HRTFs[band*NUM_EARS*s->nPWD + i*s->nPWD + j] = H_dir[band*NUM_EARS + i];
     }
     
     /* Run-time variables */
     utility_cpinv_create(&(s->hPinv), s->nMics, s->nMics);
     utility_cglslv_create(&(s->hLinSolve), s->nMics, s->nMics);
     utility_cinv_create(&(s->hInv), s->nMics);
-    s->As   = malloc1d(s->nMics*PROPOSED_MAX_K*sizeof(float_complex));
-    s->Ds   = malloc1d(PROPOSED_MAX_K*s->nMics*sizeof(float_complex));
-    s->Dd   = malloc1d(s->nMics*s->nMics*sizeof(float_complex));
-    s->new_M_par = malloc1d(NUM_EARS*(s->nMics)*sizeof(float_complex));
-    s->new_M_lin = malloc1d(NUM_EARS*(s->nMics)*sizeof(float_complex));
-    s->M_par = (float_complex**)malloc2d(s->nBands, NUM_EARS*(s->nMics), sizeof(float_complex));
-    s->M  = (float_complex**)malloc2d(s->nBands, NUM_EARS*(s->nMics), sizeof(float_complex));
-
-    /* Run-time audio buffers */
-    s->outTF = (float_complex***)malloc3d(s->nBands, NUM_EARS, s->timeSlots, sizeof(float_complex));
-    s->outTD = (float**)malloc2d(NUM_EARS, s->blocksize, sizeof(float));
+    s->smk = proposed_kernels_getSmallMat(s->nMics);
+    s->mixKernel = proposed_kernels_getMixKernel();
+
+    /* Static-pose FIR rendering */
+    saf_rfft_create(&(s->hFFT_fir), s->firLength);
+    saf_rfft_create(&(s->hFFT_part), 2*(s->blocksize));
+    s->firWindow = calloc1d(s->firLength, sizeof(float));
+    j = SAF_MIN(s->filterbankDelay, s->firLength-1-s->filterbankDelay); /* Half-width of the window */
+    for(i=SAF_MAX(s->filterbankDelay-j, 0); i<SAF_MIN(s->filterbankDelay+j, s->firLength); i++)
+        s->firWindow[i] = 0.5f*(1.0f + cosf(SAF_PI*(float)(i-s->filterbankDelay)/(float)j));
 
     /* Flush run-time buffers with zeros */
     proposed_synthesis_reset((*phSyn));
@@ -268,55 +454,42 @@ void proposed_synthesis_destroy
         free(s->binConfig);
 
         /* Free things copied from analyser */
-        free(s->H_array);
-        free(s->DCM_array);
-        free(s->W);
-        free(s->array_dirs_deg);
-        free(s->array_dirs_xyz);
-        free(s->freqVector);
+        proposed_arrayModel_release(&(s->model));
 
         /* Free time-frequency transform */
         afSTFT_destroy(&(s->hFB_dec));
 
         /* HRTF and diffuse rendering variables */
-        free(s->H_bin);
+        if(s->hrtfModel!=NULL)
+            proposed_hrtfModel_release(&(s->hrtfModel)); /* (in the lazy modes, H_bin is in the arena) */
+        free(s->H_meas);
+        free(s->itds_meas);
+        free(s->interpIdx);
+        free(s->interpW);
+        free(s->dfEQ);
         free(s->diff_dirs_xyz);
         free(s->H_array_diff);
-        free(s->H_bin_diff);
-        free(s->diff_indices);
         free(s->diffEQ);
+        free(s->srcDirTables);
+        free(s->srcDirTableIdx);
       
         /* AMBIENT-STREAM  - BSM */
-        free(s->M_BSM);
-        free(s->diff_pos_xyz);
-        free( s->diff_dirs_xyz_new);
-        free(s->diff_dirs_xyz_rot);
         proposed_array2binauralMagLS_destroy(&s->hBSM);
 
         /* Linear 6DoF baseline */
         free(s->pwd_dirs_xyz);
-        free(s->pwd_pos_xyz);
-        free(s->pwd_dirs_xyz_rot);
-        free(s->pwd_indices);
-        free(s->pwd_gains);
         free(s->M_PWD);
-        free(s->M_HRTFs);
        
         /* Run-time variables */
         utility_cpinv_destroy(&(s->hPinv));
         utility_cglslv_destroy(&(s->hLinSolve));
         utility_cinv_destroy(&(s->hInv));
-        free(s->As);
-        free(s->Ds);
-        free(s->Dd);
-        free(s->new_M_par);
-        free(s->new_M_lin);
-        free(s->M_par);
-        free(s->M);
-         
-        /* Run-time audio buffers */
-        free(s->outTF);
-        free(s->outTD);
+        proposed_arena_destroy(&(s->arena));
+
+        /* Static-pose FIR rendering */
+        saf_rfft_destroy(&(s->hFFT_fir));
+        saf_rfft_destroy(&(s->hFFT_part));
+        free(s->firWindow);
 
         free(s);
         s = NULL;
@@ -338,6 +511,10 @@ void proposed_synthesis_reset
     afSTFT_clearBuffers(s->hFB_dec);
     memset(FLATTEN2D(s->M_par), 0, s->nBands*NUM_EARS*(s->nMics)*sizeof(float_complex));
     memset(FLATTEN2D(s->M), 0, s->nBands*NUM_EARS*(s->nMics)*sizeof(float_complex));
+    memset(FLATTEN2D(s->M_lin), 0, s->nBands*NUM_EARS*(s->nMics)*sizeof(float_complex));
+    memset(s->X_fdl, 0, (s->nFirPartitions)*(s->nMics)*(s->blocksize+1)*sizeof(float_complex));
+    memset(s->firInTD, 0, (s->nMics)*2*(s->blocksize)*sizeof(float));
+    s->fdlIdx = 0;
 }
 
 void proposed_synthesis_apply
@@ -358,34 +535,101 @@ void proposed_synthesis_apply
     proposed_synthesis_data *s = (proposed_synthesis_data*)(hSyn);
     proposed_param_container_data *pcon = (proposed_param_container_data*)(hPCon);
     proposed_signal_container_data *scon = (proposed_signal_container_data*)(hSCon); 
-    int i, j, ch, nMics, band, K;
-    int doa_idx[PROPOSED_MAX_K], gain_idx[PROPOSED_MAX_K];
-    float a, b, synAvgCoeff, lin2parBalance, streamBalance, norm, Rzyx[3][3], maxBSMFreq;
-    float src_gains[PROPOSED_MAX_K];
-    float src_dirs_xyz[PROPOSED_MAX_K][3], src_dirs_xyz_rot[PROPOSED_MAX_K][3], src_pos_xyz[PROPOSED_MAX_K][3];
+    int band;
+    float Rzyx[3][3];
+
+    assert(blocksize==s->blocksize);
+    PROPOSED_RTGUARD_ENTER("proposed_synthesis_apply");
+
+    /* Update ambient rendering matrices to account for listener pose */
+    proposed_synthesis_updatePose(s, ypr_rad, xyz_m, src_dist_m, Rzyx);
+
+    /* Loop over bands and compute the mixing matrices */
+    for (band = 0; band < s->nBands; band++)
+        proposed_synthesis_computeMixingMatrix(s, pcon, scon, band, Rzyx, xyz_m, dist_map, src_dist_m, enableSrcD);
+
+    /* Blend and apply the mixing matrices of all bands in one pass */
+    proposed_synthesis_mixBands(s, scon, 0, s->nBands);
+
+    /* inverse time-frequency transform */
+    proposed_synthesis_inverseTransform(s, nChannels, blocksize, output);
+    proposed_profiler_commit(&(s->profiler));
+    PROPOSED_RTGUARD_LEAVE();
+}
+
+void proposed_synthesis_applyFused
+(
+    proposed_synthesis_handle const hSyn,
+    proposed_analysis_handle const hAna,
+    float** input,
+    int nInputs,
+    proposed_param_container_handle  const hPCon,
+    proposed_signal_container_handle const hSCon,
+    float* ypr_rad,
+    float* xyz_m,
+    PROPOSED_DISTANCE_MAPS dist_map,
+    float src_dist_m,
+    int enableSrcD,
+    int nChannels,
+    int blocksize,
+    float** output
+)
+{
+    proposed_synthesis_data *s = (proposed_synthesis_data*)(hSyn);
+    proposed_analysis_data *a = (proposed_analysis_data*)(hAna);
+    proposed_param_container_data *pcon = (proposed_param_container_data*)(hPCon);
+    proposed_signal_container_data *scon = (proposed_signal_container_data*)(hSCon);
+    int band, analyse, updateInterval;
+    float Rzyx[3][3];
+
+    assert(blocksize==s->blocksize && blocksize==a->blocksize);
+    PROPOSED_RTGUARD_ENTER("proposed_synthesis_applyFused");
+
+    /* Forward time-frequency transform */
+    proposed_analysis_forwardTransform(a, input, nInputs, blocksize, scon);
+    analyse = !(a->enableLinearOnly);
+    updateInterval = analyse ? proposed_analysis_beginSchedule(a) : 1;
+
+    /* Update ambient rendering matrices to account for listener pose */
+    proposed_synthesis_updatePose(s, ypr_rad, xyz_m, src_dist_m, Rzyx);
+
+    /* Process each band from start to finish, while its data is still in cache */
+    for(band=0; band<s->nBands; band++){
+        if(analyse){
+            proposed_analysis_updateCovariance(a, scon, band);
+            proposed_analysis_estimateParameters(a, pcon, band, updateInterval);
+        }
+        proposed_synthesis_computeMixingMatrix(s, pcon, scon, band, Rzyx, xyz_m, dist_map, src_dist_m, enableSrcD);
+        proposed_synthesis_mixBands(s, scon, band, 1);
+    }
+    if(analyse)
+        proposed_analysis_endSchedule(a);
+
+    /* inverse time-frequency transform */
+    proposed_synthesis_inverseTransform(s, nChannels, blocksize, output);
+    proposed_profiler_commit(&(a->profiler));
+    proposed_profiler_commit(&(s->profiler));
+    PROPOSED_RTGUARD_LEAVE();
+}
+
+void proposed_synthesis_updatePose
+(
+    proposed_synthesis_data* s,
+    float* ypr_rad,
+    float* xyz_m,
+    float src_dist_m,
+    float Rzyx[3][3]
+)
+{
+    int i, j, band;
+    float norm, maxBSMFreq, pwd_gain;
     float pwd_dirs_xyz[64][3]; 
-    float_complex h_dir[NUM_EARS*PROPOSED_MAX_K];
-    float_complex new_Md[NUM_EARS*PROPOSED_MAX_NMICS];
-    int dir;
-    float order_directivity, src_dist_m_MAP;
-    int order_directivity_cl, order_directivity_fl;
-    float c_n[DIRECTIVITY_ORDER_MAX+1];
-    float c_n_fl[DIRECTIVITY_ORDER_MAX+1];
-    float c_nm_base[ORDER2NSH(DIRECTIVITY_ORDER_MAX)];
-    float c_nm[ORDER2NSH(DIRECTIVITY_ORDER_MAX)];
-    float y_nm[ORDER2NSH(DIRECTIVITY_ORDER_MAX)];
-    float src_dir_rad_before[2], src_range_deg;
-    float src_dir_rad_after[2], src_dir_rad_incl_after[2];
-    const float_complex calpha = cmplxf(1.0f, 0.0f); const float_complex cbeta = cmplxf(0.0f, 0.0f); /* blas */
-    CxMic Cx_betaI, inv_Cx_betaI;
-    float_complex AH_Cx[PROPOSED_MAX_NMICS*PROPOSED_MAX_NMICS], AH_Cx_A[PROPOSED_MAX_K*PROPOSED_MAX_K], inv_AH_Cx_A[PROPOSED_MAX_K*PROPOSED_MAX_K];
+    const float_complex* H_dir;
+    unsigned long long t0;
 
+    t0 = proposed_profiler_begin(&(s->profiler));
     maxBSMFreq = s->maxBSMFreq;
-    nMics = s->nMics;
-    synAvgCoeff = SAF_CLAMP((s->synAvgCoeff), 0.0f, 0.99f);
-    lin2parBalance = SAF_CLAMP((s->linear2parBalance), 0.0f, 0.8f);
-    src_range_deg = 13.0f;
-    
+
     /* Update ambient rendering matrices to account for head-rotations (no translation) */
     /* Rotation matrix */
     euler2rotationMatrix(ypr_rad[0], ypr_rad[1], ypr_rad[2], 0, EULER_ROTATION_YAW_PITCH_ROLL, Rzyx);
@@ -411,15 +655,20 @@ void proposed_synthesis_apply
                     s->diff_dirs_xyz_new, 3,
                     (float*)Rzyx, 3, 0.0f,
                     s->diff_dirs_xyz_rot, 3);
-        proposed_findNearestGridIndices(FLATTEN2D(s->array_dirs_xyz), s->diff_dirs_xyz_rot, s->nDirs, s->nDiff, s->diff_indices);
-        for(band=0; band<s->nBands; band++){
-            if(s->freqVector[band] <= maxBSMFreq)
+        proposed_findNearestGridIndices(s->array_dirs_xyz, s->diff_dirs_xyz_rot, s->nDirs, s->nDiff, s->diff_indices);
+        for(j=0; j<s->nDiff; j++){
+            /* All bands of this direction are contiguous */
+            H_dir = proposed_synthesis_getHRTF(s, s->diff_indices[j]);
+            for(band=0; band<s->nBands && s->freqVector[band] <= maxBSMFreq; band++)
                 for(i=0; i<NUM_EARS; i++)
-                    for(j=0; j<s->nDiff; j++)
-                        s->H_bin_diff[band*NUM_EARS*s->nDiff + i*s->nDiff + j] = s->H_bin[band*NUM_EARS*s->nDirs + i*s->nDirs + s->diff_indices[j]];
+                    s->H_bin_diff[band*NUM_EARS*s->nDiff + i*s->nDiff + j] = H_dir[band*NUM_EARS + i];
         }
     }
+    proposed_profiler_end(&(s->profiler), PROPOSED_PROFILE_POSE_UPDATE, t0);
+    t0 = proposed_profiler_begin(&(s->profiler));
     proposed_array2binauralMagLS(s->hBSM, s->H_array_diff, s->H_bin_diff, s->diff_gains, s->freqVector, s->nBands, s->nMics, s->nDiff, s->maxMagLSFreq, maxBSMFreq, s->M_BSM);
+    proposed_profiler_end(&(s->profiler), PROPOSED_PROFILE_BSM, t0);
+    t0 = proposed_profiler_begin(&(s->profiler));
     
     /* Rotatate HRTFs for the linear decoder */
     cblas_scopy(s->nPWD*3, s->pwd_dirs_xyz, 1, s->pwd_pos_xyz, 1);
@@ -441,147 +690,279 @@ void proposed_synthesis_apply
                 (float*)pwd_dirs_xyz, 3,
                 (float*)Rzyx, 3, 0.0f,
                 (float*)s->pwd_dirs_xyz_rot, 3);
-    proposed_findNearestGridIndices(FLATTEN2D(s->array_dirs_xyz), (float*)s->pwd_dirs_xyz_rot, s->nDirs, s->nPWD, s->pwd_indices);
-    for(band=0; band<s->nBands; band++){
-        if(s->freqVector[band]>maxBSMFreq)
-            for(i=0; i<NUM_EARS; i++)
-                for(j=0; j<s->nPWD; j++)
-                    s->M_HRTFs[band*NUM_EARS*s->nPWD + i*s->nPWD + j] = crmulf(s->H_bin[band*NUM_EARS*s->nDirs + i*s->nDirs + s->pwd_indices[j]], SAF_MIN(s->pwd_gains[j], 8.0f));  // needed for pinv // 2*sqrtf(0.5f)*
+    proposed_findNearestGridIndices(s->array_dirs_xyz, (float*)s->pwd_dirs_xyz_rot, s->nDirs, s->nPWD, s->pwd_indices);
+    for(j=0; j<s->nPWD; j++){
+        /* All bands of this direction are contiguous */
+        H_dir = proposed_synthesis_getHRTF(s, s->pwd_indices[j]);
+        pwd_gain = SAF_MIN(s->pwd_gains[j], 8.0f); // needed for pinv // 2*sqrtf(0.5f)*
+        for(band=0; band<s->nBands; band++)
+            if(s->freqVector[band]>maxBSMFreq)
+                for(i=0; i<NUM_EARS; i++)
+                    s->M_HRTFs[band*NUM_EARS*s->nPWD + i*s->nPWD + j] = crmulf(H_dir[band*NUM_EARS + i], pwd_gain);
     }
-     
-    /* Loop over bands and compute the mixing matrices */
-    for (band = 0; band < s->nBands; band++) {
-        /* Pull estimated (and possibly modified) spatial parameters for this band */
-        K = pcon->nSrcs[band];
-        memcpy(doa_idx, pcon->doa_idx[band], K*sizeof(int));
-        memcpy(gain_idx, pcon->gains_idx[band], K*sizeof(int));
-        memcpy(src_gains, pcon->src_gains[band], K*sizeof(float));
-
-        /* Optional biasing (e.g. to conduct de-reverberation or to emphasise reverberation) [4] */
-        streamBalance = SAF_CLAMP(s->streamBalance[band], 0.0f, 2.0f);
-        if(streamBalance<1.0f){
-            a = streamBalance;        /* pump more direct energy into output */
-            b = 1.0f;                 /* pass ambient stream as normal */
-        }
-        else {
-            a = 1.0f;                 /* pass source stream as normal */
-            b = 2.0f - streamBalance; /* pump less ambient energy into output */
-        }
-        
-        /* Linear baseline method */
-        if(s->freqVector[band]<=maxBSMFreq)
-            cblas_ccopy(NUM_EARS*nMics, &s->M_BSM[band*NUM_EARS*nMics], 1, s->new_M_lin, 1);
-        else{
-            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, NUM_EARS, nMics, s->nPWD, &calpha,
-                        &s->M_HRTFs[band*NUM_EARS*s->nPWD], s->nPWD,
-                        &s->M_PWD[band*s->nPWD*nMics], nMics, &cbeta,
-                        s->new_M_lin, nMics);
-        }
-        
-        /* Parametric method */
-        if(K>0 && s->freqVector[band]<PROPOSED_MAX_RENDERING_FREQ){
-            /* Analysed source directions */
-            for(j=0; j<K; j++){
-                src_dirs_xyz[j][0] = s->array_dirs_xyz[gain_idx[j]][0];
-                src_dirs_xyz[j][1] = s->array_dirs_xyz[gain_idx[j]][1];
-                src_dirs_xyz[j][2] = s->array_dirs_xyz[gain_idx[j]][2];
-                unitCart2sph(src_dirs_xyz[j], 1, 0, src_dir_rad_before);
-                
-                switch(dist_map){
-                    case PROPOSED_DISTANCE_MAP_1SRC:
-                        if (src_dir_rad_before[0]*180.0f/SAF_PI >-50.0f-src_range_deg && src_dir_rad_before[0]*180.0f/SAF_PI <-50.0f+src_range_deg)
-                            src_dist_m_MAP = src_dist_m;
-                        else
-                            src_dist_m_MAP = 5.0f;
-                        break;
-                    case PROPOSED_DISTANCE_MAP_2SRC:
-                        if (src_dir_rad_before[0]*180.0f/SAF_PI >-50.0f-src_range_deg && src_dir_rad_before[0]*180.0f/SAF_PI <-50.0f+src_range_deg)
-                            src_dist_m_MAP = src_dist_m;
-                        else if (src_dir_rad_before[0]*180.0f/SAF_PI >-120.0f-src_range_deg && src_dir_rad_before[0]*180.0f/SAF_PI <-120.0f+src_range_deg)
-                            src_dist_m_MAP = src_dist_m;
-                        else
-                            src_dist_m_MAP = 5.0f;
-                        break;
-                    case PROPOSED_DISTANCE_MAP_3SRC:
-                        if (src_dir_rad_before[0]*180.0f/SAF_PI >-50.0f-src_range_deg && src_dir_rad_before[0]*180.0f/SAF_PI <-50.0f+src_range_deg)
-                            src_dist_m_MAP = src_dist_m;
-                        else if (src_dir_rad_before[0]*180.0f/SAF_PI >-120.0f-src_range_deg && src_dir_rad_before[0]*180.0f/SAF_PI <-120.0f+src_range_deg)
-                            src_dist_m_MAP = src_dist_m;
-                        else if (src_dir_rad_before[0]*180.0f/SAF_PI >60.0f-src_range_deg && src_dir_rad_before[0]*180.0f/SAF_PI <60.0f+src_range_deg)
-                            src_dist_m_MAP = src_dist_m;
-                        else
-                            src_dist_m_MAP = 5.0f;
-                        break;
-                    case PROPOSED_DISTANCE_MAP_USE_PARAM:
-                        src_dist_m_MAP = src_dist_m;
-                        break;
-                }
-                
-                /* Multiply unit vector by source distance to get its position */
-                src_pos_xyz[j][0] = src_dirs_xyz[j][0] * src_dist_m_MAP;
-                src_pos_xyz[j][1] = src_dirs_xyz[j][1] * src_dist_m_MAP;
-                src_pos_xyz[j][2] = src_dirs_xyz[j][2] * src_dist_m_MAP;
-                
-                /* New source direction */
-                src_dirs_xyz[j][0] = src_pos_xyz[j][0] - xyz_m[0];
-                src_dirs_xyz[j][1] = src_pos_xyz[j][1] - xyz_m[1];
-                src_dirs_xyz[j][2] = src_pos_xyz[j][2] - xyz_m[2];
-                norm = L2_norm3((float*)src_dirs_xyz[j]);
-                src_dirs_xyz[j][0] /= norm;
-                src_dirs_xyz[j][1] /= norm;
-                src_dirs_xyz[j][2] /= norm;
-                unitCart2sph(src_dirs_xyz[j], 1, 0, src_dir_rad_after);
-                src_dir_rad_incl_after[0] = src_dir_rad_after[0];
-                src_dir_rad_incl_after[1] = SAF_PI/2.0f - src_dir_rad_after[1];
-                
-                /* Account for 1/R law */
-                src_gains[j] = src_dist_m_MAP/(getDistBetween2Points(src_pos_xyz[j], xyz_m)+0.0001f);
-             
-                /* Account for source directivity */
-                if(enableSrcD){
-                    order_directivity = 0;
-                    for(dir=NUM_DIRECTIVITIES-1; dir>=0; dir--)
-                        if(s->freqVector[band]<directivity_freqs_hz[dir])
-                            order_directivity = directivity_orders[dir];
-                    order_directivity_cl = (int)(order_directivity+1.0f);
-                    order_directivity_fl = (int)order_directivity;
-                    beamWeightsCardioid2Spherical(order_directivity_cl, (float*)c_n);
-                    beamWeightsCardioid2Spherical(order_directivity_fl, (float*)c_n_fl);
-                    cblas_sscal(order_directivity_cl+1, (order_directivity-(float)order_directivity_fl), c_n, 1);
-                    cblas_saxpy(order_directivity_fl+1, (1.0f - (order_directivity-(float)order_directivity_fl)), c_n_fl, 1, c_n, 1);
-                    rotateAxisCoeffsReal(order_directivity_cl, c_n, SAF_PI/2.0f-src_dir_rad_before[1], src_dir_rad_before[0], c_nm_base);
-                    rotateAxisCoeffsReal(order_directivity_cl, c_n, SAF_PI/2.0f-src_dir_rad_after[1],  src_dir_rad_after[0],  c_nm);
-                    getSHreal_recur(order_directivity_cl, src_dir_rad_incl_after, 1, y_nm);
-                    src_gains[j] *= fabsf( cblas_sdot(ORDER2NSH(order_directivity_cl), c_nm_base, 1, y_nm, 1) / (cblas_sdot(ORDER2NSH(order_directivity_cl), c_nm, 1, y_nm, 1) +0.0001f) );
-                    
-                    /* Maximum gain permitted is 18dB: */
-                    src_gains[j] = SAF_MIN(src_gains[j], 8.0f);
+    proposed_profiler_end(&(s->profiler), PROPOSED_PROFILE_POSE_UPDATE, t0);
+}
+
+const float_complex* proposed_synthesis_getHRTF
+(
+    proposed_synthesis_data* s,
+    int dir
+)
+{
+    int band, i, k, idx;
+    float itd, ipd, mag;
+    float_complex* H_dir;
+
+    H_dir = &(s->H_bin[dir*(s->nBands)*NUM_EARS]);
+    if(s->H_bin_isValid==NULL || s->H_bin_isValid[dir])
+        return H_dir;
+
+    /* Interpolate this direction, as in proposed_getInterpolatedHRTFs() */
+    switch(s->interpOption){
+        default:
+        case PROPOSED_HRTF_INTERP_NEAREST_LAZY:
+            idx = s->interpIdx[dir*3];
+            for(band=0; band<s->nBands; band++)
+                for(i=0; i<NUM_EARS; i++)
+                    H_dir[band*NUM_EARS + i] = s->H_meas[(band*NUM_EARS + i)*(s->nHRIR) + idx];
+            break;
+
+        case PROPOSED_HRTF_INTERP_TRIANGULAR_LAZY:
+            /* As interpHRTFs(), but for the (up to) 3 non-zero weights only, and without allocating, since this may be called
+             * from the audio thread: the magnitudes and ITDs are interpolated separately, and the IPDs are then reintroduced */
+            itd = 0.0f;
+            for(k=0; k<3; k++)
+                itd += s->interpW[dir*3+k] * s->itds_meas[s->interpIdx[dir*3+k]];
+            for(band=0; band<s->nBands; band++){
+                ipd = 2.0f*SAF_PI*(s->freqVector[band])*itd + SAF_PI;
+                ipd = ipd - floorf(ipd/(2.0f*SAF_PI))*2.0f*SAF_PI - SAF_PI; /* wrapped to [-pi, pi) */
+                for(i=0; i<NUM_EARS; i++){
+                    mag = 0.0f;
+                    for(k=0; k<3; k++)
+                        mag += s->interpW[dir*3+k] * cabsf(s->H_meas[(band*NUM_EARS + i)*(s->nHRIR) + s->interpIdx[dir*3+k]]);
+                    H_dir[band*NUM_EARS + i] = cmplxf(mag*cosf((i==0 ? 0.5f : -0.5f)*ipd), mag*sinf((i==0 ? 0.5f : -0.5f)*ipd));
                 }
-                 
-                /* Apply head-rotation */
-                cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, K, 3, 3, 1.0f,
-                            (float*)src_dirs_xyz, 3,
-                            (float*)Rzyx, 3, 0.0f,
-                            (float*)src_dirs_xyz_rot, 3);
-                proposed_findNearestGridIndices(FLATTEN2D(s->array_dirs_xyz), (float*)src_dirs_xyz_rot, s->nDirs, K, gain_idx);
             }
+            break;
+    }
+
+    /* Diffuse-field EQ */
+    for(band=0; band<s->nBands; band++)
+        for(i=0; i<NUM_EARS; i++)
+            H_dir[band*NUM_EARS + i] = crmulf(H_dir[band*NUM_EARS + i], s->dfEQ[band*NUM_EARS + i]);
+
+    s->H_bin_isValid[dir] = 1;
+    return H_dir;
+}
+
+void proposed_synthesis_getATFs
+(
+    proposed_synthesis_data* s,
+    int band,
+    const int* dir_idx,
+    int nIdx,
+    float_complex* H
+)
+{
+    int i, j;
+
+    if(s->model->hATF_SH!=NULL){
+        proposed_atfSH_getATFs(s->model->hATF_SH, band, dir_idx, nIdx, H);
+        return;
+    }
+    for(j=0; j<nIdx; j++)
+        for(i=0; i<s->nMics; i++)
+            H[i*nIdx+j] = s->model->H_array[(dir_idx[j]*(s->nBands) + band)*(s->nMics) + i];
+}
+
+/* Residual mixing matrix, Dd = I - As*Ds */
+static void proposed_synthesis_residualMixingMatrix
+(
+    proposed_synthesis_data* s,
+    int K
+)
+{
+    int i, j, nMics;
+    const float_complex calpha = cmplxf(1.0f, 0.0f); const float_complex cbeta = cmplxf(0.0f, 0.0f); /* blas */
+
+    nMics = s->nMics;
+    cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nMics, nMics, K, &calpha,
+                s->As, K,
+                s->Ds, nMics, &cbeta,
+                s->Dd, nMics);
+    for(i=0; i<nMics; i++)
+        for(j=0; j<nMics; j++)
+            s->Dd[i*nMics+j] = i==j ? ccsubf(calpha, s->Dd[i*nMics+j]) : crmulf(s->Dd[i*nMics+j], -1.0f);
+}
+
+void proposed_synthesis_computeMixingMatrix
+(
+    proposed_synthesis_data* s,
+    proposed_param_container_data* pcon,
+    proposed_signal_container_data* scon,
+    int band,
+    float Rzyx[3][3],
+    float* xyz_m,
+    PROPOSED_DISTANCE_MAPS dist_map,
+    float src_dist_m,
+    int enableSrcD
+)
+{
+    int i, j, nMics, K;
+    int doa_idx[PROPOSED_MAX_K], gain_idx[PROPOSED_MAX_K];
+    float a, b, synAvgCoeff, lin2parBalance, streamBalance, norm, maxBSMFreq;
+    float src_gains[PROPOSED_MAX_K];
+    float src_dirs_xyz[PROPOSED_MAX_K][3], src_dirs_xyz_rot[PROPOSED_MAX_K][3], src_pos_xyz[PROPOSED_MAX_K][3];
+    float_complex h_dir[NUM_EARS*PROPOSED_MAX_K];
+    float_complex new_Md[NUM_EARS*PROPOSED_MAX_NMICS];
+    const float_complex* H_dir;
+    float src_dist_m_MAP, cosAngle;
+    float src_dir_rad_before[2], src_range_deg;
+    const float_complex calpha = cmplxf(1.0f, 0.0f); const float_complex cbeta = cmplxf(0.0f, 0.0f); /* blas */
+    CxMic Cx_betaI, inv_Cx_betaI;
+    float_complex AH_Cx[PROPOSED_MAX_NMICS*PROPOSED_MAX_NMICS], AH_Cx_A[PROPOSED_MAX_K*PROPOSED_MAX_K], inv_AH_Cx_A[PROPOSED_MAX_K*PROPOSED_MAX_K];
+    unsigned long long t0;
+
+    t0 = proposed_profiler_begin(&(s->profiler));
+    maxBSMFreq = s->maxBSMFreq;
+    nMics = s->nMics;
+    synAvgCoeff = SAF_CLAMP((s->synAvgCoeff), 0.0f, 0.99f);
+    lin2parBalance = SAF_CLAMP((s->linear2parBalance), 0.0f, 0.8f);
+    src_range_deg = 13.0f;
+
+    /* Pull estimated (and possibly modified) spatial parameters for this band */
+    K = pcon->nSrcs[band];
+    memcpy(doa_idx, pcon->doa_idx[band], K*sizeof(int));
+    memcpy(gain_idx, pcon->gains_idx[band], K*sizeof(int));
+    memcpy(src_gains, pcon->src_gains[band], K*sizeof(float));
+
+    /* Optional biasing (e.g. to conduct de-reverberation or to emphasise reverberation) [4] */
+    streamBalance = SAF_CLAMP(s->streamBalance[band], 0.0f, 2.0f);
+    if(streamBalance<1.0f){
+        a = streamBalance;        /* pump more direct energy into output */
+        b = 1.0f;                 /* pass ambient stream as normal */
+    }
+    else {
+        a = 1.0f;                 /* pass source stream as normal */
+        b = 2.0f - streamBalance; /* pump less ambient energy into output */
+    }
+    
+    /* Linear baseline method */
+    if(s->freqVector[band]<=maxBSMFreq)
+        cblas_ccopy(NUM_EARS*nMics, &s->M_BSM[band*NUM_EARS*nMics], 1, s->M_lin[band], 1);
+    else{
+        cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, NUM_EARS, nMics, s->nPWD, &calpha,
+                    &s->M_HRTFs[band*NUM_EARS*s->nPWD], s->nPWD,
+                    &s->M_PWD[band*s->nPWD*nMics], nMics, &cbeta,
+                    s->M_lin[band], nMics);
+    }
+
+    /* Linear-only rendering; the parametric mixing matrices are steered towards the (equalised) linear decoder through the
+     * same temporal averaging as the parametric ones, so that entering or leaving this mode is crossfaded rather than
+     * switched. Once converged, the blending below then gives the linear decoder alone, for any lin2parBalance */
+    if(s->enableLinearOnly){
+        cblas_ccopy(NUM_EARS*nMics, s->M_lin[band], 1, s->new_M_par, 1);
+        cblas_sscal(/*re+im*/2*NUM_EARS*nMics, s->diffEQ[band], (float*)s->new_M_par, 1);
+    }
+
+    /* Parametric method */
+    else if(K>0 && s->freqVector[band]<PROPOSED_MAX_RENDERING_FREQ){
+        /* Analysed source directions */
+        for(j=0; j<K; j++){
+            src_dirs_xyz[j][0] = s->array_dirs_xyz[gain_idx[j]*3+0];
+            src_dirs_xyz[j][1] = s->array_dirs_xyz[gain_idx[j]*3+1];
+            src_dirs_xyz[j][2] = s->array_dirs_xyz[gain_idx[j]*3+2];
+            unitCart2sph(src_dirs_xyz[j], 1, 0, src_dir_rad_before);
+            
+            switch(dist_map){
+                case PROPOSED_DISTANCE_MAP_1SRC:
+                    if (src_dir_rad_before[0]*180.0f/SAF_PI >-50.0f-src_range_deg && src_dir_rad_before[0]*180.0f/SAF_PI <-50.0f+src_range_deg)
+                        src_dist_m_MAP = src_dist_m;
+                    else
+                        src_dist_m_MAP = 5.0f;
+                    break;
+                case PROPOSED_DISTANCE_MAP_2SRC:
+                    if (src_dir_rad_before[0]*180.0f/SAF_PI >-50.0f-src_range_deg && src_dir_rad_before[0]*180.0f/SAF_PI <-50.0f+src_range_deg)
+                        src_dist_m_MAP = src_dist_m;
+                    else if (src_dir_rad_before[0]*180.0f/SAF_PI >-120.0f-src_range_deg && src_dir_rad_before[0]*180.0f/SAF_PI <-120.0f+src_range_deg)
+                        src_dist_m_MAP = src_dist_m;
+                    else
+                        src_dist_m_MAP = 5.0f;
+                    break;
+                case PROPOSED_DISTANCE_MAP_3SRC:
+                    if (src_dir_rad_before[0]*180.0f/SAF_PI >-50.0f-src_range_deg && src_dir_rad_before[0]*180.0f/SAF_PI <-50.0f+src_range_deg)
+                        src_dist_m_MAP = src_dist_m;
+                    else if (src_dir_rad_before[0]*180.0f/SAF_PI >-120.0f-src_range_deg && src_dir_rad_before[0]*180.0f/SAF_PI <-120.0f+src_range_deg)
+                        src_dist_m_MAP = src_dist_m;
+                    else if (src_dir_rad_before[0]*180.0f/SAF_PI >60.0f-src_range_deg && src_dir_rad_before[0]*180.0f/SAF_PI <60.0f+src_range_deg)
+                        src_dist_m_MAP = src_dist_m;
+                    else
+                        src_dist_m_MAP = 5.0f;
+                    break;
+                case PROPOSED_DISTANCE_MAP_USE_PARAM:
+                    src_dist_m_MAP = src_dist_m;
+                    break;
+            }
+            
+            /* Multiply unit vector by source distance to get its position */
+            src_pos_xyz[j][0] = src_dirs_xyz[j][0] * src_dist_m_MAP;
+            src_pos_xyz[j][1] = src_dirs_xyz[j][1] * src_dist_m_MAP;
+            src_pos_xyz[j][2] = src_dirs_xyz[j][2] * src_dist_m_MAP;
+            
+            /* New source direction */
+            src_dirs_xyz[j][0] = src_pos_xyz[j][0] - xyz_m[0];
+            src_dirs_xyz[j][1] = src_pos_xyz[j][1] - xyz_m[1];
+            src_dirs_xyz[j][2] = src_pos_xyz[j][2] - xyz_m[2];
+            norm = L2_norm3((float*)src_dirs_xyz[j]);
+            src_dirs_xyz[j][0] /= norm;
+            src_dirs_xyz[j][1] /= norm;
+            src_dirs_xyz[j][2] /= norm;
             
-            /* Source array steering vectors for the estimated DoAs */
-            for(i=0; i<nMics; i++)
-                for(j=0; j<K; j++)
-                    s->As[i*K+j] = s->H_array[band*nMics*(s->nDirs) + i*(s->nDirs) + doa_idx[j]];
+            /* Account for 1/R law */
+            src_gains[j] = src_dist_m_MAP/(getDistBetween2Points(src_pos_xyz[j], xyz_m)+0.0001f);
+         
+            /* Account for source directivity */
+            if(enableSrcD){
+                /* The pattern is steered towards the original direction and evaluated at the translated direction, relative to
+                 * its on-axis response; which only depends on the angle between the two (see proposed_synthesis_tabulateDirectivity()) */
+                cosAngle = s->array_dirs_xyz[gain_idx[j]*3+0]*src_dirs_xyz[j][0] +
+                           s->array_dirs_xyz[gain_idx[j]*3+1]*src_dirs_xyz[j][1] +
+                           s->array_dirs_xyz[gain_idx[j]*3+2]*src_dirs_xyz[j][2];
+                src_gains[j] *= proposed_synthesis_lookupDirectivity(&(s->srcDirTables[s->srcDirTableIdx[band]*SRC_DIRECTIVITY_TABLE_SIZE]), cosAngle);
+                
+                /* Maximum gain permitted is 18dB: */
+                src_gains[j] = SAF_MIN(src_gains[j], 8.0f);
+            }
+             
+            /* Apply head-rotation */
+            cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, K, 3, 3, 1.0f,
+                        (float*)src_dirs_xyz, 3,
+                        (float*)Rzyx, 3, 0.0f,
+                        (float*)src_dirs_xyz_rot, 3);
+            proposed_findNearestGridIndices(s->array_dirs_xyz, (float*)src_dirs_xyz_rot, s->nDirs, K, gain_idx);
+        }
+        
+        /* Source array steering vectors for the estimated DoAs */
+        proposed_synthesis_getATFs(s, band, doa_idx, K, s->As);
 
-            /* HRTF for these reproduction DoAs */
+        /* HRTF for these reproduction DoAs */
+        for(j=0; j<K; j++){
+            H_dir = proposed_synthesis_getHRTF(s, gain_idx[j]);
             for(i=0; i<NUM_EARS; i++)
-                for(j=0; j<K; j++)
-                    h_dir[i*K+j] = crmulf(s->H_bin[band*NUM_EARS*(s->nDirs) + i*(s->nDirs) + gain_idx[j]], src_gains[j]);
+                h_dir[i*K+j] = crmulf(H_dir[band*NUM_EARS + i], src_gains[j]);
+        }
 
-            /* Source mixing matrix (beamforming towards the estimated DoAs) */
+        /* Source mixing matrix (beamforming towards the estimated DoAs) */
 #if 1
-            /* As in e.g. [2]: */
-            cblas_ccopy(nMics*nMics, scon->Cx[band].Cx, 1, Cx_betaI.Cx, 1);
-            for(i=0; i<nMics; i++)
-                Cx_betaI.Cx[i*nMics+i] = craddf(Cx_betaI.Cx[i*nMics+i], 0.01f);
+        /* As in e.g. [2]: */
+        cblas_ccopy(nMics*nMics, proposed_signal_container_getCx(scon, band), 1, Cx_betaI.Cx, 1);
+        for(i=0; i<nMics; i++)
+            Cx_betaI.Cx[i*nMics+i] = craddf(Cx_betaI.Cx[i*nMics+i], 0.01f);
+        if(s->smk!=NULL && s->smk->invHPD(Cx_betaI.Cx, inv_Cx_betaI.Cx)==0){
+            /* Fixed-size kernels, also computing the residual mixing matrix */
+            s->smk->sourceFilters[K-1](s->As, inv_Cx_betaI.Cx, s->Ds, s->Dd);
+        }
+        else{
             utility_cinv(s->hInv, Cx_betaI.Cx, inv_Cx_betaI.Cx, nMics);
             cblas_cgemm(CblasRowMajor, CblasConjTrans, CblasNoTrans, K, nMics, nMics, &calpha,
                         s->As, K,
@@ -595,70 +976,89 @@ void proposed_synthesis_apply
             cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, K, nMics, K, &calpha,
                         inv_AH_Cx_A, K,
                         AH_Cx, nMics, &cbeta,
-                        s->Ds, nMics); 
+                        s->Ds, nMics);
+            proposed_synthesis_residualMixingMatrix(s, K);
+        }
 #else
-            /* As in e.g. [1]: */
-            utility_cpinv(s->hPinv, s->As, nMics, K, s->Ds);
+        /* As in e.g. [1]: */
+        utility_cpinv(s->hPinv, s->As, nMics, K, s->Ds);
+        proposed_synthesis_residualMixingMatrix(s, K);
 #endif
-            
-            /* Residual mixing matrix */
-            cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nMics, nMics, K, &calpha,
-                        s->As, K,
-                        s->Ds, nMics, &cbeta,
-                        s->Dd, nMics);
-            for(i=0; i<nMics; i++)
-                for(j=0; j<nMics; j++)
-                    s->Dd[i*nMics+j] = i==j ? ccsubf(calpha, s->Dd[i*nMics+j]) : crmulf(s->Dd[i*nMics+j], -1.0f);
 
-            /* Source stream */
+        /* Source stream */
+        if(s->smk!=NULL)
+            s->smk->sourceStream[K-1](h_dir, s->Ds, s->new_M_par);
+        else
             cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, NUM_EARS, nMics, K, &calpha,
                         h_dir, K,
                         s->Ds, nMics, &cbeta,
                         s->new_M_par, nMics);
-            cblas_sscal(/*re+im*/2*NUM_EARS*nMics, a, (float*)s->new_M_par, 1);
-            
-            /* Ambient stream*/
+        cblas_sscal(/*re+im*/2*NUM_EARS*nMics, a, (float*)s->new_M_par, 1);
+        
+        /* Ambient stream*/
+        if(s->smk!=NULL)
+            s->smk->ambientStream(s->M_lin[band], s->Dd, new_Md);
+        else
             cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, NUM_EARS, nMics, nMics, &calpha,
-                        s->new_M_lin, nMics,
+                        s->M_lin[band], nMics,
                         s->Dd, nMics, &cbeta,
                         new_Md, nMics);
 #if PROPOSED_USE_BSM_RESIDUAL
-            cblas_saxpy(/*re+im*/2*NUM_EARS*nMics, s->diffEQ[band]*b * SAF_CLAMP(1.0f-sqrtf(xyz_m[0]*xyz_m[0] + xyz_m[1]*xyz_m[1] + xyz_m[2]*xyz_m[2]+0.0001)/src_dist_m, 0.0f, 1.0f), (float*)new_Md, 1, (float*)s->new_M_par, 1);
+        cblas_saxpy(/*re+im*/2*NUM_EARS*nMics, s->diffEQ[band]*b * SAF_CLAMP(1.0f-sqrtf(xyz_m[0]*xyz_m[0] + xyz_m[1]*xyz_m[1] + xyz_m[2]*xyz_m[2]+0.0001)/src_dist_m, 0.0f, 1.0f), (float*)new_Md, 1, (float*)s->new_M_par, 1);
 #else
-            cblas_saxpy(/*re+im*/2*NUM_EARS*nMics, s->diffEQ[band]*b, (float*)new_Md, 1, (float*)s->new_M_par, 1);
+        cblas_saxpy(/*re+im*/2*NUM_EARS*nMics, s->diffEQ[band]*b, (float*)new_Md, 1, (float*)s->new_M_par, 1);
 #endif
-        }
-        else{
+    }
+    else{
 #if PROPOSED_USE_BSM_RESIDUAL
-            cblas_ccopy(NUM_EARS*(s->nMics), &s->M_diff[band*NUM_EARS*nMics], 1, s->new_M, 1);
+        cblas_ccopy(NUM_EARS*(s->nMics), &s->M_diff[band*NUM_EARS*nMics], 1, s->new_M, 1);
 #else
-            cblas_ccopy(NUM_EARS*(s->nMics), s->new_M_lin, 1, s->new_M_par, 1);
-            cblas_sscal(2*NUM_EARS*s->nMics, s->diffEQ[band], (float*)s->new_M_par, 1);
+        cblas_ccopy(NUM_EARS*(s->nMics), s->M_lin[band], 1, s->new_M_par, 1);
+        cblas_sscal(2*NUM_EARS*s->nMics, s->diffEQ[band], (float*)s->new_M_par, 1);
 #endif
-        }
-        
-        /* Temporal averaging of parametric mixing matrices */
-        cblas_sscal(/*re+im*/2*NUM_EARS*nMics, synAvgCoeff, (float*)s->M_par[band], 1);
-        cblas_saxpy(/*re+im*/2*NUM_EARS*nMics, 1.0f-synAvgCoeff, (float*)s->new_M_par, 1, (float*)s->M_par[band], 1);
-        
-        /* Mix together the parametric rendering and the linear baseline */
-        cblas_ccopy(NUM_EARS*nMics, s->M_par[band], 1, s->M[band], 1);
-        cblas_sscal(/*re+im*/2*NUM_EARS*nMics, lin2parBalance, (float*)s->M[band], 1);
-        cblas_saxpy(/*re+im*/2*NUM_EARS*nMics, s->diffEQ[band]*(1.0f-lin2parBalance), (float*)s->new_M_lin, 1, (float*)s->M[band], 1);
-        
-        /* Reduce the level by 6dB */
-        cblas_sscal(/*re+im*/2*NUM_EARS*nMics, 0.5f, (float*)s->M[band], 1);
     }
+    
+    /* Temporal averaging of parametric mixing matrices */
+    cblas_sscal(/*re+im*/2*NUM_EARS*nMics, synAvgCoeff, (float*)s->M_par[band], 1);
+    cblas_saxpy(/*re+im*/2*NUM_EARS*nMics, 1.0f-synAvgCoeff, (float*)s->new_M_par, 1, (float*)s->M_par[band], 1);
+    
+    /* Gains for mixing together the parametric rendering and the linear baseline, incl. a 6dB reduction. The blending itself is
+     * fused into the mixing kernel (see proposed_synthesis_mixBands()) */
+    s->gain_par[band] = 0.5f*lin2parBalance;
+    s->gain_lin[band] = 0.5f*(s->diffEQ[band])*(1.0f-lin2parBalance);
+    proposed_profiler_end(&(s->profiler), PROPOSED_PROFILE_MIXING_CONSTRUCTION, t0);
+}
 
-    /* Apply mixing matrices */
-    for(band=0; band<s->nBands; band++){
-        cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, NUM_EARS, s->timeSlots, nMics, &calpha,
-                    s->M[band], nMics,
-                    FLATTEN2D(scon->inTF[band]), s->timeSlots, &cbeta,
-                    FLATTEN2D(s->outTF[band]), s->timeSlots);
-    }
+void proposed_synthesis_mixBands
+(
+    proposed_synthesis_data* s,
+    proposed_signal_container_data* scon,
+    int band,
+    int nBands
+)
+{
+    unsigned long long t0;
+
+    t0 = proposed_profiler_begin(&(s->profiler));
+    s->mixKernel(nBands, s->nMics, s->timeSlots, &(s->gain_par[band]), &(s->gain_lin[band]),
+                 s->M_par[band], s->M_lin[band], FLATTEN2D(scon->inTF[band]),
+                 s->M[band], FLATTEN2D(s->outTF[band]));
+    proposed_profiler_end(&(s->profiler), PROPOSED_PROFILE_MIXING_APPLY, t0);
+}
+
+void proposed_synthesis_inverseTransform
+(
+    proposed_synthesis_data* s,
+    int nChannels,
+    int blocksize,
+    float** output
+)
+{
+    int ch;
+    unsigned long long t0;
 
     /* inverse time-frequency transform */
+    t0 = proposed_profiler_begin(&(s->profiler));
     afSTFT_backward_knownDimensions(s->hFB_dec, s->outTF, blocksize, NUM_EARS, s->timeSlots, s->outTD);
 
     /* Copy to output */
@@ -666,6 +1066,142 @@ void proposed_synthesis_apply
         memcpy(output[ch], s->outTD[ch], blocksize*sizeof(float));
     for(; ch<nChannels; ch++)
         memset(output[ch], 0, blocksize*sizeof(float));
+    proposed_profiler_end(&(s->profiler), PROPOSED_PROFILE_INVERSE_FB, t0);
+}
+
+void proposed_synthesis_applyTail
+(
+    proposed_synthesis_handle const hSyn,
+    int nChannels,
+    int blocksize,
+    float** output
+)
+{
+    proposed_synthesis_data *s = (proposed_synthesis_data*)(hSyn);
+
+    assert(blocksize==s->blocksize);
+
+    /* Silent input, so only the filterbank tail remains */
+    memset(FLATTEN3D(s->outTF), 0, s->nBands*NUM_EARS*(s->timeSlots)*sizeof(float_complex));
+
+    /* inverse time-frequency transform */
+    proposed_synthesis_inverseTransform(s, nChannels, blocksize, output);
+    proposed_profiler_commit(&(s->profiler));
+}
+
+void proposed_synthesis_computeStaticFIRs
+(
+    proposed_synthesis_handle const hSyn,
+    int firstFIR,
+    int nFIRs
+)
+{
+    proposed_synthesis_data *s = (proposed_synthesis_data*)(hSyn);
+    int i, j, k, p, ij, band, nBins, nMics, blocksize;
+    float f, frac, phase;
+    float_complex m;
+
+    nMics = s->nMics;
+    blocksize = s->blocksize;
+    nBins = s->firLength/2+1;
+
+    /* Hold the mixing matrices, as they are still updated by proposed_synthesis_apply() while the FIRs are being computed */
+    if(firstFIR==0)
+        memcpy(FLATTEN2D(s->M_fir), FLATTEN2D(s->M), s->nBands*NUM_EARS*nMics*sizeof(float_complex));
+
+    for(ij=SAF_MAX(firstFIR, 0); ij<SAF_MIN(firstFIR+nFIRs, NUM_EARS*nMics); ij++){
+        i = ij/nMics; /* ear */
+        j = ij%nMics; /* microphone */
+
+        /* Interpolate the mixing weights from the band centre frequencies to the FFT bins, and impose the filterbank delay */
+        band = 0;
+        for(k=0; k<nBins; k++){
+            f = (float)k*(s->fs)/(float)s->firLength;
+            while(band<s->nBands-2 && s->freqVector[band+1]<f)
+                band++;
+            frac = SAF_CLAMP((f-s->freqVector[band])/(s->freqVector[band+1]-s->freqVector[band]), 0.0f, 1.0f);
+            m = ccaddf(crmulf(s->M_fir[band][i*nMics+j], 1.0f-frac), crmulf(s->M_fir[band+1][i*nMics+j], frac));
+            phase = -2.0f*SAF_PI*(float)k*(float)s->filterbankDelay/(float)s->firLength;
+            s->firTF[k] = ccmulf(m, cmplxf(cosf(phase), sinf(phase)));
+        }
+        saf_rfft_backward(s->hFFT_fir, s->firTF, s->firTD);
+        utility_svvmul(s->firTD, s->firWindow, s->firLength, s->firTD);
+
+        /* Split into zero-padded partitions and transform */
+        for(p=0; p<s->nFirPartitions; p++){
+            memcpy(s->firOutTD, &(s->firTD[p*blocksize]), blocksize*sizeof(float));
+            memset(&(s->firOutTD[blocksize]), 0, blocksize*sizeof(float));
+            saf_rfft_forward(s->hFFT_part, s->firOutTD, &(s->H_fir[(ij*(s->nFirPartitions)+p)*(blocksize+1)]));
+        }
+    }
+}
+
+void proposed_synthesis_applyStaticFIRs
+(
+    proposed_synthesis_handle const hSyn,
+    float** input,
+    int nInputs,
+    int nChannels,
+    int blocksize,
+    float** output
+)
+{
+    proposed_synthesis_data *s = (proposed_synthesis_data*)(hSyn);
+    int i, j, k, p, ch, slot, nMics, nBins;
+    float_complex* X, *H;
+
+    assert(blocksize==s->blocksize);
+    nMics = s->nMics;
+    nBins = blocksize+1;
+
+    /* Overlap-save; transform the previous and current input blocks, and store them in the frequency-domain delay line */
+    for(j=0; j<nMics; j++){
+        memcpy(&(s->firInTD[j*2*blocksize]), &(s->firInTD[j*2*blocksize+blocksize]), blocksize*sizeof(float));
+        if(j<nInputs)
+            memcpy(&(s->firInTD[j*2*blocksize+blocksize]), input[j], blocksize*sizeof(float));
+        else
+            memset(&(s->firInTD[j*2*blocksize+blocksize]), 0, blocksize*sizeof(float));
+        saf_rfft_forward(s->hFFT_part, &(s->firInTD[j*2*blocksize]), &(s->X_fdl[((s->fdlIdx)*nMics+j)*nBins]));
+    }
+
+    /* Multiply-accumulate over all partitions and microphones, then inverse transform */
+    for(i=0; i<NUM_EARS; i++){
+        memset(s->Y_fir, 0, nBins*sizeof(float_complex));
+        for(p=0; p<s->nFirPartitions; p++){
+            slot = (s->fdlIdx - p + s->nFirPartitions) % (s->nFirPartitions);
+            for(j=0; j<nMics; j++){
+                X = &(s->X_fdl[(slot*nMics+j)*nBins]);
+                H = &(s->H_fir[((i*nMics+j)*(s->nFirPartitions)+p)*nBins]);
+                for(k=0; k<nBins; k++)
+                    s->Y_fir[k] = ccaddf(s->Y_fir[k], ccmulf(X[k], H[k]));
+            }
+        }
+        saf_rfft_backward(s->hFFT_part, s->Y_fir, s->firOutTD);
+        memcpy(s->outTD[i], &(s->firOutTD[blocksize]), blocksize*sizeof(float)); /* Discard the circularly aliased half */
+    }
+    s->fdlIdx = (s->fdlIdx + 1) % (s->nFirPartitions);
+
+    /* Copy to output */
+    for(ch=0; ch<SAF_MIN(nChannels, NUM_EARS); ch++)
+        memcpy(output[ch], s->outTD[ch], blocksize*sizeof(float));
+    for(; ch<nChannels; ch++)
+        memset(output[ch], 0, blocksize*sizeof(float));
+}
+
+int proposed_synthesis_getStaticFIRLength
+(
+    proposed_synthesis_handle const hSyn
+)
+{
+    return hSyn == NULL ? 0 : ((proposed_synthesis_data*)(hSyn))->firLength;
+}
+
+int proposed_synthesis_getNumStaticFIRs
+(
+    proposed_synthesis_handle const hSyn
+)
+{
+    return hSyn == NULL ? 0 : NUM_EARS*(((proposed_synthesis_data*)(hSyn))->nMics);
 }
 
 float* proposed_synthesis_getEqPtr
@@ -752,6 +1288,63 @@ float* proposed_synthesis_getLinear2ParametricBalancePtr
     return &(s->linear2parBalance);
 }
  
+int* proposed_synthesis_getEnableLinearOnlyPtr
+(
+    proposed_synthesis_handle const hSyn
+)
+{
+    proposed_synthesis_data *s;
+    if(hSyn==NULL)
+        return NULL;
+    s = (proposed_synthesis_data*)(hSyn);
+    return &(s->enableLinearOnly);
+}
+ 
+int* proposed_synthesis_getEnableProfilingPtr
+(
+    proposed_synthesis_handle const hSyn
+)
+{
+    proposed_synthesis_data *s;
+    if(hSyn==NULL)
+        return NULL;
+    s = (proposed_synthesis_data*)(hSyn);
+    return &(s->profiler.enable);
+}
+
+void proposed_synthesis_getProfile
+(
+    proposed_synthesis_handle const hSyn,
+    proposed_profile* profile
+)
+{
+    proposed_profile_counters counters;
+
+    memset(&counters, 0, sizeof(proposed_profile_counters));
+    if(hSyn!=NULL)
+        proposed_profiler_getCounters(&(((proposed_synthesis_data*)(hSyn))->profiler), &counters);
+    proposed_profile_getStats(&counters, profile);
+}
+
+void proposed_synthesis_getProfileCounters
+(
+    proposed_synthesis_handle const hSyn,
+    proposed_profile_counters* counters
+)
+{
+    if(hSyn!=NULL)
+        proposed_profiler_getCounters(&(((proposed_synthesis_data*)(hSyn))->profiler), counters);
+}
+
+void proposed_synthesis_resetProfile
+(
+    proposed_synthesis_handle const hSyn
+)
+{
+    if(hSyn!=NULL)
+        proposed_profiler_reset(&(((proposed_synthesis_data*)(hSyn))->profiler));
+}
+
 int proposed_synthesis_getProcDelay
 (
     proposed_synthesis_handle const hSyn
@@ -0,0 +1,199 @@
+/**
+ * @file proposed_trace.c
+ * @ingroup PROPOSED
+ * @brief Optional tracing of processing spans (see proposed_trace.h)
+ *
+ * Each thread claims one of a fixed number of ring buffers upon recording its
+ * first span, and is the only thread that writes to it until it is released.
+ * A span is written to the slot at the head of the ring buffer, which is then
+ * advanced; proposed_trace_dump() reads up to the head, and discards any span
+ * whose slot may have been written to again while it was being read. The ring
+ * buffers are static, so recording never allocates. The thread ids in the
+ * trace are the indices of the ring buffers, so a thread that takes over a
+ * released ring buffer appears under the same id as its previous owner.
+ *
+ * @author agent
+ * @date 19th October 2026
+ */
+
+#include "proposed_internal.h"
+
+#if defined(_WIN32)
+# include <windows.h>
+# define PROPOSED_TRACE_TLS __declspec(thread)
+# define PROPOSED_TRACE_BARRIER() MemoryBarrier()
+# define PROPOSED_TRACE_CLAIM(flag) ( InterlockedCompareExchange((flag), 1, 0)==0 )
+#else
+# define PROPOSED_TRACE_TLS __thread
+# define PROPOSED_TRACE_BARRIER() __sync_synchronize()
+# define PROPOSED_TRACE_CLAIM(flag) ( __sync_bool_compare_and_swap((flag), 0, 1) )
+#endif
+
+/** One recorded span */
+typedef struct _proposed_trace_span {
+    const char* name;                /**< Name of the span (static string) */
+    unsigned long long start_ns;     /**< Start time, in nanoseconds */
+    unsigned long long end_ns;       /**< End time, in nanoseconds */
+
+} proposed_trace_span;
+
+/** Ring buffer of one thread */
+typedef struct _proposed_trace_ring {
+    volatile long isOwned;           /**< 1: claimed by a thread, 0: free */
+    volatile unsigned int head;      /**< Number of spans written so far (wraps around) */
+    volatile unsigned int first;     /**< Spans before this one were discarded by proposed_trace_reset() */
+    const char* volatile threadName; /**< Name of the (last) owner, or NULL */
+    proposed_trace_span spans[PROPOSED_TRACE_RING_SIZE]; /**< Spans; span i is stored at i%PROPOSED_TRACE_RING_SIZE */
+
+} proposed_trace_ring;
+
+static proposed_trace_ring proposed_trace_rings[PROPOSED_TRACE_MAX_THREADS];
+static volatile int proposed_trace_enabled = 0;
+static unsigned long long proposed_trace_origin = 0;                  /**< Time at which tracing was first enabled */
+static PROPOSED_TRACE_TLS proposed_trace_ring* proposed_trace_thisRing = NULL; /**< Ring buffer of this thread, or NULL */
+static PROPOSED_TRACE_TLS const char* proposed_trace_thisName = NULL;  /**< Name of this thread, or NULL */
+
+/* Returns the ring buffer of the calling thread, claiming a free one if it has none (NULL if they are all in use) */
+static proposed_trace_ring* proposed_trace_getRing(void)
+{
+    int i;
+
+    if(proposed_trace_thisRing==NULL){
+        for(i=0; i<PROPOSED_TRACE_MAX_THREADS; i++){
+            if(PROPOSED_TRACE_CLAIM(&(proposed_trace_rings[i].isOwned))){
+                proposed_trace_thisRing = &(proposed_trace_rings[i]);
+                proposed_trace_thisRing->threadName = proposed_trace_thisName;
+                break;
+            }
+        }
+    }
+    return proposed_trace_thisRing;
+}
+
+void proposed_trace_setEnabled
+(
+    int enable
+)
+{
+    if(enable && proposed_trace_origin==0)
+        proposed_trace_origin = proposed_profiler_now();
+    proposed_trace_enabled = enable ? 1 : 0;
+}
+
+int proposed_trace_isEnabled(void)
+{
+    return proposed_trace_enabled;
+}
+
+void proposed_trace_setThreadName
+(
+    const char* name
+)
+{
+    proposed_trace_thisName = name;
+    if(proposed_trace_thisRing!=NULL)
+        proposed_trace_thisRing->threadName = name;
+}
+
+void proposed_trace_releaseThread(void)
+{
+    if(proposed_trace_thisRing!=NULL){
+        PROPOSED_TRACE_BARRIER();
+        proposed_trace_thisRing->isOwned = 0;
+        proposed_trace_thisRing = NULL;
+    }
+}
+
+unsigned long long proposed_trace_begin(void)
+{
+    return proposed_trace_enabled ? proposed_profiler_now() : 0;
+}
+
+void proposed_trace_end
+(
+    const char* name,
+    unsigned long long t0
+)
+{
+    if(t0!=0)
+        proposed_trace_record(name, t0, proposed_profiler_now());
+}
+
+void proposed_trace_record
+(
+    const char* name,
+    unsigned long long t0,
+    unsigned long long t1
+)
+{
+    proposed_trace_ring* ring;
+    proposed_trace_span* span;
+
+    if(!proposed_trace_enabled || t0==0)
+        return;
+    ring = proposed_trace_getRing();
+    if(ring==NULL)
+        return; /* all ring buffers are in use */
+    span = &(ring->spans[ring->head % PROPOSED_TRACE_RING_SIZE]);
+    span->name = name;
+    span->start_ns = t0;
+    span->end_ns = t1;
+
+    /* The span must be complete before it is published */
+    PROPOSED_TRACE_BARRIER();
+    ring->head++;
+}
+
+int proposed_trace_dump
+(
+    const char* path
+)
+{
+    FILE* file;
+    proposed_trace_ring* ring;
+    proposed_trace_span span;
+    const char* threadName;
+    unsigned int head, first, k;
+    int i, nSpans;
+
+    file = fopen(path, "w");
+    if(file==NULL)
+        return -1;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"proposed\"}}");
+    nSpans = 0;
+    for(i=0; i<PROPOSED_TRACE_MAX_THREADS; i++){
+        ring = &(proposed_trace_rings[i]);
+        head = ring->head;
+        first = ring->first;
+        PROPOSED_TRACE_BARRIER();
+        if(head==first)
+            continue;
+        threadName = ring->threadName;
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                i+1, threadName!=NULL ? threadName : "Unnamed");
+
+        /* Oldest span still held; those read here may still be overwritten by the owner, in which case they are left out */
+        if(head-first > PROPOSED_TRACE_RING_SIZE)
+            first = head-PROPOSED_TRACE_RING_SIZE;
+        for(k=first; k!=head; k++){
+            span = ring->spans[k % PROPOSED_TRACE_RING_SIZE];
+            PROPOSED_TRACE_BARRIER();
+            if(ring->head-k >= PROPOSED_TRACE_RING_SIZE)
+                continue;
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", span.name, i+1,
+                    (double)(span.start_ns-proposed_trace_origin)*1e-3, (double)(span.end_ns-span.start_ns)*1e-3);
+            nSpans++;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    return fclose(file)==0 ? nSpans : -1;
+}
+
+void proposed_trace_reset(void)
+{
+    int i;
+
+    for(i=0; i<PROPOSED_TRACE_MAX_THREADS; i++)
+        proposed_trace_rings[i].first = proposed_trace_rings[i].head;
+}
@@ -34,6 +34,93 @@ typedef enum {
 }INTERFACE_DISTANCE_MAPS;
 #define INTERFACE_NUM_DISTANCE_MAPS ( 4 )
 
+/** Spatial parameter update schedules */
+typedef enum {
+    INTERFACE_ANALYSIS_UPDATE_ALL_BANDS = 1, /**< (Default) every band is
+                                              *   updated every block */
+    INTERFACE_ANALYSIS_UPDATE_DECIMATED,     /**< Low bands are updated every
+                                              *   Nth block */
+    INTERFACE_ANALYSIS_UPDATE_ROUND_ROBIN    /**< 1/N of the bands are updated
+                                              *   per block */
+}INTERFACE_ANALYSIS_UPDATE_SCHEDULES;
+#define INTERFACE_NUM_ANALYSIS_UPDATE_SCHEDULES ( 3 )
+
+/**
+ * Quality tiers used by the CPU-budget governor
+ *
+ * Each tier includes the savings of the tiers before it.
+ */
+typedef enum {
+    INTERFACE_QUALITY_TIER_FULL = 1,          /**< (Default) full quality */
+    INTERFACE_QUALITY_TIER_REDUCED_BANDWIDTH, /**< Spatial analysis is limited
+                                               *   to lower frequencies */
+    INTERFACE_QUALITY_TIER_DECIMATED,         /**< Spatial parameters are
+                                               *   updated round-robin */
+    INTERFACE_QUALITY_TIER_HOLD_PARAMS,       /**< Spatial parameters are held */
+    INTERFACE_QUALITY_TIER_LINEAR_ONLY        /**< Linear-only rendering (no
+                                               *   spatial analysis) */
+}INTERFACE_QUALITY_TIERS;
+#define INTERFACE_NUM_QUALITY_TIERS ( 5 )
+
+/** Processing stages that are timed when profiling (see interface_getProfile()) */
+typedef enum {
+    INTERFACE_PROFILE_FORWARD_FB = 0,      /**< Forward time-frequency transform */
+    INTERFACE_PROFILE_COVARIANCE,          /**< Covariance matrices */
+    INTERFACE_PROFILE_WHITENING,           /**< Diffuse-field whitening */
+    INTERFACE_PROFILE_EIG,                 /**< Eigenvalue decompositions */
+    INTERFACE_PROFILE_MUSIC,               /**< Source number detection and DoA
+                                            *   estimation */
+    INTERFACE_PROFILE_POSE_UPDATE,         /**< Listener pose update */
+    INTERFACE_PROFILE_BSM,                 /**< BSM decoders for the pose */
+    INTERFACE_PROFILE_MIXING_CONSTRUCTION, /**< Per-band mixing matrices */
+    INTERFACE_PROFILE_MIXING_APPLY,        /**< Application of the mixing
+                                            *   matrices */
+    INTERFACE_PROFILE_INVERSE_FB           /**< Inverse time-frequency
+                                            *   transform */
+}INTERFACE_PROFILE_STAGES;
+#define INTERFACE_NUM_PROFILE_STAGES ( 10 )
+
+/** Running statistics of the time spent in one processing stage per frame */
+typedef struct _interface_profile_stats {
+    float last_ms;      /**< Time spent for the last frame, in milliseconds */
+    float mean_ms;      /**< Mean time per frame, in milliseconds */
+    float p99_ms;       /**< 99th percentile, in milliseconds (to within 12%) */
+    float max_ms;       /**< Maximum time per frame, in milliseconds */
+    unsigned int count; /**< Number of frames for which the stage was run */
+}interface_profile_stats;
+
+/**
+ * Reasons for which interface_process() outputs silence rather than processing
+ * a block (see interface_getTelemetry())
+ */
+typedef enum {
+    INTERFACE_SKIP_FRAME_SIZE = 0,  /**< The block size was not the frame size
+                                     *   (see interface_getFrameSize()) */
+    INTERFACE_SKIP_NO_ARRAY_IRS,    /**< No array IRs have been loaded */
+    INTERFACE_SKIP_NOT_INITIALISED  /**< The core was not initialised, or was
+                                     *   being initialised */
+}INTERFACE_SKIP_REASONS;
+#define INTERFACE_NUM_SKIP_REASONS ( 3 )
+
+/**
+ * Block timing telemetry of interface_process(), since the interface was
+ * created or interface_resetTelemetry() was called
+ *
+ * All times are on the same monotonic clock, in seconds, so the age of an
+ * event is time_s minus its timestamp.
+ */
+typedef struct _interface_telemetry {
+    unsigned int nProcessed;                              /**< Number of blocks processed */
+    unsigned int nSkipped[INTERFACE_NUM_SKIP_REASONS];    /**< Number of blocks output as silence, per reason (see #INTERFACE_SKIP_REASONS) */
+    double lastSkipTime_s[INTERFACE_NUM_SKIP_REASONS];    /**< Time of the last skipped block per reason, or -1 if there has not been one */
+    unsigned int nOverruns;                               /**< Number of blocks that took longer to process than their duration (nSamples/fs) */
+    double lastOverrunTime_s;                             /**< Time of the last overrun, or -1 if there has not been one */
+    float worstBlockTime_ms;                              /**< Longest time taken by a single call, in milliseconds */
+    float worstBlockLoad;                                 /**< Longest time taken by a single call, relative to the block duration */
+    float meanLoad;                                       /**< Processing time relative to the block duration, averaged over the processed (not skipped) blocks of roughly the last second; a longer-term average than interface_getCpuLoad() */
+    double time_s;                                        /**< Time at which this snapshot was taken */
+}interface_telemetry;
+
 /** Available degrees-of-freedom options the core can be configured for */
 typedef enum {
     CORE_0DOF = 1,          /**< Fixed-head rendering */
@@ -103,6 +190,12 @@ void interface_init(void* const hInt,
 /**
  * Intialises the core based on current global/user parameters
  *
+ * Changing the configuration while this is ongoing cancels it at its next
+ * checkpoint, after which the core status returns to
+ * CORE_STATUS_NOT_INITIALISED, and the current core is left untouched.
+ * Calling this function again then applies all of the changes made in the
+ * meantime at once.
+ *
  * @param[in] hInt interface handle
  */
 void interface_initCore(void* const hInt);
@@ -124,6 +217,23 @@ void interface_process(void* const hInt,
                        int nOutputs,
                        int nSamples);
 
+/**
+ * Returns the start time of a span to be traced, to pass to
+ * interface_traceEnd(), or 0 if tracing is disabled (see
+ * interface_setEnableTracing())
+ */
+unsigned long long interface_traceBegin(void);
+
+/**
+ * Records a span on the calling thread, from t0 (see interface_traceBegin())
+ * until now, if tracing is enabled
+ *
+ * @param[in] name Name of the span (static string)
+ * @param[in] t0   Start time of the span
+ */
+void interface_traceEnd(const char* name,
+                        unsigned long long t0);
+
 
 /* ========================================================================== */
 /*                                Set Functions                               */
@@ -140,6 +250,32 @@ void interface_setEnableEPbeamformers(void* const hInt, int newState);
 void interface_setEnableDiffEQ_HRTFs(void* const hInt, int newState);
 void interface_setEnableDiffEQ_ATFs(void* const hInt, int newState);
 
+/**
+ * Sets whether the HRTFs should only be interpolated for the grid directions
+ * that are actually used, upon first use (1), rather than for the whole array
+ * grid during initialisation (0). This reduces the initialisation time and
+ * memory footprint for dense array grids. Takes effect upon re-initialisation
+ */
+void interface_setEnableLazyHRTFs(void* const hInt, int newState);
+
+/**
+ * Sets whether the array ATFs should be stored as spherical harmonic
+ * coefficients per band (1), with the order of each band chosen by a fitting
+ * error threshold, rather than for every grid direction (0). This reduces the
+ * memory footprint for dense array grids, at the cost of synthesising the
+ * steering vectors when they are needed. Takes effect upon re-initialisation
+ */
+void interface_setEnableCompressedATFs(void* const hInt, int newState);
+
+/**
+ * Sets the maximum number of threads used to initialise the core (0: one per
+ * processor, 1: only the initialisation thread). The results are identical for
+ * any number of threads, so this does not require re-initialisation. Note that
+ * this applies to all instances in the process (see
+ * proposed_setMaxInitThreads())
+ */
+void interface_setMaxInitThreads(void* const hInt, int newValue);
+
 /** See #INTERFACE_DOF_OPTIONS */
 void interface_setDOFoption(void* const hInt, INTERFACE_DOF_OPTIONS newOption);
 
@@ -155,6 +291,31 @@ void interface_setSynthesisAveraging(void* const hInt,
 void interface_setMaximumAnalysisFreq(void* const hInt,
                                       float newValue);
 
+/**
+ * Sets whether the analysis should only process the bands used by the
+ * estimator (i.e., those below the maximum analysis frequency)
+ *
+ * @param[in] hInt     interface handle
+ * @param[in] newState 1: enabled (default), 0: process all bands
+ */
+void interface_setEnableBandLimitedAnalysis(void* const hInt,
+                                            int newState);
+
+/** See #INTERFACE_ANALYSIS_UPDATE_SCHEDULES */
+void interface_setAnalysisUpdateSchedule(void* const hInt,
+                                         INTERFACE_ANALYSIS_UPDATE_SCHEDULES newSchedule);
+
+/** Sets the update interval N (in blocks) used by the update schedule */
+void interface_setAnalysisUpdateInterval(void* const hInt,
+                                         int newValue);
+
+/**
+ * Sets the frequency (Hz), below which bands are only updated every Nth block
+ * with #INTERFACE_ANALYSIS_UPDATE_DECIMATED (default: 1.5kHz)
+ */
+void interface_setAnalysisDecimationFreq(void* const hInt,
+                                         float newValue);
+
 /** Sets the maximum BSM frequency (Hz), above which we use PWD */
 void interface_setMaximumBSMFreq(void* const hInt,
                                  float newValue);
@@ -199,6 +360,10 @@ void interface_setStreamBalanceAllBands(void* const hInt,
 /**
  * Sets the file path for a .sofa file
  *
+ * A bundle written by the sofa2bundle tool may be given instead, which is
+ * loaded much faster. It must have been computed for the current samplerate;
+ * any HRTFs that it holds are used, unless an HRIR file has been set.
+ *
  * @param[in] hInt       interface handle
  * @param[in] path       File path to .sofa file (WITH file extension)
  */
@@ -254,6 +419,140 @@ void interface_setPerimeterDistance(void* const hInt, float newValue);
 /** Sets the source directivity flag */
 void interface_setEnableSourceDirectivity(void* const hInt, int newState);
 
+/**
+ * Sets whether the analysis and synthesis should be bypassed while the input
+ * is silent (i.e., below the silence gate threshold)
+ *
+ * Once the input has remained below the threshold for the hold time, the
+ * spatial parameters and mixing matrices are held, and only the remaining tail
+ * of the synthesis filterbank is output before going fully idle. Processing
+ * resumes as soon as the input level exceeds the threshold by
+ * a few dB (hysteresis).
+ *
+ * Since very quiet material (e.g. measurement signals) may also be gated, this
+ * is disabled by default.
+ *
+ * @param[in] hInt     interface handle
+ * @param[in] newState 1: enabled, 0: disabled (default)
+ */
+void interface_setEnableSilenceGate(void* const hInt, int newState);
+
+/** Sets the silence gate threshold, in dBFS (mean input power per sample) */
+void interface_setSilenceGateThreshold(void* const hInt, float newValue_dB);
+
+/** Sets the time the input must remain silent before the gate closes, in s */
+void interface_setSilenceGateHoldTime(void* const hInt, float newValue_s);
+
+/**
+ * Sets whether to use linear-only rendering
+ *
+ * When enabled, only the forward filterbank, the linear (BSM/PWD) binaural
+ * decoder and the inverse filterbank are applied; i.e., the spatial analysis
+ * and parametric rendering are bypassed entirely. This is intended as a
+ * low-CPU mode.
+ *
+ * @param[in] hInt     interface handle
+ * @param[in] newState 1: enabled, 0: disabled (default)
+ */
+void interface_setEnableLinearOnly(void* const hInt, int newState);
+
+/**
+ * Sets whether the analysis and synthesis should be carried out in a single
+ * pass over the bands (see proposed_synthesis_applyFused()), rather than one
+ * pass over all bands per processing stage. The output is the same either way,
+ * so this is disabled by default and may be enabled where it proves faster.
+ *
+ * @param[in] hInt     interface handle
+ * @param[in] newState 1: enabled, 0: disabled (default)
+ */
+void interface_setEnableBandFusedProcessing(void* const hInt, int newState);
+
+/**
+ * Sets whether to render using static FIRs while the listener pose is
+ * unchanged
+ *
+ * Only applies to linear-only rendering (see interface_setEnableLinearOnly()),
+ * for which the decoder depends only on the listener pose. Once the pose has
+ * remained unchanged for a short while, the decoder is converted into FIR
+ * filters and applied using partitioned convolution, which is cheaper than the
+ * filterbank. Switching between the two is crossfaded.
+ *
+ * @param[in] hInt     interface handle
+ * @param[in] newState 1: enabled, 0: disabled (default)
+ */
+void interface_setEnableStaticPoseFIRs(void* const hInt, int newState);
+
+/**
+ * Sets whether the CPU-budget governor is enabled
+ *
+ * The governor measures the time taken by interface_process() for each frame,
+ * relative to the frame duration, and steps down through the quality tiers
+ * (see #INTERFACE_QUALITY_TIERS) if this exceeds the CPU budget. The quality
+ * is stepped back up once the load has remained well below the budget for a
+ * while.
+ *
+ * @param[in] hInt     interface handle
+ * @param[in] newState 1: enabled, 0: disabled (default)
+ */
+void interface_setEnableCpuGovernor(void* const hInt, int newState);
+
+/**
+ * Sets the CPU budget used by the governor, as a fraction of the frame
+ * duration (0.05..1)
+ */
+void interface_setCpuBudget(void* const hInt, float newValue);
+
+/**
+ * Enables/Disables the timing of the individual processing stages (see
+ * interface_getProfile())
+ *
+ * @param[in] hInt     interface handle
+ * @param[in] newState 1: enabled, 0: disabled (default)
+ */
+void interface_setEnableProfiling(void* const hInt, int newState);
+
+/** Clears the timing statistics of all processing stages */
+void interface_resetProfile(void* const hInt);
+
+/**
+ * Clears the block timing telemetry (see interface_getTelemetry()); this is
+ * applied by the next call to interface_process()
+ */
+void interface_resetTelemetry(void* const hInt);
+
+/**
+ * Enables/Disables the tracing of processing spans, for all instances (see
+ * interface_dumpTrace())
+ *
+ * The spans recorded are interface_process(), interface_initCore() and its
+ * steps, the processing stages (see #INTERFACE_PROFILE_STAGES), and any span
+ * marked with interface_traceBegin() and interface_traceEnd(); each along
+ * with the thread that it ran on.
+ *
+ * @param[in] newState 1: enabled, 0: disabled (default)
+ */
+void interface_setEnableTracing(int newState);
+
+/**
+ * Names the calling thread in the trace (see interface_setEnableTracing())
+ *
+ * The spans of interface_initCore() are recorded on the thread that calls it,
+ * which is left to name itself (e.g. a thread started to initialise the core).
+ *
+ * @param[in] name Name of the thread (static string)
+ */
+void interface_setTraceThreadName(const char* name);
+
+/**
+ * Releases the trace buffer of the calling thread, so that it may be used by
+ * another thread; to be called before a short-lived thread that may have
+ * traced spans returns (e.g. one started to call interface_initCore())
+ */
+void interface_releaseTraceThread(void);
+
+/** Discards the spans traced so far */
+void interface_resetTrace(void);
+
 /** Sets the listener position x coordinate (relative to origin), in metres */
 void interface_setX(void* const hInt, float newX);
 
@@ -311,6 +610,15 @@ int interface_getEnableEPbeamformers(void* const hInt);
 int interface_getEnableDiffEQ_HRTFs(void* const hInt);
 int interface_getEnableDiffEQ_ATFs(void* const hInt);
 
+/** Returns whether the HRTFs are interpolated upon first use (1) or not (0) */
+int interface_getEnableLazyHRTFs(void* const hInt);
+
+/** Returns whether the array ATFs are stored as SH coefficients (1) or not (0) */
+int interface_getEnableCompressedATFs(void* const hInt);
+
+/** Returns the maximum number of threads used to initialise the core (0: one per processor) */
+int interface_getMaxInitThreads(void* const hInt);
+
 /** Returns current DoF option (see #INTERFACE_DOF_OPTIONS) */
 INTERFACE_DOF_OPTIONS interface_getDOFoption(void* const hInt);
  
@@ -323,6 +631,21 @@ float interface_getSynthesisAveraging(void* const hInt);
 /** Returns the maximum spatial analysis frequency in Hz */
 float interface_getMaximumAnalysisFreq(void* const hInt);
  
+/** Returns the band-limited analysis flag (1: enabled, 0: disabled) */
+int interface_getEnableBandLimitedAnalysis(void* const hInt);
+
+/** See #INTERFACE_ANALYSIS_UPDATE_SCHEDULES */
+INTERFACE_ANALYSIS_UPDATE_SCHEDULES interface_getAnalysisUpdateSchedule(void* const hInt);
+
+/** Returns the update interval N (in blocks) used by the update schedule */
+int interface_getAnalysisUpdateInterval(void* const hInt);
+
+/**
+ * Returns the frequency (Hz), below which bands are only updated every Nth
+ * block with #INTERFACE_ANALYSIS_UPDATE_DECIMATED
+ */
+float interface_getAnalysisDecimationFreq(void* const hInt);
+
 /** Returns the maximum BSM frequency in Hz */
 float interface_getMaximumBSMFreq(void* const hInt);
 
@@ -489,6 +812,115 @@ float interface_getPerimeterDistance(void* const hInt);
 /** Returns the source directivity flag */
 int interface_getEnableSourceDirectivity(void* const hInt);
 
+/** Returns the silence gate flag (1: enabled, 0: disabled) */
+int interface_getEnableSilenceGate(void* const hInt);
+
+/** Returns the silence gate threshold, in dBFS */
+float interface_getSilenceGateThreshold(void* const hInt);
+
+/** Returns the silence gate hold time, in seconds */
+float interface_getSilenceGateHoldTime(void* const hInt);
+
+/**
+ * Returns whether the silence gate is currently closed (1: processing is
+ * bypassed, 0: processing as normal)
+ */
+int interface_getSilenceGateIsClosed(void* const hInt);
+
+/** Returns the linear-only rendering flag (1: enabled, 0: disabled) */
+int interface_getEnableLinearOnly(void* const hInt);
+
+/** Returns the band-fused processing flag (1: enabled, 0: disabled) */
+int interface_getEnableBandFusedProcessing(void* const hInt);
+
+/** Returns the static-pose FIR rendering flag (1: enabled, 0: disabled) */
+int interface_getEnableStaticPoseFIRs(void* const hInt);
+
+/**
+ * Returns whether the static FIRs are currently being used for rendering (1)
+ * or the filterbank (0)
+ */
+int interface_getStaticPoseFIRsActive(void* const hInt);
+
+/** Returns the CPU-budget governor flag (1: enabled, 0: disabled) */
+int interface_getEnableCpuGovernor(void* const hInt);
+
+/** Returns the CPU budget, as a fraction of the frame duration */
+float interface_getCpuBudget(void* const hInt);
+
+/**
+ * Returns the quality tier currently selected by the CPU-budget governor (see
+ * #INTERFACE_QUALITY_TIERS); always #INTERFACE_QUALITY_TIER_FULL if the
+ * governor is disabled
+ */
+INTERFACE_QUALITY_TIERS interface_getQualityTier(void* const hInt);
+
+/**
+ * Returns the (smoothed) processing time per frame, as a fraction of the frame
+ * duration, as measured by the governor
+ *
+ * This is averaged over only a few frames, so that the governor reacts
+ * quickly, and only includes frames that are fully processed (i.e. not while
+ * the silence gate is closed). See interface_telemetry::meanLoad for a longer
+ * term average.
+ */
+float interface_getCpuLoad(void* const hInt);
+
+/** Returns the profiling flag (1: enabled, 0: disabled) */
+int interface_getEnableProfiling(void* const hInt);
+
+/**
+ * Returns the timing statistics of each processing stage, since the core was
+ * last initialised or interface_resetProfile() was called
+ *
+ * Stages which are computed per frequency band are summed over all bands of
+ * the frame. The timings are updated after each frame that is processed while
+ * profiling is enabled, and may be read from any thread; the statistics are
+ * computed by this function, rather than on the processing thread.
+ *
+ * @param[in]  hInt  interface handle
+ * @param[out] stats Statistics per stage (see #INTERFACE_PROFILE_STAGES);
+ *                   INTERFACE_NUM_PROFILE_STAGES x 1
+ */
+void interface_getProfile(void* const hInt,
+                          interface_profile_stats* stats);
+
+/** Returns the name of a processing stage (see #INTERFACE_PROFILE_STAGES) */
+const char* interface_getProfileStageName(INTERFACE_PROFILE_STAGES stage);
+
+/**
+ * Returns a consistent snapshot of the block timing telemetry, i.e. the
+ * number of skipped blocks (per reason), overruns, the worst-case block time
+ * and the CPU load
+ *
+ * This may be called from any thread. It never blocks interface_process(),
+ * which updates the telemetry after every block; instead, the snapshot is
+ * taken again if it was updated in the meantime.
+ *
+ * @param[in]  hInt      interface handle
+ * @param[out] telemetry Snapshot of the telemetry
+ */
+void interface_getTelemetry(void* const hInt,
+                            interface_telemetry* telemetry);
+
+/** Returns the name of a reason for skipping blocks (see #INTERFACE_SKIP_REASONS) */
+const char* interface_getSkipReasonName(INTERFACE_SKIP_REASONS reason);
+
+/** Returns the tracing flag (1: enabled, 0: disabled) */
+int interface_getEnableTracing(void);
+
+/**
+ * Writes the traced spans (see interface_setEnableTracing()) to a file, as
+ * Chrome trace-event JSON, which may be opened in chrome://tracing or
+ * https://ui.perfetto.dev
+ *
+ * This may be called at any time; the spans are kept.
+ *
+ * @param[in] path Path of the file to write
+ * @returns Number of spans written, or -1 if the file could not be written
+ */
+int interface_dumpTrace(const char* path);
+
 /** Returns the listener position x coordinate (relative to origin), in metres */
 float interface_getX(void* const hInt);
 
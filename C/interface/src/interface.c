@@ -26,6 +26,8 @@ void interface_create
     pData->enableEPbeamformers = SAF_TRUE;
     pData->enableDiffEQ_HRTFs = SAF_TRUE;
     pData->enableDiffEQ_ATFs = SAF_FALSE;
+    pData->enableLazyHRTFs = SAF_FALSE;
+    pData->enableCompressedATFs = SAF_FALSE;
     pData->renderingMode = CORE_6DOF;
     pData->sofa_filepath_MAIR = NULL;
     pData->useDefaultHRIRsFLAG = SAF_TRUE;
@@ -42,6 +44,15 @@ void interface_create
     pData->distMapOption = INTERFACE_DISTANCE_MAP_USE_PARAM;
     pData->sourceDistance = 1.85f;
     pData->enableSourceDirectivity = SAF_FALSE;
+    pData->enableSilenceGate = SAF_FALSE; /* opt-in, as it gates quiet material (e.g. measurements) */
+    pData->silenceGateThreshold_dB = -90.0f;
+    pData->silenceGateHold_s = 0.5f;
+    pData->enableLinearOnly = SAF_FALSE;
+    pData->enableBandFusedProcessing = SAF_FALSE; /* opt-in, as the output is the same either way */
+    pData->enableStaticPoseFIRs = SAF_FALSE;
+    pData->enableCpuGovernor = SAF_FALSE;
+    pData->cpuBudget = 0.7f;
+    pData->enableProfiling = 0; /* opt-in, as the timers themselves cost a little on every frame */
     pData->x = 0.0f;
     pData->y = 0.0f;
     pData->z = 0.0f;
@@ -52,6 +63,7 @@ void interface_create
     /* internal parameters */
     pData->inputFrameTD =  (float**)malloc2d(INTERFACE_MAX_NUM_CHANNELS, FRAME_SIZE, sizeof(float));
     pData->outputFrameTD = (float**)malloc2d(NUM_EARS, FRAME_SIZE, sizeof(float));
+    pData->firFrameTD = (float**)malloc2d(NUM_EARS, FRAME_SIZE, sizeof(float));
     pData->fs = 48000.0f;
     pData->hAna = NULL;
     pData->hSyn = NULL;
@@ -80,6 +92,23 @@ void interface_create
     pData->MAIR_SOFA_isLoadedFLAG = 0;
     pData->procStatus = PROC_STATUS_NOT_ONGOING;
     pData->coreStatus = CORE_STATUS_NOT_INITIALISED;
+    pData->initRequest = 0;
+    pData->gateStatus = GATE_STATUS_OPEN;
+    pData->gateCounter = 0;
+    pData->qualityTier = INTERFACE_QUALITY_TIER_FULL;
+    pData->cpuLoad = 0.0f;
+    pData->governorCounter = 0;
+    memset(&(pData->profile_local), 0, sizeof(proposed_profile_counters));
+    pData->profileSeq = 0;
+    pData->profileResetRequested = 0;
+    pData->telemetrySeq = 0;
+    pData->telemetryResetRequested = 1; /* i.e. initialised with the first block */
+    memset(&(pData->telemetry), 0, sizeof(interface_telemetry));
+    pData->firStatus = STATIC_FIR_STATUS_OFF;
+    pData->firCounter = 0;
+    pData->poseCounter = 0;
+    pData->staticFIRsInvalid = 1;
+    memset(pData->prevPose, 0, 7*sizeof(float));
 
     /* Init core with defaults */
     interface_initCore(*phInt);
@@ -93,7 +122,8 @@ void interface_destroy
     interface_data *pData = (interface_data*)(*phInt);
 
     if (pData != NULL) {
-        /* not safe to free memory during intialisation/processing loop */
+        /* not safe to free memory during intialisation/processing loop (an ongoing initialisation is cancelled at its next checkpoint) */
+        interface_requestInit(*phInt);
         while (pData->coreStatus == CORE_STATUS_INITIALISING ||
                pData->procStatus == PROC_STATUS_ONGOING){
             SAF_SLEEP(10);
@@ -107,6 +137,7 @@ void interface_destroy
         free(pData->progressBarText);
         free(pData->inputFrameTD);
         free(pData->outputFrameTD);
+        free(pData->firFrameTD);
         free(pData->freqVector_local);
         free(pData->streamBalBands_local);
         free(pData->histogram_local);
@@ -136,6 +167,10 @@ void interface_init
         proposed_analysis_reset(pData->hAna);
         proposed_synthesis_reset(pData->hSyn);
     }
+    pData->gateStatus = GATE_STATUS_OPEN;
+    pData->gateCounter = 0;
+    pData->firStatus = STATIC_FIR_STATUS_OFF;
+    pData->poseCounter = 0;
 }
 
 void interface_initCore
@@ -144,12 +179,23 @@ void interface_initCore
 )
 {
     interface_data *pData = (interface_data*)(hInt);
-    int load_prevFLAG, nBands;
+    int load_prevFLAG, nBands, useBundledHRTFs, cancelled;
+    int favour2Daccuracy, enableEPbeamformers, enableDiffEQ_HRTFs, enableDiffEQ_ATFs, enableLazyHRTFs, enableCompressedATFs;
+    int nDirs, nMics, IRlength;
     float* eq, *streamBalance, *tmp;
     SAF_SOFA_ERROR_CODES error;
     saf_sofa_container sofa;
-    float maxMagLSFreq, maxBSMFreq, maxAnalysisFreq;
+    float fs, IR_fs, maxMagLSFreq, maxBSMFreq, maxAnalysisFreq, decimationFreq;
+    int enableBandLimitedAnalysis, updateInterval;
+    PROPOSED_ANALYSIS_UPDATE_SCHEDULES updateSchedule;
     float* grid_dirs_deg;
+    char* sofa_filepath_MAIR, *sofa_filepath_HRIR;
+    proposed_analysis_handle hAna;
+    proposed_synthesis_handle hSyn;
+    proposed_param_container_handle hPCon;
+    proposed_signal_container_handle hSCon;
+    unsigned long long tInit, tStep;
+    long initRequest;
 
     if (pData->coreStatus != CORE_STATUS_NOT_INITIALISED)
         return; /* re-init not required, or already happening */
@@ -158,19 +204,50 @@ void interface_initCore
         pData->coreStatus = CORE_STATUS_INITIALISING; /* indicate that we want to init */
         SAF_SLEEP(10);
     }
+    tInit = proposed_trace_begin();
     
     /* for progress bar */
     pData->coreStatus = CORE_STATUS_INITIALISING;
     strcpy(pData->progressBarText,"Intialising Core");
     pData->progressBar0_1 = 0.0f;
 
+    /* Snapshot of the configuration. Any change made from here on cancels this initialisation at its next checkpoint
+     * (see interface_setCoreStatus()), and the changes are then picked up together by the next one. The checkpoints (and
+     * progress bar updates) are between the stages, so a stage that has started (e.g. proposed_analysis_create()) is
+     * always completed first */
+    initRequest = interface_getInitRequest(hInt);
+    fs = pData->fs;
+    favour2Daccuracy = pData->favour2Daccuracy;
+    enableEPbeamformers = pData->enableEPbeamformers;
+    enableDiffEQ_HRTFs = pData->enableDiffEQ_HRTFs;
+    enableDiffEQ_ATFs = pData->enableDiffEQ_ATFs;
+    enableLazyHRTFs = pData->enableLazyHRTFs;
+    enableCompressedATFs = pData->enableCompressedATFs;
+    sofa_filepath_MAIR = sofa_filepath_HRIR = NULL;
+    if(pData->sofa_filepath_MAIR!=NULL){
+        sofa_filepath_MAIR = malloc1d(strlen(pData->sofa_filepath_MAIR)+1);
+        strcpy(sofa_filepath_MAIR, pData->sofa_filepath_MAIR);
+    }
+    if(pData->sofa_filepath_HRIR!=NULL){
+        sofa_filepath_HRIR = malloc1d(strlen(pData->sofa_filepath_HRIR)+1);
+        strcpy(sofa_filepath_HRIR, pData->sofa_filepath_HRIR);
+    }
+
     /* Local copy of internal settings (since they are overriden) */
     maxBSMFreq = maxMagLSFreq = maxAnalysisFreq = 0.0f;
+    enableBandLimitedAnalysis = 1;
+    updateSchedule = PROPOSED_ANALYSIS_UPDATE_ALL_BANDS;
+    updateInterval = 2;
+    decimationFreq = 1.5e3f;
     if(pData->hAna!=NULL && pData->hSyn!=NULL){
         load_prevFLAG = 1;
         maxBSMFreq = *proposed_synthesis_getMaxBSMFreqPtr(pData->hSyn);
         maxMagLSFreq = *proposed_synthesis_getMaxMagLSFreqPtr(pData->hSyn);
         maxAnalysisFreq = *proposed_analysis_getMaxAnalysisFreqPtr(pData->hAna);
+        enableBandLimitedAnalysis = *proposed_analysis_getEnableBandLimitedAnalysisPtr(pData->hAna);
+        updateSchedule = *proposed_analysis_getUpdateSchedulePtr(pData->hAna);
+        updateInterval = *proposed_analysis_getUpdateIntervalPtr(pData->hAna);
+        decimationFreq = *proposed_analysis_getDecimationFreqPtr(pData->hAna);
         tmp = proposed_synthesis_getEqPtr(pData->hSyn, &nBands);
         eq = malloc1d(nBands*sizeof(float));
         memcpy(eq, tmp, nBands*sizeof(float));
@@ -183,39 +260,66 @@ void interface_initCore
         eq = streamBalance = NULL;
         nBands = -1;
     }
-    
-    /* Load SOFA file */
-    error = saf_sofa_open(&sofa, pData->sofa_filepath_MAIR, SAF_SOFA_READER_OPTION_DEFAULT);
-    if(error==SAF_SOFA_OK){
-        pData->nDirs = sofa.nSources;
-        pData->nMics = sofa.nReceivers;
-        pData->IR_fs = sofa.DataSamplingRate;
-        pData->IRlength = sofa.DataLengthIR;
-        grid_dirs_deg = malloc1d(pData->nDirs*2*sizeof(float));
-        cblas_scopy(pData->nDirs, sofa.SourcePosition, 3, grid_dirs_deg, 2); /* azi */
-        cblas_scopy(pData->nDirs, &sofa.SourcePosition[1], 3, &grid_dirs_deg[1], 2); /* elev */
-   
-        /* Analysis */
-        strcpy(pData->progressBarText,"Intialising Analysis");
-        pData->progressBar0_1 = 0.3f;
-        proposed_analysis_destroy(&(pData->hAna));
-        proposed_analysis_create(&(pData->hAna), pData->fs, HOP_SIZE, FRAME_SIZE, sofa.DataIR, grid_dirs_deg, pData->nDirs, pData->nMics, sofa.DataLengthIR);
-        free(grid_dirs_deg);
 
+    /* The new core is built alongside the current one, which is only replaced once it is complete. Therefore, a cancelled
+     * initialisation leaves the current core (and its settings) untouched, and models that are unaffected by the change
+     * are shared with it through the model cache, rather than being computed again */
+    hAna = NULL;
+    hSyn = NULL;
+    hPCon = NULL;
+    hSCon = NULL;
+    nDirs = nMics = IRlength = 0;
+    IR_fs = 0.0f;
+    cancelled = 0;
+
+    /* Analysis; either loaded from a bundle that was pre-computed for this samplerate (see sofa2bundle), or from a SOFA file */
+    strcpy(pData->progressBarText,"Intialising Analysis");
+    pData->progressBar0_1 = 0.05f;
+    tStep = proposed_trace_begin();
+    memset(&sofa, 0, sizeof(saf_sofa_container)); /* it is closed below, even if a bundle was loaded instead */
+    if(proposed_analysis_createFromBundle(&hAna, sofa_filepath_MAIR, fs, HOP_SIZE, FRAME_SIZE)==PROPOSED_BUNDLE_OK){
+        nDirs = proposed_analysis_getNDirs(hAna);
+        nMics = proposed_analysis_getNMics(hAna);
+        IR_fs = fs;
+        error = SAF_SOFA_OK;
+    }
+    else{
+        error = saf_sofa_open(&sofa, sofa_filepath_MAIR, SAF_SOFA_READER_OPTION_DEFAULT);
+        pData->progressBar0_1 = 0.15f;
+        cancelled = interface_isInitCancelled(hInt, initRequest);
+        if(error==SAF_SOFA_OK && !cancelled){
+            nDirs = sofa.nSources;
+            nMics = sofa.nReceivers;
+            IR_fs = sofa.DataSamplingRate;
+            IRlength = sofa.DataLengthIR;
+            grid_dirs_deg = malloc1d(nDirs*2*sizeof(float));
+            cblas_scopy(nDirs, sofa.SourcePosition, 3, grid_dirs_deg, 2); /* azi */
+            cblas_scopy(nDirs, &sofa.SourcePosition[1], 3, &grid_dirs_deg[1], 2); /* elev */
+            proposed_analysis_create(&hAna, fs, HOP_SIZE, FRAME_SIZE, sofa.DataIR, grid_dirs_deg, nDirs, nMics, sofa.DataLengthIR,
+                                     enableCompressedATFs ? PROPOSED_ATF_SH_DEFAULT_FIT_ERROR : 0.0f);
+            free(grid_dirs_deg);
+        }
+        saf_sofa_close(&sofa); /* The array IRs are no longer needed */
+    }
+    proposed_trace_end("Init: analysis", tStep);
+    cancelled = cancelled || interface_isInitCancelled(hInt, initRequest);
+    if(error==SAF_SOFA_OK && !cancelled){
         /* Parameter/signal containers */
         strcpy(pData->progressBarText,"Intialising Containers");
-        pData->progressBar0_1 = 0.5f;
-        proposed_param_container_destroy(&(pData->hPCon));
-        proposed_param_container_create(&(pData->hPCon), pData->hAna);
-        proposed_signal_container_destroy(&(pData->hSCon));
-        proposed_signal_container_create(&(pData->hSCon), pData->hAna);
+        pData->progressBar0_1 = 0.6f;
+        tStep = proposed_trace_begin();
+        proposed_param_container_create(&hPCon, hAna);
+        proposed_signal_container_create(&hSCon, hAna);
+        proposed_trace_end("Init: containers", tStep);
 
-        /* Synthesis */
+        /* HRIRs */
         strcpy(pData->progressBarText,"Intialising Synthesis");
-        pData->progressBar0_1 = 0.8f;
-        saf_sofa_close(&sofa); /* Close previous */
-        error = saf_sofa_open(&sofa, pData->sofa_filepath_HRIR, SAF_SOFA_READER_OPTION_DEFAULT);
-        if(error==SAF_SOFA_OK){
+        pData->progressBar0_1 = 0.65f;
+        tStep = proposed_trace_begin();
+        useBundledHRTFs = sofa_filepath_HRIR==NULL && proposed_analysis_hasBundledHRTFs(hAna);
+        if(useBundledHRTFs) /* Use the HRTFs stored in the bundle, unless other HRIRs have been loaded */
+            pData->useDefaultHRIRsFLAG = 0;
+        else if((error = saf_sofa_open(&sofa, sofa_filepath_HRIR, SAF_SOFA_READER_OPTION_DEFAULT))==SAF_SOFA_OK){
             pData->binConfig.nHRIR = sofa.nSources;
             pData->binConfig.hrir_fs = sofa.DataSamplingRate;
             pData->binConfig.lHRIR = sofa.DataLengthIR;
@@ -236,15 +340,67 @@ void interface_initCore
             pData->binConfig.hrir_fs = __default_hrir_fs;
             pData->useDefaultHRIRsFLAG = 1;
         }
-        proposed_synthesis_destroy(&(pData->hSyn));
-        proposed_synthesis_create(&(pData->hSyn), pData->hAna, &pData->binConfig, PROPOSED_HRTF_INTERP_NEAREST, pData->favour2Daccuracy, pData->enableEPbeamformers, pData->enableDiffEQ_HRTFs, pData->enableDiffEQ_ATFs);
- 
-        /* All went OK */
-        pData->MAIR_SOFA_isLoadedFLAG = 1;
+        saf_sofa_close(&sofa);
+        proposed_trace_end("Init: HRIRs", tStep);
+
+        /* Synthesis */
+        pData->progressBar0_1 = 0.7f;
+        cancelled = interface_isInitCancelled(hInt, initRequest);
+        tStep = proposed_trace_begin();
+        if(!cancelled)
+            proposed_synthesis_create(&hSyn, hAna, useBundledHRTFs ? NULL : &pData->binConfig, enableLazyHRTFs ? PROPOSED_HRTF_INTERP_NEAREST_LAZY : PROPOSED_HRTF_INTERP_NEAREST,
+                                      favour2Daccuracy, enableEPbeamformers, enableDiffEQ_HRTFs, enableDiffEQ_ATFs);
+        proposed_trace_end("Init: synthesis", tStep);
+        error = SAF_SOFA_OK; /* (the default HRIRs are used if the HRIR SOFA file could not be loaded) */
     }
-    else /* Bypass audio, try to load a valid SOFA file instead: */
+    cancelled = cancelled || interface_isInitCancelled(hInt, initRequest);
+    free(sofa_filepath_MAIR);
+    free(sofa_filepath_HRIR);
+    if(cancelled || error!=SAF_SOFA_OK){
+        /* Discard the partially built core, and keep the current one (and its settings) */
+        proposed_synthesis_destroy(&hSyn);
+        proposed_param_container_destroy(&hPCon);
+        proposed_signal_container_destroy(&hSCon);
+        proposed_analysis_destroy(&hAna);
+        free(eq);
+        free(streamBalance);
+        if(cancelled){
+            /* The configuration has changed in the meantime; leave it to the next initialisation */
+            strcpy(pData->progressBarText,"Configuration changed");
+            pData->progressBar0_1 = 0.0f;
+            pData->coreStatus = CORE_STATUS_NOT_INITIALISED;
+            proposed_trace_end("interface_initCore (cancelled)", tInit);
+            return;
+        }
+
+        /* The array IRs could not be loaded; bypass audio until a valid SOFA file is loaded instead */
         pData->MAIR_SOFA_isLoadedFLAG = 0;
-    saf_sofa_close(&sofa);
+        strcpy(pData->progressBarText,"Failed to load the array IRs");
+        pData->progressBar0_1 = 1.0f;
+        pData->coreStatus = CORE_STATUS_INITIALISED;
+        if(interface_isInitCancelled(hInt, initRequest)) /* changed since the last checkpoint */
+            pData->coreStatus = CORE_STATUS_NOT_INITIALISED;
+        proposed_trace_end("interface_initCore (failed)", tInit);
+        return;
+    }
+
+    /* Replace the current core */
+    strcpy(pData->progressBarText,"Finalising Core");
+    pData->progressBar0_1 = 0.95f;
+    tStep = proposed_trace_begin();
+    proposed_synthesis_destroy(&(pData->hSyn));
+    proposed_param_container_destroy(&(pData->hPCon));
+    proposed_signal_container_destroy(&(pData->hSCon));
+    proposed_analysis_destroy(&(pData->hAna));
+    pData->hAna = hAna;
+    pData->hSyn = hSyn;
+    pData->hPCon = hPCon;
+    pData->hSCon = hSCon;
+    pData->nDirs = nDirs;
+    pData->nMics = nMics;
+    pData->IR_fs = IR_fs;
+    pData->IRlength = IRlength;
+    pData->MAIR_SOFA_isLoadedFLAG = 1;
 
     /* Load previous internal settings (if not first init, and nBands is the same) */
     if(load_prevFLAG && (nBands==proposed_analysis_getNbands(pData->hAna))){
@@ -256,6 +412,10 @@ void interface_initCore
         *proposed_synthesis_getMaxBSMFreqPtr(pData->hSyn) = maxBSMFreq;
         *proposed_synthesis_getMaxMagLSFreqPtr(pData->hSyn) = maxMagLSFreq;
         *proposed_analysis_getMaxAnalysisFreqPtr(pData->hAna) = maxAnalysisFreq;
+        *proposed_analysis_getEnableBandLimitedAnalysisPtr(pData->hAna) = enableBandLimitedAnalysis;
+        *proposed_analysis_getUpdateSchedulePtr(pData->hAna) = updateSchedule;
+        *proposed_analysis_getUpdateIntervalPtr(pData->hAna) = updateInterval;
+        *proposed_analysis_getDecimationFreqPtr(pData->hAna) = decimationFreq;
     }
  
     /* Local copy of internal parameter vectors (for optional thread-safe GUI plotting) */
@@ -273,12 +433,24 @@ void interface_initCore
     tmp = proposed_synthesis_getStreamBalancePtr(pData->hSyn, NULL);
     memcpy(pData->streamBalBands_local, tmp, pData->nBands_local*sizeof(float));
 
+    /* Start with the gate open, since the new core has no filterbank tail */
+    pData->gateStatus = GATE_STATUS_OPEN;
+    pData->gateCounter = 0;
+
+    /* Start with the filterbank, since there are no static FIRs yet */
+    pData->firStatus = STATIC_FIR_STATUS_OFF;
+    pData->poseCounter = 0;
+
     /* done! */
     strcpy(pData->progressBarText,"Done!");
     pData->progressBar0_1 = 1.0f;
     pData->coreStatus = CORE_STATUS_INITIALISED;
+    if(interface_isInitCancelled(hInt, initRequest)) /* changed since the last checkpoint */
+        pData->coreStatus = CORE_STATUS_NOT_INITIALISED;
     free(eq);
     free(streamBalance);
+    proposed_trace_end("Init: finalising", tStep);
+    proposed_trace_end("interface_initCore", tInit);
 }
 
 void interface_process
@@ -292,17 +464,27 @@ void interface_process
 )
 {
     interface_data *pData = (interface_data*)(hInt);
-    int ch, nMics;
-    float ypr_rad[3], xyz_m[3], Rzyx[3][3];
+    int i, ch, nMics, nHoldFrames, linearOnly, poseChanged, runFilterbank, runFIRs, fused, skipReason;
+    float ypr_rad[3], xyz_m[3], Rzyx[3][3], pose[7], level_dB, fade;
+    double startTime;
+    unsigned long long tProcess;
+    proposed_analysis_limits* limits;
     const float forwards_xyz[3] = {1.0f, 0.0f, 0.0f};
     PROPOSED_DISTANCE_MAPS distMap;
 
+    PROPOSED_RTGUARD_ENTER("interface_process");
+    startTime = interface_getTime_s();
+    if(proposed_trace_isEnabled())
+        proposed_trace_setThreadName("Audio");
+    tProcess = proposed_trace_begin();
+
     /* Local copies of parameters */
     nMics = pData->nMics;
     
     /* Process Frame if everything is ready */
     if ((nSamples == FRAME_SIZE) && (pData->coreStatus == CORE_STATUS_INITIALISED) && pData->MAIR_SOFA_isLoadedFLAG) {
         pData->procStatus = PROC_STATUS_ONGOING;
+        skipReason = TELEMETRY_NOT_SKIPPED;
 
         /* Load time-domain data */
         for(ch=0; ch < SAF_MIN(nMics, nInputs); ch++)
@@ -310,9 +492,34 @@ void interface_process
         for(; ch<nMics; ch++)
             memset(pData->inputFrameTD[ch], 0, FRAME_SIZE * sizeof(float)); /* fill remaining channels with zeros */
 
-        /* Apply proposed analysis */
-        proposed_analysis_apply(pData->hAna, pData->inputFrameTD, nMics, FRAME_SIZE, pData->hPCon, pData->hSCon);
- 
+        /* Silence gate (with hysteresis and hold time) */
+        if(pData->enableSilenceGate){
+            level_dB = 0.0f;
+            for(ch=0; ch<nMics; ch++)
+                level_dB += cblas_sdot(FRAME_SIZE, pData->inputFrameTD[ch], 1, pData->inputFrameTD[ch], 1);
+            level_dB = 10.0f*log10f(level_dB/(float)(SAF_MAX(nMics,1)*FRAME_SIZE) + 1e-20f);
+            switch(pData->gateStatus){
+                case GATE_STATUS_OPEN:
+                    nHoldFrames = (int)(pData->silenceGateHold_s*pData->fs/(float)FRAME_SIZE + 0.5f);
+                    pData->gateCounter = level_dB < pData->silenceGateThreshold_dB ? pData->gateCounter+1 : 0;
+                    if(pData->gateCounter > nHoldFrames){
+                        /* Close the gate, but first output the remaining filterbank tail (the tail of the static FIRs is negligible after the hold time) */
+                        pData->gateStatus = pData->firStatus == STATIC_FIR_STATUS_ON || pData->firStatus == STATIC_FIR_STATUS_RELEASE ? GATE_STATUS_IDLE : GATE_STATUS_TAIL;
+                        pData->gateCounter = interface_getProcessingDelay(hInt)/FRAME_SIZE + 1;
+                    }
+                    break;
+                case GATE_STATUS_TAIL: /* fall through */
+                case GATE_STATUS_IDLE:
+                    if(level_dB > pData->silenceGateThreshold_dB + SILENCE_GATE_HYSTERESIS_DB){
+                        pData->gateStatus = GATE_STATUS_OPEN;
+                        pData->gateCounter = 0;
+                    }
+                    break;
+            }
+        }
+        else
+            pData->gateStatus = GATE_STATUS_OPEN;
+
         /* Listener head-orientation/rotation */
         switch (pData->renderingMode){
             default: /* fall through */
@@ -347,25 +554,159 @@ void interface_process
             case INTERFACE_DISTANCE_MAP_2SRC:      distMap = PROPOSED_DISTANCE_MAP_2SRC; break;
             case INTERFACE_DISTANCE_MAP_3SRC:      distMap = PROPOSED_DISTANCE_MAP_3SRC; break; 
         }
-         
+
+        /* Static-pose FIR rendering (the FIRs are only valid for linear-only rendering at an unchanged pose) */
+        linearOnly = pData->enableLinearOnly || pData->qualityTier >= INTERFACE_QUALITY_TIER_LINEAR_ONLY;
+        memcpy(pose, ypr_rad, 3*sizeof(float));
+        memcpy(&pose[3], xyz_m, 3*sizeof(float));
+        pose[6] = pData->sourceDistance;
+        poseChanged = memcmp(pose, pData->prevPose, 7*sizeof(float)) || pData->staticFIRsInvalid || !linearOnly || !pData->enableStaticPoseFIRs;
+        memcpy(pData->prevPose, pose, 7*sizeof(float));
+        pData->staticFIRsInvalid = 0;
+        if(poseChanged){
+            pData->poseCounter = 0;
+            if(pData->firStatus == STATIC_FIR_STATUS_DESIGN || pData->firStatus == STATIC_FIR_STATUS_PRIMING)
+                pData->firStatus = STATIC_FIR_STATUS_OFF; /* was still rendering with the filterbank anyway */
+            else if(pData->firStatus == STATIC_FIR_STATUS_ON){
+                pData->firStatus = STATIC_FIR_STATUS_RELEASE;
+                pData->firCounter = 2*(interface_getProcessingDelay(hInt)/FRAME_SIZE + 1); /* enough to flush both the forward and backward transforms */
+            }
+        }
+        runFilterbank = pData->firStatus != STATIC_FIR_STATUS_ON;
+        runFIRs = pData->firStatus != STATIC_FIR_STATUS_OFF && pData->firStatus != STATIC_FIR_STATUS_DESIGN;
+
+        /* Apply proposed analysis (parameters, covariance and mixing matrices are held while the gate is closed) */
+        fused = pData->enableBandFusedProcessing;
+        *proposed_analysis_getEnableLinearOnlyPtr(pData->hAna) = linearOnly;
+        *proposed_synthesis_getEnableLinearOnlyPtr(pData->hSyn) = linearOnly;
+        *proposed_analysis_getEnableProfilingPtr(pData->hAna) = pData->enableProfiling;
+        *proposed_synthesis_getEnableProfilingPtr(pData->hSyn) = pData->enableProfiling;
+        if(pData->profileResetRequested){
+            proposed_analysis_resetProfile(pData->hAna);
+            proposed_synthesis_resetProfile(pData->hSyn);
+            interface_updateProfile(hInt); /* (clears the local copy too, even if profiling is disabled) */
+            pData->profileResetRequested = 0;
+        }
+        if(pData->gateStatus == GATE_STATUS_OPEN && runFilterbank){
+            /* Limit the analysis based on the quality tier selected by the governor (the user settings are left as they are) */
+            limits = proposed_analysis_getLimitsPtr(pData->hAna);
+            limits->maxAnalysisFreq = pData->qualityTier >= INTERFACE_QUALITY_TIER_REDUCED_BANDWIDTH ? GOVERNOR_REDUCED_ANALYSIS_FREQ : 0.0f;
+            limits->forceBandLimitedAnalysis = pData->qualityTier >= INTERFACE_QUALITY_TIER_REDUCED_BANDWIDTH;
+            limits->minUpdateInterval = pData->qualityTier == INTERFACE_QUALITY_TIER_DECIMATED ? GOVERNOR_DECIMATED_INTERVAL : 0;
+            limits->holdParameters = pData->qualityTier >= INTERFACE_QUALITY_TIER_HOLD_PARAMS;
+
+            if(fused) /* Analysis and synthesis in one go */
+                proposed_synthesis_applyFused(pData->hSyn, pData->hAna, pData->inputFrameTD, nMics, pData->hPCon, pData->hSCon,
+                                              (float*)ypr_rad, (float*)xyz_m, distMap, pData->sourceDistance, pData->enableSourceDirectivity,
+                                              NUM_EARS, FRAME_SIZE, pData->outputFrameTD);
+            else
+                proposed_analysis_apply(pData->hAna, pData->inputFrameTD, nMics, FRAME_SIZE, pData->hPCon, pData->hSCon);
+        }
+
         /* Apply proposed synthesis */
-        proposed_synthesis_apply(pData->hSyn, pData->hPCon, pData->hSCon,
-                                 (float*)ypr_rad, (float*)xyz_m, distMap, pData->sourceDistance, pData->enableSourceDirectivity,
-                                 NUM_EARS, FRAME_SIZE, pData->outputFrameTD);
+        switch(pData->gateStatus){
+            case GATE_STATUS_OPEN:
+                if(runFilterbank && !fused)
+                    proposed_synthesis_apply(pData->hSyn, pData->hPCon, pData->hSCon,
+                                             (float*)ypr_rad, (float*)xyz_m, distMap, pData->sourceDistance, pData->enableSourceDirectivity,
+                                             NUM_EARS, FRAME_SIZE, pData->outputFrameTD);
+                break;
+            case GATE_STATUS_TAIL:
+                proposed_synthesis_applyTail(pData->hSyn, NUM_EARS, FRAME_SIZE, pData->outputFrameTD);
+                if(--(pData->gateCounter) <= 0)
+                    pData->gateStatus = GATE_STATUS_IDLE;
+                break;
+            case GATE_STATUS_IDLE:
+                for(ch=0; ch<NUM_EARS; ch++)
+                    memset(pData->outputFrameTD[ch], 0, FRAME_SIZE*sizeof(float));
+                break;
+        }
+
+        /* Apply static FIRs, and crossfade between the two paths at the end of the priming/release */
+        if(runFIRs && pData->gateStatus == GATE_STATUS_OPEN){
+            proposed_synthesis_applyStaticFIRs(pData->hSyn, pData->inputFrameTD, nMics, NUM_EARS, FRAME_SIZE, pData->firFrameTD);
+            switch(pData->firStatus){
+                case STATIC_FIR_STATUS_OFF:    /* fall through */
+                case STATIC_FIR_STATUS_DESIGN: break; /* not reachable */
+                case STATIC_FIR_STATUS_ON:
+                    for(ch=0; ch<NUM_EARS; ch++)
+                        memcpy(pData->outputFrameTD[ch], pData->firFrameTD[ch], FRAME_SIZE*sizeof(float));
+                    break;
+                case STATIC_FIR_STATUS_PRIMING: /* fall through */
+                case STATIC_FIR_STATUS_RELEASE:
+                    if(--(pData->firCounter) > 0){
+                        if(pData->firStatus == STATIC_FIR_STATUS_RELEASE)
+                            for(ch=0; ch<NUM_EARS; ch++)
+                                memcpy(pData->outputFrameTD[ch], pData->firFrameTD[ch], FRAME_SIZE*sizeof(float));
+                        break;
+                    }
+                    for(ch=0; ch<NUM_EARS; ch++){
+                        for(i=0; i<FRAME_SIZE; i++){
+                            fade = (float)(i+1)/(float)FRAME_SIZE;
+                            if(pData->firStatus == STATIC_FIR_STATUS_RELEASE)
+                                fade = 1.0f - fade;
+                            pData->outputFrameTD[ch][i] = fade*pData->firFrameTD[ch][i] + (1.0f-fade)*pData->outputFrameTD[ch][i];
+                        }
+                    }
+                    pData->firStatus = pData->firStatus == STATIC_FIR_STATUS_PRIMING ? STATIC_FIR_STATUS_ON : STATIC_FIR_STATUS_OFF;
+                    break;
+            }
+        }
+        else if(pData->firStatus == STATIC_FIR_STATUS_OFF && pData->gateStatus == GATE_STATUS_OPEN){
+            /* Once the pose has been static for long enough, start converting the current (linear-only) mixing matrices into FIRs */
+            if(++(pData->poseCounter) >= (int)(STATIC_POSE_HOLD_TIME_S*pData->fs/(float)FRAME_SIZE)){
+                pData->firStatus = STATIC_FIR_STATUS_DESIGN;
+                pData->firCounter = 0;
+            }
+        }
+        else if(pData->firStatus == STATIC_FIR_STATUS_DESIGN && pData->gateStatus == GATE_STATUS_OPEN){
+            /* A few FIRs per frame, rather than all of them in one frame */
+            proposed_synthesis_computeStaticFIRs(pData->hSyn, pData->firCounter, STATIC_FIRS_PER_FRAME);
+            pData->firCounter += STATIC_FIRS_PER_FRAME;
+            if(pData->firCounter >= proposed_synthesis_getNumStaticFIRs(pData->hSyn)){
+                pData->firStatus = STATIC_FIR_STATUS_PRIMING;
+                pData->firCounter = proposed_synthesis_getStaticFIRLength(pData->hSyn)/FRAME_SIZE;
+            }
+        }
 
         /* Copy to output */
         for(ch=0; ch<SAF_MIN(NUM_EARS,nOutputs); ch++)
             memcpy(outputs[ch], pData->outputFrameTD[ch], FRAME_SIZE*sizeof(float));
         for(; ch<nOutputs; ch++)
             memset(outputs[ch], 0, FRAME_SIZE * sizeof(float)); /* fill remaining channels with zeros */
+
+        /* Only frames that are fully processed are representative of the CPU load */
+        if(pData->gateStatus == GATE_STATUS_OPEN)
+            interface_updateGovernor(hInt, interface_getTime_s()-startTime);
+        if(pData->enableProfiling)
+            interface_updateProfile(hInt);
     }
     else{
         /* output zero if one of the pre-requrisite conditions are not met */
         for(ch=0; ch<nOutputs; ch++)
-            memset(outputs[ch], 0, FRAME_SIZE*sizeof(float));
+            memset(outputs[ch], 0, nSamples*sizeof(float));
+        if(nSamples != FRAME_SIZE)
+            skipReason = INTERFACE_SKIP_FRAME_SIZE;
+        else if(!pData->MAIR_SOFA_isLoadedFLAG)
+            skipReason = INTERFACE_SKIP_NO_ARRAY_IRS;
+        else
+            skipReason = INTERFACE_SKIP_NOT_INITIALISED;
     }
+    interface_updateTelemetry(hInt, skipReason, nSamples, startTime, interface_getTime_s());
+    proposed_trace_end(skipReason == TELEMETRY_NOT_SKIPPED ? "interface_process" : "interface_process (skipped)", tProcess);
 
     pData->procStatus = PROC_STATUS_NOT_ONGOING;
+    PROPOSED_RTGUARD_LEAVE();
+}
+
+unsigned long long interface_traceBegin(void)
+{
+    return proposed_trace_begin();
+}
+
+void interface_traceEnd(const char* name, unsigned long long t0)
+{
+    proposed_trace_end(name, t0);
 }
     
 /* Set Functions */
@@ -411,6 +752,30 @@ void interface_setEnableDiffEQ_ATFs(void* const hInt, int newState)
     }
 }
 
+void interface_setEnableLazyHRTFs(void* const hInt, int newState)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    if(pData->enableLazyHRTFs!=newState){
+        pData->enableLazyHRTFs = newState;
+        interface_setCoreStatus(hInt, CORE_STATUS_NOT_INITIALISED);
+    }
+}
+
+void interface_setEnableCompressedATFs(void* const hInt, int newState)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    if(pData->enableCompressedATFs!=newState){
+        pData->enableCompressedATFs = newState;
+        interface_setCoreStatus(hInt, CORE_STATUS_NOT_INITIALISED);
+    }
+}
+
+void interface_setMaxInitThreads(void* const hInt, int newValue)
+{
+    (void)hInt;
+    proposed_setMaxInitThreads(newValue);
+}
+
 void interface_setDOFoption(void* const hInt, INTERFACE_DOF_OPTIONS newOption)
 {
     interface_data *pData = (interface_data*)(hInt);
@@ -441,12 +806,49 @@ void interface_setMaximumAnalysisFreq(void* const hInt, float newValue)
     *proposed_analysis_getMaxAnalysisFreqPtr(pData->hAna) = newValue;
 }
  
+void interface_setEnableBandLimitedAnalysis(void* const hInt, int newState)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    if(pData->hAna==NULL)
+        return;
+    *proposed_analysis_getEnableBandLimitedAnalysisPtr(pData->hAna) = newState;
+}
+
+void interface_setAnalysisUpdateSchedule(void* const hInt, INTERFACE_ANALYSIS_UPDATE_SCHEDULES newSchedule)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    if(pData->hAna==NULL)
+        return;
+    switch(newSchedule){
+        case INTERFACE_ANALYSIS_UPDATE_ALL_BANDS:   *proposed_analysis_getUpdateSchedulePtr(pData->hAna) = PROPOSED_ANALYSIS_UPDATE_ALL_BANDS; break;
+        case INTERFACE_ANALYSIS_UPDATE_DECIMATED:   *proposed_analysis_getUpdateSchedulePtr(pData->hAna) = PROPOSED_ANALYSIS_UPDATE_DECIMATED; break;
+        case INTERFACE_ANALYSIS_UPDATE_ROUND_ROBIN: *proposed_analysis_getUpdateSchedulePtr(pData->hAna) = PROPOSED_ANALYSIS_UPDATE_ROUND_ROBIN; break;
+    }
+}
+
+void interface_setAnalysisUpdateInterval(void* const hInt, int newValue)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    if(pData->hAna==NULL)
+        return;
+    *proposed_analysis_getUpdateIntervalPtr(pData->hAna) = SAF_MAX(newValue, 1);
+}
+
+void interface_setAnalysisDecimationFreq(void* const hInt, float newValue)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    if(pData->hAna==NULL)
+        return;
+    *proposed_analysis_getDecimationFreqPtr(pData->hAna) = SAF_MAX(newValue, 0.0f);
+}
+
 void interface_setMaximumBSMFreq(void* const hInt, float newValue)
 {
     interface_data *pData = (interface_data*)(hInt);
     if(pData->hSyn==NULL)
         return;
     *proposed_synthesis_getMaxBSMFreqPtr(pData->hSyn) = newValue;
+    pData->staticFIRsInvalid = 1;
 }
     
 void interface_setMaximumMagLSFreq(void* const hInt, float newValue)
@@ -455,6 +857,7 @@ void interface_setMaximumMagLSFreq(void* const hInt, float newValue)
     if(pData->hSyn==NULL)
         return;
     *proposed_synthesis_getMaxMagLSFreqPtr(pData->hSyn) = newValue;
+    pData->staticFIRsInvalid = 1;
 }
 
 void interface_setLinear2ParametricBalance(void* const hInt, float newValue)
@@ -587,6 +990,92 @@ void interface_setEnableSourceDirectivity(void* const hInt, int newState)
     pData->enableSourceDirectivity = newState;
 }
 
+void interface_setEnableSilenceGate(void* const hInt, int newState)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    pData->enableSilenceGate = newState;
+}
+
+void interface_setSilenceGateThreshold(void* const hInt, float newValue_dB)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    pData->silenceGateThreshold_dB = newValue_dB;
+}
+
+void interface_setSilenceGateHoldTime(void* const hInt, float newValue_s)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    pData->silenceGateHold_s = SAF_MAX(newValue_s, 0.0f);
+}
+
+void interface_setEnableLinearOnly(void* const hInt, int newState)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    pData->enableLinearOnly = newState;
+}
+
+void interface_setEnableBandFusedProcessing(void* const hInt, int newState)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    pData->enableBandFusedProcessing = newState;
+}
+
+void interface_setEnableStaticPoseFIRs(void* const hInt, int newState)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    pData->enableStaticPoseFIRs = newState;
+}
+
+void interface_setEnableCpuGovernor(void* const hInt, int newState)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    pData->enableCpuGovernor = newState;
+}
+
+void interface_setCpuBudget(void* const hInt, float newValue)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    pData->cpuBudget = SAF_CLAMP(newValue, 0.05f, 1.0f);
+}
+
+void interface_setEnableProfiling(void* const hInt, int newState)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    pData->enableProfiling = newState;
+}
+
+void interface_resetProfile(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    pData->profileResetRequested = 1; /* applied by the processing thread, which is the only writer */
+}
+
+void interface_resetTelemetry(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    pData->telemetryResetRequested = 1; /* applied by the processing thread, which is the only writer */
+}
+
+void interface_setEnableTracing(int newState)
+{
+    proposed_trace_setEnabled(newState);
+}
+
+void interface_setTraceThreadName(const char* name)
+{
+    proposed_trace_setThreadName(name);
+}
+
+void interface_releaseTraceThread(void)
+{
+    proposed_trace_releaseThread();
+}
+
+void interface_resetTrace(void)
+{
+    proposed_trace_reset();
+}
+
 void interface_setX(void  * const hInt, float newX)
 {
     interface_data *pData = (interface_data*)(hInt);
@@ -680,6 +1169,24 @@ int interface_getEnableDiffEQ_ATFs(void* const hInt)
     interface_data *pData = (interface_data*)(hInt);
     return pData->enableDiffEQ_ATFs;
 }
+
+int interface_getEnableLazyHRTFs(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->enableLazyHRTFs;
+}
+
+int interface_getEnableCompressedATFs(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->enableCompressedATFs;
+}
+
+int interface_getMaxInitThreads(void* const hInt)
+{
+    (void)hInt;
+    return proposed_getMaxInitThreads();
+}
     
 INTERFACE_DOF_OPTIONS interface_getDOFoption(void* const hInt)
 {
@@ -705,6 +1212,37 @@ float interface_getMaximumAnalysisFreq(void* const hInt)
     return pData->hAna==NULL ? 5000.0f : *proposed_analysis_getMaxAnalysisFreqPtr(pData->hAna);
 }
  
+int interface_getEnableBandLimitedAnalysis(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->hAna==NULL ? 1 : *proposed_analysis_getEnableBandLimitedAnalysisPtr(pData->hAna);
+}
+
+INTERFACE_ANALYSIS_UPDATE_SCHEDULES interface_getAnalysisUpdateSchedule(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    if(pData->hAna==NULL)
+        return INTERFACE_ANALYSIS_UPDATE_ALL_BANDS;
+    switch(*proposed_analysis_getUpdateSchedulePtr(pData->hAna)){
+        default: /* fall through */
+        case PROPOSED_ANALYSIS_UPDATE_ALL_BANDS:   return INTERFACE_ANALYSIS_UPDATE_ALL_BANDS;
+        case PROPOSED_ANALYSIS_UPDATE_DECIMATED:   return INTERFACE_ANALYSIS_UPDATE_DECIMATED;
+        case PROPOSED_ANALYSIS_UPDATE_ROUND_ROBIN: return INTERFACE_ANALYSIS_UPDATE_ROUND_ROBIN;
+    }
+}
+
+int interface_getAnalysisUpdateInterval(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->hAna==NULL ? 2 : *proposed_analysis_getUpdateIntervalPtr(pData->hAna);
+}
+
+float interface_getAnalysisDecimationFreq(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->hAna==NULL ? 1.5e3f : *proposed_analysis_getDecimationFreqPtr(pData->hAna);
+}
+
 float interface_getMaximumBSMFreq(void* const hInt)
 {
     interface_data *pData = (interface_data*)(hInt);
@@ -907,6 +1445,151 @@ int interface_getEnableSourceDirectivity(void* const hInt)
     return pData->enableSourceDirectivity;
 }
 
+int interface_getEnableSilenceGate(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->enableSilenceGate;
+}
+
+float interface_getSilenceGateThreshold(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->silenceGateThreshold_dB;
+}
+
+float interface_getSilenceGateHoldTime(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->silenceGateHold_s;
+}
+
+int interface_getSilenceGateIsClosed(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->gateStatus != GATE_STATUS_OPEN;
+}
+
+int interface_getEnableLinearOnly(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->enableLinearOnly;
+}
+
+int interface_getEnableBandFusedProcessing(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->enableBandFusedProcessing;
+}
+
+int interface_getEnableStaticPoseFIRs(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->enableStaticPoseFIRs;
+}
+
+int interface_getStaticPoseFIRsActive(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->firStatus == STATIC_FIR_STATUS_ON || pData->firStatus == STATIC_FIR_STATUS_RELEASE;
+}
+
+int interface_getEnableCpuGovernor(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->enableCpuGovernor;
+}
+
+float interface_getCpuBudget(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->cpuBudget;
+}
+
+INTERFACE_QUALITY_TIERS interface_getQualityTier(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->qualityTier;
+}
+
+float interface_getCpuLoad(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->cpuLoad;
+}
+
+int interface_getEnableProfiling(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return pData->enableProfiling;
+}
+
+void interface_getProfile(void* const hInt, interface_profile_stats* stats)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    proposed_profile_counters counters;
+    proposed_profile profile;
+    const proposed_profile_stats* local;
+    unsigned int seq;
+    int i;
+
+    /* Lock-free read; retry if interface_process() updated the counters while they were being copied */
+    do {
+        seq = pData->profileSeq;
+        interface_memoryBarrier();
+        memcpy(&counters, &(pData->profile_local), sizeof(proposed_profile_counters));
+        interface_memoryBarrier();
+    } while ((seq & 1) || seq != pData->profileSeq);
+    proposed_profile_getStats(&counters, &profile);
+    for(i=0; i<INTERFACE_NUM_PROFILE_STAGES; i++){
+        local = &(profile.stage[i]);
+        stats[i].last_ms = local->last_ms;
+        stats[i].mean_ms = local->mean_ms;
+        stats[i].p99_ms = local->p99_ms;
+        stats[i].max_ms = local->max_ms;
+        stats[i].count = local->count;
+    }
+}
+
+const char* interface_getProfileStageName(INTERFACE_PROFILE_STAGES stage)
+{
+    return proposed_profile_getStageName((PROPOSED_PROFILE_STAGES)stage);
+}
+
+void interface_getTelemetry(void* const hInt, interface_telemetry* telemetry)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    unsigned int seq;
+
+    /* Lock-free read; retry if interface_process() updated the telemetry while it was being copied */
+    do {
+        seq = pData->telemetrySeq;
+        interface_memoryBarrier();
+        memcpy(telemetry, &(pData->telemetry), sizeof(interface_telemetry));
+        interface_memoryBarrier();
+    } while ((seq & 1) || seq != pData->telemetrySeq);
+    telemetry->time_s = interface_getTime_s();
+}
+
+const char* interface_getSkipReasonName(INTERFACE_SKIP_REASONS reason)
+{
+    switch(reason){
+        case INTERFACE_SKIP_FRAME_SIZE:      return "Unsupported block size";
+        case INTERFACE_SKIP_NO_ARRAY_IRS:    return "No array IRs loaded";
+        case INTERFACE_SKIP_NOT_INITIALISED: return "Core not initialised";
+    }
+    return "";
+}
+
+int interface_getEnableTracing(void)
+{
+    return proposed_trace_isEnabled();
+}
+
+int interface_dumpTrace(const char* path)
+{
+    return proposed_trace_dump(path);
+}
+
 float interface_getYaw(void* const hInt)
 {
     interface_data *pData = (interface_data*)(hInt);
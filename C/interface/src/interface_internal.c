@@ -10,17 +10,162 @@
  * @date 10th August 2022
  */
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+# define _POSIX_C_SOURCE 199309L /* for clock_gettime() */
+#endif
 #include "interface.h"
 #include "interface_internal.h"
+#ifdef _WIN32
+# include <windows.h>
+# define INTERFACE_ATOMIC_INCREMENT(x) ( InterlockedIncrement((x)) )
+# define INTERFACE_ATOMIC_LOAD(x) ( InterlockedCompareExchange((x), 0, 0) )
+#else
+# include <time.h>
+# define INTERFACE_ATOMIC_INCREMENT(x) ( __sync_add_and_fetch((x), 1) )
+# define INTERFACE_ATOMIC_LOAD(x) ( __sync_fetch_and_add((x), 0) )
+#endif
 
 void interface_setCoreStatus(void* const hInt, INTERFACE_CORE_STATUS newStatus)
 {
     interface_data *pData = (interface_data*)(hInt);
     if(newStatus==CORE_STATUS_NOT_INITIALISED){
-        /* Pause until current initialisation is complete */
-        while(pData->coreStatus == CORE_STATUS_INITIALISING)
-            SAF_SLEEP(10);
+        /* The configuration has changed. If an initialisation is ongoing, then it is cancelled at its next checkpoint
+         * and flags the core as not initialised itself, so that all changes made in the meantime are picked up by a
+         * single re-initialisation (rather than waiting here for it to complete, and then starting another one) */
+        interface_requestInit(hInt);
+        if(pData->coreStatus == CORE_STATUS_INITIALISING)
+            return;
     }
     pData->coreStatus = newStatus;
 }
 
+void interface_requestInit(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    INTERFACE_ATOMIC_INCREMENT(&(pData->initRequest)); /* (may be called from any thread, e.g. the GUI and the host) */
+}
+
+long interface_getInitRequest(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    return INTERFACE_ATOMIC_LOAD(&(pData->initRequest));
+}
+
+int interface_isInitCancelled(void* const hInt, long initRequest)
+{
+    return interface_getInitRequest(hInt) != initRequest;
+}
+
+double interface_getTime_s(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart/(double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+#endif
+}
+
+void interface_updateGovernor(void* const hInt, double elapsed_s)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    float load, budget;
+    int nRecoverFrames;
+
+    /* Processing time relative to the frame duration */
+    load = (float)(elapsed_s*(double)pData->fs/(double)FRAME_SIZE);
+    pData->cpuLoad = GOVERNOR_LOAD_AVG_COEFF*pData->cpuLoad + (1.0f-GOVERNOR_LOAD_AVG_COEFF)*load;
+    if(!pData->enableCpuGovernor){
+        pData->qualityTier = INTERFACE_QUALITY_TIER_FULL;
+        pData->governorCounter = 0;
+        return;
+    }
+
+    /* Step down quickly when over budget, but only step back up once the load has remained well under budget for a while */
+    budget = pData->cpuBudget;
+    nRecoverFrames = (int)(GOVERNOR_RECOVER_TIME_S*pData->fs/(float)FRAME_SIZE);
+    if(pData->cpuLoad > budget)
+        pData->governorCounter = SAF_MAX(pData->governorCounter, 0) + 1;
+    else if(pData->cpuLoad < GOVERNOR_RECOVER_RATIO*budget)
+        pData->governorCounter = SAF_MIN(pData->governorCounter, 0) - 1;
+    else
+        pData->governorCounter = 0;
+    if(pData->governorCounter >= GOVERNOR_DEGRADE_FRAMES && pData->qualityTier < INTERFACE_NUM_QUALITY_TIERS){
+        pData->qualityTier++;
+        pData->governorCounter = 0;
+    }
+    else if(pData->governorCounter <= -nRecoverFrames && pData->qualityTier > INTERFACE_QUALITY_TIER_FULL){
+        pData->qualityTier--;
+        pData->governorCounter = 0;
+    }
+}
+
+void interface_updateTelemetry(void* const hInt, int skipReason, int nSamples, double startTime_s, double endTime_s)
+{
+    interface_data *pData = (interface_data*)(hInt);
+    interface_telemetry* t = &(pData->telemetry);
+    float duration_s, load, alpha;
+    int i;
+
+    /* Readers take their snapshot again if the counter was odd, or has changed, in the meantime (see interface_getTelemetry()) */
+    pData->telemetrySeq++;
+    interface_memoryBarrier();
+    if(pData->telemetryResetRequested){
+        memset(t, 0, sizeof(interface_telemetry));
+        for(i=0; i<INTERFACE_NUM_SKIP_REASONS; i++)
+            t->lastSkipTime_s[i] = -1.0;
+        t->lastOverrunTime_s = -1.0;
+        pData->telemetryResetRequested = 0;
+    }
+    if(skipReason == TELEMETRY_NOT_SKIPPED)
+        t->nProcessed++;
+    else{
+        t->nSkipped[skipReason]++;
+        t->lastSkipTime_s[skipReason] = endTime_s;
+    }
+
+    /* Time taken, relative to the real-time budget of the block */
+    duration_s = pData->fs > 0.0f ? (float)nSamples/pData->fs : 0.0f;
+    load = duration_s > 0.0f ? (float)(endTime_s-startTime_s)/duration_s : 0.0f;
+    if(load > 1.0f){
+        t->nOverruns++;
+        t->lastOverrunTime_s = endTime_s;
+    }
+    t->worstBlockTime_ms = SAF_MAX(t->worstBlockTime_ms, (float)(endTime_s-startTime_s)*1e3f);
+    t->worstBlockLoad = SAF_MAX(t->worstBlockLoad, load);
+    if(skipReason == TELEMETRY_NOT_SKIPPED){ /* (skipped blocks cost next to nothing, and would dilute the average) */
+        alpha = duration_s > 0.0f ? expf(-duration_s/TELEMETRY_LOAD_WINDOW_S) : 1.0f;
+        t->meanLoad = alpha*(t->meanLoad) + (1.0f-alpha)*load;
+    }
+
+    interface_memoryBarrier();
+    pData->telemetrySeq++;
+}
+
+void interface_memoryBarrier(void)
+{
+#ifdef _WIN32
+    MemoryBarrier();
+#else
+    __sync_synchronize();
+#endif
+}
+
+void interface_updateProfile(void* const hInt)
+{
+    interface_data *pData = (interface_data*)(hInt);
+
+    /* Each stage is timed by either the analyser or the synthesiser; only the raw counters are copied here, and the
+     * statistics are computed by interface_getProfile(), off the processing thread. As for the telemetry, readers take
+     * their copy again if the counter was odd, or has changed, in the meantime */
+    pData->profileSeq++;
+    interface_memoryBarrier();
+    proposed_analysis_getProfileCounters(pData->hAna, &(pData->profile_local));
+    proposed_synthesis_getProfileCounters(pData->hSyn, &(pData->profile_local));
+    interface_memoryBarrier();
+    pData->profileSeq++;
+}
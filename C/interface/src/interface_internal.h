@@ -41,6 +41,30 @@ typedef enum {
                               *   be reinitialised if needed. */
 }PROC_STATUS;
 
+/** Current status of the silence gate */
+typedef enum {
+    GATE_STATUS_OPEN = 0, /**< Input is active; analysis and synthesis run */
+    GATE_STATUS_TAIL,     /**< Input is silent; only the synthesis filterbank
+                           *   tail is being output */
+    GATE_STATUS_IDLE      /**< Input is silent and the tail has been output;
+                           *   nothing is processed */
+}GATE_STATUS;
+
+/** Current status of the static-pose FIR rendering */
+typedef enum {
+    STATIC_FIR_STATUS_OFF = 0, /**< Rendering with the filterbank */
+    STATIC_FIR_STATUS_DESIGN,  /**< Pose is static; the FIRs are being computed,
+                                *   a few per frame, while still rendering with
+                                *   the filterbank */
+    STATIC_FIR_STATUS_PRIMING, /**< Pose is static; the FIRs have been computed
+                                *   and the convolution is being primed, while
+                                *   still rendering with the filterbank */
+    STATIC_FIR_STATUS_ON,      /**< Rendering with the static FIRs */
+    STATIC_FIR_STATUS_RELEASE  /**< Pose has changed; the filterbank is being
+                                *   primed, while still rendering with the
+                                *   static FIRs */
+}STATIC_FIR_STATUS;
+
 
 /* ========================================================================== */
 /*                            Internal Parameters                             */
@@ -53,7 +77,20 @@ typedef enum {
 #define HOP_SIZE ( 128 )
 #if (FRAME_SIZE % HOP_SIZE != 0)
 # error "FRAME_SIZE must be an integer multiple of HOP_SIZE"
-#endif 
+#endif
+/* #INTERFACE_PROFILE_STAGES must mirror #PROPOSED_PROFILE_STAGES (fails to compile otherwise) */
+typedef char interface_profileStagesMatch[(INTERFACE_NUM_PROFILE_STAGES == PROPOSED_PROFILE_NUM_STAGES) ? 1 : -1]; 
+#define SILENCE_GATE_HYSTERESIS_DB ( 6.0f ) /* Input must exceed the threshold by this much to re-open the gate */
+#define GOVERNOR_LOAD_AVG_COEFF ( 0.9f )    /* Temporal averaging coefficient for the measured CPU load */
+#define GOVERNOR_DEGRADE_FRAMES ( 8 )       /* Number of frames over budget before stepping down a quality tier */
+#define GOVERNOR_RECOVER_TIME_S ( 2.0f )    /* Time spent well under budget before stepping up a quality tier */
+#define GOVERNOR_RECOVER_RATIO ( 0.5f )     /* Load must fall below this fraction of the budget to step up (hysteresis) */
+#define GOVERNOR_REDUCED_ANALYSIS_FREQ ( 3e3f ) /* Maximum analysis frequency, in Hz, for the reduced bandwidth tier */
+#define GOVERNOR_DECIMATED_INTERVAL ( 4 )   /* Round-robin update interval for the decimated tier */
+#define STATIC_POSE_HOLD_TIME_S ( 0.5f )    /* Time the pose must remain unchanged before switching to the static FIRs */
+#define STATIC_FIRS_PER_FRAME ( 4 )         /* Number of static FIRs computed per frame, to spread their cost over several frames */
+#define TELEMETRY_LOAD_WINDOW_S ( 1.0f )    /* Time constant of the mean load reported by interface_getTelemetry() */
+#define TELEMETRY_NOT_SKIPPED ( -1 )        /* Passed to interface_updateTelemetry() for blocks that were processed */
 
 /* ========================================================================== */
 /*                                 Structures                                 */
@@ -73,10 +110,22 @@ typedef struct _interface {
     proposed_param_container_handle hPCon;   /**< Parameter Container handle */
     proposed_signal_container_handle hSCon;  /**< Signal Container handle */
     INTERFACE_CORE_STATUS coreStatus;        /**< see #INTERFACE_CORE_STATUS */
+    volatile long initRequest;               /**< Incremented whenever the configuration changes; only accessed via interface_requestInit() and interface_getInitRequest() */
     float progressBar0_1;                    /**< Progress bar value [0..1] */
     char* progressBarText;                   /**< Progress bar text; INTERFACE_PROGRESSBARTEXT_CHAR_LENGTH x 1*/
     PROC_STATUS procStatus;                  /**< see #_PROC_STATUS */
+    GATE_STATUS gateStatus;                  /**< see #GATE_STATUS */
+    int gateCounter;                         /**< Number of silent frames so far (when open), or number of tail frames remaining (when outputting the tail) */
     float head_orientation_xyz[3];           /**< Head orientation as unit length Cartesian vector */
+    INTERFACE_QUALITY_TIERS qualityTier;     /**< Quality tier currently selected by the governor; see #INTERFACE_QUALITY_TIERS */
+    float cpuLoad;                           /**< Smoothed processing time per fully processed frame, as a fraction of the frame duration (for the governor; see interface_getCpuLoad()) */
+    int governorCounter;                     /**< Number of consecutive frames over budget (>0) or well under budget (<0) */
+    STATIC_FIR_STATUS firStatus;             /**< see #STATIC_FIR_STATUS */
+    int firCounter;                          /**< Index of the next FIR to compute (design), or number of frames remaining until the end of the priming/release */
+    int poseCounter;                         /**< Number of frames rendered with the filterbank using the current pose */
+    int staticFIRsInvalid;                   /**< Flag, 1: settings affecting the linear decoder have changed, so the current static FIRs are invalid */
+    float prevPose[7];                       /**< Pose used for the previous frame; yaw, pitch, roll, x, y, z, source distance */
+    float** firFrameTD;                      /**< Output frame of the static FIR rendering; #NUM_EARS x FRAME_SIZE */
 
     /* Local copy of internal parameter vectors (for optional thread-safe GUI plotting) */
     int nBands_local;                        /**< Number of bands used for plotting */
@@ -85,6 +134,14 @@ typedef struct _interface {
     float* streamBalBands_local;             /**< Local stream balance vector; nBands_local x 1 */
     float* grid_dirs_xyz_local;              /**< Local grid directions in Cartesian coords; nDirs_local x 1 */
     float* histogram_local;                  /**< Local histogram; nDirs_local x 1 */
+    proposed_profile_counters profile_local; /**< Local copy of the raw stage timings of the analyser and synthesiser (written by interface_process() only; see interface_getProfile()) */
+    volatile unsigned int profileSeq;        /**< Sequence counter of profile_local; odd while it is being updated */
+    volatile int profileResetRequested;      /**< Flag, 1: clear the stage timings before processing the next frame */
+
+    /* Block timing telemetry (written by interface_process() only; see interface_getTelemetry()) */
+    interface_telemetry telemetry;           /**< Current telemetry (time_s is unused) */
+    volatile unsigned int telemetrySeq;      /**< Sequence counter of the telemetry; odd while it is being updated */
+    int telemetryResetRequested;             /**< Flag, 1: clear the telemetry after the next block */
 
     /* IR data */
     int nMics;                               /**< Number of microphones/hydrophones in the array */
@@ -97,6 +154,8 @@ typedef struct _interface {
     int enableEPbeamformers;
     int enableDiffEQ_HRTFs;
     int enableDiffEQ_ATFs;
+    int enableLazyHRTFs;                     /**< 1: HRTFs are interpolated upon first use, 0: for the whole grid during initialisation */
+    int enableCompressedATFs;                /**< 1: array ATFs are stored as spherical harmonic coefficients per band, 0: for every grid direction */
     INTERFACE_DOF_OPTIONS renderingMode;     /**< See #INTERFACE_DOF_OPTIONS */
     proposed_binaural_config binConfig;      /**< Binaural configuration settings */
     char* sofa_filepath_MAIR;                /**< microphone array IRs; absolute/relative file path for a sofa file */
@@ -111,6 +170,15 @@ typedef struct _interface {
     INTERFACE_DISTANCE_MAPS distMapOption;   /**< see #INTERFACE_DISTANCE_MAPS */
     float sourceDistance;                    /**< Source distance in metres */
     int enableSourceDirectivity;             /**< Flag, 0: disabled, 1: enabled */
+    int enableSilenceGate;                   /**< Flag, 1: bypass the analysis and synthesis while the input is silent, 0: always process */
+    float silenceGateThreshold_dB;           /**< Input level, in dBFS, below which the input is considered silent */
+    float silenceGateHold_s;                 /**< Time the input must remain silent before the gate closes, in seconds */
+    int enableLinearOnly;                    /**< Flag, 1: linear-only rendering, 0: linear + parametric rendering */
+    int enableBandFusedProcessing;           /**< Flag, 1: analysis and synthesis in a single pass over the bands, 0: one pass per processing stage */
+    int enableStaticPoseFIRs;                /**< Flag, 1: render using static FIRs while the pose is unchanged (linear-only rendering only), 0: always use the filterbank */
+    int enableCpuGovernor;                   /**< Flag, 1: degrade the quality tier when over the CPU budget, 0: always full quality */
+    float cpuBudget;                         /**< CPU budget, as a fraction of the frame duration */
+    int enableProfiling;                     /**< Flag, 1: time the processing stages, 0: do not */
     float x;                                 /**< x coordinate, in metres */
     float y;                                 /**< y coordinate, in metres */
     float z;                                 /**< z coordinate, in metres */
@@ -134,6 +202,79 @@ typedef struct _interface {
 void interface_setCoreStatus(void* const hInt,
                              INTERFACE_CORE_STATUS newStatus);
 
+/**
+ * Atomically increments initRequest, which cancels an ongoing initialisation at
+ * its next checkpoint (see interface_isInitCancelled())
+ *
+ * @param[in] hInt interface handle
+ */
+void interface_requestInit(void* const hInt);
+
+/** Atomically reads initRequest, e.g. when an initialisation is started */
+long interface_getInitRequest(void* const hInt);
+
+/**
+ * Returns 1 if the configuration has changed since an initialisation was
+ * started, in which case it should be abandoned at this checkpoint; 0 otherwise
+ *
+ * @param[in] hInt        interface handle
+ * @param[in] initRequest Value of initRequest when the initialisation started
+ *                        (see interface_getInitRequest())
+ */
+int interface_isInitCancelled(void* const hInt,
+                              long initRequest);
+
+/** Returns the current value of a monotonic wall-clock, in seconds */
+double interface_getTime_s(void);
+
+/**
+ * Updates the CPU-budget governor with the time taken to process the current
+ * frame, and steps the quality tier up or down accordingly
+ *
+ * @param[in] hInt      interface handle
+ * @param[in] elapsed_s Time taken to process the current frame, in seconds
+ */
+void interface_updateGovernor(void* const hInt,
+                              double elapsed_s);
+
+/**
+ * Adds a block to the telemetry (see interface_getTelemetry())
+ *
+ * Only interface_process() may call this, as readers rely on there being a
+ * single writer.
+ *
+ * @param[in] hInt        interface handle
+ * @param[in] skipReason  Reason for which the block was output as silence
+ *                        (see #INTERFACE_SKIP_REASONS), or
+ *                        TELEMETRY_NOT_SKIPPED if it was processed
+ * @param[in] nSamples    Number of samples in the block
+ * @param[in] startTime_s Time at which interface_process() was called
+ * @param[in] endTime_s   Time at which it returned
+ */
+void interface_updateTelemetry(void* const hInt,
+                               int skipReason,
+                               int nSamples,
+                               double startTime_s,
+                               double endTime_s);
+
+/**
+ * Full memory barrier (also preventing the compiler from reordering memory
+ * accesses across it); used for the sequence counters of the telemetry and
+ * profile
+ */
+void interface_memoryBarrier(void);
+
+/**
+ * Copies the raw stage timings of the analyser and synthesiser into the local
+ * copy, from which interface_getProfile() computes the statistics
+ *
+ * Only interface_process() may call this, as readers rely on there being a
+ * single writer.
+ *
+ * @param[in] hInt interface handle
+ */
+void interface_updateProfile(void* const hInt);
+
 
 #ifdef __cplusplus
 } /* extern "C" */
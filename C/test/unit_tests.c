@@ -14,6 +14,8 @@
  */
 
 #include "unit_tests.h"
+#include "proposed_internal.h" /* internal kernels, which are also tested (C only, so not included via unit_tests.h) */
+#include "interface_internal.h" /* internal state of the interface, which is also checked */
 
 static tick_t start;      /**< Start time for whole test program */
 static tick_t start_test; /**< Start time for the current unit test */
@@ -52,6 +54,19 @@ int main_test(void) {
 
     /* SAF utilities modules unit tests */
     RUN_TEST(test__proposed_method);
+    RUN_TEST(test__proposed_rtSafety);
+    RUN_TEST(test__proposed_trace);
+    RUN_TEST(test__proposed_fusedProcessing);
+    RUN_TEST(test__proposed_mixKernels);
+    RUN_TEST(test__proposed_smallMatKernels);
+    RUN_TEST(test__proposed_bundle);
+    RUN_TEST(test__proposed_initThreads);
+    RUN_TEST(test__proposed_quadratureWeights);
+    RUN_TEST(test__proposed_silenceGate);
+    RUN_TEST(test__proposed_governor);
+    RUN_TEST(test__proposed_linearOnly);
+    RUN_TEST(test__proposed_staticFIRs);
+    RUN_TEST(test__proposed_atfSH);
     
     /* close */
     timer_lib_shutdown();
@@ -95,7 +110,7 @@ void test__proposed_method(void){
     array_dirs_deg = malloc1d(nDirs*2*sizeof(float));
     cblas_scopy(nDirs, sofa.SourcePosition, 3, array_dirs_deg, 2);         /* azi */
     cblas_scopy(nDirs, &sofa.SourcePosition[1], 3, &array_dirs_deg[1], 2); /* elev */
-    proposed_analysis_create(&hAna, (float)fs, hopsize, blocksize, sofa.DataIR, array_dirs_deg, nDirs, nMics, sofa.DataLengthIR);
+    proposed_analysis_create(&hAna, (float)fs, hopsize, blocksize, sofa.DataIR, array_dirs_deg, nDirs, nMics, sofa.DataLengthIR, 0.0f);
     saf_sofa_close(&sofa);
 
     /* Synthesis */
@@ -156,3 +171,1409 @@ void test__proposed_method(void){
     free(outSigBIN_block);
     free(outSigBIN);
 }
+
+/**
+ * Checks that the processing functions neither allocate nor lock. This
+ * requires the core to be built with the real-time safety guard (CMake option
+ * PROPOSED_ENABLE_RT_GUARD=ON), and is skipped otherwise.
+ *
+ * Random IRs are used for the array (on a 21st degree t-design), and the
+ * default HRIRs for the synthesis, so that this does not depend on any SOFA
+ * files. Every code path that changes between blocks is exercised: separate
+ * and fused processing, a moving listener, lazily interpolated HRTFs (nearest
+ * and triangular), and the analysis limits of each quality tier.
+ *
+ * The same is then done through interface_process(), with the model loaded from
+ * a bundle of the objects above. Internal state of the interface is set and
+ * checked, so that each of its modes is reached regardless of the speed of the
+ * machine: the CPU governor stepping down to linear-only, the static-pose FIRs
+ * (designed, primed, used and released), the silence gate (tail and idle), and
+ * tracing, whose ring buffer is claimed by this thread inside interface_process().
+ *
+ * Not covered: interface_initCore() (which may allocate, and does not run on the
+ * audio thread), and the first access of a thread to thread-local storage in a
+ * dynamically loaded library (e.g. the plug-in), which the dynamic linker may
+ * allocate lazily; the test program links the core statically.
+ */
+void test__proposed_rtSafety(void){
+    proposed_analysis_handle hAna = NULL;
+    proposed_synthesis_handle hSyn = NULL, hSynLazy = NULL, hSynTriLazy = NULL;
+    proposed_param_container_handle hPCon = NULL;
+    proposed_signal_container_handle hSCon = NULL;
+    proposed_analysis_limits* limits;
+    proposed_binaural_config binConfig;
+    interface_data* pData;
+    void* hInt = NULL;
+    int i, nDirs, moving, silent, reachedFIRs, reachedRelease, reachedIdle;
+    float *h_array, *array_dirs_deg;
+    float** inSig, **outSig;
+    float ypr_rad[3] = {0.0f};
+    float xyz_m[3] = {0.0f};
+    void* tmp;
+    const char* path = "proposed_rtSafety_test.bin";
+
+    /* Config */
+    const int fs = 48000;
+    const int nMics = 4;
+    const int h_len = 256;
+    const int hopsize = 128;
+    const int blocksize = 256;
+    const int nBlocks = 200;
+    const int nGovernorBlocks = 6*GOVERNOR_DEGRADE_FRAMES;                       /* over budget, stepping down every GOVERNOR_DEGRADE_FRAMES */
+    const int nStaticBlocks = 2*(int)(STATIC_POSE_HOLD_TIME_S*fs/FRAME_SIZE);   /* hold time, then designing and priming the FIRs */
+    const int nReleaseBlocks = 40;                                              /* releasing the FIRs */
+    const int nSilentBlocks = 2*(int)(0.5f*fs/FRAME_SIZE) + 20;                 /* hold time of the gate, then the tail */
+    const int nInterfaceBlocks = nGovernorBlocks + nStaticBlocks + nReleaseBlocks + nSilentBlocks + 10;
+
+    if(!proposed_rtguard_isSupported())
+        TEST_IGNORE_MESSAGE("Requires the real-time safety guard (PROPOSED_ENABLE_RT_GUARD=ON, Linux)");
+
+    /* Check that the guard itself detects allocations */
+    proposed_rtguard_reset();
+    proposed_rtguard_enter("test__proposed_rtSafety");
+    tmp = malloc1d(16);
+    proposed_rtguard_leave();
+    free(tmp);
+    TEST_ASSERT_TRUE(proposed_rtguard_getNumViolations()>0);
+    proposed_rtguard_reset();
+
+    /* Analysis, synthesis and containers */
+    nDirs = __Tdesign_degree_21_nPoints;
+    array_dirs_deg = malloc1d(nDirs*2*sizeof(float));
+    memcpy(array_dirs_deg, __Tdesign_degree_21_dirs_deg, nDirs*2*sizeof(float));
+    h_array = malloc1d(nDirs*nMics*h_len*sizeof(float));
+    rand_m1_1(h_array, nDirs*nMics*h_len);
+    proposed_analysis_create(&hAna, (float)fs, hopsize, blocksize, h_array, array_dirs_deg, nDirs, nMics, h_len, 0.0f);
+    binConfig.hrir_fs = __default_hrir_fs;
+    binConfig.lHRIR = __default_hrir_len;
+    binConfig.nHRIR = __default_N_hrir_dirs;
+    binConfig.hrirs = (float*)__default_hrirs;
+    binConfig.hrir_dirs_deg = (float*)__default_hrir_dirs_deg;
+    proposed_synthesis_create(&hSyn, hAna, &binConfig, PROPOSED_HRTF_INTERP_NEAREST, 0, 1, 1, 0);
+    proposed_synthesis_create(&hSynLazy, hAna, &binConfig, PROPOSED_HRTF_INTERP_NEAREST_LAZY, 0, 1, 1, 0);
+    proposed_synthesis_create(&hSynTriLazy, hAna, &binConfig, PROPOSED_HRTF_INTERP_TRIANGULAR_LAZY, 0, 1, 1, 0);
+    proposed_param_container_create(&hPCon, hAna);
+    proposed_signal_container_create(&hSCon, hAna);
+    inSig = (float**)malloc2d(nMics, blocksize, sizeof(float));
+    outSig = (float**)malloc2d(NUM_EARS, blocksize, sizeof(float));
+
+    /* Main loop */
+    for(i=0; i<nBlocks; i++){
+        rand_m1_1(FLATTEN2D(inSig), nMics*blocksize);
+        ypr_rad[0] = 2.0f*SAF_PI*(float)i/(float)nBlocks;
+        xyz_m[0] = 0.5f*sinf(ypr_rad[0]);
+
+        /* Analysis limits of the quality tiers, in turn */
+        limits = proposed_analysis_getLimitsPtr(hAna);
+        limits->maxAnalysisFreq = (i/10)%4 >= 1 ? 3e3f : 0.0f;
+        limits->forceBandLimitedAnalysis = (i/10)%4 >= 1;
+        limits->minUpdateInterval = (i/10)%4 == 2 ? 4 : 0;
+        limits->holdParameters = (i/10)%4 == 3;
+        switch(i%4){
+            case 0:
+                proposed_analysis_apply(hAna, inSig, nMics, blocksize, hPCon, hSCon);
+                proposed_synthesis_apply(hSyn, hPCon, hSCon, ypr_rad, xyz_m, PROPOSED_DISTANCE_MAP_USE_PARAM, 2.0f, SAF_TRUE, NUM_EARS, blocksize, outSig);
+                break;
+            case 1:
+                proposed_synthesis_applyFused(hSyn, hAna, inSig, nMics, hPCon, hSCon, ypr_rad, xyz_m, PROPOSED_DISTANCE_MAP_USE_PARAM, 2.0f, SAF_TRUE, NUM_EARS, blocksize, outSig);
+                break;
+            case 2:
+                proposed_synthesis_applyFused(hSynLazy, hAna, inSig, nMics, hPCon, hSCon, ypr_rad, xyz_m, PROPOSED_DISTANCE_MAP_USE_PARAM, 2.0f, SAF_TRUE, NUM_EARS, blocksize, outSig);
+                break;
+            case 3:
+                proposed_synthesis_applyFused(hSynTriLazy, hAna, inSig, nMics, hPCon, hSCon, ypr_rad, xyz_m, PROPOSED_DISTANCE_MAP_USE_PARAM, 2.0f, SAF_TRUE, NUM_EARS, blocksize, outSig);
+                break;
+        }
+    }
+    memset(proposed_analysis_getLimitsPtr(hAna), 0, sizeof(proposed_analysis_limits));
+    if(proposed_rtguard_getNumViolations()>0)
+        proposed_rtguard_printReport();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, proposed_rtguard_getNumViolations(), "Allocations or locks inside the processing functions (see the report above)");
+
+    /* Interface, with the model loaded from a bundle of the objects above */
+    TEST_ASSERT_EQUAL_INT(PROPOSED_BUNDLE_OK, proposed_bundle_save(hAna, hSyn, path));
+    TEST_ASSERT_EQUAL_INT(blocksize, interface_getFrameSize());
+    interface_create(&hInt);
+    interface_setSofaFilePathMAIR(hInt, path);
+    interface_init(hInt, fs);
+    interface_initCore(hInt);
+    TEST_ASSERT_EQUAL_INT(CORE_STATUS_INITIALISED, interface_getCoreStatus(hInt));
+    pData = (interface_data*)hInt;
+    interface_setEnableSilenceGate(hInt, 1);
+    interface_setEnableCpuGovernor(hInt, 1);
+    pData->cpuBudget = 0.0f; /* (below the range of interface_setCpuBudget(), so that every frame is over budget) */
+    interface_setEnableTracing(1);
+    reachedFIRs = reachedRelease = reachedIdle = 0;
+    for(i=0; i<nInterfaceBlocks; i++){
+        if(i==nGovernorBlocks){
+            /* The governor has stepped down to linear-only; now with the static-pose FIRs instead */
+            TEST_ASSERT_EQUAL_INT(INTERFACE_QUALITY_TIER_LINEAR_ONLY, interface_getQualityTier(hInt));
+            interface_setEnableCpuGovernor(hInt, 0);
+            interface_setEnableLinearOnly(hInt, 1);
+            interface_setEnableStaticPoseFIRs(hInt, 1);
+        }
+        moving = i<nGovernorBlocks || i>=nGovernorBlocks+nStaticBlocks;
+        silent = i>=nGovernorBlocks+nStaticBlocks+nReleaseBlocks && i<nInterfaceBlocks-10;
+        if(moving)
+            interface_setYaw(hInt, 360.0f*(float)i/(float)nInterfaceBlocks);
+        if(silent)
+            memset(FLATTEN2D(inSig), 0, nMics*blocksize*sizeof(float));
+        else
+            rand_m1_1(FLATTEN2D(inSig), nMics*blocksize);
+        interface_process(hInt, inSig, outSig, nMics, NUM_EARS, blocksize);
+        reachedFIRs = reachedFIRs || pData->firStatus == STATIC_FIR_STATUS_ON;
+        reachedRelease = reachedRelease || (reachedFIRs && pData->firStatus == STATIC_FIR_STATUS_RELEASE);
+        reachedIdle = reachedIdle || pData->gateStatus == GATE_STATUS_IDLE;
+    }
+    interface_setEnableTracing(0);
+    TEST_ASSERT_TRUE(reachedFIRs);
+    TEST_ASSERT_TRUE(reachedRelease);
+    TEST_ASSERT_TRUE(reachedIdle);
+    TEST_ASSERT_EQUAL_INT(GATE_STATUS_OPEN, pData->gateStatus);
+    if(proposed_rtguard_getNumViolations()>0)
+        proposed_rtguard_printReport();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, proposed_rtguard_getNumViolations(), "Allocations or locks inside interface_process() (see the report above)");
+
+    /* Clean-up */
+    proposed_rtguard_reset();
+    proposed_trace_reset();
+    proposed_trace_releaseThread();
+    interface_destroy(&hInt);
+    remove(path);
+    proposed_analysis_destroy(&hAna);
+    proposed_param_container_destroy(&hPCon);
+    proposed_signal_container_destroy(&hSCon);
+    proposed_synthesis_destroy(&hSyn);
+    proposed_synthesis_destroy(&hSynLazy);
+    proposed_synthesis_destroy(&hSynTriLazy);
+    free(array_dirs_deg);
+    free(h_array);
+    free(inSig);
+    free(outSig);
+}
+
+/** Returns the contents of a file as a string (to be freed), or NULL */
+static char* trace_test_read(const char* path){
+    FILE* file;
+    char* contents;
+    long len;
+
+    file = fopen(path, "rb");
+    if(file==NULL)
+        return NULL;
+    fseek(file, 0, SEEK_END);
+    len = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    contents = malloc1d((size_t)len+1);
+    len = (long)fread(contents, 1, (size_t)len, file);
+    contents[len] = '\0';
+    fclose(file);
+    return contents;
+}
+
+/** Returns the number of occurrences of pattern in str */
+static int trace_test_count(const char* str, const char* pattern){
+    int n;
+
+    for(n=0; (str = strstr(str, pattern))!=NULL; n++)
+        str += strlen(pattern);
+    return n;
+}
+
+/** Shared by the two threads of test__proposed_trace() */
+typedef struct _trace_test_job {
+    const char* path;        /**< File to dump to */
+    int nDumps;              /**< Number of dumps to take while the other thread records */
+    volatile int done;       /**< Set once all dumps have been taken */
+    int nBadDumps;           /**< Dumps that failed, or held a span that was overwritten while being read */
+    int maxSpans;            /**< Largest number of spans in a dump */
+} trace_test_job;
+
+/* Index 0 dumps the trace repeatedly, while index 1 (on another thread) keeps recording spans that each last exactly 1us;
+ * a span that was overwritten while being read would have a different duration (the span of the main thread lasts 2us) */
+static void trace_test_thread(void* ctx, int index, int worker){
+    trace_test_job* job = (trace_test_job*)ctx;
+    unsigned long long t0;
+    char* json;
+    int i, nSpans;
+
+    (void)worker;
+    if(index==0){
+        for(i=0; i<job->nDumps; i++){
+            nSpans = proposed_trace_dump(job->path);
+            json = trace_test_read(job->path);
+            if(nSpans<0 || json==NULL || trace_test_count(json, "\"ph\":\"X\"")!=nSpans ||
+               trace_test_count(json, "\"dur\":1.000}") + trace_test_count(json, "\"dur\":2.000}")!=nSpans)
+                job->nBadDumps++;
+            job->maxSpans = SAF_MAX(job->maxSpans, nSpans);
+            free(json);
+        }
+        job->done = 1;
+    }
+    else{
+        proposed_trace_setThreadName("Writer");
+        do{
+            t0 = proposed_profiler_now();
+            proposed_trace_record("Writer span", t0, t0+1000);
+        } while(!job->done);
+        proposed_trace_releaseThread();
+    }
+}
+
+/**
+ * Checks that spans are only recorded while tracing is enabled, and that they
+ * are written as Chrome trace-event JSON along with the name of their thread.
+ * Also checks that a full ring buffer keeps only the newest spans, and that a
+ * dump taken while another thread is recording leaves out any span that is
+ * overwritten while it is being read.
+ */
+void test__proposed_trace(void){
+    FILE* file;
+    char json[1024];
+    char* contents;
+    size_t len;
+    int i;
+    unsigned long long t0;
+    trace_test_job job;
+    const char* path = "proposed_trace_test.json";
+
+    proposed_trace_reset();
+    proposed_trace_setThreadName("Test thread");
+    t0 = proposed_trace_begin();
+    TEST_ASSERT_TRUE(t0==0);
+    proposed_trace_end("Not traced", t0);
+    proposed_trace_setEnabled(1);
+    t0 = proposed_trace_begin();
+    proposed_trace_end("Traced", t0);
+    proposed_trace_setEnabled(0);
+    TEST_ASSERT_EQUAL_INT(1, proposed_trace_dump(path));
+
+    /* Check the contents */
+    file = fopen(path, "r");
+    TEST_ASSERT_NOT_NULL(file);
+    len = fread(json, 1, sizeof(json)-1, file);
+    json[len] = '\0';
+    fclose(file);
+    remove(path);
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"traceEvents\""));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"args\":{\"name\":\"Test thread\"}"));
+    TEST_ASSERT_NOT_NULL(strstr(json, "{\"name\":\"Traced\",\"ph\":\"X\""));
+    TEST_ASSERT_NULL(strstr(json, "Not traced"));
+
+    /* Discarded spans are not written */
+    proposed_trace_reset();
+    TEST_ASSERT_EQUAL_INT(0, proposed_trace_dump(path));
+    remove(path);
+
+    /* Once the ring buffer wraps around, only the newest spans are kept */
+    proposed_trace_setEnabled(1);
+    for(i=0; i<PROPOSED_TRACE_RING_SIZE+100; i++){
+        t0 = proposed_trace_begin();
+        proposed_trace_end(i<100 ? "Oldest" : "Newest", t0);
+    }
+    TEST_ASSERT_EQUAL_INT(PROPOSED_TRACE_RING_SIZE, proposed_trace_dump(path));
+    contents = trace_test_read(path);
+    TEST_ASSERT_NOT_NULL(contents);
+    TEST_ASSERT_EQUAL_INT(0, trace_test_count(contents, "\"Oldest\""));
+    TEST_ASSERT_EQUAL_INT(PROPOSED_TRACE_RING_SIZE, trace_test_count(contents, "\"Newest\""));
+    free(contents);
+
+    /* Dumps taken while another thread keeps recording (and wrapping around) hold only intact spans */
+    proposed_trace_reset();
+    t0 = proposed_profiler_now();
+    proposed_trace_record("Main span", t0, t0+2000);
+    job.path = path;
+    job.nDumps = 20;
+    job.done = 0;
+    job.nBadDumps = job.maxSpans = 0;
+    proposed_parallel_for(2, 2, &trace_test_thread, (void*)&job);
+    TEST_ASSERT_EQUAL_INT(0, job.nBadDumps);
+    TEST_ASSERT_TRUE(job.maxSpans <= 1+PROPOSED_TRACE_RING_SIZE);
+
+    /* Spans of both threads, each under its own name */
+    TEST_ASSERT_TRUE(proposed_trace_dump(path) > 1);
+    proposed_trace_setEnabled(0);
+    contents = trace_test_read(path);
+    TEST_ASSERT_NOT_NULL(contents);
+    TEST_ASSERT_NOT_NULL(strstr(contents, "\"args\":{\"name\":\"Test thread\"}"));
+    TEST_ASSERT_NOT_NULL(strstr(contents, "\"args\":{\"name\":\"Writer\"}"));
+    TEST_ASSERT_EQUAL_INT(1, trace_test_count(contents, "\"Main span\""));
+    TEST_ASSERT_TRUE(trace_test_count(contents, "\"Writer span\"") > 0);
+    free(contents);
+    remove(path);
+    proposed_trace_reset();
+    proposed_trace_releaseThread();
+}
+
+/**
+ * Checks that proposed_synthesis_applyFused() gives the same output as
+ * proposed_analysis_apply() followed by proposed_synthesis_apply(). Two
+ * identical analysis/synthesis instances are run side by side on the same
+ * input (random array IRs, default HRIRs, and a moving listener), one with each
+ * processing order.
+ */
+void test__proposed_fusedProcessing(void){
+    proposed_analysis_handle hAna = NULL, hAnaFused = NULL;
+    proposed_synthesis_handle hSyn = NULL, hSynFused = NULL;
+    proposed_param_container_handle hPCon = NULL, hPConFused = NULL;
+    proposed_signal_container_handle hSCon = NULL, hSConFused = NULL;
+    proposed_binaural_config binConfig;
+    int i, ch, j, nDirs;
+    float maxRef, maxDiff;
+    float *h_array, *array_dirs_deg;
+    float** inSig, **outSig, **outSigFused;
+    float ypr_rad[3] = {0.0f};
+    float xyz_m[3] = {0.0f};
+
+    /* Config */
+    const int fs = 48000;
+    const int nMics = 4;
+    const int h_len = 256;
+    const int hopsize = 128;
+    const int blocksize = 256;
+    const int nBlocks = 200;
+    const float tol = 1e-4f; /* relative to the peak output */
+
+    /* Two identical instances */
+    nDirs = __Tdesign_degree_21_nPoints;
+    array_dirs_deg = malloc1d(nDirs*2*sizeof(float));
+    memcpy(array_dirs_deg, __Tdesign_degree_21_dirs_deg, nDirs*2*sizeof(float));
+    h_array = malloc1d(nDirs*nMics*h_len*sizeof(float));
+    rand_m1_1(h_array, nDirs*nMics*h_len);
+    proposed_analysis_create(&hAna, (float)fs, hopsize, blocksize, h_array, array_dirs_deg, nDirs, nMics, h_len, 0.0f);
+    proposed_analysis_create(&hAnaFused, (float)fs, hopsize, blocksize, h_array, array_dirs_deg, nDirs, nMics, h_len, 0.0f);
+    binConfig.hrir_fs = __default_hrir_fs;
+    binConfig.lHRIR = __default_hrir_len;
+    binConfig.nHRIR = __default_N_hrir_dirs;
+    binConfig.hrirs = (float*)__default_hrirs;
+    binConfig.hrir_dirs_deg = (float*)__default_hrir_dirs_deg;
+    proposed_synthesis_create(&hSyn, hAna, &binConfig, PROPOSED_HRTF_INTERP_NEAREST, 0, 1, 1, 0);
+    proposed_synthesis_create(&hSynFused, hAnaFused, &binConfig, PROPOSED_HRTF_INTERP_NEAREST, 0, 1, 1, 0);
+    proposed_param_container_create(&hPCon, hAna);
+    proposed_param_container_create(&hPConFused, hAnaFused);
+    proposed_signal_container_create(&hSCon, hAna);
+    proposed_signal_container_create(&hSConFused, hAnaFused);
+    inSig = (float**)malloc2d(nMics, blocksize, sizeof(float));
+    outSig = (float**)malloc2d(NUM_EARS, blocksize, sizeof(float));
+    outSigFused = (float**)malloc2d(NUM_EARS, blocksize, sizeof(float));
+
+    /* Main loop */
+    maxRef = maxDiff = 0.0f;
+    for(i=0; i<nBlocks; i++){
+        rand_m1_1(FLATTEN2D(inSig), nMics*blocksize);
+        ypr_rad[0] = 2.0f*SAF_PI*(float)i/(float)nBlocks;
+        xyz_m[0] = 0.5f*sinf(ypr_rad[0]);
+        proposed_analysis_apply(hAna, inSig, nMics, blocksize, hPCon, hSCon);
+        proposed_synthesis_apply(hSyn, hPCon, hSCon, ypr_rad, xyz_m, PROPOSED_DISTANCE_MAP_USE_PARAM, 2.0f, SAF_TRUE, NUM_EARS, blocksize, outSig);
+        proposed_synthesis_applyFused(hSynFused, hAnaFused, inSig, nMics, hPConFused, hSConFused, ypr_rad, xyz_m, PROPOSED_DISTANCE_MAP_USE_PARAM, 2.0f, SAF_TRUE, NUM_EARS, blocksize, outSigFused);
+        for(ch=0; ch<NUM_EARS; ch++){
+            for(j=0; j<blocksize; j++){
+                maxRef = SAF_MAX(maxRef, fabsf(outSig[ch][j]));
+                maxDiff = SAF_MAX(maxDiff, fabsf(outSig[ch][j]-outSigFused[ch][j]));
+            }
+        }
+    }
+    TEST_ASSERT_TRUE(maxRef>0.0f);
+    TEST_ASSERT_TRUE_MESSAGE(maxDiff <= tol*maxRef, "Fused processing differs from separate analysis/synthesis");
+
+    /* Clean-up */
+    proposed_analysis_destroy(&hAna);
+    proposed_analysis_destroy(&hAnaFused);
+    proposed_param_container_destroy(&hPCon);
+    proposed_param_container_destroy(&hPConFused);
+    proposed_signal_container_destroy(&hSCon);
+    proposed_signal_container_destroy(&hSConFused);
+    proposed_synthesis_destroy(&hSyn);
+    proposed_synthesis_destroy(&hSynFused);
+    free(array_dirs_deg);
+    free(h_array);
+    free(inSig);
+    free(outSig);
+    free(outSigFused);
+}
+
+/**
+ * Checks that every mixing kernel supported by the host CPU (scalar, AVX2 and
+ * AVX-512) gives the same blended mixing matrices and output as the scalar
+ * kernel, for random data. Both the specialised (timeSlots == 2) and the
+ * generic dimensions are tested, including array sizes that are not a multiple
+ * of the SIMD width.
+ */
+void test__proposed_mixKernels(void){
+    int isa, d, i, nMics, timeSlots, nTested;
+    float *gain_par, *gain_lin;
+    float_complex *M_par, *M_lin, *inTF, *M, *outTF, *M_ref, *outTF_ref;
+    proposed_mixKernel kernel;
+
+    /* Config */
+    const int nBands = 133;
+    const int maxMics = 19;
+    const int maxTimeSlots = 4;
+    const int dims[][2] = { {4, 2}, {6, 2}, {7, 2}, {8, 2}, {16, 2}, {19, 2}, {4, 4}, {7, 1} }; /* nMics, timeSlots */
+    const float tol = 1e-5f;
+
+    gain_par = malloc1d(nBands*sizeof(float));
+    gain_lin = malloc1d(nBands*sizeof(float));
+    M_par = malloc1d(nBands*NUM_EARS*maxMics*sizeof(float_complex));
+    M_lin = malloc1d(nBands*NUM_EARS*maxMics*sizeof(float_complex));
+    inTF = malloc1d(nBands*maxMics*maxTimeSlots*sizeof(float_complex));
+    M = malloc1d(nBands*NUM_EARS*maxMics*sizeof(float_complex));
+    M_ref = malloc1d(nBands*NUM_EARS*maxMics*sizeof(float_complex));
+    outTF = malloc1d(nBands*NUM_EARS*maxTimeSlots*sizeof(float_complex));
+    outTF_ref = malloc1d(nBands*NUM_EARS*maxTimeSlots*sizeof(float_complex));
+    rand_0_1(gain_par, nBands);
+    rand_0_1(gain_lin, nBands);
+    rand_m1_1((float*)M_par, 2*nBands*NUM_EARS*maxMics);
+    rand_m1_1((float*)M_lin, 2*nBands*NUM_EARS*maxMics);
+    rand_m1_1((float*)inTF, 2*nBands*maxMics*maxTimeSlots);
+
+    nTested = 0;
+    for(isa=PROPOSED_KERNEL_ISA_SCALAR; isa<=PROPOSED_KERNEL_ISA_AVX512; isa++){
+        kernel = proposed_kernels_getMixKernelForISA((PROPOSED_KERNEL_ISA)isa);
+        if(kernel==NULL)
+            continue; /* not supported by this CPU */
+        nTested++;
+        for(d=0; d<(int)(sizeof(dims)/sizeof(dims[0])); d++){
+            nMics = dims[d][0];
+            timeSlots = dims[d][1];
+            proposed_kernels_mix_scalar(nBands, nMics, timeSlots, gain_par, gain_lin, M_par, M_lin, inTF, M_ref, outTF_ref);
+            kernel(nBands, nMics, timeSlots, gain_par, gain_lin, M_par, M_lin, inTF, M, outTF);
+            for(i=0; i<nBands*NUM_EARS*nMics; i++){
+                TEST_ASSERT_FLOAT_WITHIN(tol, crealf(M_ref[i]), crealf(M[i]));
+                TEST_ASSERT_FLOAT_WITHIN(tol, cimagf(M_ref[i]), cimagf(M[i]));
+            }
+            for(i=0; i<nBands*NUM_EARS*timeSlots; i++){
+                TEST_ASSERT_FLOAT_WITHIN(tol*(float)nMics, crealf(outTF_ref[i]), crealf(outTF[i]));
+                TEST_ASSERT_FLOAT_WITHIN(tol*(float)nMics, cimagf(outTF_ref[i]), cimagf(outTF[i]));
+            }
+        }
+    }
+    TEST_ASSERT_TRUE(nTested>=1);
+    if(nTested<=1)
+        printf("    (Only the scalar mixing kernel is supported by this CPU)\n");
+
+    /* Clean-up */
+    free(gain_par);
+    free(gain_lin);
+    free(M_par);
+    free(M_lin);
+    free(inTF);
+    free(M);
+    free(M_ref);
+    free(outTF);
+    free(outTF_ref);
+}
+
+/**
+ * Checks the fixed-size small-matrix kernels on random Hermitian positive-
+ * definite matrices: that the Jacobi eigendecomposition satisfies
+ * A*V = V*diag(lambda) and V^H*V = I (with the eigenvalues in descending
+ * order), and that the Cholesky inverse satisfies A*inv(A) = I. The closed-
+ * form K x K inverse is compared with utility_cinv(), and must remain finite
+ * for singular matrices.
+ */
+void test__proposed_smallMatKernels(void){
+    int n, N, K, i, j, nTested;
+    void* hInv;
+    float_complex B[8*8], A[8*8], V[8*8], invA[8*8], AV[8*8], VHV[8*8], AinvA[8*8];
+    float_complex invA_ref[3*3];
+    float lambda[8];
+    float_complex VL;
+    const proposed_smallmat_kernels* smk;
+    const float_complex calpha = cmplxf(1.0f, 0.0f), cbeta = cmplxf(0.0f, 0.0f);
+
+    /* Config */
+    const int Ns[3] = {4, 6, 8};
+    const float tol = 1e-4f; /* relative to the size of the matrix */
+
+    /* Eigendecomposition and Cholesky inverse, for each array size with fixed-size kernels */
+    nTested = 0;
+    for(n=0; n<3; n++){
+        N = Ns[n];
+        smk = proposed_kernels_getSmallMat(N);
+        if(smk==NULL)
+            continue; /* PROPOSED_DISABLE_SMALLMAT */
+        nTested++;
+        TEST_ASSERT_EQUAL_INT(N, smk->nMics);
+
+        /* A = B*B^H + I */
+        rand_m1_1((float*)B, 2*N*N);
+        cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasConjTrans, N, N, N, &calpha, B, N, B, N, &cbeta, A, N);
+        for(i=0; i<N; i++)
+            A[i*N+i] = ccaddf(A[i*N+i], cmplxf(1.0f, 0.0f));
+
+        /* A*V = V*diag(lambda), and V^H*V = I */
+        smk->eigh(A, V, lambda);
+        cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, N, N, N, &calpha, A, N, V, N, &cbeta, AV, N);
+        cblas_cgemm(CblasRowMajor, CblasConjTrans, CblasNoTrans, N, N, N, &calpha, V, N, V, N, &cbeta, VHV, N);
+        for(j=0; j<N; j++){
+            if(j>0)
+                TEST_ASSERT_TRUE(lambda[j] <= lambda[j-1]);
+            TEST_ASSERT_TRUE(lambda[j] > 0.0f);
+            for(i=0; i<N; i++){
+                VL = crmulf(V[i*N+j], lambda[j]);
+                TEST_ASSERT_FLOAT_WITHIN(tol*(float)(N*N), crealf(VL), crealf(AV[i*N+j]));
+                TEST_ASSERT_FLOAT_WITHIN(tol*(float)(N*N), cimagf(VL), cimagf(AV[i*N+j]));
+                TEST_ASSERT_FLOAT_WITHIN(tol*(float)N, i==j ? 1.0f : 0.0f, crealf(VHV[i*N+j]));
+                TEST_ASSERT_FLOAT_WITHIN(tol*(float)N, 0.0f, cimagf(VHV[i*N+j]));
+            }
+        }
+
+        /* A*inv(A) = I */
+        TEST_ASSERT_EQUAL_INT(0, smk->invHPD(A, invA));
+        cblas_cgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, N, N, N, &calpha, A, N, invA, N, &cbeta, AinvA, N);
+        for(i=0; i<N; i++){
+            for(j=0; j<N; j++){
+                TEST_ASSERT_FLOAT_WITHIN(tol*(float)(N*N), i==j ? 1.0f : 0.0f, crealf(AinvA[i*N+j]));
+                TEST_ASSERT_FLOAT_WITHIN(tol*(float)(N*N), 0.0f, cimagf(AinvA[i*N+j]));
+            }
+        }
+    }
+    if(nTested==0)
+        printf("    (The fixed-size small-matrix kernels are disabled; only the closed-form inverse was tested)\n");
+
+    /* Closed-form K x K inverse, compared with utility_cinv() (well-conditioned, thanks to the dominant diagonal) */
+    for(K=1; K<=PROPOSED_MAX_K; K++){
+        rand_m1_1((float*)A, 2*K*K);
+        for(i=0; i<K; i++)
+            A[i*K+i] = ccaddf(A[i*K+i], cmplxf(2.0f*(float)K, 0.0f));
+        proposed_smallmat_cinv((const float*)A, K, (float*)invA);
+        utility_cinv_create(&hInv, K);
+        memcpy(B, A, K*K*sizeof(float_complex)); /* in case utility_cinv() overwrites its input */
+        utility_cinv(hInv, B, invA_ref, K);
+        utility_cinv_destroy(&hInv);
+        for(i=0; i<K*K; i++){
+            TEST_ASSERT_FLOAT_WITHIN(tol, crealf(invA_ref[i]), crealf(invA[i]));
+            TEST_ASSERT_FLOAT_WITHIN(tol, cimagf(invA_ref[i]), cimagf(invA[i]));
+        }
+
+        /* Singular (rank 1, or zero), for which the output must still be finite */
+        rand_m1_1((float*)B, 2*K);
+        for(i=0; i<K; i++)
+            for(j=0; j<K; j++)
+                A[i*K+j] = ccmulf(B[i], conjf(B[j]));
+        proposed_smallmat_cinv((const float*)A, K, (float*)invA);
+        for(i=0; i<K*K; i++){
+            TEST_ASSERT_FALSE(isnan(crealf(invA[i])) || isinf(crealf(invA[i])));
+            TEST_ASSERT_FALSE(isnan(cimagf(invA[i])) || isinf(cimagf(invA[i])));
+        }
+        memset(A, 0, K*K*sizeof(float_complex));
+        proposed_smallmat_cinv((const float*)A, K, (float*)invA);
+        for(i=0; i<K*K; i++)
+            TEST_ASSERT_TRUE(crealf(invA[i])==0.0f && cimagf(invA[i])==0.0f);
+    }
+}
+
+/**
+ * Saves the model of an analyser and synthesiser (random array IRs, default
+ * HRIRs) to a bundle, as sofa2bundle does, and loads it again. The loaded model
+ * must be a separate (memory-mapped) model, since it also holds the HRTFs, and
+ * must hold the same data as the computed one; and rendering with it must give
+ * the same output.
+ */
+void test__proposed_bundle(void){
+    proposed_analysis_handle hAna = NULL, hAnaBundle = NULL, hAnaBundle2 = NULL;
+    proposed_synthesis_handle hSyn = NULL, hSynBundle = NULL;
+    proposed_param_container_handle hPCon = NULL, hPConBundle = NULL;
+    proposed_signal_container_handle hSCon = NULL, hSConBundle = NULL;
+    proposed_binaural_config binConfig;
+    proposed_array_model *m, *mb;
+    int i, ch, j, band, nDirs;
+    float maxRef, maxDiff;
+    float *h_array, *array_dirs_deg;
+    float** inSig, **outSig, **outSigBundle;
+    float ypr_rad[3] = {0.0f};
+    float xyz_m[3] = {0.0f};
+    const char* path = "proposed_bundle_test.bin";
+
+    /* Config */
+    const int fs = 48000;
+    const int nMics = 4;
+    const int h_len = 256;
+    const int hopsize = 128;
+    const int blocksize = 256;
+    const int nBlocks = 50;
+
+    /* Computed model, saved to a bundle */
+    nDirs = __Tdesign_degree_21_nPoints;
+    array_dirs_deg = malloc1d(nDirs*2*sizeof(float));
+    memcpy(array_dirs_deg, __Tdesign_degree_21_dirs_deg, nDirs*2*sizeof(float));
+    h_array = malloc1d(nDirs*nMics*h_len*sizeof(float));
+    rand_m1_1(h_array, nDirs*nMics*h_len);
+    proposed_analysis_create(&hAna, (float)fs, hopsize, blocksize, h_array, array_dirs_deg, nDirs, nMics, h_len, 0.0f);
+    binConfig.hrir_fs = __default_hrir_fs;
+    binConfig.lHRIR = __default_hrir_len;
+    binConfig.nHRIR = __default_N_hrir_dirs;
+    binConfig.hrirs = (float*)__default_hrirs;
+    binConfig.hrir_dirs_deg = (float*)__default_hrir_dirs_deg;
+    proposed_synthesis_create(&hSyn, hAna, &binConfig, PROPOSED_HRTF_INTERP_NEAREST, 0, 1, 1, 0);
+    TEST_ASSERT_EQUAL_INT(PROPOSED_BUNDLE_OK, proposed_bundle_save(hAna, hSyn, path));
+
+    /* Loaded model; a separate model from the computed one, which is shared when the same bundle is loaded again */
+    TEST_ASSERT_EQUAL_INT(PROPOSED_BUNDLE_OK, proposed_analysis_createFromBundle(&hAnaBundle, path, (float)fs, hopsize, blocksize));
+    m = ((proposed_analysis_data*)hAna)->model;
+    mb = ((proposed_analysis_data*)hAnaBundle)->model;
+    TEST_ASSERT_TRUE(mb!=m && mb->hBundle!=NULL && mb->H_bin!=NULL);
+    TEST_ASSERT_EQUAL_INT(PROPOSED_BUNDLE_OK, proposed_analysis_createFromBundle(&hAnaBundle2, path, (float)fs, hopsize, blocksize));
+    TEST_ASSERT_TRUE(((proposed_analysis_data*)hAnaBundle2)->model==mb);
+    proposed_analysis_destroy(&hAnaBundle2);
+    TEST_ASSERT_EQUAL_INT(PROPOSED_BUNDLE_ERROR_MISMATCH, proposed_analysis_createFromBundle(&hAnaBundle2, path, (float)fs, 2*hopsize, blocksize));
+    TEST_ASSERT_NULL(hAnaBundle2);
+
+    /* Same data */
+    TEST_ASSERT_EQUAL_INT(m->nBands, mb->nBands);
+    TEST_ASSERT_EQUAL_INT(m->nMics, mb->nMics);
+    TEST_ASSERT_EQUAL_INT(m->nDirs, mb->nDirs);
+    TEST_ASSERT_EQUAL_INT(m->nScan, mb->nScan);
+    TEST_ASSERT_EQUAL_MEMORY(m->freqVector, mb->freqVector, m->nBands*sizeof(float));
+    TEST_ASSERT_EQUAL_MEMORY(m->array_dirs_deg, mb->array_dirs_deg, m->nDirs*2*sizeof(float));
+    TEST_ASSERT_EQUAL_MEMORY(m->array_dirs_xyz, mb->array_dirs_xyz, m->nDirs*3*sizeof(float));
+    TEST_ASSERT_EQUAL_MEMORY(m->W, mb->W, m->nDirs*sizeof(float));
+    TEST_ASSERT_EQUAL_MEMORY(m->DCM_array, mb->DCM_array, m->nBands*nMics*nMics*sizeof(float_complex));
+    for(band=0; band<m->nBands; band++)
+        TEST_ASSERT_EQUAL_MEMORY(m->T[band], mb->T[band], nMics*nMics*sizeof(float_complex));
+    TEST_ASSERT_EQUAL_MEMORY(m->scan_dirs_deg, mb->scan_dirs_deg, m->nScan*2*sizeof(float));
+    TEST_ASSERT_EQUAL_MEMORY(m->scan_dirs_xyz, mb->scan_dirs_xyz, m->nScan*3*sizeof(float));
+    TEST_ASSERT_EQUAL_MEMORY(m->scan_idx, mb->scan_idx, m->nScan*sizeof(int));
+    TEST_ASSERT_EQUAL_MEMORY(m->H_scan_w, mb->H_scan_w, m->nBands*nMics*(m->nScan)*sizeof(float_complex));
+    TEST_ASSERT_EQUAL_MEMORY(m->H_array, mb->H_array, m->nDirs*(m->nBands)*nMics*sizeof(float_complex));
+
+    /* Same HRTFs, when the synthesiser uses those stored in the bundle */
+    proposed_synthesis_create(&hSynBundle, hAnaBundle, NULL, PROPOSED_HRTF_INTERP_NEAREST, 0, 1, 1, 0);
+    for(j=0; j<nDirs; j++)
+        TEST_ASSERT_EQUAL_MEMORY(proposed_synthesis_getHRTF((proposed_synthesis_data*)hSyn, j),
+                                 proposed_synthesis_getHRTF((proposed_synthesis_data*)hSynBundle, j), m->nBands*NUM_EARS*sizeof(float_complex));
+
+    /* Same output */
+    proposed_param_container_create(&hPCon, hAna);
+    proposed_param_container_create(&hPConBundle, hAnaBundle);
+    proposed_signal_container_create(&hSCon, hAna);
+    proposed_signal_container_create(&hSConBundle, hAnaBundle);
+    inSig = (float**)malloc2d(nMics, blocksize, sizeof(float));
+    outSig = (float**)malloc2d(NUM_EARS, blocksize, sizeof(float));
+    outSigBundle = (float**)malloc2d(NUM_EARS, blocksize, sizeof(float));
+    maxRef = maxDiff = 0.0f;
+    for(i=0; i<nBlocks; i++){
+        rand_m1_1(FLATTEN2D(inSig), nMics*blocksize);
+        ypr_rad[0] = 2.0f*SAF_PI*(float)i/(float)nBlocks;
+        proposed_analysis_apply(hAna, inSig, nMics, blocksize, hPCon, hSCon);
+        proposed_synthesis_apply(hSyn, hPCon, hSCon, ypr_rad, xyz_m, PROPOSED_DISTANCE_MAP_USE_PARAM, 2.0f, SAF_TRUE, NUM_EARS, blocksize, outSig);
+        proposed_analysis_apply(hAnaBundle, inSig, nMics, blocksize, hPConBundle, hSConBundle);
+        proposed_synthesis_apply(hSynBundle, hPConBundle, hSConBundle, ypr_rad, xyz_m, PROPOSED_DISTANCE_MAP_USE_PARAM, 2.0f, SAF_TRUE, NUM_EARS, blocksize, outSigBundle);
+        for(ch=0; ch<NUM_EARS; ch++){
+            for(j=0; j<blocksize; j++){
+                maxRef = SAF_MAX(maxRef, fabsf(outSig[ch][j]));
+                maxDiff = SAF_MAX(maxDiff, fabsf(outSig[ch][j]-outSigBundle[ch][j]));
+            }
+        }
+    }
+    TEST_ASSERT_TRUE(maxRef>0.0f);
+    TEST_ASSERT_TRUE(maxDiff <= 1e-5f*maxRef);
+
+    /* Clean-up */
+    proposed_synthesis_destroy(&hSyn);
+    proposed_synthesis_destroy(&hSynBundle);
+    proposed_analysis_destroy(&hAna);
+    proposed_analysis_destroy(&hAnaBundle);
+    proposed_param_container_destroy(&hPCon);
+    proposed_param_container_destroy(&hPConBundle);
+    proposed_signal_container_destroy(&hSCon);
+    proposed_signal_container_destroy(&hSConBundle);
+    remove(path);
+    free(array_dirs_deg);
+    free(h_array);
+    free(inSig);
+    free(outSig);
+    free(outSigBundle);
+}
+
+void test__proposed_initThreads(void){
+    proposed_analysis_handle hAna = NULL;
+    proposed_synthesis_handle hSyn = NULL;
+    proposed_param_container_handle hPCon = NULL;
+    proposed_signal_container_handle hSCon = NULL;
+    proposed_binaural_config binConfig;
+    proposed_array_model *m;
+    int i, run, band, j, nDirs, nBands, nScan;
+    float *h_array, *array_dirs_deg, *inSig_all;
+    float** inSig, **outSig;
+    float_complex *H_array[2], *DCM_array[2], *T[2], *H_scan_w[2], *H_bin[2];
+    float *W[2], *out[2];
+    float ypr_rad[3] = {0.0f};
+    float xyz_m[3] = {0.0f};
+
+    /* Config */
+    const int fs = 48000;
+    const int nMics = 4;
+    const int h_len = 256;
+    const int hopsize = 128;
+    const int blocksize = 256;
+    const int nBlocks = 20;
+    const int nThreads[2] = {1, 4};
+
+    nDirs = __Tdesign_degree_21_nPoints;
+    array_dirs_deg = malloc1d(nDirs*2*sizeof(float));
+    memcpy(array_dirs_deg, __Tdesign_degree_21_dirs_deg, nDirs*2*sizeof(float));
+    h_array = malloc1d(nDirs*nMics*h_len*sizeof(float));
+    rand_m1_1(h_array, nDirs*nMics*h_len);
+    inSig_all = malloc1d(nBlocks*nMics*blocksize*sizeof(float));
+    rand_m1_1(inSig_all, nBlocks*nMics*blocksize);
+    binConfig.hrir_fs = __default_hrir_fs;
+    binConfig.lHRIR = __default_hrir_len;
+    binConfig.nHRIR = __default_N_hrir_dirs;
+    binConfig.hrirs = (float*)__default_hrirs;
+    binConfig.hrir_dirs_deg = (float*)__default_hrir_dirs_deg;
+    inSig = (float**)malloc2d(nMics, blocksize, sizeof(float));
+    outSig = (float**)malloc2d(NUM_EARS, blocksize, sizeof(float));
+
+    /* The objects of each run are destroyed before the next one, so that the model is computed again rather than shared */
+    for(run=0; run<2; run++){
+        proposed_setMaxInitThreads(nThreads[run]);
+        TEST_ASSERT_EQUAL_INT(nThreads[run], proposed_getMaxInitThreads());
+        proposed_analysis_create(&hAna, (float)fs, hopsize, blocksize, h_array, array_dirs_deg, nDirs, nMics, h_len, 0.0f);
+        proposed_synthesis_create(&hSyn, hAna, &binConfig, PROPOSED_HRTF_INTERP_NEAREST, 0, 1, 1, 0);
+        proposed_param_container_create(&hPCon, hAna);
+        proposed_signal_container_create(&hSCon, hAna);
+
+        /* Copy of the model and HRTFs */
+        m = ((proposed_analysis_data*)hAna)->model;
+        nBands = m->nBands;
+        nScan = m->nScan;
+        H_array[run] = malloc1d(nDirs*nBands*nMics*sizeof(float_complex));
+        memcpy(H_array[run], m->H_array, nDirs*nBands*nMics*sizeof(float_complex));
+        DCM_array[run] = malloc1d(nBands*nMics*nMics*sizeof(float_complex));
+        memcpy(DCM_array[run], m->DCM_array, nBands*nMics*nMics*sizeof(float_complex));
+        T[run] = malloc1d(nBands*nMics*nMics*sizeof(float_complex));
+        for(band=0; band<nBands; band++)
+            memcpy(&(T[run][band*nMics*nMics]), m->T[band], nMics*nMics*sizeof(float_complex));
+        H_scan_w[run] = malloc1d(nBands*nMics*nScan*sizeof(float_complex));
+        memcpy(H_scan_w[run], m->H_scan_w, nBands*nMics*nScan*sizeof(float_complex));
+        W[run] = malloc1d(nDirs*sizeof(float));
+        memcpy(W[run], m->W, nDirs*sizeof(float));
+        H_bin[run] = malloc1d(nDirs*nBands*NUM_EARS*sizeof(float_complex));
+        for(j=0; j<nDirs; j++)
+            memcpy(&(H_bin[run][j*nBands*NUM_EARS]), proposed_synthesis_getHRTF((proposed_synthesis_data*)hSyn, j), nBands*NUM_EARS*sizeof(float_complex));
+
+        /* Output */
+        out[run] = malloc1d(nBlocks*NUM_EARS*blocksize*sizeof(float));
+        for(i=0; i<nBlocks; i++){
+            memcpy(FLATTEN2D(inSig), &(inSig_all[i*nMics*blocksize]), nMics*blocksize*sizeof(float));
+            ypr_rad[0] = 2.0f*SAF_PI*(float)i/(float)nBlocks;
+            proposed_analysis_apply(hAna, inSig, nMics, blocksize, hPCon, hSCon);
+            proposed_synthesis_apply(hSyn, hPCon, hSCon, ypr_rad, xyz_m, PROPOSED_DISTANCE_MAP_USE_PARAM, 2.0f, SAF_TRUE, NUM_EARS, blocksize, outSig);
+            memcpy(&(out[run][i*NUM_EARS*blocksize]), FLATTEN2D(outSig), NUM_EARS*blocksize*sizeof(float));
+        }
+        proposed_synthesis_destroy(&hSyn);
+        proposed_analysis_destroy(&hAna);
+        proposed_param_container_destroy(&hPCon);
+        proposed_signal_container_destroy(&hSCon);
+    }
+    proposed_setMaxInitThreads(0);
+
+    /* Identical, not merely close */
+    TEST_ASSERT_EQUAL_MEMORY(H_array[0], H_array[1], nDirs*nBands*nMics*sizeof(float_complex));
+    TEST_ASSERT_EQUAL_MEMORY(DCM_array[0], DCM_array[1], nBands*nMics*nMics*sizeof(float_complex));
+    TEST_ASSERT_EQUAL_MEMORY(T[0], T[1], nBands*nMics*nMics*sizeof(float_complex));
+    TEST_ASSERT_EQUAL_MEMORY(H_scan_w[0], H_scan_w[1], nBands*nMics*nScan*sizeof(float_complex));
+    TEST_ASSERT_EQUAL_MEMORY(W[0], W[1], nDirs*sizeof(float));
+    TEST_ASSERT_EQUAL_MEMORY(H_bin[0], H_bin[1], nDirs*nBands*NUM_EARS*sizeof(float_complex));
+    TEST_ASSERT_EQUAL_MEMORY(out[0], out[1], nBlocks*NUM_EARS*blocksize*sizeof(float));
+
+    /* Clean-up */
+    for(run=0; run<2; run++){
+        free(H_array[run]);
+        free(DCM_array[run]);
+        free(T[run]);
+        free(H_scan_w[run]);
+        free(W[run]);
+        free(H_bin[run]);
+        free(out[run]);
+    }
+    free(array_dirs_deg);
+    free(h_array);
+    free(inSig_all);
+    free(inSig);
+    free(outSig);
+}
+
+void test__proposed_quadratureWeights(void){
+    int i;
+    float z, sum, relErr, meanRelErr, maxRelErr;
+    float *dirs_deg, *w, *w_voronoi;
+
+    /* Config */
+    const int nDirs = 2000; /* dense enough for the kernel density estimate (>= PROPOSED_VORONOI_MAX_DIRS) */
+    const float warp = 0.1f;
+
+    /* Spiral grid, with a smoothly varying density (sparser towards the poles) */
+    TEST_ASSERT_TRUE(nDirs>=PROPOSED_VORONOI_MAX_DIRS);
+    dirs_deg = malloc1d(nDirs*2*sizeof(float));
+    for(i=0; i<nDirs; i++){
+        z = 1.0f - 2.0f*((float)i+0.5f)/(float)nDirs;
+        z += warp*sinf(SAF_PI*z);
+        dirs_deg[i*2]   = fmodf((float)i*137.50776f, 360.0f) - 180.0f;
+        dirs_deg[i*2+1] = asinf(SAF_CLAMP(z, -1.0f, 1.0f))*180.0f/SAF_PI;
+    }
+    w = malloc1d(nDirs*sizeof(float));
+    w_voronoi = malloc1d(nDirs*sizeof(float));
+    proposed_getQuadratureWeights(dirs_deg, nDirs, w);
+    getVoronoiWeights(dirs_deg, nDirs, 0, w_voronoi);
+
+    /* Sum to the area of the unit sphere */
+    sum = 0.0f;
+    for(i=0; i<nDirs; i++){
+        TEST_ASSERT_TRUE(w[i]>0.0f);
+        sum += w[i];
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f*4.0f*SAF_PI, 4.0f*SAF_PI, sum);
+
+    /* Agree with the Voronoi areas to within a few percent on average, and the worst direction is not far off either */
+    meanRelErr = maxRelErr = 0.0f;
+    for(i=0; i<nDirs; i++){
+        relErr = fabsf(w[i]-w_voronoi[i])/w_voronoi[i];
+        meanRelErr += relErr/(float)nDirs;
+        maxRelErr = SAF_MAX(maxRelErr, relErr);
+    }
+    TEST_ASSERT_TRUE(meanRelErr<0.05f);
+    TEST_ASSERT_TRUE(maxRelErr<0.25f);
+
+    /* Clean-up */
+    free(dirs_deg);
+    free(w);
+    free(w_voronoi);
+}
+
+/** Saves a bundle of a 4-channel array with random responses, from which the interface tests load their array model */
+static void interface_test_saveBundle(const char* path, float fs){
+    proposed_analysis_handle hAna = NULL;
+    proposed_synthesis_handle hSyn = NULL;
+    proposed_binaural_config binConfig;
+    int nDirs;
+    float *h_array, *array_dirs_deg;
+    const int nMics = 4;
+    const int h_len = 256;
+
+    nDirs = __Tdesign_degree_21_nPoints;
+    array_dirs_deg = malloc1d(nDirs*2*sizeof(float));
+    memcpy(array_dirs_deg, __Tdesign_degree_21_dirs_deg, nDirs*2*sizeof(float));
+    h_array = malloc1d(nDirs*nMics*h_len*sizeof(float));
+    rand_m1_1(h_array, nDirs*nMics*h_len);
+    proposed_analysis_create(&hAna, fs, HOP_SIZE, FRAME_SIZE, h_array, array_dirs_deg, nDirs, nMics, h_len, 0.0f);
+    binConfig.hrir_fs = __default_hrir_fs;
+    binConfig.lHRIR = __default_hrir_len;
+    binConfig.nHRIR = __default_N_hrir_dirs;
+    binConfig.hrirs = (float*)__default_hrirs;
+    binConfig.hrir_dirs_deg = (float*)__default_hrir_dirs_deg;
+    proposed_synthesis_create(&hSyn, hAna, &binConfig, PROPOSED_HRTF_INTERP_NEAREST, 0, 1, 1, 0);
+    TEST_ASSERT_EQUAL_INT(PROPOSED_BUNDLE_OK, proposed_bundle_save(hAna, hSyn, path));
+    proposed_analysis_destroy(&hAna);
+    proposed_synthesis_destroy(&hSyn);
+    free(array_dirs_deg);
+    free(h_array);
+}
+
+/** Creates an interface, with the array model loaded from a bundle saved by interface_test_saveBundle() */
+static void interface_test_create(void** phInt, const char* path, int fs){
+    interface_create(phInt);
+    interface_setSofaFilePathMAIR(*phInt, path);
+    interface_init(*phInt, fs);
+    interface_initCore(*phInt);
+    TEST_ASSERT_EQUAL_INT(CORE_STATUS_INITIALISED, interface_getCoreStatus(*phInt));
+}
+
+/**
+ * Checks the silence gate against an interface without it: the output is
+ * identical until the gate closes, by which time the filterbank tail has
+ * already been output (i.e. none of it is lost), and it is exactly zero once
+ * the gate is idle. Also checks that the first frame of a signal onset
+ * re-opens the gate, and that the output then resumes.
+ */
+void test__proposed_silenceGate(void){
+    void *hInt = NULL, *hIntRef = NULL;
+    interface_data* pData;
+    int i, j, ch, silent, onset, reachedTail, reachedIdle;
+    float signalEnergy, lostEnergy, onsetEnergy, onsetEnergyRef;
+    float** inSig, **outSig, **outSigRef;
+    const char* path = "proposed_silenceGate_test.bin";
+
+    /* Config */
+    const int fs = 48000;
+    const int nMics = 4;
+    const float holdTime_s = 0.1f;
+    const int nSignalBlocks = 40;
+    const int nSilentBlocks = 2*(int)(holdTime_s*fs/FRAME_SIZE) + 20; /* hold time of the gate, then the tail */
+    const int nOnsetBlocks = 20;
+
+    /* Gated and reference interfaces, with the same array model */
+    interface_test_saveBundle(path, (float)fs);
+    interface_test_create(&hInt, path, fs);
+    interface_test_create(&hIntRef, path, fs);
+    interface_setEnableSilenceGate(hInt, 1);
+    interface_setSilenceGateHoldTime(hInt, holdTime_s);
+    pData = (interface_data*)hInt;
+    inSig = (float**)malloc2d(nMics, FRAME_SIZE, sizeof(float));
+    outSig = (float**)malloc2d(NUM_EARS, FRAME_SIZE, sizeof(float));
+    outSigRef = (float**)malloc2d(NUM_EARS, FRAME_SIZE, sizeof(float));
+
+    /* Signal, silence, then a signal onset */
+    reachedTail = reachedIdle = 0;
+    signalEnergy = lostEnergy = onsetEnergy = onsetEnergyRef = 0.0f;
+    for(i=0; i<nSignalBlocks+nSilentBlocks+nOnsetBlocks; i++){
+        silent = i>=nSignalBlocks && i<nSignalBlocks+nSilentBlocks;
+        onset = i>=nSignalBlocks+nSilentBlocks;
+        if(silent)
+            memset(FLATTEN2D(inSig), 0, nMics*FRAME_SIZE*sizeof(float));
+        else
+            rand_m1_1(FLATTEN2D(inSig), nMics*FRAME_SIZE);
+        interface_process(hInt, inSig, outSig, nMics, NUM_EARS, FRAME_SIZE);
+        interface_process(hIntRef, inSig, outSigRef, nMics, NUM_EARS, FRAME_SIZE);
+        reachedTail = reachedTail || pData->gateStatus == GATE_STATUS_TAIL;
+        reachedIdle = reachedIdle || pData->gateStatus == GATE_STATUS_IDLE;
+        if(onset) /* from the first frame of the onset */
+            TEST_ASSERT_FALSE(interface_getSilenceGateIsClosed(hInt));
+        for(ch=0; ch<NUM_EARS; ch++){
+            for(j=0; j<FRAME_SIZE; j++){
+                if(!onset && pData->gateStatus == GATE_STATUS_OPEN)
+                    TEST_ASSERT_FLOAT_WITHIN(1e-6f, outSigRef[ch][j], outSig[ch][j]);
+                else if(pData->gateStatus == GATE_STATUS_IDLE)
+                    TEST_ASSERT_EQUAL_FLOAT(0.0f, outSig[ch][j]);
+                if(!silent && !onset)
+                    signalEnergy += outSigRef[ch][j]*outSigRef[ch][j];
+                else if(silent && pData->gateStatus != GATE_STATUS_OPEN)
+                    lostEnergy += outSigRef[ch][j]*outSigRef[ch][j];
+                else if(onset){
+                    onsetEnergy += outSig[ch][j]*outSig[ch][j];
+                    onsetEnergyRef += outSigRef[ch][j]*outSigRef[ch][j];
+                }
+            }
+        }
+        if(i==nSignalBlocks+nSilentBlocks-1)
+            TEST_ASSERT_TRUE(interface_getSilenceGateIsClosed(hInt));
+    }
+    TEST_ASSERT_TRUE(reachedTail);
+    TEST_ASSERT_TRUE(reachedIdle);
+    TEST_ASSERT_TRUE(signalEnergy>0.0f);
+    TEST_ASSERT_TRUE(lostEnergy<=1e-10f*signalEnergy); /* anything the reference still outputs after the gate closes */
+
+    /* The output resumes with the onset (the parameters were held while the gate was closed, so are not identical) */
+    TEST_ASSERT_TRUE(onsetEnergyRef>0.0f);
+    TEST_ASSERT_TRUE(onsetEnergy>0.1f*onsetEnergyRef && onsetEnergy<10.0f*onsetEnergyRef);
+
+    /* Clean-up */
+    interface_destroy(&hInt);
+    interface_destroy(&hIntRef);
+    remove(path);
+    free(inSig);
+    free(outSig);
+    free(outSigRef);
+}
+
+/**
+ * Checks that the CPU governor steps down one quality tier at a time while the
+ * load is over budget, holds the tier while the load is within the hysteresis
+ * band, and steps back up (more slowly) once the load is well under budget.
+ * The load is forced by passing the processing times to the governor directly.
+ * Also checks the analysis limits that interface_process() applies in each
+ * tier.
+ */
+void test__proposed_governor(void){
+    void* hInt = NULL;
+    interface_data* pData;
+    proposed_analysis_data* a;
+    proposed_analysis_limits* limits;
+    INTERFACE_QUALITY_TIERS tier, prevTier;
+    int i, nFrames, lastChange, nRecoverFrames;
+    double frameDuration_s;
+    float** inSig, **outSig;
+    const char* path = "proposed_governor_test.bin";
+
+    /* Config */
+    const int fs = 48000;
+    const int nMics = 4;
+    const float budget = 0.7f;
+
+    interface_test_saveBundle(path, (float)fs);
+    interface_test_create(&hInt, path, fs);
+    pData = (interface_data*)hInt;
+    interface_setEnableCpuGovernor(hInt, 1);
+    interface_setCpuBudget(hInt, budget);
+    frameDuration_s = (double)FRAME_SIZE/(double)fs;
+    nRecoverFrames = (int)(GOVERNOR_RECOVER_TIME_S*fs/(float)FRAME_SIZE);
+    TEST_ASSERT_EQUAL_INT(INTERFACE_QUALITY_TIER_FULL, interface_getQualityTier(hInt));
+
+    /* Over budget: down to linear-only, one tier at a time and at most every GOVERNOR_DEGRADE_FRAMES frames */
+    prevTier = INTERFACE_QUALITY_TIER_FULL;
+    lastChange = 0;
+    for(nFrames=1; nFrames<=100; nFrames++){
+        interface_updateGovernor(hInt, 2.0*budget*frameDuration_s);
+        tier = interface_getQualityTier(hInt);
+        if(tier!=prevTier){
+            TEST_ASSERT_EQUAL_INT(prevTier+1, tier);
+            TEST_ASSERT_TRUE(nFrames-lastChange >= GOVERNOR_DEGRADE_FRAMES);
+            lastChange = nFrames;
+            prevTier = tier;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(INTERFACE_QUALITY_TIER_LINEAR_ONLY, interface_getQualityTier(hInt));
+
+    /* Under budget, but not by enough to recover (hysteresis) */
+    for(nFrames=1; nFrames<=2*nRecoverFrames; nFrames++)
+        interface_updateGovernor(hInt, 0.6*budget*frameDuration_s);
+    TEST_ASSERT_EQUAL_INT(INTERFACE_QUALITY_TIER_LINEAR_ONLY, interface_getQualityTier(hInt));
+
+    /* Well under budget: back up to full quality, one tier at a time and at most every nRecoverFrames frames */
+    lastChange = 0;
+    for(nFrames=1; nFrames<=(INTERFACE_NUM_QUALITY_TIERS+1)*nRecoverFrames; nFrames++){
+        interface_updateGovernor(hInt, 0.0);
+        tier = interface_getQualityTier(hInt);
+        if(tier!=prevTier){
+            TEST_ASSERT_EQUAL_INT(prevTier-1, tier);
+            TEST_ASSERT_TRUE(nFrames-lastChange >= nRecoverFrames);
+            lastChange = nFrames;
+            prevTier = tier;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(INTERFACE_QUALITY_TIER_FULL, interface_getQualityTier(hInt));
+
+    /* Disabling the governor restores full quality straight away */
+    for(nFrames=1; nFrames<=100; nFrames++)
+        interface_updateGovernor(hInt, 2.0*budget*frameDuration_s);
+    TEST_ASSERT_TRUE(interface_getQualityTier(hInt)>INTERFACE_QUALITY_TIER_FULL);
+    interface_setEnableCpuGovernor(hInt, 0);
+    interface_updateGovernor(hInt, 2.0*budget*frameDuration_s);
+    TEST_ASSERT_EQUAL_INT(INTERFACE_QUALITY_TIER_FULL, interface_getQualityTier(hInt));
+
+    /* Limits applied by interface_process() in each tier (one frame per tier is too few for the governor to change it) */
+    interface_setEnableCpuGovernor(hInt, 1);
+    inSig = (float**)malloc2d(nMics, FRAME_SIZE, sizeof(float));
+    outSig = (float**)malloc2d(NUM_EARS, FRAME_SIZE, sizeof(float));
+    a = (proposed_analysis_data*)pData->hAna;
+    limits = proposed_analysis_getLimitsPtr(pData->hAna);
+    for(i=INTERFACE_QUALITY_TIER_FULL; i<=INTERFACE_NUM_QUALITY_TIERS; i++){
+        pData->qualityTier = (INTERFACE_QUALITY_TIERS)i;
+        pData->governorCounter = 0;
+        rand_m1_1(FLATTEN2D(inSig), nMics*FRAME_SIZE);
+        interface_process(hInt, inSig, outSig, nMics, NUM_EARS, FRAME_SIZE);
+        TEST_ASSERT_EQUAL_FLOAT(i>=INTERFACE_QUALITY_TIER_REDUCED_BANDWIDTH ? GOVERNOR_REDUCED_ANALYSIS_FREQ : 0.0f, limits->maxAnalysisFreq);
+        TEST_ASSERT_EQUAL_INT(i>=INTERFACE_QUALITY_TIER_REDUCED_BANDWIDTH, limits->forceBandLimitedAnalysis);
+        TEST_ASSERT_EQUAL_INT(i==INTERFACE_QUALITY_TIER_DECIMATED ? GOVERNOR_DECIMATED_INTERVAL : 0, limits->minUpdateInterval);
+        TEST_ASSERT_EQUAL_INT(i>=INTERFACE_QUALITY_TIER_HOLD_PARAMS, limits->holdParameters);
+        TEST_ASSERT_EQUAL_INT(i==INTERFACE_QUALITY_TIER_LINEAR_ONLY, *proposed_analysis_getEnableLinearOnlyPtr(pData->hAna));
+        TEST_ASSERT_EQUAL_INT(i==INTERFACE_QUALITY_TIER_LINEAR_ONLY, *proposed_synthesis_getEnableLinearOnlyPtr(pData->hSyn));
+        if(i<INTERFACE_QUALITY_TIER_LINEAR_ONLY){
+            /* ...and taken up by the analysis (which is skipped for linear-only rendering) */
+            TEST_ASSERT_EQUAL_FLOAT(i>=INTERFACE_QUALITY_TIER_REDUCED_BANDWIDTH ? SAF_MIN(a->maximumAnalysisFreq, GOVERNOR_REDUCED_ANALYSIS_FREQ) :
+                                    a->maximumAnalysisFreq, a->blockMaxAnalysisFreq);
+            TEST_ASSERT_EQUAL_INT(i>=INTERFACE_QUALITY_TIER_REDUCED_BANDWIDTH || a->enableBandLimitedAnalysis, a->blockBandLimitedAnalysis);
+        }
+    }
+
+    /* Clean-up */
+    interface_destroy(&hInt);
+    remove(path);
+    free(inSig);
+    free(outSig);
+}
+
+/**
+ * Returns the distance (Frobenius norm over all bands) of the blended mixing
+ * matrices from the equalised linear decoder, or the norm of the decoder itself
+ * if distance is 0
+ */
+static float linearOnly_test_distance(proposed_synthesis_data* s, int distance){
+    int band, k;
+    float_complex d;
+    float sum;
+
+    sum = 0.0f;
+    for(band=0; band<s->nBands; band++){
+        for(k=0; k<NUM_EARS*s->nMics; k++){
+            /* M = gain_par*M_par + gain_lin*M_lin, with M_par converged to diffEQ*M_lin, and 0.5 as the 6dB reduction */
+            d = crmulf(s->M_lin[band][k], 0.5f*s->diffEQ[band]);
+            if(distance)
+                d = ccsubf(s->M[band][k], d);
+            sum += crealf(d)*crealf(d) + cimagf(d)*cimagf(d);
+        }
+    }
+    return sqrtf(sum);
+}
+
+/**
+ * Checks that linear-only rendering (at a fixed pose) converges to the
+ * equalised linear decoder, and that entering and leaving this mode is
+ * crossfaded through the temporal averaging of the mixing matrices, rather
+ * than switched.
+ */
+void test__proposed_linearOnly(void){
+    proposed_analysis_handle hAna = NULL;
+    proposed_synthesis_handle hSyn = NULL;
+    proposed_param_container_handle hPCon = NULL;
+    proposed_signal_container_handle hSCon = NULL;
+    proposed_binaural_config binConfig;
+    proposed_synthesis_data* s;
+    int i, nDirs;
+    float dist0, dist1, distN, norm;
+    float *h_array, *array_dirs_deg;
+    float** inSig, **outSig;
+    float ypr_rad[3] = {0.0f};
+    float xyz_m[3] = {0.0f};
+
+    /* Config */
+    const int fs = 48000;
+    const int nMics = 4;
+    const int h_len = 256;
+    const int hopsize = 128;
+    const int blocksize = 256;
+    const int nBlocks = 200;
+
+    nDirs = __Tdesign_degree_21_nPoints;
+    array_dirs_deg = malloc1d(nDirs*2*sizeof(float));
+    memcpy(array_dirs_deg, __Tdesign_degree_21_dirs_deg, nDirs*2*sizeof(float));
+    h_array = malloc1d(nDirs*nMics*h_len*sizeof(float));
+    rand_m1_1(h_array, nDirs*nMics*h_len);
+    proposed_analysis_create(&hAna, (float)fs, hopsize, blocksize, h_array, array_dirs_deg, nDirs, nMics, h_len, 0.0f);
+    binConfig.hrir_fs = __default_hrir_fs;
+    binConfig.lHRIR = __default_hrir_len;
+    binConfig.nHRIR = __default_N_hrir_dirs;
+    binConfig.hrirs = (float*)__default_hrirs;
+    binConfig.hrir_dirs_deg = (float*)__default_hrir_dirs_deg;
+    proposed_synthesis_create(&hSyn, hAna, &binConfig, PROPOSED_HRTF_INTERP_NEAREST, 0, 1, 1, 0);
+    proposed_param_container_create(&hPCon, hAna);
+    proposed_signal_container_create(&hSCon, hAna);
+    s = (proposed_synthesis_data*)hSyn;
+    inSig = (float**)malloc2d(nMics, blocksize, sizeof(float));
+    outSig = (float**)malloc2d(NUM_EARS, blocksize, sizeof(float));
+
+    /* Parametric rendering, then linear-only rendering, then parametric rendering again */
+    dist0 = dist1 = 0.0f;
+    for(i=0; i<3*nBlocks; i++){
+        if(i==nBlocks || i==2*nBlocks){
+            dist0 = linearOnly_test_distance(s, 1);
+            *proposed_analysis_getEnableLinearOnlyPtr(hAna) = i==nBlocks;
+            *proposed_synthesis_getEnableLinearOnlyPtr(hSyn) = i==nBlocks;
+        }
+        rand_m1_1(FLATTEN2D(inSig), nMics*blocksize);
+        proposed_analysis_apply(hAna, inSig, nMics, blocksize, hPCon, hSCon);
+        proposed_synthesis_apply(hSyn, hPCon, hSCon, ypr_rad, xyz_m, PROPOSED_DISTANCE_MAP_USE_PARAM, 2.0f, SAF_TRUE, NUM_EARS, blocksize, outSig);
+        if(i==nBlocks || i==2*nBlocks)
+            dist1 = linearOnly_test_distance(s, 1);
+        if(i==2*nBlocks-1){
+            /* Converged to the linear decoder */
+            distN = linearOnly_test_distance(s, 1);
+            norm = linearOnly_test_distance(s, 0);
+            TEST_ASSERT_TRUE(norm>0.0f);
+            TEST_ASSERT_TRUE(distN<=1e-3f*norm);
+        }
+        if(i==nBlocks){
+            /* Entering: the first block only moves a little of the way towards the linear decoder */
+            TEST_ASSERT_TRUE(dist0>1e-2f*linearOnly_test_distance(s, 0));
+            TEST_ASSERT_TRUE(dist1<dist0 && dist1>0.5f*dist0);
+        }
+    }
+
+    /* Leaving: the first block only moves a little of the way towards the parametric rendering */
+    distN = linearOnly_test_distance(s, 1);
+    TEST_ASSERT_TRUE(distN>1e-2f*linearOnly_test_distance(s, 0));
+    TEST_ASSERT_TRUE(dist1<0.5f*distN);
+
+    /* Clean-up */
+    proposed_analysis_destroy(&hAna);
+    proposed_param_container_destroy(&hPCon);
+    proposed_signal_container_destroy(&hSCon);
+    proposed_synthesis_destroy(&hSyn);
+    free(array_dirs_deg);
+    free(h_array);
+    free(inSig);
+    free(outSig);
+}
+
+/**
+ * Processes one frame of noise with both interfaces of test__proposed_staticFIRs(), and returns the energy of the
+ * difference between their outputs, relative to the energy of the reference output
+ */
+static float staticFIRs_test_frame(void* hInt, void* hIntRef, float** inSig, float** outSig, float** outSigRef, int nMics){
+    int ch, j;
+    float energy, errEnergy;
+
+    rand_m1_1(FLATTEN2D(inSig), nMics*FRAME_SIZE);
+    interface_process(hInt, inSig, outSig, nMics, NUM_EARS, FRAME_SIZE);
+    interface_process(hIntRef, inSig, outSigRef, nMics, NUM_EARS, FRAME_SIZE);
+    energy = errEnergy = 0.0f;
+    for(ch=0; ch<NUM_EARS; ch++){
+        for(j=0; j<FRAME_SIZE; j++){
+            energy += outSigRef[ch][j]*outSigRef[ch][j];
+            errEnergy += (outSig[ch][j]-outSigRef[ch][j])*(outSig[ch][j]-outSigRef[ch][j]);
+        }
+    }
+    TEST_ASSERT_TRUE(energy>0.0f);
+    return errEnergy/energy;
+}
+
+/**
+ * Checks linear-only rendering at a fixed pose with the static-pose FIRs
+ * against the same rendering with the filterbank: the FIR output matches it
+ * within a tolerance (it is not identical, as the FIRs interpolate the mixing
+ * matrices between the band centre frequencies), and switching to the FIRs and
+ * back again is continuous, i.e. no frame deviates by more than the tolerance.
+ */
+void test__proposed_staticFIRs(void){
+    void *hInt = NULL, *hIntRef = NULL;
+    interface_data* pData;
+    int i;
+    float relErr, maxRelErr, meanRelErr;
+    float** inSig, **outSig, **outSigRef;
+    const char* path = "proposed_staticFIRs_test.bin";
+
+    /* Config */
+    const int fs = 48000;
+    const int nMics = 4;
+    const int nOnFrames = 100;
+    const int maxFrames = 1000;      /* to reach each status */
+    const float tol = 0.1f;          /* mean relative error energy (-10 dB) */
+    const float frameTol = 0.25f;    /* relative error energy of any one frame (-6 dB) */
+
+    /* Linear-only rendering at a fixed pose, with and without the static FIRs */
+    interface_test_saveBundle(path, (float)fs);
+    interface_test_create(&hInt, path, fs);
+    interface_test_create(&hIntRef, path, fs);
+    interface_setEnableLinearOnly(hInt, 1);
+    interface_setEnableLinearOnly(hIntRef, 1);
+    interface_setEnableStaticPoseFIRs(hInt, 1);
+    pData = (interface_data*)hInt;
+    inSig = (float**)malloc2d(nMics, FRAME_SIZE, sizeof(float));
+    outSig = (float**)malloc2d(NUM_EARS, FRAME_SIZE, sizeof(float));
+    outSigRef = (float**)malloc2d(NUM_EARS, FRAME_SIZE, sizeof(float));
+
+    /* Hold time, designing and priming the FIRs, then crossfading to them */
+    maxRelErr = 0.0f;
+    for(i=0; i<maxFrames && pData->firStatus != STATIC_FIR_STATUS_ON; i++){
+        relErr = staticFIRs_test_frame(hInt, hIntRef, inSig, outSig, outSigRef, nMics);
+        maxRelErr = SAF_MAX(maxRelErr, relErr);
+    }
+    TEST_ASSERT_EQUAL_INT(STATIC_FIR_STATUS_ON, pData->firStatus);
+
+    /* Rendering with the FIRs */
+    meanRelErr = 0.0f;
+    for(i=0; i<nOnFrames; i++){
+        relErr = staticFIRs_test_frame(hInt, hIntRef, inSig, outSig, outSigRef, nMics);
+        maxRelErr = SAF_MAX(maxRelErr, relErr);
+        meanRelErr += relErr/(float)nOnFrames;
+        TEST_ASSERT_EQUAL_INT(STATIC_FIR_STATUS_ON, pData->firStatus);
+    }
+    TEST_ASSERT_TRUE_MESSAGE(meanRelErr<=tol, "Static FIR output differs from the filterbank output");
+
+    /* Flushing the filterbank, then crossfading back to it (same pose, so the reference remains valid throughout) */
+    interface_setEnableStaticPoseFIRs(hInt, 0);
+    for(i=0; i<maxFrames && pData->firStatus != STATIC_FIR_STATUS_OFF; i++){
+        relErr = staticFIRs_test_frame(hInt, hIntRef, inSig, outSig, outSigRef, nMics);
+        maxRelErr = SAF_MAX(maxRelErr, relErr);
+    }
+    TEST_ASSERT_EQUAL_INT(STATIC_FIR_STATUS_OFF, pData->firStatus);
+    for(i=0; i<10; i++){
+        relErr = staticFIRs_test_frame(hInt, hIntRef, inSig, outSig, outSigRef, nMics);
+        TEST_ASSERT_TRUE(relErr<1e-4f); /* the filterbank again, and fully flushed */
+    }
+    TEST_ASSERT_TRUE_MESSAGE(maxRelErr<=frameTol, "Switching to or from the static FIRs is not continuous");
+
+    /* Clean-up */
+    interface_destroy(&hInt);
+    interface_destroy(&hIntRef);
+    remove(path);
+    free(inSig);
+    free(outSig);
+    free(outSigRef);
+}
+
+/**
+ * Checks the spherical harmonic (SH) representation of the array ATFs. Bands
+ * of known SH order (deliberately not increasing with the band index) must be
+ * fitted at exactly that order, a band of random ATFs must be stored
+ * uncompressed, and the ATFs reconstructed for every band must be within the
+ * fitting error bound. Also checks the bound for the ATFs of an analyser
+ * created with the default fitting error.
+ */
+void test__proposed_atfSH(void){
+    proposed_analysis_handle hAna = NULL;
+    void* hSH = NULL;
+    int band, i, j, nDirs, nSH, order;
+    float err, nrm;
+    float *dirs_deg, *Y, *c, *h_array;
+    float_complex *H_array, *H;
+    float_complex d;
+    int* dir_idx;
+
+    /* Config */
+    const int fs = 48000;
+    const int nMics = 4;
+    const int h_len = 256;
+    const int hopsize = 128;
+    const int blocksize = 256;
+    const int nBands = 6;
+    const int bandOrders[6] = {3, 1, 0, 5, 2, -1}; /* -1: random ATFs, i.e. not of limited order */
+    const int maxOrder = 5;
+    const float maxFitError = PROPOSED_ATF_SH_DEFAULT_FIT_ERROR;
+
+    /* ATFs of known order on a T-design (on which the SH up to order 10 are orthogonal) */
+    nDirs = __Tdesign_degree_21_nPoints;
+    dirs_deg = malloc1d(nDirs*2*sizeof(float));
+    memcpy(dirs_deg, __Tdesign_degree_21_dirs_deg, nDirs*2*sizeof(float));
+    Y = malloc1d(ORDER2NSH(maxOrder)*nDirs*sizeof(float));
+    getRSH(maxOrder, dirs_deg, nDirs, Y); /* nSH x nDirs */
+    c = malloc1d(2*ORDER2NSH(maxOrder)*sizeof(float));
+    H_array = malloc1d(nDirs*nBands*nMics*sizeof(float_complex));
+    for(band=0; band<nBands; band++){
+        for(i=0; i<nMics; i++){
+            nSH = bandOrders[band]>=0 ? ORDER2NSH(bandOrders[band]) : 0;
+            rand_m1_1(c, 2*nSH);
+            for(j=0; j<nDirs; j++){
+                if(bandOrders[band]>=0)
+                    H_array[(j*nBands + band)*nMics + i] = cmplxf(cblas_sdot(nSH, c, 1, &Y[j], nDirs), cblas_sdot(nSH, &c[nSH], 1, &Y[j], nDirs));
+                else
+                    rand_m1_1((float*)&H_array[(j*nBands + band)*nMics + i], 2);
+            }
+        }
+    }
+    proposed_atfSH_create(&hSH, H_array, dirs_deg, nBands, nMics, nDirs, maxFitError);
+
+    /* Orders, and the reconstructed ATFs */
+    dir_idx = malloc1d(nDirs*sizeof(int));
+    for(j=0; j<nDirs; j++)
+        dir_idx[j] = j;
+    H = malloc1d(nMics*nDirs*sizeof(float_complex));
+    for(band=0; band<nBands; band++){
+        TEST_ASSERT_EQUAL_INT(bandOrders[band], proposed_atfSH_getOrder(hSH, band));
+        proposed_atfSH_getATFs(hSH, band, dir_idx, nDirs, H);
+        err = nrm = 0.0f;
+        for(i=0; i<nMics; i++){
+            for(j=0; j<nDirs; j++){
+                d = ccsubf(H[i*nDirs+j], H_array[(j*nBands + band)*nMics + i]);
+                err += crealf(d)*crealf(d) + cimagf(d)*cimagf(d);
+                d = H_array[(j*nBands + band)*nMics + i];
+                nrm += crealf(d)*crealf(d) + cimagf(d)*cimagf(d);
+            }
+        }
+        TEST_ASSERT_TRUE(err/nrm <= maxFitError);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, proposed_atfSH_getFitError(hSH, band), err/nrm);
+    }
+    proposed_atfSH_destroy(&hSH);
+
+    /* Analyser with compressed ATFs */
+    h_array = malloc1d(nDirs*nMics*h_len*sizeof(float));
+    rand_m1_1(h_array, nDirs*nMics*h_len);
+    proposed_analysis_create(&hAna, (float)fs, hopsize, blocksize, h_array, dirs_deg, nDirs, nMics, h_len, maxFitError);
+    for(band=0; band<proposed_analysis_getNbands(hAna); band++){
+        order = proposed_analysis_getATFOrder(hAna, band);
+        TEST_ASSERT_TRUE(order>=-1 && order<=PROPOSED_ATF_SH_MAX_ORDER);
+        TEST_ASSERT_TRUE(proposed_analysis_getATFFitError(hAna, band) <= maxFitError);
+    }
+
+    /* Clean-up */
+    proposed_analysis_destroy(&hAna);
+    free(dirs_deg);
+    free(Y);
+    free(c);
+    free(H_array);
+    free(dir_idx);
+    free(H);
+    free(h_array);
+}
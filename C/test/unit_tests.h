@@ -32,6 +32,45 @@ int main_test(void);
 /** Proposed method */
 void test__proposed_method(void);
 
+/** Real-time safety of the processing functions of the proposed method */
+void test__proposed_rtSafety(void);
+
+/** Tracing of processing spans */
+void test__proposed_trace(void);
+
+/** Fused (per-band) processing, compared with separate analysis/synthesis */
+void test__proposed_fusedProcessing(void);
+
+/** SIMD mixing kernels, compared with the scalar kernel */
+void test__proposed_mixKernels(void);
+
+/** Fixed-size small-matrix kernels (eigendecomposition and inverses) */
+void test__proposed_smallMatKernels(void);
+
+/** Array model bundles, saved and loaded again */
+void test__proposed_bundle(void);
+
+/** Initialisation with one and with several threads, which must give identical results */
+void test__proposed_initThreads(void);
+
+/** Integration weights of a dense grid, compared with the Voronoi weights */
+void test__proposed_quadratureWeights(void);
+
+/** Silence gate of the interface, compared with the interface without it */
+void test__proposed_silenceGate(void);
+
+/** CPU governor of the interface, and the analysis limits of its quality tiers */
+void test__proposed_governor(void);
+
+/** Linear-only rendering, which converges to the equalised linear decoder and is crossfaded */
+void test__proposed_linearOnly(void);
+
+/** Static-pose FIRs of the interface, compared with the filterbank rendering */
+void test__proposed_staticFIRs(void);
+
+/** Spherical harmonic representation of the array ATFs, with the fitting error bound and per-band orders */
+void test__proposed_atfSH(void);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif /* __cplusplus */
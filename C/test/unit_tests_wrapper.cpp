@@ -10,5 +10,5 @@
 
 int main(){
     /* std::cout << "(This is a C++ wrapper for running the unit tests)\n\n"; */
-    main_test();
+    return main_test(); /* the number of failed tests */
 }
@@ -0,0 +1,101 @@
+/**
+ * @file sofa2bundle.c
+ * @brief Converts array IRs (and optionally HRIRs) stored as SOFA files into a
+ *        bundle, which may then be loaded with
+ *        proposed_analysis_createFromBundle()
+ *
+ * Usage:
+ *   sofa2bundle <array.sofa> <output bundle> [samplerate] [hopsize] [hrirs.sofa]
+ *
+ * The samplerate defaults to 48kHz, and the hopsize to 128 (as used by the
+ * plug-in). If an HRIR SOFA file is given, then the HRTFs interpolated for the
+ * array grid (nearest neighbour, with diffuse-field equalisation) are also
+ * stored in the bundle.
+ *
+ * @author agent
+ * @date 19th October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "proposed.h"
+#include "saf.h"
+
+#define DEFAULT_FS ( 48000.0f )
+#define DEFAULT_HOP_SIZE ( 128 )
+
+int main(int argc, char* argv[])
+{
+    saf_sofa_container sofa;
+    SAF_SOFA_ERROR_CODES error;
+    PROPOSED_BUNDLE_ERROR_CODES bundleError;
+    proposed_analysis_handle hAna;
+    proposed_synthesis_handle hSyn;
+    proposed_binaural_config binConfig;
+    float fs;
+    int i, hopsize, nDirs, nMics;
+    float* array_dirs_deg;
+
+    if(argc<3){
+        printf("Usage: %s <array.sofa> <output bundle> [samplerate] [hopsize] [hrirs.sofa]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    fs = argc>3 ? (float)atof(argv[3]) : DEFAULT_FS;
+    hopsize = argc>4 ? atoi(argv[4]) : DEFAULT_HOP_SIZE;
+    if(fs<=0.0f || hopsize<=0){
+        printf("Invalid samplerate or hopsize\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Array model */
+    error = saf_sofa_open(&sofa, argv[1], SAF_SOFA_READER_OPTION_DEFAULT);
+    if(error!=SAF_SOFA_OK){
+        printf("Could not load the array IRs: %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    nDirs = sofa.nSources;
+    nMics = sofa.nReceivers;
+    array_dirs_deg = malloc1d(nDirs*2*sizeof(float));
+    for(i=0; i<nDirs; i++){
+        array_dirs_deg[i*2]   = sofa.SourcePosition[i*3];   /* azi */
+        array_dirs_deg[i*2+1] = sofa.SourcePosition[i*3+1]; /* elev */
+    }
+    printf("Computing the array model: %d directions, %d microphones, %.0f Hz, hopsize %d\n", nDirs, nMics, fs, hopsize);
+    proposed_analysis_create(&hAna, fs, hopsize, hopsize, sofa.DataIR, array_dirs_deg, nDirs, nMics, sofa.DataLengthIR, 0.0f);
+    free(array_dirs_deg);
+    saf_sofa_close(&sofa);
+
+    /* Optional HRTFs */
+    hSyn = NULL;
+    if(argc>5){
+        error = saf_sofa_open(&sofa, argv[5], SAF_SOFA_READER_OPTION_DEFAULT);
+        if(error!=SAF_SOFA_OK){
+            printf("Could not load the HRIRs: %s\n", argv[5]);
+            proposed_analysis_destroy(&hAna);
+            return EXIT_FAILURE;
+        }
+        binConfig.nHRIR = sofa.nSources;
+        binConfig.lHRIR = sofa.DataLengthIR;
+        binConfig.hrir_fs = (int)sofa.DataSamplingRate;
+        binConfig.hrirs = sofa.DataIR;
+        binConfig.hrir_dirs_deg = malloc1d(binConfig.nHRIR*2*sizeof(float));
+        for(i=0; i<binConfig.nHRIR; i++){
+            binConfig.hrir_dirs_deg[i*2]   = sofa.SourcePosition[i*3];   /* azi */
+            binConfig.hrir_dirs_deg[i*2+1] = sofa.SourcePosition[i*3+1]; /* elev */
+        }
+        printf("Interpolating the HRTFs: %d measurements\n", binConfig.nHRIR);
+        proposed_synthesis_create(&hSyn, hAna, &binConfig, PROPOSED_HRTF_INTERP_NEAREST, 0, 0, 1, 0);
+        free(binConfig.hrir_dirs_deg);
+        saf_sofa_close(&sofa);
+    }
+
+    /* Write */
+    bundleError = proposed_bundle_save(hAna, hSyn, argv[2]);
+    if(bundleError!=PROPOSED_BUNDLE_OK)
+        printf("Could not write the bundle: %s (error %d)\n", argv[2], (int)bundleError);
+    else
+        printf("Written: %s\n", argv[2]);
+    proposed_synthesis_destroy(&hSyn);
+    proposed_analysis_destroy(&hAna);
+    return bundleError==PROPOSED_BUNDLE_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -493,6 +493,22 @@ PluginEditor::PluginEditor (PluginProcessor* ownerFilter)
     progressbar.setColour(ProgressBar::backgroundColourId, Colours::gold);
     progressbar.setColour(ProgressBar::foregroundColourId, Colours::white);
 
+    /* Processing stage timings */
+    label_profile.reset (new juce::Label ("profile", String()));
+    addAndMakeVisible (label_profile.get());
+    label_profile->setFont (juce::Font (11.00f, juce::Font::plain));
+    label_profile->setJustificationType (juce::Justification::centredLeft);
+    label_profile->setColour (juce::Label::textColourId, juce::Colours::white);
+    label_profile->setBounds (444, 34, 292, 12); /* (between the HRIR panel and the listener view option, above the translation window) */
+
+    /* Block timing telemetry */
+    label_telemetry.reset (new juce::Label ("telemetry", String()));
+    addAndMakeVisible (label_telemetry.get());
+    label_telemetry->setFont (juce::Font (11.00f, juce::Font::plain));
+    label_telemetry->setJustificationType (juce::Justification::centredLeft);
+    label_telemetry->setColour (juce::Label::textColourId, juce::Colours::white);
+    label_telemetry->setBounds (444, 46, 292, 12);
+
     /* grab current parameter settings */
     s_diff2dir->setValue(interface_getStreamBalanceAllBands(hInt), dontSendNotification);
     TBuseDefaultHRIRs->setToggleState((bool)interface_getUseDefaultHRIRsflag(hInt), dontSendNotification);
@@ -1667,6 +1683,7 @@ void PluginEditor::comboBoxChanged (juce::ComboBox* comboBoxThatHasChanged)
 //[MiscUserCode] You can add your own definitions of your custom methods or any other code here...
 void PluginEditor::timerCallback(int timerID)
 {
+    ScopedTraceSpan span("Message thread", "Editor timer");
     switch(timerID){
         case TIMER_PROCESSING_RELATED:
             /* Handled in PluginProcessor */
@@ -1721,6 +1738,10 @@ void PluginEditor::timerCallback(int timerID)
             translationWindow->setDataHandles(pX_vector, pY_values, nPoints);
             translationWindow->refresh();
 
+            /* Processing stage timings */
+            refreshProfile();
+            refreshTelemetry();
+
             /* Progress bar */
             if(interface_getCoreStatus(hInt)==CORE_STATUS_INITIALISING){
                 addAndMakeVisible(progressbar);
@@ -1784,6 +1805,74 @@ void PluginEditor::timerCallback(int timerID)
     }
 }
 
+void PluginEditor::refreshProfile()
+{
+    interface_profile_stats stats[INTERFACE_NUM_PROFILE_STAGES];
+    String table;
+    float total_ms;
+    int i, heaviest;
+
+    if(!interface_getEnableProfiling(hInt)){
+        label_profile->setText(String(), dontSendNotification);
+        return;
+    }
+
+    /* Mean time per frame, and the stage with the highest 99th percentile (the likely cause of any spikes) */
+    interface_getProfile(hInt, stats);
+    total_ms = 0.0f;
+    heaviest = 0;
+    for(i=0; i<INTERFACE_NUM_PROFILE_STAGES; i++){
+        total_ms += stats[i].mean_ms;
+        if(stats[i].p99_ms > stats[heaviest].p99_ms)
+            heaviest = i;
+        table += String(interface_getProfileStageName((INTERFACE_PROFILE_STAGES)i)) + ": " +
+                 String(stats[i].last_ms, 3) + " / " + String(stats[i].mean_ms, 3) + " / " +
+                 String(stats[i].p99_ms, 3) + " / " + String(stats[i].max_ms, 3) + " ms (" + String(stats[i].count) + ")\n";
+    }
+    if(stats[heaviest].count == 0){
+        label_profile->setText(String(), dontSendNotification);
+        return;
+    }
+    label_profile->setText(TRANS("DSP: ") + String(total_ms, 2) + TRANS(" ms/frame, heaviest: ") +
+                           String(interface_getProfileStageName((INTERFACE_PROFILE_STAGES)heaviest)) +
+                           TRANS(" (p99 ") + String(stats[heaviest].p99_ms, 2) + TRANS(" ms)"), dontSendNotification);
+    label_profile->setTooltip(TRANS("Time per frame for each processing stage; last / mean / p99 / max (number of frames):\n") + table);
+}
+
+void PluginEditor::refreshTelemetry()
+{
+    interface_telemetry t;
+    String text, table;
+    unsigned int nSkipped;
+    int i, latest;
+
+    interface_getTelemetry(hInt, &t);
+    text = TRANS("Load: ") + String(100.0f*t.meanLoad, 1) + "%";
+
+    /* Overruns, with the age of the last one */
+    if(t.nOverruns > 0)
+        text += TRANS(", overruns: ") + String(t.nOverruns) + " (" + String(t.time_s-t.lastOverrunTime_s, 0) + TRANS(" s ago)");
+
+    /* Skipped blocks, with the reason for the most recent one */
+    nSkipped = 0;
+    latest = 0;
+    for(i=0; i<INTERFACE_NUM_SKIP_REASONS; i++){
+        nSkipped += t.nSkipped[i];
+        if(t.lastSkipTime_s[i] > t.lastSkipTime_s[latest])
+            latest = i;
+        table += String(interface_getSkipReasonName((INTERFACE_SKIP_REASONS)i)) + ": " + String(t.nSkipped[i]) +
+                 (t.lastSkipTime_s[i] < 0.0 ? String() : " (" + String(t.time_s-t.lastSkipTime_s[i], 1) + TRANS(" s ago)")) + "\n";
+    }
+    if(nSkipped > 0)
+        text += TRANS(", skipped: ") + String(nSkipped) + " (" + String(interface_getSkipReasonName((INTERFACE_SKIP_REASONS)latest)) + ")";
+    label_telemetry->setText(text, dontSendNotification);
+    label_telemetry->setTooltip(TRANS("Blocks processed: ") + String(t.nProcessed) + "\n" +
+                                TRANS("Overruns (longer than the block duration): ") + String(t.nOverruns) +
+                                (t.lastOverrunTime_s < 0.0 ? String() : " (" + String(t.time_s-t.lastOverrunTime_s, 1) + TRANS(" s ago)")) + "\n" +
+                                TRANS("Worst block: ") + String(t.worstBlockTime_ms, 3) + " ms (" + String(100.0f*t.worstBlockLoad, 1) + TRANS("% of its duration)\n") +
+                                TRANS("Blocks output as silence:\n") + table);
+}
+
 //[/MiscUserCode]
 
 
@@ -138,6 +138,14 @@ private:
     /* warnings */
     POSSIBLE_WARNINGS currentWarning;
 
+    /* processing stage timings (the full table is shown as its tooltip) */
+    std::unique_ptr<juce::Label> label_profile;
+    void refreshProfile();
+
+    /* block timing telemetry, i.e. load, overruns and skipped blocks (details are shown as its tooltip) */
+    std::unique_ptr<juce::Label> label_telemetry;
+    void refreshTelemetry();
+
     /* tooltips */
     SharedResourcePointer<TooltipWindow> tipWindow;
     std::unique_ptr<juce::ComboBox> pluginDescription; /* Dummy combo box to provide plugin description tooltip */
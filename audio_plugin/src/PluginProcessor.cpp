@@ -28,16 +28,26 @@ PluginProcessor::PluginProcessor()
     /* tell the component to listen for OSC messages */
     osc.addListener(this);
 
+    /* optional tracing of the audio, initialisation, OSC and GUI threads; set PROPOSED_TRACE_FILE to the path of the
+     * Chrome trace-event JSON file to write when the plug-in is closed (see interface_dumpTrace()) */
+    traceFilePath = SystemStats::getEnvironmentVariable("PROPOSED_TRACE_FILE", String());
+    if(traceFilePath.isNotEmpty())
+        interface_setEnableTracing(1);
+
     startTimer(TIMER_PROCESSING_RELATED, 40); 
 }
 
 PluginProcessor::~PluginProcessor()
 {
+    if(traceFilePath.isNotEmpty())
+        interface_dumpTrace(traceFilePath.toRawUTF8());
 	interface_destroy(&hInt);
 }
 
 void PluginProcessor::oscMessageReceived(const OSCMessage& message)
 {
+    ScopedTraceSpan span("OSC", "OSC message");
+
     /* if rotation angles are sent as an array \ypr[3] */
     if (message.size() == 3 && message.getAddressPattern().toString().compare("ypr")) {
         if (message[0].isFloat32())
@@ -328,6 +338,7 @@ void PluginProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer& /*mid
     float** bufferData = buffer.getArrayOfWritePointers(); 
     float* pFrameData[INTERFACE_MAX_NUM_CHANNELS];
     int frameSize = interface_getFrameSize();
+    ScopedTraceSpan span("Audio", "processBlock");
 
     if(nCurrentBlockSize % frameSize == 0){ /* divisible by frame size */
         for(int frame = 0; frame < nCurrentBlockSize/frameSize; frame++) {
@@ -338,8 +349,11 @@ void PluginProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer& /*mid
             interface_process(hInt, pFrameData, pFrameData, nNumInputs, nNumOutputs, frameSize);
         }
     }
-    else
+    else{
+        /* not processed, but passed on so that it is counted as a skipped block (see interface_getTelemetry()) */
+        interface_process(hInt, bufferData, bufferData, nNumInputs, nNumOutputs, nCurrentBlockSize);
         buffer.clear();
+    }
 }
 
 //==============================================================================
@@ -34,6 +34,22 @@ typedef enum _TIMERS{
     TIMER_GUI_RELATED
 }TIMERS;
 
+/* Traces the scope in which it is declared as a span, if tracing is enabled (see interface_setEnableTracing()) */
+class ScopedTraceSpan
+{
+public:
+    ScopedTraceSpan(const char* threadName, const char* spanName) : name(spanName) {
+        if(interface_getEnableTracing())
+            interface_setTraceThreadName(threadName);
+        t0 = interface_traceBegin();
+    }
+    ~ScopedTraceSpan() { interface_traceEnd(name, t0); }
+
+private:
+    const char* name;
+    unsigned long long t0;
+};
+
 enum {
     /* For the default VST GUI */
     k_listenerX,
@@ -100,14 +116,22 @@ private:
     OSCReceiver osc;         /* OSC receiver object */
     bool osc_connected;      /* flag. 0: not connected, 1: connect to "osc_port_ID"  */
     int osc_port_ID;         /* port ID */
+
+    String traceFilePath;    /* file that the traced spans are written to when closed (empty: tracing disabled) */
     
     void timerCallback(int timerID) override {
+        ScopedTraceSpan span("Message thread", "Processor timer");
         switch(timerID){
             case TIMER_PROCESSING_RELATED:
                 /* reinitialise codec if needed */
                 if(interface_getCoreStatus(hInt) == CORE_STATUS_NOT_INITIALISED){
                     try{
-                        std::thread threadInit(interface_initCore, hInt);
+                        std::thread threadInit([](void* h){
+                            if(interface_getEnableTracing())
+                                interface_setTraceThreadName("Init");
+                            interface_initCore(h);
+                            interface_releaseTraceThread(); /* (this thread only lives for this initialisation) */
+                        }, hInt);
                         threadInit.detach();
                     } catch (const std::exception& exception) {
                         std::cout << "Could not create thread" << exception.what() << std::endl;